@@ -0,0 +1,62 @@
+#include "BenchInputs.hpp"
+#include "core/ASTAnalyzer.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace ts_mcp;
+using namespace ts_mcp::bench;
+
+namespace {
+
+// Cache hit: validity check (stat) plus the analysis queries
+void BM_AnalyzeFileCacheHit(benchmark::State& state) {
+    auto size = static_cast<InputSize>(state.range(0));
+    const auto& ws = workspace(size);
+    ASTAnalyzer analyzer;
+    analyzer.analyze_file(ws.single_file);
+
+    for (auto _ : state) {
+        auto result = analyzer.analyze_file(ws.single_file);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetLabel(std::string(size_name(size)));
+}
+
+BENCHMARK(BM_AnalyzeFileCacheHit)->ArgName("size")->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+// Cache miss: read, parse and analyze
+void BM_AnalyzeFileCacheMiss(benchmark::State& state) {
+    auto size = static_cast<InputSize>(state.range(0));
+    const auto& ws = workspace(size);
+    ASTAnalyzer analyzer;
+
+    for (auto _ : state) {
+        analyzer.clear_cache();
+        auto result = analyzer.analyze_file(ws.single_file);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetLabel(std::string(size_name(size)));
+}
+
+BENCHMARK(BM_AnalyzeFileCacheMiss)->ArgName("size")->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+// Whole workspace with a warm cache
+void BM_AnalyzeFilesWarm(benchmark::State& state) {
+    auto size = static_cast<InputSize>(state.range(0));
+    const auto& ws = workspace(size);
+    ASTAnalyzer analyzer;
+    analyzer.analyze_files(ws.files);
+
+    for (auto _ : state) {
+        auto result = analyzer.analyze_files(ws.files);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ws.files.size()));
+    state.SetLabel(std::string(size_name(size)));
+}
+
+BENCHMARK(BM_AnalyzeFilesWarm)->ArgName("size")->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+} // namespace
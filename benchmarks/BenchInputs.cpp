@@ -0,0 +1,191 @@
+#include "BenchInputs.hpp"
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+
+#ifndef TS_MCP_BENCH_REVISION
+#define TS_MCP_BENCH_REVISION "unknown"
+#endif
+
+namespace ts_mcp::bench {
+
+namespace {
+
+constexpr uint32_t SEED = 42;
+
+/**
+ * @brief Minimal LCG: stable output across standard library implementations
+ */
+class Rng {
+public:
+    explicit Rng(uint32_t seed) : state_(seed * 2654435761u + 1) {}
+
+    uint32_t next() {
+        state_ = state_ * 1664525u + 1013904223u;
+        return state_ >> 8;
+    }
+
+    uint32_t below(uint32_t bound) { return next() % bound; }
+
+private:
+    uint32_t state_;
+};
+
+size_t file_count(InputSize size) {
+    switch (size) {
+        case InputSize::Small: return 1;
+        case InputSize::Medium: return 50;
+        case InputSize::Huge: return 500;
+    }
+    return 1;
+}
+
+/**
+ * @brief Owns the generated workspaces and deletes them at exit
+ */
+class WorkspaceStore {
+public:
+    ~WorkspaceStore() {
+        std::error_code ec;
+        if (!base_.empty()) {
+            std::filesystem::remove_all(base_, ec);
+        }
+    }
+
+    const Workspace& get(InputSize size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = workspaces_.find(size);
+        if (it != workspaces_.end()) {
+            return it->second;
+        }
+        return workspaces_.emplace(size, create(size)).first->second;
+    }
+
+private:
+    Workspace create(InputSize size) {
+        if (base_.empty()) {
+            base_ = std::filesystem::temp_directory_path() /
+                    ("ts_mcp_bench_" + std::to_string(::getpid()));
+        }
+
+        Workspace ws;
+        ws.root = base_ / std::string(size_name(size));
+        std::filesystem::create_directories(ws.root);
+
+        // Medium and huge spread files over a few subdirectories
+        size_t count = file_count(size);
+        size_t classes = count == 1 ? classes_per_file(size) : 20;
+        for (size_t i = 0; i < count; ++i) {
+            auto dir = count == 1 ? ws.root : ws.root / ("module" + std::to_string(i % 10));
+            std::filesystem::create_directories(dir);
+            auto path = dir / ("file" + std::to_string(i) + ".cpp");
+            std::ofstream(path) << make_cpp_source(classes, SEED + static_cast<uint32_t>(i));
+            ws.files.push_back(std::filesystem::canonical(path));
+        }
+
+        // Old timestamps, as in a real checkout: fresh ones fall inside the
+        // inventory's racy window and would force a re-listing on every scan
+        auto past = std::filesystem::file_time_type::clock::now() - std::chrono::hours(24);
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(ws.root)) {
+            std::filesystem::last_write_time(entry.path(), past);
+        }
+        std::filesystem::last_write_time(ws.root, past);
+
+        ws.single_file = ws.files.front();
+        ws.root = std::filesystem::canonical(ws.root);
+        ws.class_name = "Class" + std::to_string(SEED) + "_0";
+        ws.function_name = "helper_0";
+        return ws;
+    }
+
+    std::mutex mutex_;
+    std::filesystem::path base_;
+    std::map<InputSize, Workspace> workspaces_;
+};
+
+WorkspaceStore& store() {
+    static WorkspaceStore instance;
+    return instance;
+}
+
+} // namespace
+
+std::string_view size_name(InputSize size) {
+    switch (size) {
+        case InputSize::Small: return "small";
+        case InputSize::Medium: return "medium";
+        case InputSize::Huge: return "huge";
+    }
+    return "unknown";
+}
+
+size_t classes_per_file(InputSize size) {
+    switch (size) {
+        case InputSize::Small: return 5;
+        case InputSize::Medium: return 100;
+        case InputSize::Huge: return 2000;
+    }
+    return 5;
+}
+
+std::string make_cpp_source(size_t class_count, uint32_t seed) {
+    Rng rng(seed);
+    std::string out;
+    out.reserve(class_count * 400);
+
+    out += "#include <string>\n#include <vector>\n";
+    out += "#include \"module" + std::to_string(seed % 10) + "/common.hpp\"\n\n";
+    out += "namespace gen" + std::to_string(seed) + " {\n\n";
+    out += "int helper_0(int value) { return value * 2; }\n\n";
+
+    for (size_t c = 0; c < class_count; ++c) {
+        std::string name = "Class" + std::to_string(seed) + "_" + std::to_string(c);
+        out += "/**\n * @brief Generated class " + name + "\n */\n";
+        if (c > 0 && rng.below(3) == 0) {
+            out += "class " + name + " : public Class" + std::to_string(seed) + "_" +
+                   std::to_string(rng.below(static_cast<uint32_t>(c))) + " {\n";
+        } else {
+            out += "class " + name + " {\n";
+        }
+        out += "public:\n";
+        out += "    " + name + "() = default;\n";
+        out += "    virtual ~" + name + "() = default;\n";
+
+        uint32_t methods = 2 + rng.below(4);
+        for (uint32_t m = 0; m < methods; ++m) {
+            std::string method = "method" + std::to_string(m);
+            out += "    virtual int " + method + "(int a, const std::string& b) {\n";
+            out += "        int total = a + static_cast<int>(b.size());\n";
+            out += "        for (int i = 0; i < " + std::to_string(1 + rng.below(10)) + "; ++i) {\n";
+            out += "            if (i % 2 == 0) { total += helper_0(i); } else { total -= i; }\n";
+            out += "        }\n";
+            out += "        return total;\n";
+            out += "    }\n";
+        }
+
+        out += "\nprivate:\n";
+        out += "    std::vector<int> values_;\n";
+        out += "    int counter_ = " + std::to_string(rng.below(100)) + ";\n";
+        out += "};\n\n";
+    }
+
+    out += "} // namespace gen" + std::to_string(seed) + "\n";
+    return out;
+}
+
+const Workspace& workspace(InputSize size) {
+    return store().get(size);
+}
+
+void initialize() {
+    spdlog::set_level(spdlog::level::off);
+    benchmark::AddCustomContext("ts_mcp_revision", TS_MCP_BENCH_REVISION);
+    benchmark::AddCustomContext("ts_mcp_input_seed", std::to_string(SEED));
+}
+
+} // namespace ts_mcp::bench
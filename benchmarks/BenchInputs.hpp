@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ts_mcp::bench {
+
+/**
+ * @brief Input scale used by every benchmark (the benchmark argument)
+ *
+ * Inputs are generated from a fixed seed, so results of the same benchmark
+ * on different commits measure the same work.
+ */
+enum class InputSize : int64_t {
+    Small = 0,   // One file, a few classes
+    Medium = 1,  // A directory of tens of files
+    Huge = 2     // Hundreds of files; single-file benchmarks use one very large file
+};
+
+/**
+ * @brief Label for benchmark output ("small", "medium", "huge")
+ */
+std::string_view size_name(InputSize size);
+
+/**
+ * @brief Number of classes in the single-file input of a size
+ */
+size_t classes_per_file(InputSize size);
+
+/**
+ * @brief Deterministic C++ source with classes, methods, includes and calls
+ * @param class_count Number of classes to generate
+ * @param seed Generator seed (same seed, same text)
+ */
+std::string make_cpp_source(size_t class_count, uint32_t seed);
+
+/**
+ * @brief On-disk workspace shared by the file-based benchmarks
+ *
+ * Created on first use under the temp directory and removed at exit.
+ */
+struct Workspace {
+    std::filesystem::path root;              // Directory holding all files of this size
+    std::filesystem::path single_file;       // One representative file
+    std::vector<std::filesystem::path> files;
+    std::string class_name;                  // A class defined in single_file
+    std::string function_name;               // A function referenced across files
+};
+
+/**
+ * @brief Get (creating on first call) the workspace for a size
+ */
+const Workspace& workspace(InputSize size);
+
+/**
+ * @brief Silence logging and record run metadata in the benchmark context
+ */
+void initialize();
+
+} // namespace ts_mcp::bench
@@ -0,0 +1,26 @@
+#include "BenchInputs.hpp"
+#include "core/TreeSitterParser.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace ts_mcp;
+using namespace ts_mcp::bench;
+
+namespace {
+
+void BM_ParseString(benchmark::State& state) {
+    auto size = static_cast<InputSize>(state.range(0));
+    std::string source = make_cpp_source(classes_per_file(size), 1);
+    TreeSitterParser parser(Language::CPP);
+
+    for (auto _ : state) {
+        auto tree = parser.parse_string(source);
+        benchmark::DoNotOptimize(tree);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+    state.SetLabel(std::string(size_name(size)));
+}
+
+BENCHMARK(BM_ParseString)->ArgName("size")->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,40 @@
+#include "BenchInputs.hpp"
+#include "core/PathResolver.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace ts_mcp;
+using namespace ts_mcp::bench;
+
+namespace {
+
+/**
+ * @brief Recursive scan of a workspace
+ *
+ * Second argument: 1 = resident inventory (the default), 0 = walk on every call
+ */
+void BM_ResolvePaths(benchmark::State& state) {
+    auto size = static_cast<InputSize>(state.range(0));
+    bool inventory = state.range(1) != 0;
+    const auto& ws = workspace(size);
+
+    PathResolver::set_inventory_enabled(inventory);
+    std::vector<std::string> paths{ws.root.string()};
+    size_t found = 0;
+
+    for (auto _ : state) {
+        auto result = PathResolver::resolve_paths(paths, true);
+        found = result.size();
+        benchmark::DoNotOptimize(result);
+    }
+
+    PathResolver::set_inventory_enabled(true);
+    state.counters["files"] = static_cast<double>(found);
+    state.SetLabel(std::string(size_name(size)));
+}
+
+BENCHMARK(BM_ResolvePaths)
+    ->ArgNames({"size", "inventory"})
+    ->ArgsProduct({{0, 1, 2}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,61 @@
+#include "BenchInputs.hpp"
+#include "core/QueryEngine.hpp"
+#include "core/TreeSitterParser.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace ts_mcp;
+using namespace ts_mcp::bench;
+
+namespace {
+
+void BM_CompileQuery(benchmark::State& state) {
+    auto type = static_cast<QueryType>(state.range(0));
+    auto query_string = QueryEngine::get_predefined_query(type, Language::CPP);
+    if (!query_string) {
+        state.SkipWithError("No predefined query");
+        return;
+    }
+    QueryEngine engine;
+
+    for (auto _ : state) {
+        auto query = engine.compile_query(*query_string, Language::CPP);
+        benchmark::DoNotOptimize(query);
+    }
+}
+
+BENCHMARK(BM_CompileQuery)
+    ->ArgName("query_type")
+    ->Arg(static_cast<int64_t>(QueryType::CLASSES))
+    ->Arg(static_cast<int64_t>(QueryType::FUNCTIONS))
+    ->Arg(static_cast<int64_t>(QueryType::INCLUDES))
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ExecuteQuery(benchmark::State& state) {
+    auto size = static_cast<InputSize>(state.range(0));
+    std::string source = make_cpp_source(classes_per_file(size), 1);
+    TreeSitterParser parser(Language::CPP);
+    auto tree = parser.parse_string(source);
+
+    QueryEngine engine;
+    auto query = engine.compile_query(
+        *QueryEngine::get_predefined_query(QueryType::FUNCTIONS, Language::CPP), Language::CPP);
+    if (!tree || !query) {
+        state.SkipWithError("Setup failed");
+        return;
+    }
+
+    size_t matches = 0;
+    for (auto _ : state) {
+        auto result = engine.execute(*tree, *query, source);
+        matches = result.size();
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["matches"] = static_cast<double>(matches);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+    state.SetLabel(std::string(size_name(size)));
+}
+
+BENCHMARK(BM_ExecuteQuery)->ArgName("size")->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,85 @@
+#include "BenchInputs.hpp"
+#include "tools/ExecuteQueryTool.hpp"
+#include "tools/ExtractInterfaceTool.hpp"
+#include "tools/FindClassesTool.hpp"
+#include "tools/FindFunctionsTool.hpp"
+#include "tools/FindReferencesTool.hpp"
+#include "tools/GetClassHierarchyTool.hpp"
+#include "tools/GetDependencyGraphTool.hpp"
+#include "tools/GetFileSummaryTool.hpp"
+#include "tools/GetSymbolContextTool.hpp"
+#include "tools/ParseFileTool.hpp"
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <memory>
+
+using namespace ts_mcp;
+using namespace ts_mcp::bench;
+
+namespace {
+
+/**
+ * @brief Target path for a size: the single file for small, the directory otherwise
+ */
+std::string target(const Workspace& ws, InputSize size) {
+    return size == InputSize::Small ? ws.single_file.string() : ws.root.string();
+}
+
+using ArgsBuilder = std::function<json(const Workspace& ws, InputSize size)>;
+
+json filepath_args(const Workspace& ws, InputSize size) {
+    return {{"filepath", target(ws, size)}};
+}
+
+/**
+ * @brief Benchmark Tool::execute with a warm analyzer cache
+ */
+template <typename Tool>
+void register_tool(const std::string& name, ArgsBuilder build_args) {
+    auto* bench = benchmark::RegisterBenchmark(
+        ("BM_Tool/" + name).c_str(),
+        [build_args](benchmark::State& state) {
+            auto size = static_cast<InputSize>(state.range(0));
+            const auto& ws = workspace(size);
+            json args = build_args(ws, size);
+
+            auto analyzer = std::make_shared<ASTAnalyzer>();
+            Tool tool(analyzer);
+            size_t result_bytes = tool.execute(args).dump().size();
+
+            for (auto _ : state) {
+                auto result = tool.execute(args);
+                benchmark::DoNotOptimize(result);
+            }
+
+            state.counters["result_bytes"] = static_cast<double>(result_bytes);
+            state.SetLabel(std::string(size_name(size)));
+        });
+    bench->ArgName("size")->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+}
+
+const bool registered = [] {
+    register_tool<ParseFileTool>("parse_file", filepath_args);
+    register_tool<FindClassesTool>("find_classes", filepath_args);
+    register_tool<FindFunctionsTool>("find_functions", filepath_args);
+    register_tool<ExtractInterfaceTool>("extract_interface", filepath_args);
+    register_tool<GetFileSummaryTool>("get_file_summary", filepath_args);
+    register_tool<GetClassHierarchyTool>("get_class_hierarchy", filepath_args);
+    register_tool<GetDependencyGraphTool>("get_dependency_graph", filepath_args);
+
+    register_tool<ExecuteQueryTool>("execute_query", [](const Workspace& ws, InputSize size) {
+        return json{{"filepath", target(ws, size)},
+                    {"query", "(class_specifier name: (type_identifier) @name)"}};
+    });
+    register_tool<FindReferencesTool>("find_references", [](const Workspace& ws, InputSize size) {
+        return json{{"filepath", target(ws, size)}, {"symbol", ws.function_name}};
+    });
+    register_tool<GetSymbolContextTool>("get_symbol_context", [](const Workspace& ws, InputSize) {
+        return json{{"symbol_name", ws.class_name},
+                    {"filepath", ws.single_file.string()},
+                    {"search_paths", json::array({ws.root.string()})}};
+    });
+    return true;
+}();
+
+} // namespace
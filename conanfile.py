@@ -18,12 +18,14 @@ class CppTreesitterMcpConan(ConanFile):
     options = {
         "shared": [True, False],
         "build_tests": [True, False],
-        "build_sse": [True, False]
+        "build_sse": [True, False],
+        "build_benchmarks": [True, False]
     }
     default_options = {
         "shared": False,
         "build_tests": True,
-        "build_sse": True
+        "build_sse": True,
+        "build_benchmarks": False
     }
 
     # Build requirements
@@ -39,6 +41,9 @@ class CppTreesitterMcpConan(ConanFile):
         if self.options.build_tests:
             self.test_requires("gtest/1.14.0")
 
+        if self.options.build_benchmarks:
+            self.test_requires("benchmark/1.8.3")
+
     def layout(self):
         cmake_layout(self)
 
@@ -46,6 +51,7 @@ class CppTreesitterMcpConan(ConanFile):
         tc = CMakeToolchain(self)
         tc.variables["BUILD_TESTS"] = self.options.build_tests
         tc.variables["BUILD_SSE_SERVER"] = self.options.build_sse
+        tc.variables["BUILD_BENCHMARKS"] = self.options.build_benchmarks
         tc.generate()
 
         deps = CMakeDeps(self)
@@ -1,31 +1,687 @@
 #include "core/ASTAnalyzer.hpp"
 #include "core/Language.hpp"
+#include "core/LexicalScanner.hpp"
+#include "core/Metrics.hpp"
+#include "core/PathResolver.hpp"
+#include "core/RequestProfile.hpp"
+#include "core/Trace.hpp"
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <fstream>
+#include <set>
 #include <sstream>
 
 namespace ts_mcp {
 
+namespace {
+
+TSPoint point_at(std::string_view text, size_t byte) {
+    std::string_view before = text.substr(0, byte);
+    size_t line_start = before.rfind('\n');
+    line_start = line_start == std::string_view::npos ? 0 : line_start + 1;
+    return {static_cast<uint32_t>(std::count(before.begin(), before.end(), '\n')),
+            static_cast<uint32_t>(byte - line_start)};
+}
+
+/**
+ * @brief The span where two versions of a source differ, as one edit
+ */
+TSInputEdit single_edit(std::string_view old_source, std::string_view new_source) {
+    size_t shorter = std::min(old_source.size(), new_source.size());
+    size_t prefix = 0;
+    while (prefix < shorter && old_source[prefix] == new_source[prefix]) {
+        prefix++;
+    }
+    size_t suffix = 0;
+    while (suffix < shorter - prefix &&
+           old_source[old_source.size() - 1 - suffix] == new_source[new_source.size() - 1 - suffix]) {
+        suffix++;
+    }
+
+    TSInputEdit edit;
+    edit.start_byte = static_cast<uint32_t>(prefix);
+    edit.old_end_byte = static_cast<uint32_t>(old_source.size() - suffix);
+    edit.new_end_byte = static_cast<uint32_t>(new_source.size() - suffix);
+    edit.start_point = point_at(new_source, edit.start_byte);
+    edit.old_end_point = point_at(old_source, edit.old_end_byte);
+    edit.new_end_point = point_at(new_source, edit.new_end_byte);
+    return edit;
+}
+
+bool is_comment(TSNode node) {
+    return std::string_view(ts_node_type(node)) == "comment";
+}
+
+/**
+ * @brief Definition units under a node (see ASTAnalyzer::definition_facts())
+ */
+void collect_units(TSNode node, std::vector<TSNode>& units) {
+    static const std::set<std::string_view> containers = {
+        "namespace_definition", "linkage_specification",          // C++
+        "class_specifier", "struct_specifier", "union_specifier",
+        "class_definition"                                         // Python
+    };
+
+    uint32_t count = ts_node_named_child_count(node);
+    for (uint32_t i = 0; i < count; ++i) {
+        TSNode child = ts_node_named_child(node, i);
+        if (is_comment(child)) {
+            continue;  // Part of the next unit
+        }
+        TSNode body = ts_node_child_by_field_name(child, "body", 4);
+        if (containers.count(ts_node_type(child)) && !ts_node_is_null(body)) {
+            collect_units(body, units);
+        } else {
+            units.push_back(child);
+        }
+    }
+}
+
+/**
+ * @brief Start of a unit including the comments directly before it
+ */
+uint32_t unit_start(TSNode unit) {
+    TSNode first = unit;
+    for (TSNode prev = ts_node_prev_named_sibling(first); !ts_node_is_null(prev) && is_comment(prev);
+         prev = ts_node_prev_named_sibling(prev)) {
+        first = prev;
+    }
+    return ts_node_start_byte(first);
+}
+
+/**
+ * @brief Hot tier bytes of a document: its source plus accounted tree memory
+ */
+int64_t document_bytes(const ParsedDocument& document) {
+    return static_cast<int64_t>(document.source.capacity()) + document.memory.bytes();
+}
+
+void shift_lines(json& facts, int64_t rows) {
+    if (facts.is_object()) {
+        for (auto& [key, value] : facts.items()) {
+            if (key == "line" && value.is_number_integer()) {
+                value = value.get<int64_t>() + rows;
+            } else {
+                shift_lines(value, rows);
+            }
+        }
+    } else if (facts.is_array()) {
+        for (auto& item : facts) {
+            shift_lines(item, rows);
+        }
+    }
+}
+
+} // namespace
+
 ASTAnalyzer::ASTAnalyzer()
-    : parsers_(), query_engine_(), cache_() {
+    : query_engine_(), cache_() {
     spdlog::debug("ASTAnalyzer created");
 }
 
-TreeSitterParser& ASTAnalyzer::get_parser_for_language(Language lang) {
-    auto it = parsers_.find(lang);
-    if (it != parsers_.end()) {
-        return it->second;
+ASTAnalyzer::~ASTAnalyzer() {
+    if (watcher_) {
+        watcher_->stop();
+    }
+}
+
+void ASTAnalyzer::attach_watcher(std::shared_ptr<FileWatcher> watcher) {
+    watcher->add_listener([this](const ChangeBatch& batch) {
+        on_files_changed(batch);
+    });
+    watcher_ = std::move(watcher);
+}
+
+void ASTAnalyzer::set_fact_cache(std::shared_ptr<FactCache> cache) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    fact_cache_ = std::move(cache);
+}
+
+void ASTAnalyzer::set_cache_limits(const CacheLimits& limits) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    limits_ = limits;
+}
+
+json ASTAnalyzer::cached_facts(const std::filesystem::path& filepath,
+                               std::string_view kind,
+                               const std::function<json()>& compute,
+                               bool persistent) {
+    ShardContext* shard = ShardContext::current();
+    if (shard && !shard->is_worker()) {
+        if (const json* facts = shard->lookup(filepath, kind)) {
+            return *facts;
+        }
+    }
+
+    json facts = persistent ? persisted_facts(filepath, kind, compute) : compute();
+    if (shard && shard->is_worker()) {
+        shard->capture(filepath, kind, facts);
+    }
+    return facts;
+}
+
+json ASTAnalyzer::persisted_facts(const std::filesystem::path& filepath,
+                                  std::string_view kind,
+                                  const std::function<json()>& compute) {
+    sync_watcher();
+    if (auto facts = warm_facts(filepath, kind)) {
+        CoreMetrics::get().warm_fact_hits.add();
+        return std::move(*facts);
+    }
+
+    std::shared_ptr<FactCache> fact_cache;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        fact_cache = fact_cache_;
+    }
+
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(filepath, ec);
+    auto size = std::filesystem::file_size(filepath, ec);
+    if (ec) {
+        return compute();  // Unreadable: let compute report it
+    }
+
+    std::optional<ObjectId> content_id;
+    if (fact_cache) {
+        content_id = current_content_id(filepath);
+        if (!content_id) {
+            return compute();
+        }
+        if (auto facts = fact_cache->get(filepath, kind, *content_id)) {
+            keep_facts(filepath, kind, *content_id, mtime, size, *facts);
+            return std::move(*facts);
+        }
+    }
+
+    json facts = compute();
+    // Degraded (lexical-only) facts depend on the parse limits, not just the content
+    bool failed = facts.is_null() ||
+                  (facts.is_object() && (facts.contains("error") || !facts.value("success", true) ||
+                                         facts.value("degraded", false)));
+    if (failed) {
+        return facts;
+    }
+
+    // Usually just a stat: compute has parsed the file into the hot tier
+    auto computed_id = current_content_id(filepath);
+    bool changed = !computed_id || (content_id && *computed_id != *content_id) ||
+                   std::filesystem::last_write_time(filepath, ec) != mtime ||
+                   std::filesystem::file_size(filepath, ec) != size || ec;
+    if (!changed) {
+        if (fact_cache) {
+            fact_cache->put(filepath, kind, *computed_id, facts);
+        }
+        keep_facts(filepath, kind, *computed_id, mtime, size, facts);
+    }
+    return facts;
+}
+
+std::optional<json> ASTAnalyzer::warm_facts(const std::filesystem::path& filepath, std::string_view kind) {
+    std::optional<ObjectId> content_id;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex_);
+            auto it = facts_.find(filepath);
+            if (it == facts_.end()) {
+                return std::nullopt;
+            }
+            FactRecord& record = it->second;
+            auto kind_it = record.facts.find(kind);
+            if (kind_it == record.facts.end()) {
+                return std::nullopt;
+            }
+
+            bool valid = record.watched && watcher_ && watcher_->healthy();
+            if (!valid) {
+                std::error_code ec;
+                auto mtime = std::filesystem::last_write_time(filepath, ec);
+                auto size = std::filesystem::file_size(filepath, ec);
+                if (ec) {
+                    drop_facts_locked(it);
+                    return std::nullopt;
+                }
+                if (size != record.size) {
+                    drop_facts_locked(it);
+                    return std::nullopt;
+                }
+                if (mtime == record.mtime) {
+                    valid = true;
+                } else if (content_id) {
+                    // Touched but unmodified: the facts still hold
+                    if (*content_id != record.content_id) {
+                        drop_facts_locked(it);
+                        return std::nullopt;
+                    }
+                    record.mtime = mtime;
+                    valid = true;
+                }
+            }
+            if (valid) {
+                record.last_used = ++use_clock_;
+                return json::from_cbor(kind_it->second);
+            }
+        }
+
+        // The mtime changed: compare content (may hash the file, so without the lock)
+        content_id = current_content_id(filepath);
+        if (!content_id) {
+            return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+void ASTAnalyzer::keep_facts(const std::filesystem::path& filepath,
+                             std::string_view kind,
+                             const ObjectId& content_id,
+                             std::filesystem::file_time_type mtime,
+                             uintmax_t size,
+                             const json& facts) {
+    std::vector<uint8_t> encoded = json::to_cbor(facts);
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    FactRecord& record = facts_[filepath];
+    if (record.content_id != content_id) {
+        fact_bytes_ -= record.bytes;
+        record.facts.clear();
+        record.bytes = 0;
+        record.content_id = content_id;
+    }
+    record.mtime = mtime;
+    record.size = size;
+    record.watched = is_watched(filepath);
+    record.last_used = ++use_clock_;
+
+    auto [it, inserted] = record.facts.try_emplace(std::string(kind));
+    record.bytes -= it->second.size();
+    fact_bytes_ -= it->second.size();
+    it->second = std::move(encoded);
+    record.bytes += it->second.size();
+    fact_bytes_ += it->second.size();
+
+    evict_facts_locked();
+}
+
+void ASTAnalyzer::drop_facts_locked(std::map<std::filesystem::path, FactRecord>::iterator it) {
+    fact_bytes_ -= it->second.bytes;
+    facts_.erase(it);
+}
+
+int64_t ASTAnalyzer::tree_bytes_locked() const {
+    int64_t bytes = 0;
+    for (const auto& [key, document] : documents_) {
+        bytes += document_bytes(*document);
+    }
+    return bytes;
+}
+
+void ASTAnalyzer::evict_trees_locked(const std::filesystem::path& keep) {
+    int64_t bytes = tree_bytes_locked();
+
+    // Limits count documents: paths sharing one cost next to nothing
+    const ParsedDocument* kept = cache_.at(keep).document.get();
+    while (documents_.size() > 1 &&
+           (documents_.size() > limits_.max_trees || bytes > static_cast<int64_t>(limits_.max_tree_bytes))) {
+        auto victim = cache_.end();
+        for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+            if (it->second.document.get() != kept &&
+                (victim == cache_.end() || it->second.last_used < victim->second.last_used)) {
+                victim = it;
+            }
+        }
+        // The facts of evicted files stay in the warm tier
+        const ParsedDocument& document = *victim->second.document;
+        if (document.refs == 1) {
+            bytes -= document_bytes(document);
+        }
+        spdlog::debug("Evicting parse of {}", victim->first.string());
+        release_locked(victim->second);
+        definitions_.erase(victim->first);
+        cache_.erase(victim);
+        CoreMetrics::get().cache_evictions.add();
+    }
+}
+
+void ASTAnalyzer::evict_facts_locked() {
+    if (fact_bytes_ <= limits_.max_fact_bytes) {
+        return;
+    }
+
+    // Evict in a batch down to 90% of the limit, so a full tier doesn't sort on every insertion
+    std::vector<std::pair<uint64_t, std::map<std::filesystem::path, FactRecord>::iterator>> by_age;
+    by_age.reserve(facts_.size());
+    for (auto it = facts_.begin(); it != facts_.end(); ++it) {
+        by_age.emplace_back(it->second.last_used, it);
+    }
+    std::sort(by_age.begin(), by_age.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    size_t target = limits_.max_fact_bytes / 10 * 9;
+    size_t evicted = 0;
+    for (auto& [last_used, it] : by_age) {
+        if (fact_bytes_ <= target || facts_.size() == 1) {
+            break;
+        }
+        drop_facts_locked(it);
+        evicted++;
+    }
+    CoreMetrics::get().warm_fact_evictions.add(evicted);
+    spdlog::debug("Evicted facts of {} files ({} bytes kept)", evicted, fact_bytes_);
+}
+
+std::optional<ObjectId> ASTAnalyzer::current_content_id(const std::filesystem::path& filepath) {
+    sync_watcher();
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        auto it = cache_.find(filepath);
+        if (it != cache_.end()) {
+            bool trusted = it->second.watched && watcher_ && watcher_->healthy();
+            if (trusted || is_cache_valid(filepath, it->second, it->second.language)) {
+                return it->second.content_id;
+            }
+        }
+    }
+
+    if (auto indexed = PathResolver::indexed_blob_id(filepath)) {
+        return indexed;
     }
 
-    // Create new parser for this language
-    spdlog::debug("Creating parser for language: {}", LanguageUtils::to_string(lang));
-    auto [new_it, inserted] = parsers_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(lang),
-        std::forward_as_tuple(lang)
-    );
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string source = buffer.str();
+    CoreMetrics::get().bytes_read.add(source.size());
 
-    return new_it->second;
+    TraceSpan hash_span("content_hash");
+    return ContentHash::git_blob_id(source);
+}
+
+void ASTAnalyzer::sync_watcher() {
+    if (watcher_ && watcher_->healthy()) {
+        watcher_->sync();
+    }
+}
+
+bool ASTAnalyzer::is_watched(const std::filesystem::path& filepath) const {
+    if (!watcher_ || !watcher_->healthy() || !filepath.is_absolute()) {
+        return false;
+    }
+    // A symlink's target may live in a directory nobody watches
+    std::error_code ec;
+    if (std::filesystem::is_symlink(filepath, ec)) {
+        return false;
+    }
+    return watcher_->is_watching(filepath.parent_path());
+}
+
+void ASTAnalyzer::on_files_changed(const ChangeBatch& batch) {
+    struct Changed {
+        std::filesystem::path path;
+        ObjectId content_id;
+        Language language;
+    };
+    std::vector<Changed> changed_files;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+        if (batch.overflow) {
+            // Events were lost: fall back to mtime checks for every entry
+            for (auto& [path, cached] : cache_) {
+                cached.watched = false;
+            }
+            for (auto& [path, record] : facts_) {
+                record.watched = false;
+            }
+            return;
+        }
+
+        std::set<std::string> changed;
+        for (const auto& path : batch.paths) {
+            changed.insert(path.string());
+        }
+
+        // Removed or renamed directories are reported once for the whole subtree
+        auto is_changed = [&](const std::filesystem::path& path) {
+            bool hit = changed.count(path.string()) > 0;
+            for (auto dir = path.parent_path(); !hit && dir.has_relative_path(); dir = dir.parent_path()) {
+                hit = changed.count(dir.string()) > 0;
+            }
+            return hit;
+        };
+
+        // Facts are re-derived on demand
+        for (auto it = facts_.begin(); it != facts_.end();) {
+            auto next = std::next(it);
+            if (is_changed(it->first)) {
+                drop_facts_locked(it);
+            }
+            it = next;
+        }
+
+        // Until re-parsed, lookups check these files themselves rather than trust them
+        for (auto& [path, cached] : cache_) {
+            if (is_changed(path)) {
+                cached.watched = false;
+                changed_files.push_back({path, cached.content_id, cached.language});
+            }
+        }
+    }
+
+    // Re-parsed one at a time without the lock: requests keep looking files up meanwhile
+    size_t reparsed = 0;
+    size_t dropped = 0;
+    for (const auto& file : changed_files) {
+        if (reparse_cached(file.path, file.content_id, file.language)) {
+            reparsed++;
+        } else {
+            dropped++;
+        }
+    }
+
+    if (reparsed > 0 || dropped > 0) {
+        spdlog::debug("File changes: re-parsed {}, dropped {} cached files", reparsed, dropped);
+    }
+}
+
+bool ASTAnalyzer::reparse_cached(const std::filesystem::path& filepath, const ObjectId& content_id, Language lang) {
+    // The entry, if nothing replaced it since the change was reported
+    auto current = [&]() -> CachedFile* {
+        auto it = cache_.find(filepath);
+        bool same = it != cache_.end() && it->second.content_id == content_id && it->second.language == lang;
+        return same ? &it->second : nullptr;
+    };
+    auto drop = [&] {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (CachedFile* cached = current()) {
+            release_locked(*cached);
+            cache_.erase(filepath);
+            definitions_.erase(filepath);
+            CoreMetrics::get().cache_evictions.add();
+        }
+        return false;
+    };
+
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(filepath, ec);
+    if (ec) {
+        return drop();
+    }
+
+    std::ifstream file(filepath);
+    if (!file) {
+        return drop();
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string source = buffer.str();
+    CoreMetrics::get().bytes_read.add(source.size());
+    ObjectId new_id = content_id_of(filepath, source);
+
+    // Parse unless the content is unchanged (rewritten identically) or parsed for another path
+    std::shared_ptr<ParsedDocument> document;
+    std::shared_ptr<const ParsedDocument> previous;
+    bool known;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        known = new_id == content_id || documents_.count({new_id, lang}) > 0;
+        if (CachedFile* cached = current()) {
+            previous = cached->document;
+        }
+    }
+    if (!known) {
+        CoreMetrics::get().cache_misses.add();
+        TreeSitterParser parser(lang);
+        document = parse_document(filepath, parser, std::move(source), previous.get(), content_id);
+        if (!document) {
+            return drop();
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    CachedFile* cached = current();
+    if (!cached) {
+        return true;  // Replaced meanwhile by a request that read the file itself
+    }
+    if (new_id != content_id) {
+        // Other paths may share the old document: switch this one to the new content.
+        // Snapshots of the old document stay valid until their requests finish.
+        auto document_it = documents_.find({new_id, lang});
+        if (document_it != documents_.end()) {
+            document = document_it->second;
+            CoreMetrics::get().documents_shared.add();
+        } else if (!document) {
+            return drop();  // Shared document evicted meanwhile: parsed again on next use
+        } else {
+            documents_.emplace(std::make_pair(new_id, lang), document);
+        }
+        attach_locked(*cached, std::move(document));
+        cached->content_id = new_id;
+    }
+
+    cached->mtime = mtime;
+    cached->watched = is_watched(filepath);
+    return true;
+}
+
+ObjectId ASTAnalyzer::content_id_of(const std::filesystem::path& filepath, std::string_view source) {
+    if (auto indexed = PathResolver::indexed_blob_id(filepath)) {
+        return *indexed;
+    }
+    return ContentHash::git_blob_id(source);
+}
+
+size_t ASTAnalyzer::cache_size() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return cache_.size();
+}
+
+bool ASTAnalyzer::has_tree(const std::filesystem::path& filepath) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto it = cache_.find(filepath);
+    return it != cache_.end() && it->second.document;
+}
+
+bool ASTAnalyzer::release_transient(const std::filesystem::path& filepath) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto it = cache_.find(filepath);
+    if (it == cache_.end() || !it->second.transient) {
+        return false;
+    }
+    release_locked(it->second);
+    definitions_.erase(filepath);
+    cache_.erase(it);
+    return true;
+}
+
+size_t ASTAnalyzer::tree_bytes() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return static_cast<size_t>(tree_bytes_locked());
+}
+
+CacheLimits ASTAnalyzer::cache_limits() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return limits_;
+}
+
+bool ASTAnalyzer::fact_tier_full() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return fact_bytes_ >= limits_.max_fact_bytes / 10 * 9;
+}
+
+size_t ASTAnalyzer::document_count() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return documents_.size();
+}
+
+size_t ASTAnalyzer::fact_record_count() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return facts_.size();
+}
+
+json ASTAnalyzer::memory_usage(size_t top_n) const {
+    struct DocumentUsage {
+        const std::filesystem::path* path;  // One of the paths sharing it
+        Language language;
+        size_t paths;
+        size_t source_bytes;
+        int64_t tree_bytes;
+    };
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+    std::map<const ParsedDocument*, const std::filesystem::path*> first_path;
+    for (const auto& [path, cached] : cache_) {
+        first_path.emplace(cached.document.get(), &path);
+    }
+
+    std::vector<DocumentUsage> documents;
+    documents.reserve(documents_.size());
+    size_t source_bytes = 0;
+    int64_t tree_bytes = 0;
+    for (const auto& [key, document] : documents_) {
+        DocumentUsage usage{first_path.at(document.get()), key.second, document->refs,
+                            document->source.capacity(), document->memory.bytes()};
+        source_bytes += usage.source_bytes;
+        tree_bytes += usage.tree_bytes;
+        documents.push_back(usage);
+    }
+
+    auto total = [](const DocumentUsage& usage) {
+        return static_cast<int64_t>(usage.source_bytes) + usage.tree_bytes;
+    };
+    size_t listed = std::min(top_n, documents.size());
+    std::partial_sort(documents.begin(), documents.begin() + static_cast<std::ptrdiff_t>(listed), documents.end(),
+                      [&](const DocumentUsage& a, const DocumentUsage& b) { return total(a) > total(b); });
+
+    json top_files = json::array();
+    for (size_t i = 0; i < listed; ++i) {
+        json entry = {
+            {"path", documents[i].path->string()},
+            {"language", std::string(LanguageUtils::to_string(documents[i].language))},
+            {"source_bytes", documents[i].source_bytes},
+            {"tree_bytes", documents[i].tree_bytes},
+            {"total_bytes", total(documents[i])}
+        };
+        if (documents[i].paths > 1) {
+            entry["shared_by"] = documents[i].paths;
+        }
+        top_files.push_back(entry);
+    }
+
+    return {
+        {"documents", cache_.size()},
+        {"unique_documents", documents_.size()},
+        {"source_bytes", source_bytes},
+        {"tree_bytes", tree_bytes},
+        {"fact_files", facts_.size()},
+        {"fact_bytes", fact_bytes_},
+        {"top_files", top_files}
+    };
 }
 
 Language ASTAnalyzer::detect_language(const std::filesystem::path& filepath,
@@ -44,6 +700,13 @@ Language ASTAnalyzer::detect_language(const std::filesystem::path& filepath,
 }
 
 json ASTAnalyzer::analyze_file(const std::filesystem::path& filepath, std::optional<Language> lang) {
+    std::string kind = "analysis/" + std::string(LanguageUtils::to_string(detect_language(filepath, lang)));
+    json result = cached_facts(filepath, kind, [&] { return analyze_file_uncached(filepath, lang); });
+    result["filepath"] = filepath.string();  // Stored under the absolute path
+    return result;
+}
+
+json ASTAnalyzer::analyze_file_uncached(const std::filesystem::path& filepath, std::optional<Language> lang) {
     json result = {
         {"filepath", filepath.string()},
         {"success", false}
@@ -52,25 +715,29 @@ json ASTAnalyzer::analyze_file(const std::filesystem::path& filepath, std::optio
     Language detected_lang = detect_language(filepath, lang);
     result["language"] = std::string(LanguageUtils::to_string(detected_lang));
 
-    auto file_data = get_or_parse_file(filepath, detected_lang);
-    if (!file_data) {
+    auto file = snapshot(filepath, detected_lang);
+    if (!file) {
+        if (auto degraded = degraded_result(filepath, detected_lang, "analysis")) {
+            return *degraded;
+        }
         result["error"] = "Failed to parse file";
         return result;
     }
 
-    const Tree* tree = std::get<0>(*file_data);
-    std::string_view source = std::get<1>(*file_data);
-    Language actual_lang = std::get<2>(*file_data);
+    // Queries run on the snapshot without the lock
+    const Tree& tree = file->tree();
+    std::string_view source = file->source();
+    Language actual_lang = file->language();
 
     result["success"] = true;
-    result["has_errors"] = tree->has_error();
+    result["has_errors"] = tree.has_error();
 
     // Count classes
     auto class_query_str = QueryEngine::get_predefined_query(QueryType::CLASSES, actual_lang);
     if (class_query_str) {
         auto class_query = query_engine_.compile_query(*class_query_str, actual_lang);
         if (class_query) {
-            auto class_matches = query_engine_.execute(*tree, *class_query, source);
+            auto class_matches = query_engine_.execute(tree, *class_query, source);
             result["class_count"] = class_matches.size();
         } else {
             result["class_count"] = 0;
@@ -84,7 +751,7 @@ json ASTAnalyzer::analyze_file(const std::filesystem::path& filepath, std::optio
     if (func_query_str) {
         auto func_query = query_engine_.compile_query(*func_query_str, actual_lang);
         if (func_query) {
-            auto func_matches = query_engine_.execute(*tree, *func_query, source);
+            auto func_matches = query_engine_.execute(tree, *func_query, source);
             result["function_count"] = func_matches.size();
         } else {
             result["function_count"] = 0;
@@ -98,7 +765,7 @@ json ASTAnalyzer::analyze_file(const std::filesystem::path& filepath, std::optio
     if (include_query_str) {
         auto include_query = query_engine_.compile_query(*include_query_str, actual_lang);
         if (include_query) {
-            auto include_matches = query_engine_.execute(*tree, *include_query, source);
+            auto include_matches = query_engine_.execute(tree, *include_query, source);
             result["include_count"] = include_matches.size();
         } else {
             result["include_count"] = 0;
@@ -117,6 +784,13 @@ json ASTAnalyzer::analyze_file(const std::filesystem::path& filepath, std::optio
 }
 
 json ASTAnalyzer::find_classes(const std::filesystem::path& filepath, std::optional<Language> lang) {
+    std::string kind = "classes/" + std::string(LanguageUtils::to_string(detect_language(filepath, lang)));
+    json result = cached_facts(filepath, kind, [&] { return find_classes_uncached(filepath, lang); });
+    result["filepath"] = filepath.string();  // Stored under the absolute path
+    return result;
+}
+
+json ASTAnalyzer::find_classes_uncached(const std::filesystem::path& filepath, std::optional<Language> lang) {
     json result = {
         {"filepath", filepath.string()},
         {"success", false}
@@ -125,15 +799,19 @@ json ASTAnalyzer::find_classes(const std::filesystem::path& filepath, std::optio
     Language detected_lang = detect_language(filepath, lang);
     result["language"] = std::string(LanguageUtils::to_string(detected_lang));
 
-    auto file_data = get_or_parse_file(filepath, detected_lang);
-    if (!file_data) {
+    auto file = snapshot(filepath, detected_lang);
+    if (!file) {
+        if (auto degraded = degraded_result(filepath, detected_lang, "classes")) {
+            return *degraded;
+        }
         result["error"] = "Failed to parse file";
         return result;
     }
 
-    const Tree* tree = std::get<0>(*file_data);
-    std::string_view source = std::get<1>(*file_data);
-    Language actual_lang = std::get<2>(*file_data);
+    // Queries run on the snapshot without the lock
+    const Tree& tree = file->tree();
+    std::string_view source = file->source();
+    Language actual_lang = file->language();
 
     auto query_str = QueryEngine::get_predefined_query(QueryType::CLASSES, actual_lang);
     if (!query_str) {
@@ -147,7 +825,7 @@ json ASTAnalyzer::find_classes(const std::filesystem::path& filepath, std::optio
         return result;
     }
 
-    auto matches = query_engine_.execute(*tree, *query, source);
+    auto matches = query_engine_.execute(tree, *query, source);
 
     result["success"] = true;
     result["classes"] = matches_to_json(matches);
@@ -156,6 +834,13 @@ json ASTAnalyzer::find_classes(const std::filesystem::path& filepath, std::optio
 }
 
 json ASTAnalyzer::find_functions(const std::filesystem::path& filepath, std::optional<Language> lang) {
+    std::string kind = "functions/" + std::string(LanguageUtils::to_string(detect_language(filepath, lang)));
+    json result = cached_facts(filepath, kind, [&] { return find_functions_uncached(filepath, lang); });
+    result["filepath"] = filepath.string();  // Stored under the absolute path
+    return result;
+}
+
+json ASTAnalyzer::find_functions_uncached(const std::filesystem::path& filepath, std::optional<Language> lang) {
     json result = {
         {"filepath", filepath.string()},
         {"success", false}
@@ -164,15 +849,19 @@ json ASTAnalyzer::find_functions(const std::filesystem::path& filepath, std::opt
     Language detected_lang = detect_language(filepath, lang);
     result["language"] = std::string(LanguageUtils::to_string(detected_lang));
 
-    auto file_data = get_or_parse_file(filepath, detected_lang);
-    if (!file_data) {
+    auto file = snapshot(filepath, detected_lang);
+    if (!file) {
+        if (auto degraded = degraded_result(filepath, detected_lang, "functions")) {
+            return *degraded;
+        }
         result["error"] = "Failed to parse file";
         return result;
     }
 
-    const Tree* tree = std::get<0>(*file_data);
-    std::string_view source = std::get<1>(*file_data);
-    Language actual_lang = std::get<2>(*file_data);
+    // Queries run on the snapshot without the lock
+    const Tree& tree = file->tree();
+    std::string_view source = file->source();
+    Language actual_lang = file->language();
 
     auto query_str = QueryEngine::get_predefined_query(QueryType::FUNCTIONS, actual_lang);
     if (!query_str) {
@@ -186,7 +875,7 @@ json ASTAnalyzer::find_functions(const std::filesystem::path& filepath, std::opt
         return result;
     }
 
-    auto matches = query_engine_.execute(*tree, *query, source);
+    auto matches = query_engine_.execute(tree, *query, source);
 
     result["success"] = true;
     result["functions"] = matches_to_json(matches);
@@ -195,6 +884,13 @@ json ASTAnalyzer::find_functions(const std::filesystem::path& filepath, std::opt
 }
 
 json ASTAnalyzer::find_includes(const std::filesystem::path& filepath, std::optional<Language> lang) {
+    std::string kind = "includes/" + std::string(LanguageUtils::to_string(detect_language(filepath, lang)));
+    json result = cached_facts(filepath, kind, [&] { return find_includes_uncached(filepath, lang); });
+    result["filepath"] = filepath.string();  // Stored under the absolute path
+    return result;
+}
+
+json ASTAnalyzer::find_includes_uncached(const std::filesystem::path& filepath, std::optional<Language> lang) {
     json result = {
         {"filepath", filepath.string()},
         {"success", false}
@@ -203,15 +899,19 @@ json ASTAnalyzer::find_includes(const std::filesystem::path& filepath, std::opti
     Language detected_lang = detect_language(filepath, lang);
     result["language"] = std::string(LanguageUtils::to_string(detected_lang));
 
-    auto file_data = get_or_parse_file(filepath, detected_lang);
-    if (!file_data) {
+    auto file = snapshot(filepath, detected_lang);
+    if (!file) {
+        if (auto degraded = degraded_result(filepath, detected_lang, "includes")) {
+            return *degraded;
+        }
         result["error"] = "Failed to parse file";
         return result;
     }
 
-    const Tree* tree = std::get<0>(*file_data);
-    std::string_view source = std::get<1>(*file_data);
-    Language actual_lang = std::get<2>(*file_data);
+    // Queries run on the snapshot without the lock
+    const Tree& tree = file->tree();
+    std::string_view source = file->source();
+    Language actual_lang = file->language();
 
     auto query_str = QueryEngine::get_predefined_query(QueryType::INCLUDES, actual_lang);
     if (!query_str) {
@@ -225,7 +925,7 @@ json ASTAnalyzer::find_includes(const std::filesystem::path& filepath, std::opti
         return result;
     }
 
-    auto matches = query_engine_.execute(*tree, *query, source);
+    auto matches = query_engine_.execute(tree, *query, source);
 
     result["success"] = true;
     result["includes"] = matches_to_json(matches);
@@ -244,15 +944,19 @@ json ASTAnalyzer::execute_query(const std::filesystem::path& filepath,
     Language detected_lang = detect_language(filepath, lang);
     result["language"] = std::string(LanguageUtils::to_string(detected_lang));
 
-    auto file_data = get_or_parse_file(filepath, detected_lang);
-    if (!file_data) {
+    auto file = snapshot(filepath, detected_lang);
+    if (!file) {
+        if (auto degraded = degraded_result(filepath, detected_lang, "query")) {
+            return *degraded;
+        }
         result["error"] = "Failed to parse file";
         return result;
     }
 
-    const Tree* tree = std::get<0>(*file_data);
-    std::string_view source = std::get<1>(*file_data);
-    Language actual_lang = std::get<2>(*file_data);
+    // Queries run on the snapshot without the lock
+    const Tree& tree = file->tree();
+    std::string_view source = file->source();
+    Language actual_lang = file->language();
 
     auto query = query_engine_.compile_query(query_string, actual_lang);
     if (!query) {
@@ -260,7 +964,7 @@ json ASTAnalyzer::execute_query(const std::filesystem::path& filepath,
         return result;
     }
 
-    auto matches = query_engine_.execute(*tree, *query, source);
+    auto matches = query_engine_.execute(tree, *query, source);
 
     result["success"] = true;
     result["matches"] = matches_to_json(matches);
@@ -268,6 +972,116 @@ json ASTAnalyzer::execute_query(const std::filesystem::path& filepath,
     return result;
 }
 
+std::optional<DocumentSnapshot> ASTAnalyzer::snapshot(const std::filesystem::path& filepath,
+                                                      std::optional<Language> lang) {
+    Language detected_lang = detect_language(filepath, lang);
+    sync_watcher();
+    return get_or_parse_file(filepath, detected_lang);
+}
+
+std::optional<DegradeReason> ASTAnalyzer::degrade_reason(const std::filesystem::path& filepath) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto it = degraded_.find(filepath);
+    if (it == degraded_.end()) {
+        return std::nullopt;
+    }
+    return it->second.reason;
+}
+
+json ASTAnalyzer::definition_facts(const DocumentSnapshot& snapshot,
+                                   const std::filesystem::path& filepath,
+                                   std::string_view kind,
+                                   const std::function<json(TSNode unit, std::string_view source)>& compute) {
+    // Taken out while computing; a concurrent call for the file computes everything
+    std::optional<DefinitionRecord> old;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        auto path_it = definitions_.find(filepath);
+        if (path_it != definitions_.end()) {
+            auto kind_it = path_it->second.find(kind);
+            if (kind_it != path_it->second.end()) {
+                old = std::move(kind_it->second);
+                path_it->second.erase(kind_it);
+            }
+        }
+    }
+
+    // Old facts apply as they are to unchanged content, or across the edit to the new content
+    const DocumentDelta* delta = snapshot.delta();
+    bool same = old && old->content_id == snapshot.content_id();
+    bool edited = old && !same && delta && old->content_id == delta->previous;
+
+    auto affected = [&](uint32_t start, uint32_t end) {
+        if (end > delta->edit.start_byte && start < delta->edit.new_end_byte) {
+            return true;
+        }
+        return std::any_of(delta->changed.begin(), delta->changed.end(), [&](const TSRange& range) {
+            return end > range.start_byte && start < range.end_byte;
+        });
+    };
+    auto find_old = [&](uint32_t start, uint32_t end) -> const UnitFacts* {
+        auto it = std::lower_bound(old->units.begin(), old->units.end(), start,
+                                   [](const UnitFacts& unit, uint32_t byte) { return unit.start_byte < byte; });
+        return it != old->units.end() && it->start_byte == start && it->end_byte == end ? &*it : nullptr;
+    };
+
+    std::vector<TSNode> units;
+    collect_units(snapshot.tree().root_node(), units);
+
+    DefinitionRecord record{snapshot.content_id(), {}};
+    record.units.reserve(units.size());
+    json result = json::array();
+    size_t reused = 0;
+    for (TSNode unit : units) {
+        uint32_t start = unit_start(unit);
+        uint32_t end = ts_node_end_byte(unit);
+
+        const UnitFacts* previous = nullptr;
+        int64_t rows = 0;
+        if (same) {
+            previous = find_old(start, end);
+        } else if (edited && !affected(start, end)) {
+            if (end <= delta->edit.start_byte) {
+                previous = find_old(start, end);
+            } else {
+                // After the edit: the same bytes, moved by its growth
+                uint32_t moved = delta->edit.old_end_byte - delta->edit.new_end_byte;
+                previous = find_old(start + moved, end + moved);
+                rows = static_cast<int64_t>(delta->edit.new_end_point.row) -
+                       static_cast<int64_t>(delta->edit.old_end_point.row);
+            }
+        }
+
+        json facts;
+        if (previous) {
+            facts = previous->facts;
+            if (rows != 0) {
+                shift_lines(facts, rows);
+            }
+            reused++;
+        } else {
+            facts = compute(unit, snapshot.source());
+        }
+        for (const auto& item : facts) {
+            result.push_back(item);
+        }
+        record.units.push_back({start, end, std::move(facts)});
+    }
+
+    CoreMetrics::get().definitions_reused.add(reused);
+    CoreMetrics::get().definitions_recomputed.add(units.size() - reused);
+    if (edited) {
+        spdlog::debug("{}: reused facts of {} of {} definitions after edit", filepath.string(), reused,
+                      units.size());
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (cache_.count(filepath)) {
+        definitions_[filepath][std::string(kind)] = std::move(record);
+    }
+    return result;
+}
+
 json ASTAnalyzer::analyze_files(const std::vector<std::filesystem::path>& filepaths) {
     json results = json::array();
     int total = filepaths.size();
@@ -404,14 +1218,40 @@ json ASTAnalyzer::execute_query_on_files(
 }
 
 void ASTAnalyzer::clear_cache() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    CoreMetrics::get().cache_evictions.add(cache_.size());
     cache_.clear();
+    documents_.clear();
+    facts_.clear();
+    fact_bytes_ = 0;
+    definitions_.clear();
+    degraded_.clear();
     spdlog::debug("Cache cleared");
 }
 
-std::optional<std::tuple<const Tree*, std::string_view, Language>> ASTAnalyzer::get_or_parse_file(
+std::optional<DocumentSnapshot> ASTAnalyzer::get_or_parse_file(
     const std::filesystem::path& filepath,
     Language lang
 ) {
+    auto hit = [&](CachedFile& cached) {
+        cached.last_used = ++use_clock_;
+        cached.transient = cached.transient && transient_;
+        CoreMetrics::get().cache_hits.add();
+        RequestProfile::add_cache_hit();
+        return DocumentSnapshot(cached.document, cached.content_id, cached.language);
+    };
+
+    // Files in watched directories stay valid until the watcher reports them
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        auto it = cache_.find(filepath);
+        if (it != cache_.end() && it->second.watched && it->second.language == lang && watcher_ &&
+            watcher_->healthy()) {
+            spdlog::trace("Using watched cached parse for {}", filepath.string());
+            return hit(it->second);
+        }
+    }
+
     // Check if file exists
     if (!std::filesystem::exists(filepath)) {
         spdlog::error("File does not exist: {}", filepath.string());
@@ -427,65 +1267,225 @@ std::optional<std::tuple<const Tree*, std::string_view, Language>> ASTAnalyzer::
         return std::nullopt;
     }
 
-    // Check cache
-    auto it = cache_.find(filepath);
-    if (it != cache_.end()) {
-        if (is_cache_valid(filepath, it->second, lang)) {
+    // Parsed incrementally from the path's previous document, if any
+    std::shared_ptr<const ParsedDocument> previous;
+    ObjectId previous_id;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+        // Refused by the parse guard and unchanged since: don't read it again
+        auto degraded_it = degraded_.find(filepath);
+        if (degraded_it != degraded_.end()) {
+            if (degraded_it->second.mtime == mtime) {
+                return std::nullopt;
+            }
+            degraded_.erase(degraded_it);
+        }
+
+        // Check cache
+        auto it = cache_.find(filepath);
+        if (it != cache_.end() && it->second.language == lang && it->second.mtime == mtime) {
             spdlog::debug("Using cached parse for {} ({})",
                          filepath.string(),
                          LanguageUtils::to_string(lang));
-            return std::make_tuple(it->second.tree.get(),
-                                  std::string_view(it->second.source),
-                                  it->second.language);
-        } else {
-            spdlog::debug("Cache invalid for {}, re-parsing", filepath.string());
-            cache_.erase(it);
+            return hit(it->second);
+        }
+
+        if (it != cache_.end() && it->second.language == lang) {
+            previous = it->second.document;
+            previous_id = it->second.content_id;
+        }
+    }
+
+    // Touched but unmodified tracked file, or a tracked copy of parsed
+    // content: the git index knows its content without reading it
+    std::optional<ObjectId> indexed_id = PathResolver::indexed_blob_id(filepath);
+    if (indexed_id) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (auto shared = share_locked(filepath, *indexed_id, lang, mtime)) {
+            return shared;
         }
     }
 
-    // Parse file
+    // Read, hash and parse without the lock: other files' lookups proceed meanwhile
     spdlog::debug("Parsing file: {} with language {}",
                  filepath.string(),
                  LanguageUtils::to_string(lang));
 
-    // Read file contents
-    std::ifstream file(filepath);
-    if (!file) {
-        spdlog::error("Failed to open file: {}", filepath.string());
-        return std::nullopt;
+    std::string source;
+    {
+        TraceSpan read_span("read_file", filepath.string());
+        std::ifstream file(filepath);
+        if (!file) {
+            spdlog::error("Failed to open file: {}", filepath.string());
+            return std::nullopt;
+        }
+
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        source = buffer.str();
     }
+    CoreMetrics::get().bytes_read.add(source.size());
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string source = buffer.str();
+    ObjectId content_id;
+    {
+        TraceSpan hash_span("content_hash");
+        content_id = indexed_id ? *indexed_id : ContentHash::git_blob_id(source);
+    }
 
-    // Get parser for this language
-    TreeSitterParser& parser = get_parser_for_language(lang);
+    if (!indexed_id) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (auto shared = share_locked(filepath, content_id, lang, mtime)) {
+            return shared;
+        }
+    }
 
-    // Parse
-    auto tree = parser.parse_string(source);
-    if (!tree) {
-        spdlog::error("Failed to parse file: {}", filepath.string());
+    CoreMetrics::get().cache_misses.add();
+    RequestProfile::add_parse();
+    TreeSitterParser parser(lang);
+    std::shared_ptr<ParsedDocument> document =
+        parse_document(filepath, parser, std::move(source), previous.get(), previous_id);
+
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!document) {
+        // A stale entry would outlive the content it was parsed from
+        auto stale = cache_.find(filepath);
+        if (stale != cache_.end() && stale->second.mtime != mtime) {
+            release_locked(stale->second);
+            definitions_.erase(filepath);
+            cache_.erase(stale);
+            CoreMetrics::get().cache_evictions.add();
+        }
+        if (parser.last_degraded() != DegradeReason::NONE) {
+            spdlog::info("{}: lexical analysis only ({})", filepath.string(),
+                         ParseGuard::to_string(parser.last_degraded()));
+            degraded_[filepath] = {parser.last_degraded(), mtime};
+        } else {
+            spdlog::error("Failed to parse file: {}", filepath.string());
+        }
         return std::nullopt;
     }
 
+    // Another thread may have cached the same content while this one parsed
+    if (auto shared = share_locked(filepath, content_id, lang, mtime)) {
+        return shared;
+    }
+    documents_.emplace(std::make_pair(content_id, lang), document);
+
     // Cache result
-    CachedFile cached;
-    cached.tree = std::move(tree);
-    cached.source = std::move(source);
+    auto [it, inserted] = cache_.try_emplace(filepath);
+    if (!inserted) {
+        spdlog::debug("Cache invalid for {}, re-parsed", filepath.string());
+        CoreMetrics::get().cache_evictions.add();
+    }
+    CachedFile& cached = it->second;
+    attach_locked(cached, std::move(document));
+    cached.transient = inserted ? transient_ : cached.transient && transient_;
     cached.mtime = mtime;
+    cached.content_id = content_id;
     cached.language = lang;
-
-    auto [cache_it, inserted] = cache_.emplace(filepath, std::move(cached));
+    cached.watched = is_watched(filepath);
+    cached.last_used = ++use_clock_;
+    evict_trees_locked(filepath);
 
     spdlog::debug("Cached parse for {} ({}, cache size: {})",
                  filepath.string(),
                  LanguageUtils::to_string(lang),
                  cache_.size());
 
-    return std::make_tuple(cache_it->second.tree.get(),
-                          std::string_view(cache_it->second.source),
-                          cache_it->second.language);
+    return DocumentSnapshot(cached.document, content_id, lang);
+}
+
+std::optional<DocumentSnapshot> ASTAnalyzer::share_locked(const std::filesystem::path& filepath,
+                                                          const ObjectId& content_id,
+                                                          Language lang,
+                                                          std::filesystem::file_time_type mtime) {
+    auto it = cache_.find(filepath);
+    if (it != cache_.end() && it->second.language == lang && it->second.content_id == content_id) {
+        spdlog::debug("Content of {} unchanged, keeping cached parse", filepath.string());
+        it->second.mtime = mtime;
+        it->second.watched = is_watched(filepath);
+    } else {
+        auto document_it = documents_.find({content_id, lang});
+        if (document_it == documents_.end()) {
+            return std::nullopt;
+        }
+        spdlog::debug("Content of {} already parsed, sharing it", filepath.string());
+        CoreMetrics::get().documents_shared.add();
+        if (it != cache_.end()) {
+            CoreMetrics::get().cache_evictions.add();
+        } else {
+            it = cache_.try_emplace(filepath).first;
+            it->second.transient = transient_;
+        }
+        CachedFile& cached = it->second;
+        attach_locked(cached, document_it->second);
+        cached.mtime = mtime;
+        cached.content_id = content_id;
+        cached.language = lang;
+        cached.watched = is_watched(filepath);
+        evict_trees_locked(filepath);  // Never evicts filepath itself
+    }
+
+    CachedFile& cached = it->second;
+    cached.last_used = ++use_clock_;
+    cached.transient = cached.transient && transient_;
+    CoreMetrics::get().cache_hits.add();
+    RequestProfile::add_cache_hit();
+    return DocumentSnapshot(cached.document, cached.content_id, cached.language);
+}
+
+std::shared_ptr<ParsedDocument> ASTAnalyzer::parse_document(const std::filesystem::path& filepath,
+                                                            TreeSitterParser& parser,
+                                                            std::string&& source,
+                                                            const ParsedDocument* previous,
+                                                            const ObjectId& previous_id) {
+    auto document = std::make_shared<ParsedDocument>();
+    std::unique_ptr<Tree> edited;  // Own handle of the previous tree: others may be reading it
+    TSInputEdit edit{};
+    {
+        TraceSpan parse_span("parse", filepath.string());
+        MemoryAccount::Scope memory_scope(document->memory);
+        if (previous) {
+            edit = single_edit(previous->source, source);
+            edited = std::make_unique<Tree>(previous->tree->copy());
+            document->tree = parser.parse_incremental(*edited, source, edit);
+        } else {
+            document->tree = parser.parse_string(source);
+        }
+    }
+    if (!document->tree) {
+        return nullptr;
+    }
+    if (edited) {
+        CoreMetrics::get().parses_incremental.add();
+        document->delta = DocumentDelta{previous_id, edit, document->tree->changed_ranges(*edited)};
+    }
+    document->source = std::move(source);
+    return document;
+}
+
+void ASTAnalyzer::attach_locked(CachedFile& cached, std::shared_ptr<ParsedDocument> document) {
+    if (cached.document == document) {
+        return;
+    }
+    release_locked(cached);
+    cached.document = std::move(document);
+    cached.document->refs++;
+}
+
+void ASTAnalyzer::release_locked(CachedFile& cached) {
+    if (!cached.document) {
+        return;
+    }
+    if (--cached.document->refs == 0) {
+        documents_.erase({cached.content_id, cached.language});
+        if (cached.document.use_count() > 1) {
+            // Requests still read it; freed with their last snapshot
+            CoreMetrics::get().documents_retired_in_use.add();
+        }
+    }
+    cached.document.reset();
 }
 
 bool ASTAnalyzer::is_cache_valid(const std::filesystem::path& filepath,
@@ -506,6 +1506,71 @@ bool ASTAnalyzer::is_cache_valid(const std::filesystem::path& filepath,
     }
 }
 
+std::optional<json> ASTAnalyzer::degraded_result(const std::filesystem::path& filepath,
+                                                 Language lang,
+                                                 std::string_view what) {
+    DegradeReason reason;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        auto it = degraded_.find(filepath);
+        if (it == degraded_.end()) {
+            return std::nullopt;
+        }
+        reason = it->second.reason;
+    }
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string source = buffer.str();
+    CoreMetrics::get().bytes_read.add(source.size());
+
+    auto metrics = LexicalScanner::line_metrics(source, lang);
+    json result = {
+        {"filepath", filepath.string()},
+        {"language", std::string(LanguageUtils::to_string(lang))},
+        {"success", true},
+        {"degraded", true},
+        {"degraded_reason", std::string(ParseGuard::to_string(reason))},
+        {"lines", metrics.lines},
+        {"bytes", metrics.bytes}
+    };
+
+    if (what == "query") {
+        result["success"] = false;
+        result["error"] = "File not parsed (" + std::string(ParseGuard::to_string(reason)) +
+                          "): queries need a syntax tree";
+        return result;
+    }
+
+    auto includes = LexicalScanner::includes(source, lang);
+    if (what == "analysis") {
+        result["has_errors"] = false;
+        result["class_count"] = 0;
+        result["function_count"] = 0;
+        result["include_count"] = includes.size();
+    } else if (what == "classes") {
+        result["classes"] = json::array();
+    } else if (what == "functions") {
+        result["functions"] = json::array();
+    } else if (what == "includes") {
+        json items = json::array();
+        for (const auto& include : includes) {
+            items.push_back({
+                {"capture_name", include.kind},
+                {"line", include.line},
+                {"column", include.column},
+                {"text", include.text}
+            });
+        }
+        result["includes"] = items;
+    }
+    return result;
+}
+
 json ASTAnalyzer::matches_to_json(const std::vector<QueryMatch>& matches) const {
     json result = json::array();
 
@@ -2,25 +2,117 @@
 
 #include "core/TreeSitterParser.hpp"
 #include "core/QueryEngine.hpp"
+#include "core/ContentHash.hpp"
+#include "core/FactCache.hpp"
+#include "core/ShardContext.hpp"
+#include "core/FileWatcher.hpp"
+#include "core/MemoryAccounting.hpp"
 #include <nlohmann/json.hpp>
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <optional>
+#include <utility>
+#include <vector>
 
 using json = nlohmann::json;
 
 namespace ts_mcp {
 
 /**
- * @brief Cached parse result for a file
+ * @brief How a document differs from the previous content of the path it was parsed for
  */
-struct CachedFile {
+struct DocumentDelta {
+    ObjectId previous;             // Content the edit applies to
+    TSInputEdit edit;              // The differing span, as one edit
+    std::vector<TSRange> changed;  // Ranges whose syntax changed (ts_tree_get_changed_ranges)
+};
+
+/**
+ * @brief Parsed content, shared by every cached path with that content
+ *
+ * Immutable once parsed: an update replaces the document, so snapshots of
+ * the old one stay consistent.
+ */
+struct ParsedDocument {
     std::unique_ptr<Tree> tree;
     std::string source;
+    MemoryAccount memory;  // Tree-sitter allocations of tree (and its parses)
+    size_t refs = 0;       // Cached paths pointing at it (snapshots hold it through shared_ptr)
+    std::optional<DocumentDelta> delta;  // Set when parsed incrementally from a path's previous content
+};
+
+/**
+ * @brief A reader's consistent version of one parsed file
+ *
+ * Keeps the document it was taken from alive: if the file is re-parsed or
+ * evicted meanwhile, the cache moves on to a new document and this one is
+ * freed when the last snapshot of it goes. TSNodes and string_views taken
+ * from a snapshot are valid for its lifetime, and no analyzer lock is
+ * held while it is read.
+ *
+ * Each snapshot has its own tree handle (Tree::copy()), so snapshots of
+ * one document can be read on different threads.
+ */
+class DocumentSnapshot {
+public:
+    DocumentSnapshot(std::shared_ptr<const ParsedDocument> document, const ObjectId& content_id, Language language)
+        : document_(std::move(document)), tree_(document_->tree->copy()),
+          content_id_(content_id), language_(language) {}
+
+    const Tree& tree() const { return tree_; }
+    std::string_view source() const { return document_->source; }
+    const ObjectId& content_id() const { return content_id_; }
+    Language language() const { return language_; }
+
+    /**
+     * @brief Difference from the content previously cached for the path (nullptr if unknown)
+     */
+    const DocumentDelta* delta() const { return document_->delta ? &*document_->delta : nullptr; }
+
+private:
+    std::shared_ptr<const ParsedDocument> document_;
+    Tree tree_;
+    ObjectId content_id_;
+    Language language_;
+};
+
+/**
+ * @brief Cached parse result for a file
+ */
+struct CachedFile {
     std::filesystem::file_time_type mtime;
+    ObjectId content_id;  // Git blob id of source
     Language language;  // Language of the cached file
+    bool watched = false;  // Reported by a healthy FileWatcher: validity needs no stat()
+    bool transient = false;  // Loaded in a TransientScope and not used outside one since
+    uint64_t last_used = 0;  // Use clock value of the last hit (LRU eviction)
+    std::shared_ptr<ParsedDocument> document;  // Also in documents_, keyed by content_id and language
+};
+
+/**
+ * @brief Facts derived from one file, kept after its tree is evicted
+ */
+struct FactRecord {
+    ObjectId content_id;  // Content the facts were derived from
+    std::filesystem::file_time_type mtime;
+    uintmax_t size = 0;  // File size, checked with mtime (a rewrite may keep a coarse mtime)
+    bool watched = false;
+    std::map<std::string, std::vector<uint8_t>, std::less<>> facts;  // Kind to CBOR-encoded facts
+    size_t bytes = 0;  // Encoded size of facts
+    uint64_t last_used = 0;
+};
+
+/**
+ * @brief Size limits of the analyzer's two cache tiers
+ */
+struct CacheLimits {
+    size_t max_trees = 256;               // Hot tier: files kept parsed
+    size_t max_tree_bytes = 1024u << 20;  // Hot tier: sources plus accounted tree bytes
+    size_t max_fact_bytes = 256u << 20;   // Warm tier: encoded facts
 };
 
 /**
@@ -29,14 +121,118 @@ struct CachedFile {
  * Provides file-level caching and JSON serialization of analysis results.
  * Supports C++ and Python with automatic language detection from file extensions.
  * Uses TreeSitterParser for parsing and QueryEngine for querying.
+ *
+ * Cache validity is checked with a stat() per access. With a FileWatcher
+ * attached, files in watched directories are trusted until the watcher
+ * reports a change; changed files are then re-parsed in the background.
+ *
+ * Entries remember the git blob id of their content, so a file whose mtime
+ * changed without a content change (touch, branch switch back and forth)
+ * keeps its tree. With the git index enabled in PathResolver the id of an
+ * unmodified tracked file is taken from the index instead of hashing.
+ *
+ * Parsed documents are stored by content: paths with identical content
+ * (vendored copies, symlinks, copied generated files) share one tree and
+ * source, which is released when the last of them leaves the cache. A
+ * tracked file whose content is already parsed is not even read.
+ *
+ * The cache has two tiers. The hot tier keeps the tree and source of the
+ * most recently used files; trees cost many times their source, so it is
+ * small. The warm tier keeps the per-file results of cached_facts()
+ * (classes, functions, includes, summaries...) as compact CBOR records
+ * tied to the content they were derived from, so many more files answer
+ * repeat queries without being parsed again. Both evict least recently
+ * used entries beyond their CacheLimits.
+ *
+ * With a FactCache attached, per-file results are also kept on disk keyed
+ * by content, and a restarted server answers for unchanged files without
+ * parsing them (see cached_facts()).
+ *
+ * Thread-safe. Readers work on DocumentSnapshots: the lock is held only
+ * to look a file up or publish its parse, never while a file is parsed or
+ * queried, so concurrent requests parse and query in parallel. Watcher
+ * updates likewise read and parse changed files without the lock and then
+ * swap the new document in; a request that took its snapshot earlier
+ * finishes on the old version.
  */
 class ASTAnalyzer {
 public:
+    /**
+     * @brief Marks the trees that background work loads on this thread
+     *
+     * Hot tier entries created while a scope is active are transient
+     * until a lookup outside any scope uses them (see release_transient()).
+     */
+    class TransientScope {
+    public:
+        TransientScope() : previous_(transient_) { transient_ = true; }
+        ~TransientScope() { transient_ = previous_; }
+
+        TransientScope(const TransientScope&) = delete;
+        TransientScope& operator=(const TransientScope&) = delete;
+
+    private:
+        bool previous_;
+    };
+
     /**
      * @brief Construct a new ASTAnalyzer
      */
     ASTAnalyzer();
 
+    /**
+     * @brief Stops an attached watcher (its listener refers to this analyzer)
+     */
+    ~ASTAnalyzer();
+
+    /**
+     * @brief Keep the parse cache fresh from file change notifications
+     *
+     * Must be called before the watcher is started.
+     * @param watcher Watcher for the workspace
+     */
+    void attach_watcher(std::shared_ptr<FileWatcher> watcher);
+
+    /**
+     * @brief Persist per-file results in a fact cache
+     *
+     * Must be called before the analyzer is used.
+     * @param cache Cache shared with the tools
+     */
+    void set_fact_cache(std::shared_ptr<FactCache> cache);
+
+    /**
+     * @brief Limit the hot (trees) and warm (facts) cache tiers
+     *
+     * Takes effect at the next insertion into each tier.
+     */
+    void set_cache_limits(const CacheLimits& limits);
+
+    /**
+     * @brief Per-file facts, from the warm tier or the fact cache if the content is unchanged
+     *
+     * The warm tier is checked first, like the parse cache (watcher, then
+     * mtime, then content). Next, with a fact cache, the file's current
+     * blob id is determined (from the parse cache, the git index or by
+     * hashing the file, never by parsing) and looked up. On a miss compute
+     * runs and its result is kept in both unless it reports an error
+     * ("error" field or "success": false) or the file changed meanwhile.
+     *
+     * Facts also pass through the thread's ShardContext, if any: a worker
+     * captures them and the coordinator answers them from its workers.
+     *
+     * @param filepath File the facts describe
+     * @param kind Fact kind; must encode everything besides the content the
+     *        result depends on (language, options)
+     * @param compute Derives the facts (called without internal locks held)
+     * @param persistent False for facts of one request (query results) that
+     *        are only shared with a coordinator, never stored
+     */
+    json cached_facts(const std::filesystem::path& filepath,
+                      std::string_view kind,
+                      const std::function<json()>& compute,
+                      bool persistent = true);
+
     /**
      * @brief Analyze a file and return metadata
      * @param filepath Path to the file to analyze
@@ -84,6 +280,45 @@ public:
                       std::string_view query_string,
                       std::optional<Language> lang = std::nullopt);
 
+    /**
+     * @brief The current parse of a file, held for as long as the caller needs it
+     * @param filepath Path to the file
+     * @param lang Optional language override (auto-detected if nullopt)
+     * @return nullopt if the file cannot be read or parsed
+     */
+    std::optional<DocumentSnapshot> snapshot(const std::filesystem::path& filepath,
+                                             std::optional<Language> lang = std::nullopt);
+
+    /**
+     * @brief Why the parse guard refused a file at its last parse attempt (nullopt if it did not)
+     */
+    std::optional<DegradeReason> degrade_reason(const std::filesystem::path& filepath) const;
+
+    /**
+     * @brief Facts of a file's definitions, recomputed only where the file changed
+     *
+     * The file is split into definition units: its top-level definitions,
+     * with namespaces, linkage blocks and class bodies opened up, each with
+     * the comments directly before it. compute derives the facts of one
+     * unit from that node alone, as a JSON array.
+     *
+     * The facts of each unit are kept while the file is in the hot tier.
+     * When the file is re-parsed after an edit, units outside the edit and
+     * outside the ranges whose syntax changed keep their facts, with every
+     * "line" field shifted by the lines the edit added or removed. Editing
+     * one function of a large file recomputes that function's facts only.
+     *
+     * @param snapshot The file's current parse (from snapshot())
+     * @param filepath The file
+     * @param kind Fact kind; must encode the options compute depends on
+     * @param compute Facts of one unit (called without internal locks held)
+     * @return The facts of all units, concatenated in source order
+     */
+    json definition_facts(const DocumentSnapshot& snapshot,
+                          const std::filesystem::path& filepath,
+                          std::string_view kind,
+                          const std::function<json(TSNode unit, std::string_view source)>& compute);
+
     /**
      * @brief Analyze multiple C++ files and return aggregated metadata
      * @param filepaths Vector of file paths to analyze
@@ -122,21 +357,218 @@ public:
     void clear_cache();
 
     /**
-     * @brief Get the number of cached files
+     * @brief Get the number of cached files (hot tier: files with a tree)
      */
-    size_t cache_size() const { return cache_.size(); }
+    size_t cache_size() const;
+
+    /**
+     * @brief Whether filepath has a tree in the hot tier
+     */
+    bool has_tree(const std::filesystem::path& filepath) const;
+
+    /**
+     * @brief Drop filepath's tree if it is still transient, keeping its facts in the warm tier
+     *
+     * For background work that wants the facts without displacing the
+     * trees of interactive requests: a tree that a lookup outside any
+     * TransientScope used since it was loaded is kept.
+     *
+     * @return Whether the tree was dropped
+     */
+    bool release_transient(const std::filesystem::path& filepath);
+
+    /**
+     * @brief Hot tier bytes (sources plus accounted tree bytes, as limited by CacheLimits)
+     */
+    size_t tree_bytes() const;
+
+    CacheLimits cache_limits() const;
+
+    /**
+     * @brief Whether the warm tier is at its limit (new facts evict others)
+     */
+    bool fact_tier_full() const;
+
+    /**
+     * @brief Number of distinct parsed contents (at most cache_size())
+     */
+    size_t document_count() const;
+
+    /**
+     * @brief Number of files with facts in the warm tier
+     */
+    size_t fact_record_count() const;
+
+    /**
+     * @brief Memory held by the parse cache
+     *
+     * Tree bytes are exact when TreeSitterMemory is installed, 0 otherwise.
+     * @param top_n Number of heaviest files to list
+     * @return JSON object with documents (cached paths), unique_documents,
+     *         source_bytes, tree_bytes (of unique documents), fact_files,
+     *         fact_bytes (warm tier) and top_files
+     */
+    json memory_usage(size_t top_n) const;
 
 private:
-    std::map<Language, TreeSitterParser> parsers_;  // Parser cache per language
+    static inline thread_local bool transient_ = false;
+
     QueryEngine query_engine_;
-    std::map<std::filesystem::path, CachedFile> cache_;
+    std::map<std::filesystem::path, CachedFile> cache_;     // Hot tier
+    std::map<std::pair<ObjectId, Language>, std::shared_ptr<ParsedDocument>> documents_;  // Hot tier contents
+    std::map<std::filesystem::path, FactRecord> facts_;     // Warm tier
+    size_t fact_bytes_ = 0;
+    CacheLimits limits_;
+    uint64_t use_clock_ = 0;
+
+    /**
+     * @brief Facts of one definition unit (see definition_facts())
+     */
+    struct UnitFacts {
+        uint32_t start_byte;  // Including the comments before it
+        uint32_t end_byte;
+        json facts;
+    };
+
+    /**
+     * @brief Facts of all units of one content, in source order
+     */
+    struct DefinitionRecord {
+        ObjectId content_id;
+        std::vector<UnitFacts> units;
+    };
+
+    // Per-unit facts of files in the hot tier, by path and kind
+    std::map<std::filesystem::path, std::map<std::string, DefinitionRecord, std::less<>>> definitions_;
+
+    struct DegradedFile {
+        DegradeReason reason;
+        std::filesystem::file_time_type mtime;
+    };
+    std::map<std::filesystem::path, DegradedFile> degraded_;  // Files the parse guard refused
+    std::shared_ptr<FileWatcher> watcher_;
+    std::shared_ptr<FactCache> fact_cache_;
+    mutable std::recursive_mutex mutex_;  // Guards documents_, both tiers, definitions_ and degraded_
+
+    // Bodies of the single-file methods, bypassing the fact cache
+    json analyze_file_uncached(const std::filesystem::path& filepath, std::optional<Language> lang);
+    json find_classes_uncached(const std::filesystem::path& filepath, std::optional<Language> lang);
+    json find_functions_uncached(const std::filesystem::path& filepath, std::optional<Language> lang);
+    json find_includes_uncached(const std::filesystem::path& filepath, std::optional<Language> lang);
+
+    /**
+     * @brief Lexical-only result for a file the parse guard refused (nullopt otherwise)
+     * @param what "analysis", "classes", "functions", "includes" or "query"
+     */
+    std::optional<json> degraded_result(const std::filesystem::path& filepath,
+                                        Language lang,
+                                        std::string_view what);
+
+    /**
+     * @brief The fact cache part of cached_facts()
+     */
+    json persisted_facts(const std::filesystem::path& filepath,
+                         std::string_view kind,
+                         const std::function<json()>& compute);
+
+    /**
+     * @brief Facts of a kind from the warm tier, if still valid for the file
+     */
+    std::optional<json> warm_facts(const std::filesystem::path& filepath, std::string_view kind);
+
+    /**
+     * @brief Add facts to the warm tier (replacing facts of other content)
+     */
+    void keep_facts(const std::filesystem::path& filepath,
+                    std::string_view kind,
+                    const ObjectId& content_id,
+                    std::filesystem::file_time_type mtime,
+                    uintmax_t size,
+                    const json& facts);
+
+    void drop_facts_locked(std::map<std::filesystem::path, FactRecord>::iterator it);
+
+    /**
+     * @brief Cache hit on content already parsed: filepath's own entry, or a document another path shares
+     *
+     * Points filepath's entry at the document and records mtime.
+     * @return nullopt if no cached document has content_id
+     */
+    std::optional<DocumentSnapshot> share_locked(const std::filesystem::path& filepath,
+                                                 const ObjectId& content_id,
+                                                 Language lang,
+                                                 std::filesystem::file_time_type mtime);
+
+    /**
+     * @brief Parse source into a new document, charging tree-sitter's allocations to it
+     *
+     * With the previous document of the path, the parse is incremental and
+     * the new document records its DocumentDelta.
+     * @return nullptr if the parse fails
+     */
+    static std::shared_ptr<ParsedDocument> parse_document(const std::filesystem::path& filepath,
+                                                          TreeSitterParser& parser,
+                                                          std::string&& source,
+                                                          const ParsedDocument* previous = nullptr,
+                                                          const ObjectId& previous_id = {});
+
+    /**
+     * @brief Point a cache entry at a document (releasing its previous one)
+     */
+    void attach_locked(CachedFile& cached, std::shared_ptr<ParsedDocument> document);
+
+    /**
+     * @brief Drop a cache entry's reference, freeing the document if it was the last
+     */
+    void release_locked(CachedFile& cached);
+
+    /**
+     * @brief Evict least recently used trees beyond the limits, except keep
+     */
+    void evict_trees_locked(const std::filesystem::path& keep);
+
+    int64_t tree_bytes_locked() const;
+
+    /**
+     * @brief Evict least recently used fact records beyond the limit
+     */
+    void evict_facts_locked();
+
+    /**
+     * @brief Blob id of a file's current content without parsing it
+     * @return nullopt if the file cannot be read
+     */
+    std::optional<ObjectId> current_content_id(const std::filesystem::path& filepath);
+
+    /**
+     * @brief Deliver queued file change events (must be called without mutex_ held)
+     */
+    void sync_watcher();
+
+    /**
+     * @brief Watcher listener: re-parse or drop changed cache entries
+     */
+    void on_files_changed(const ChangeBatch& batch);
+
+    /**
+     * @brief Check if the watcher reports changes to a file
+     */
+    bool is_watched(const std::filesystem::path& filepath) const;
+
+    /**
+     * @brief Re-read a changed cached file and swap in the document of its new content
+     *
+     * Reads and parses without the lock; the swap is skipped if the entry
+     * changed meanwhile (updated by a request, evicted).
+     * @param content_id Content of the entry when the change was reported
+     * @return false if the entry was dropped (file unreadable or unparseable)
+     */
+    bool reparse_cached(const std::filesystem::path& filepath, const ObjectId& content_id, Language lang);
 
     /**
-     * @brief Get or create parser for a specific language
-     * @param lang Programming language
-     * @return Reference to parser for this language
+     * @brief Blob id of freshly read file content (from the git index when possible)
      */
-    TreeSitterParser& get_parser_for_language(Language lang);
+    static ObjectId content_id_of(const std::filesystem::path& filepath, std::string_view source);
 
     /**
      * @brief Detect language from filepath or use override
@@ -149,11 +581,16 @@ private:
 
     /**
      * @brief Get or parse a file (with caching)
+     *
+     * Looks up under the lock, but reads, hashes and parses without it, with
+     * a parser of its own, so lookups of other files never wait for a parse.
+     * The new document is published under the lock; if another thread cached
+     * the same content meanwhile, its document is used instead.
      * @param filepath Path to the file
      * @param lang Language to use for parsing
-     * @return Optional containing tree, source, and language, or nullopt on error
+     * @return Snapshot of the file's document, or nullopt on error
      */
-    std::optional<std::tuple<const Tree*, std::string_view, Language>> get_or_parse_file(
+    std::optional<DocumentSnapshot> get_or_parse_file(
         const std::filesystem::path& filepath,
         Language lang
     );
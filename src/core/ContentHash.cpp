@@ -0,0 +1,176 @@
+#include "core/ContentHash.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace ts_mcp {
+
+namespace {
+
+/**
+ * @brief Incremental SHA-1 (FIPS 180-4)
+ */
+class Sha1 {
+public:
+    void update(std::string_view data) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+        size_t len = data.size();
+        total_ += len;
+
+        if (buffered_ > 0) {
+            size_t take = std::min(len, sizeof(buffer_) - buffered_);
+            std::memcpy(buffer_ + buffered_, bytes, take);
+            buffered_ += take;
+            bytes += take;
+            len -= take;
+            if (buffered_ < sizeof(buffer_)) {
+                return;
+            }
+            process(buffer_);
+            buffered_ = 0;
+        }
+
+        for (; len >= sizeof(buffer_); bytes += sizeof(buffer_), len -= sizeof(buffer_)) {
+            process(bytes);
+        }
+
+        std::memcpy(buffer_, bytes, len);
+        buffered_ = len;
+    }
+
+    ObjectId finish() {
+        const uint64_t bit_len = total_ * 8;
+
+        static const uint8_t padding[64] = {0x80};
+        size_t pad = buffered_ < 56 ? 56 - buffered_ : 120 - buffered_;
+        update(std::string_view(reinterpret_cast<const char*>(padding), pad));
+
+        char length[8];
+        for (int i = 0; i < 8; ++i) {
+            length[i] = static_cast<char>(bit_len >> (56 - 8 * i));
+        }
+        update(std::string_view(length, sizeof(length)));
+
+        ObjectId id;
+        for (int i = 0; i < 5; ++i) {
+            id.bytes[4 * i] = static_cast<uint8_t>(state_[i] >> 24);
+            id.bytes[4 * i + 1] = static_cast<uint8_t>(state_[i] >> 16);
+            id.bytes[4 * i + 2] = static_cast<uint8_t>(state_[i] >> 8);
+            id.bytes[4 * i + 3] = static_cast<uint8_t>(state_[i]);
+        }
+        return id;
+    }
+
+private:
+    static uint32_t rotl(uint32_t value, int bits) {
+        return (value << bits) | (value >> (32 - bits));
+    }
+
+    void process(const uint8_t* block) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+                   (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3], e = state_[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+
+        state_[0] += a;
+        state_[1] += b;
+        state_[2] += c;
+        state_[3] += d;
+        state_[4] += e;
+    }
+
+    uint32_t state_[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    uint8_t buffer_[64];
+    size_t buffered_ = 0;
+    uint64_t total_ = 0;
+};
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+std::string ObjectId::to_hex() const {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (uint8_t byte : bytes) {
+        hex += digits[byte >> 4];
+        hex += digits[byte & 0xF];
+    }
+    return hex;
+}
+
+std::optional<ObjectId> ObjectId::from_hex(std::string_view hex) {
+    ObjectId id;
+    if (hex.size() != id.bytes.size() * 2) {
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < id.bytes.size(); ++i) {
+        int high = hex_value(hex[2 * i]);
+        int low = hex_value(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return std::nullopt;
+        }
+        id.bytes[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return id;
+}
+
+bool ObjectId::is_zero() const {
+    for (uint8_t byte : bytes) {
+        if (byte != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ObjectId ContentHash::sha1(std::string_view data) {
+    Sha1 hasher;
+    hasher.update(data);
+    return hasher.finish();
+}
+
+ObjectId ContentHash::git_blob_id(std::string_view content) {
+    std::string header = "blob " + std::to_string(content.size());
+    header += '\0';
+
+    Sha1 hasher;
+    hasher.update(header);
+    hasher.update(content);
+    return hasher.finish();
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ts_mcp {
+
+/**
+ * @brief 20-byte SHA-1 object id (git blob id)
+ */
+struct ObjectId {
+    std::array<uint8_t, 20> bytes{};
+
+    /**
+     * @brief Lowercase 40-character hex form
+     */
+    std::string to_hex() const;
+
+    /**
+     * @brief Parse a 40-character hex id
+     * @return nullopt if hex is malformed
+     */
+    static std::optional<ObjectId> from_hex(std::string_view hex);
+
+    bool is_zero() const;
+
+    bool operator==(const ObjectId& other) const = default;
+    auto operator<=>(const ObjectId& other) const = default;
+};
+
+/**
+ * @brief Content hashing compatible with git object ids
+ *
+ * The parse cache keys file contents by their git blob id, so ids taken
+ * from the git index (see GitIndex) and ids computed from file contents
+ * are interchangeable.
+ */
+class ContentHash {
+public:
+    /**
+     * @brief SHA-1 of raw data
+     */
+    static ObjectId sha1(std::string_view data);
+
+    /**
+     * @brief Git blob id: SHA-1 of "blob <size>\0" followed by the content
+     */
+    static ObjectId git_blob_id(std::string_view content);
+};
+
+} // namespace ts_mcp
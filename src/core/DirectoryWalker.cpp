@@ -0,0 +1,606 @@
+#include "core/DirectoryWalker.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ts_mcp {
+
+namespace {
+
+constexpr unsigned MAX_DEFAULT_THREADS = 8;
+
+struct DirTask {
+    std::string abs;   // Directory path as passed to the OS
+    std::string rel;   // Relative to the walk root: "" or "a/b/"
+    std::shared_ptr<const IgnoreRules> rules;
+};
+
+std::string join_path(const std::string& dir, std::string_view name) {
+    std::string result;
+    result.reserve(dir.size() + name.size() + 1);
+    result += dir;
+    if (!result.empty() && result.back() != '/') {
+        result += '/';
+    }
+    result += name;
+    return result;
+}
+
+std::string read_text_file(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return {};
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+#ifdef __linux__
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+std::string read_file_at(int dirfd, const char* name) {
+    int fd = ::openat(dirfd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {};
+    }
+    std::string contents;
+    char buf[8192];
+    ssize_t n;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0) {
+        contents.append(buf, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return contents;
+}
+
+void fill_stat(const struct stat& st, uint64_t& size, int64_t& mtime_ns, uint64_t& inode) {
+    size = static_cast<uint64_t>(st.st_size);
+    mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    inode = static_cast<uint64_t>(st.st_ino);
+}
+#endif
+
+enum class EntryKind { File, Directory, Other };
+
+struct RawEntry {
+    std::string name;
+    EntryKind kind;
+    uint64_t size = 0;       // Stat data, filled only when collecting stats
+    int64_t mtime_ns = 0;
+    uint64_t inode = 0;
+};
+
+} // namespace
+
+std::vector<std::string> WalkOptions::default_excluded_dirs() {
+    return {".git", ".hg", ".svn", "build", "node_modules", "third_party", "_deps"};
+}
+
+// ============================================================================
+// Walk: state of a single parallel traversal
+// ============================================================================
+
+class DirectoryWalker::Walk {
+public:
+    Walk(const WalkOptions& options,
+         const FileFilter& filter,
+         const DirectoryFilter& dir_filter,
+         std::string root_prefix,
+         unsigned threads,
+         bool collect_stats = false)
+        : options_(options), filter_(filter), dir_filter_(dir_filter),
+          root_prefix_(std::move(root_prefix)), collect_stats_(collect_stats) {
+        for (unsigned i = 0; i < threads; i++) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        results_.resize(threads);
+        entries_.resize(threads);
+    }
+
+    std::vector<std::filesystem::path> run(DirTask root) {
+        run_workers(std::move(root));
+
+        std::vector<std::filesystem::path> merged;
+        size_t total = 0;
+        for (const auto& r : results_) {
+            total += r.size();
+        }
+        merged.reserve(total);
+        for (auto& r : results_) {
+            std::move(r.begin(), r.end(), std::back_inserter(merged));
+        }
+        return merged;
+    }
+
+    std::vector<WalkEntry> run_scan(DirTask root) {
+        run_workers(std::move(root));
+
+        std::vector<WalkEntry> merged;
+        size_t total = 0;
+        for (const auto& e : entries_) {
+            total += e.size();
+        }
+        merged.reserve(total);
+        for (auto& e : entries_) {
+            std::move(e.begin(), e.end(), std::back_inserter(merged));
+        }
+        return merged;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<DirTask> tasks;
+    };
+
+    void run_workers(DirTask root) {
+        push(0, std::move(root));
+
+        std::vector<std::thread> helpers;
+        for (unsigned i = 1; i < queues_.size(); i++) {
+            helpers.emplace_back([this, i] { worker(i); });
+        }
+        worker(0);
+        for (auto& t : helpers) {
+            t.join();
+        }
+    }
+
+    void push(unsigned self, DirTask task) {
+        pending_.fetch_add(1, std::memory_order_acq_rel);
+        std::lock_guard<std::mutex> lock(queues_[self]->mutex);
+        queues_[self]->tasks.push_back(std::move(task));
+    }
+
+    bool pop(unsigned self, DirTask& task) {
+        // LIFO on our own queue keeps the working set depth-first and cache-warm
+        {
+            Queue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // Steal the oldest (usually largest) subtree from another worker
+        for (size_t k = 1; k < queues_.size(); k++) {
+            Queue& victim = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void worker(unsigned self) {
+        DirTask task;
+        unsigned idle_rounds = 0;
+
+        while (true) {
+            if (pop(self, task)) {
+                idle_rounds = 0;
+                process(self, task);
+                pending_.fetch_sub(1, std::memory_order_acq_rel);
+                continue;
+            }
+
+            if (pending_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+
+            if (++idle_rounds < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+
+    bool is_excluded_name(std::string_view name) const {
+        return std::find(options_.excluded_dir_names.begin(),
+                         options_.excluded_dir_names.end(),
+                         name) != options_.excluded_dir_names.end();
+    }
+
+    void process(unsigned self, const DirTask& task) {
+        std::vector<RawEntry> entries;
+        std::string ignore_contents;
+        WalkEntry self_entry;
+        if (!list_directory(task, entries, ignore_contents, self_entry)) {
+            return;
+        }
+
+        if (collect_stats_) {
+            self_entry.rel_path = task.rel;
+            self_entry.is_dir = true;
+            self_entry.listed = true;
+            entries_[self].push_back(std::move(self_entry));
+        }
+
+        std::shared_ptr<const IgnoreRules> rules = task.rules;
+        if (ignore_contents.find_first_not_of('\n') != std::string::npos) {
+            rules = std::make_shared<IgnoreRules>(ignore_contents, root_prefix_ + task.rel, rules);
+        }
+
+        for (const auto& entry : entries) {
+            std::string rel = task.rel + entry.name;
+
+            if (entry.kind == EntryKind::Directory) {
+                if (!options_.recursive || is_excluded_name(entry.name)) {
+                    continue;
+                }
+                if (rules && rules->is_ignored(root_prefix_ + rel, true)) {
+                    spdlog::trace("Pruned ignored directory {}", rel);
+                    continue;
+                }
+                rel += '/';
+                if (dir_filter_ && !dir_filter_(rel)) {
+                    if (collect_stats_) {
+                        entries_[self].push_back(
+                            WalkEntry{std::move(rel), true, false, entry.size, entry.mtime_ns, entry.inode});
+                    }
+                    continue;
+                }
+                push(self, DirTask{join_path(task.abs, entry.name), std::move(rel), rules});
+            } else if (entry.kind == EntryKind::File) {
+                if (rules && rules->is_ignored(root_prefix_ + rel, false)) {
+                    continue;
+                }
+                if (filter_ && !filter_(rel, entry.name)) {
+                    continue;
+                }
+                if (collect_stats_) {
+                    entries_[self].push_back(
+                        WalkEntry{std::move(rel), false, false, entry.size, entry.mtime_ns, entry.inode});
+                } else {
+                    results_[self].emplace_back(join_path(task.abs, entry.name));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Read one directory level
+     * @param entries Output: files and subdirectories
+     * @param ignore_contents Output: concatenated .gitignore + .ignore text
+     * @param self_entry Output: stat data of the directory itself (when collecting stats)
+     * @return false if the directory could not be opened
+     */
+    bool list_directory(const DirTask& task,
+                        std::vector<RawEntry>& entries,
+                        std::string& ignore_contents,
+                        WalkEntry& self_entry) const {
+#ifdef __linux__
+        int fd = ::open(task.abs.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            spdlog::debug("Cannot open directory {}: {}", task.abs, std::strerror(errno));
+            return false;
+        }
+
+        if (collect_stats_) {
+            struct stat self_st;
+            if (::fstat(fd, &self_st) == 0) {
+                fill_stat(self_st, self_entry.size, self_entry.mtime_ns, self_entry.inode);
+            }
+        }
+
+        bool has_gitignore = false;
+        bool has_ignore = false;
+        alignas(8) char buf[32 * 1024];
+
+        while (true) {
+            long n = ::syscall(SYS_getdents64, fd, buf, sizeof(buf));
+            if (n <= 0) {
+                if (n < 0) {
+                    spdlog::debug("getdents64 failed for {}: {}", task.abs, std::strerror(errno));
+                }
+                break;
+            }
+
+            for (long offset = 0; offset < n;) {
+                auto* d = reinterpret_cast<LinuxDirent64*>(buf + offset);
+                offset += d->d_reclen;
+
+                const char* name = d->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                    continue;
+                }
+
+                EntryKind kind = EntryKind::Other;
+                unsigned char type = d->d_type;
+                struct stat st;
+
+                if (type == DT_UNKNOWN) {
+                    if (::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0) {
+                        if (S_ISDIR(st.st_mode)) {
+                            type = DT_DIR;
+                        } else if (S_ISREG(st.st_mode)) {
+                            type = DT_REG;
+                        } else if (S_ISLNK(st.st_mode)) {
+                            type = DT_LNK;
+                        }
+                    }
+                }
+
+                if (type == DT_DIR) {
+                    kind = EntryKind::Directory;
+                } else if (type == DT_REG) {
+                    kind = EntryKind::File;
+                } else if (type == DT_LNK) {
+                    // Like recursive_directory_iterator: report symlinked files,
+                    // never follow symlinked directories
+                    if (::fstatat(fd, name, &st, 0) == 0 && S_ISREG(st.st_mode)) {
+                        kind = EntryKind::File;
+                    }
+                }
+
+                if (kind == EntryKind::Other) {
+                    continue;
+                }
+
+                RawEntry raw{name, kind};
+                if (collect_stats_ && ::fstatat(fd, name, &st, 0) == 0) {
+                    fill_stat(st, raw.size, raw.mtime_ns, raw.inode);
+                }
+
+                if (kind == EntryKind::File && options_.use_ignore_files) {
+                    if (std::strcmp(name, ".gitignore") == 0) {
+                        has_gitignore = true;
+                    } else if (std::strcmp(name, ".ignore") == 0) {
+                        has_ignore = true;
+                    }
+                }
+
+                entries.push_back(std::move(raw));
+            }
+        }
+
+        // .ignore is appended last so its rules take precedence
+        if (has_gitignore) {
+            ignore_contents += read_file_at(fd, ".gitignore");
+            ignore_contents += '\n';
+        }
+        if (has_ignore) {
+            ignore_contents += read_file_at(fd, ".ignore");
+        }
+
+        ::close(fd);
+        return true;
+#else
+        if (collect_stats_) {
+            DirectoryWalker::stat_path(task.abs, self_entry);
+        }
+
+        std::error_code ec;
+        std::filesystem::directory_iterator it(
+            task.abs, std::filesystem::directory_options::skip_permission_denied, ec);
+        if (ec) {
+            spdlog::debug("Cannot open directory {}: {}", task.abs, ec.message());
+            return false;
+        }
+
+        for (const auto& entry : it) {
+            std::string name = entry.path().filename().string();
+            bool is_link = entry.is_symlink(ec);
+
+            EntryKind kind = EntryKind::Other;
+            if (entry.is_directory(ec)) {
+                kind = is_link ? EntryKind::Other : EntryKind::Directory;
+            } else if (entry.is_regular_file(ec)) {
+                kind = EntryKind::File;
+            }
+
+            if (kind == EntryKind::Other) {
+                continue;
+            }
+
+            RawEntry raw{name, kind};
+            WalkEntry st;
+            if (collect_stats_ && DirectoryWalker::stat_path(entry.path(), st)) {
+                raw.size = st.size;
+                raw.mtime_ns = st.mtime_ns;
+            }
+            entries.push_back(std::move(raw));
+        }
+
+        if (options_.use_ignore_files) {
+            ignore_contents += read_text_file(std::filesystem::path(task.abs) / ".gitignore");
+            ignore_contents += '\n';
+            ignore_contents += read_text_file(std::filesystem::path(task.abs) / ".ignore");
+        }
+        return true;
+#endif
+    }
+
+    const WalkOptions& options_;
+    const FileFilter& filter_;
+    const DirectoryFilter& dir_filter_;
+    std::string root_prefix_;
+    bool collect_stats_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::vector<std::filesystem::path>> results_;
+    std::vector<std::vector<WalkEntry>> entries_;
+    std::atomic<size_t> pending_{0};
+};
+
+// ============================================================================
+// DirectoryWalker implementation
+// ============================================================================
+
+DirectoryWalker::DirectoryWalker(WalkOptions options)
+    : options_(std::move(options)) {
+}
+
+std::shared_ptr<const IgnoreRules> DirectoryWalker::load_ancestor_rules(
+    const std::filesystem::path& root,
+    std::string& root_prefix
+) const {
+    root_prefix.clear();
+
+    // Find the enclosing repository (bounded walk towards '/')
+    std::filesystem::path repo_root;
+    std::error_code ec;
+    std::filesystem::path current = root;
+    for (int depth = 0; depth < 64 && !current.empty(); depth++) {
+        if (std::filesystem::exists(current / ".git", ec)) {
+            repo_root = current;
+            break;
+        }
+        auto parent = current.parent_path();
+        if (parent == current) {
+            break;
+        }
+        current = parent;
+    }
+
+    if (repo_root.empty()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<const IgnoreRules> rules;
+
+    std::string exclude = read_text_file(repo_root / ".git" / "info" / "exclude");
+    if (!exclude.empty()) {
+        rules = std::make_shared<IgnoreRules>(exclude, "", rules);
+    }
+
+    // Ancestors strictly above the walk root; the root's own ignore files
+    // are picked up while listing it.
+    std::filesystem::path relative = root.lexically_relative(repo_root);
+    std::filesystem::path dir = repo_root;
+    std::string base;
+
+    for (const auto& component : relative) {
+        if (component == ".") {
+            break;
+        }
+
+        std::string contents = read_text_file(dir / ".gitignore");
+        contents += '\n';
+        contents += read_text_file(dir / ".ignore");
+        if (contents.size() > 1) {
+            rules = std::make_shared<IgnoreRules>(contents, base, rules);
+        }
+
+        dir /= component;
+        base += component.string() + "/";
+    }
+
+    root_prefix = base;
+    return rules;
+}
+
+unsigned DirectoryWalker::thread_count() const {
+    if (!options_.recursive) {
+        return 1;
+    }
+    if (options_.max_threads != 0) {
+        return options_.max_threads;
+    }
+    return std::clamp(std::thread::hardware_concurrency(), 1u, MAX_DEFAULT_THREADS);
+}
+
+std::vector<std::filesystem::path> DirectoryWalker::walk(
+    const std::filesystem::path& root,
+    const FileFilter& filter,
+    const DirectoryFilter& dir_filter
+) const {
+    std::shared_ptr<const IgnoreRules> rules;
+    std::string root_prefix;
+
+    if (options_.use_ignore_files) {
+        std::error_code ec;
+        auto canonical_root = std::filesystem::weakly_canonical(root, ec);
+        if (!ec) {
+            rules = load_ancestor_rules(canonical_root, root_prefix);
+        }
+    }
+
+    unsigned threads = thread_count();
+    Walk walk(options_, filter, dir_filter, std::move(root_prefix), threads);
+    auto results = walk.run(DirTask{root.string(), "", std::move(rules)});
+
+    spdlog::debug("Walked {} with {} threads: {} files", root.string(), threads, results.size());
+    return results;
+}
+
+std::vector<WalkEntry> DirectoryWalker::scan(
+    const std::filesystem::path& root,
+    const DirectoryFilter& dir_filter
+) const {
+    std::shared_ptr<const IgnoreRules> rules;
+    std::string root_prefix;
+
+    if (options_.use_ignore_files) {
+        std::error_code ec;
+        auto canonical_root = std::filesystem::weakly_canonical(root, ec);
+        if (!ec) {
+            rules = load_ancestor_rules(canonical_root, root_prefix);
+        }
+    }
+
+    const FileFilter no_filter;
+    unsigned threads = thread_count();
+    Walk walk(options_, no_filter, dir_filter, std::move(root_prefix), threads, true);
+    auto entries = walk.run_scan(DirTask{root.string(), "", std::move(rules)});
+
+    spdlog::debug("Scanned {} with {} threads: {} entries", root.string(), threads, entries.size());
+    return entries;
+}
+
+bool DirectoryWalker::stat_path(const std::filesystem::path& path, WalkEntry& entry) {
+#ifdef __linux__
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    entry.is_dir = S_ISDIR(st.st_mode);
+    fill_stat(st, entry.size, entry.mtime_ns, entry.inode);
+    return true;
+#else
+    std::error_code ec;
+    auto status = std::filesystem::status(path, ec);
+    if (ec || !std::filesystem::exists(status)) {
+        return false;
+    }
+    entry.is_dir = std::filesystem::is_directory(status);
+    entry.size = entry.is_dir ? 0 : static_cast<uint64_t>(std::filesystem::file_size(path, ec));
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    entry.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        mtime.time_since_epoch()).count();
+    entry.inode = 0;
+    return true;
+#endif
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "core/IgnoreRules.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Options controlling a directory walk
+ */
+struct WalkOptions {
+    bool recursive = true;           // Descend into subdirectories
+    bool use_ignore_files = true;    // Honor .gitignore / .ignore / .git/info/exclude
+    unsigned max_threads = 0;        // Worker threads (0 = hardware concurrency, capped at 8)
+
+    /**
+     * Directory names that are never entered below the walk root.
+     * Explicitly requested roots are always walked, even if they match.
+     */
+    std::vector<std::string> excluded_dir_names = default_excluded_dirs();
+
+    /**
+     * @brief Default set of VCS, build output and vendored dependency directories
+     */
+    static std::vector<std::string> default_excluded_dirs();
+};
+
+/**
+ * @brief A file or directory reported by DirectoryWalker::scan()
+ */
+struct WalkEntry {
+    std::string rel_path;    // Relative to the walk root; directories end with '/' (root is "")
+    bool is_dir = false;
+    bool listed = false;     // Directory contents were read during this scan
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;    // Modification time, nanoseconds (comparable only to other WalkEntry values)
+    uint64_t inode = 0;      // 0 where the platform does not expose inodes
+};
+
+/**
+ * @brief Parallel directory walker with ignore-rule pruning
+ *
+ * Each directory is a unit of work. Worker threads keep their own deque of
+ * pending directories and steal from other workers when they run dry, so a
+ * single huge subtree is spread across all threads.
+ *
+ * On Linux directories are read with openat()/getdents64(), which returns
+ * entry types without a stat() per entry. Other platforms fall back to
+ * std::filesystem::directory_iterator.
+ *
+ * Ignored directories (excluded names, .gitignore/.ignore rules) are pruned
+ * before they are opened, so their contents cost nothing.
+ */
+class DirectoryWalker {
+public:
+    /**
+     * @brief Predicate deciding whether a regular file is reported
+     * @param rel_path Path relative to the walk root ('/' separated)
+     * @param name File name
+     */
+    using FileFilter = std::function<bool(std::string_view rel_path, std::string_view name)>;
+
+    /**
+     * @brief Predicate deciding whether a subdirectory is entered
+     * @param rel_dir Directory relative to the walk root, with trailing '/'
+     */
+    using DirectoryFilter = std::function<bool(std::string_view rel_dir)>;
+
+    explicit DirectoryWalker(WalkOptions options = {});
+
+    /**
+     * @brief Walk a directory and collect matching regular files
+     * @param root Directory to walk
+     * @param filter File filter (nullptr accepts every file)
+     * @param dir_filter Subdirectory filter applied after ignore rules
+     *                   (nullptr enters every directory)
+     * @return Paths of matching files (root / relative path, unordered)
+     */
+    std::vector<std::filesystem::path> walk(const std::filesystem::path& root,
+                                            const FileFilter& filter,
+                                            const DirectoryFilter& dir_filter = nullptr) const;
+
+    /**
+     * @brief Walk a directory and report every non-ignored entry with its stat data
+     *
+     * Used to build and incrementally refresh a FileInventory. Subdirectories
+     * rejected by dir_filter are still reported (listed == false) but not
+     * entered. Directory stat data is captured before the directory is read,
+     * so a change that races with the listing is seen by the next scan.
+     *
+     * @param root Directory to walk
+     * @param dir_filter Subdirectory filter (nullptr enters every directory)
+     * @return Entries in unspecified order; the root itself is reported as ""
+     */
+    std::vector<WalkEntry> scan(const std::filesystem::path& root,
+                                const DirectoryFilter& dir_filter = nullptr) const;
+
+    /**
+     * @brief Stat a single path with the same clock and semantics as scan()
+     * @param path Path to stat (symlinks are followed)
+     * @param entry Output: is_dir, size, mtime_ns and inode
+     * @return false if the path does not exist or cannot be accessed
+     */
+    static bool stat_path(const std::filesystem::path& path, WalkEntry& entry);
+
+    const WalkOptions& options() const { return options_; }
+
+private:
+    class Walk;
+
+    /**
+     * @brief Load ignore files above the walk root up to the repository root
+     *
+     * Gitignore rules are relative to the directory that holds them, so a
+     * walk of "repo/src" must also see "repo/.gitignore".
+     *
+     * @param root Canonical walk root
+     * @param root_prefix Output: walk root relative to the ignore root ("" or "a/b/")
+     * @return Rule chain applying to the walk root (may be nullptr)
+     */
+    std::shared_ptr<const IgnoreRules> load_ancestor_rules(
+        const std::filesystem::path& root,
+        std::string& root_prefix
+    ) const;
+
+    unsigned thread_count() const;
+
+    WalkOptions options_;
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,461 @@
+#include "core/FactCache.hpp"
+#include "core/Language.hpp"
+#include "core/Metrics.hpp"
+#include <spdlog/spdlog.h>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ts_mcp {
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'S', 'M', 'C', 'P', 'F', 'C', 'T'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t HEADER_SIZE = 32;         // Magic, version, byte order, fingerprint, reserved
+constexpr size_t RECORD_HEADER_SIZE = 32;  // Key size, value size, checksum, content id
+constexpr uint64_t COMPACT_MIN_BYTES = 1 << 20;
+
+struct RecordHeader {
+    uint32_t key_size = 0;
+    uint32_t value_size = 0;
+    uint32_t checksum = 0;
+    ObjectId content_id;
+};
+
+uint32_t fnv1a32(const uint8_t* data, size_t size, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t record_checksum(std::string_view key, const uint8_t* value, size_t value_size) {
+    uint32_t hash = fnv1a32(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+    return fnv1a32(value, value_size, hash);
+}
+
+std::string encode_header(uint64_t fingerprint) {
+    std::string header(HEADER_SIZE, '\0');
+    std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+    std::memcpy(header.data() + 8, &FactCache::FORMAT_VERSION, 4);
+    std::memcpy(header.data() + 12, &BYTE_ORDER_MARK, 4);
+    std::memcpy(header.data() + 16, &fingerprint, 8);
+    return header;
+}
+
+void append_record(std::string& out, std::string_view key, const RecordHeader& header, const uint8_t* value) {
+    size_t start = out.size();
+    out.resize(start + RECORD_HEADER_SIZE);
+    std::memcpy(out.data() + start, &header.key_size, 4);
+    std::memcpy(out.data() + start + 4, &header.value_size, 4);
+    std::memcpy(out.data() + start + 8, &header.checksum, 4);
+    std::memcpy(out.data() + start + 12, header.content_id.bytes.data(), header.content_id.bytes.size());
+    out.append(key);
+    out.append(reinterpret_cast<const char*>(value), header.value_size);
+}
+
+} // namespace
+
+std::string FactCache::make_key(const std::filesystem::path& file, std::string_view kind) {
+    std::string key(kind);
+    key += '\n';
+    key += std::filesystem::absolute(file).lexically_normal().string();
+    return key;
+}
+
+std::filesystem::path FactCache::default_directory() {
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg && std::filesystem::path(xdg).is_absolute()) {
+        return std::filesystem::path(xdg) / "tree-sitter-mcp";
+    }
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::filesystem::path(home) / ".cache" / "tree-sitter-mcp";
+    }
+    return std::filesystem::temp_directory_path() / "tree-sitter-mcp";
+}
+
+uint64_t FactCache::fingerprint() {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 1099511628211ull;
+        }
+    };
+    mix(FORMAT_VERSION);
+    mix(FACTS_VERSION);
+    mix(LanguageUtils::grammar_fingerprint(Language::CPP));
+    mix(LanguageUtils::grammar_fingerprint(Language::PYTHON));
+    return hash;
+}
+
+FactCache::Stats FactCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats result;
+    result.entries = slots_.size();
+    result.file_bytes = file_size_;
+    result.dead_bytes = dead_bytes_;
+    result.hits = hits_;
+    result.misses = misses_;
+    result.writes = writes_;
+    return result;
+}
+
+const uint8_t* FactCache::value_locked(const Slot& slot) const {
+    return slot.pending.empty() ? map_ + slot.offset : slot.pending.data();
+}
+
+std::optional<nlohmann::json> FactCache::get(const std::filesystem::path& file,
+                                             std::string_view kind,
+                                             const ObjectId& content_id) {
+    std::string key = make_key(file, kind);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(key);
+    if (it == slots_.end() || it->second.content_id != content_id) {
+        misses_++;
+        CoreMetrics::get().fact_cache_misses.add();
+        return std::nullopt;
+    }
+
+    const Slot& slot = it->second;
+    const uint8_t* value = value_locked(slot);
+    if (record_checksum(key, value, slot.size) != slot.checksum) {
+        spdlog::warn("Corrupt fact cache record for {}", key);
+        slots_.erase(it);
+        misses_++;
+        CoreMetrics::get().fact_cache_misses.add();
+        return std::nullopt;
+    }
+
+    nlohmann::json facts = nlohmann::json::from_cbor(value, value + slot.size, true, false);
+    if (facts.is_discarded()) {
+        spdlog::warn("Undecodable fact cache record for {}", key);
+        slots_.erase(it);
+        misses_++;
+        CoreMetrics::get().fact_cache_misses.add();
+        return std::nullopt;
+    }
+
+    hits_++;
+    CoreMetrics::get().fact_cache_hits.add();
+    return facts;
+}
+
+#ifdef __linux__
+
+FactCache::FactCache(const std::filesystem::path& directory)
+    : directory_(directory), file_(directory / "facts-v1.bin") {
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot create fact cache directory " + directory_.string() + ": " +
+                                 ec.message());
+    }
+
+    fd_ = ::open(file_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Cannot open fact cache " + file_.string() + ": " + std::strerror(errno));
+    }
+
+    bool compact_now = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ::flock(fd_, LOCK_EX);
+        try {
+            load_locked();
+        } catch (...) {
+            ::flock(fd_, LOCK_UN);
+            unmap_locked();
+            ::close(fd_);
+            throw;
+        }
+        ::flock(fd_, LOCK_UN);
+        compact_now = file_size_ > COMPACT_MIN_BYTES && dead_bytes_ * 2 > file_size_;
+    }
+
+    spdlog::info("Fact cache {}: {} entries, {} bytes", file_.string(), slots_.size(), file_size_);
+    if (compact_now) {
+        compact();
+    }
+}
+
+FactCache::~FactCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unmap_locked();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void FactCache::unmap_locked() {
+    if (map_) {
+        ::munmap(const_cast<uint8_t*>(map_), map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+}
+
+void FactCache::load_locked() {
+    unmap_locked();
+    slots_.clear();
+    dead_bytes_ = 0;
+
+    struct stat st{};
+    if (::fstat(fd_, &st) < 0) {
+        throw std::runtime_error("Cannot stat fact cache " + file_.string() + ": " + std::strerror(errno));
+    }
+    auto size = static_cast<size_t>(st.st_size);
+
+    std::string expected = encode_header(fingerprint());
+    if (size > 0) {
+        map_ = static_cast<const uint8_t*>(::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0));
+        if (map_ == MAP_FAILED) {
+            map_ = nullptr;
+            throw std::runtime_error("Cannot map fact cache " + file_.string() + ": " + std::strerror(errno));
+        }
+        map_size_ = size;
+    }
+
+    if (size < HEADER_SIZE || std::memcmp(map_, expected.data(), HEADER_SIZE) != 0) {
+        if (size > 0) {
+            spdlog::info("Discarding fact cache {} (other format, schema or grammar version)", file_.string());
+        }
+        unmap_locked();
+        if (size == 0) {
+            if (::write(fd_, expected.data(), expected.size()) != static_cast<ssize_t>(expected.size())) {
+                throw std::runtime_error("Cannot initialize fact cache " + file_.string() + ": " +
+                                         std::strerror(errno));
+            }
+        } else if (!replace_locked(expected)) {
+            throw std::runtime_error("Cannot initialize fact cache " + file_.string());
+        }
+        file_size_ = HEADER_SIZE;
+        return;
+    }
+
+    size_t offset = HEADER_SIZE;
+    while (offset + RECORD_HEADER_SIZE <= size) {
+        RecordHeader header;
+        std::memcpy(&header.key_size, map_ + offset, 4);
+        std::memcpy(&header.value_size, map_ + offset + 4, 4);
+        std::memcpy(&header.checksum, map_ + offset + 8, 4);
+        std::memcpy(header.content_id.bytes.data(), map_ + offset + 12, header.content_id.bytes.size());
+
+        uint64_t body = uint64_t(header.key_size) + header.value_size;
+        if (body > size - offset - RECORD_HEADER_SIZE) {
+            break;  // Torn append
+        }
+
+        std::string key(reinterpret_cast<const char*>(map_ + offset + RECORD_HEADER_SIZE), header.key_size);
+        Slot slot;
+        slot.content_id = header.content_id;
+        slot.checksum = header.checksum;
+        slot.offset = offset + RECORD_HEADER_SIZE + header.key_size;
+        slot.size = header.value_size;
+
+        auto [it, inserted] = slots_.try_emplace(std::move(key));
+        if (!inserted) {
+            dead_bytes_ += RECORD_HEADER_SIZE + it->first.size() + it->second.size;
+        }
+        it->second = std::move(slot);
+        offset += RECORD_HEADER_SIZE + body;
+    }
+
+    file_size_ = offset;
+    if (offset < size) {
+        spdlog::warn("Fact cache {}: dropping {} bytes of incomplete records", file_.string(), size - offset);
+        // Appends must follow the last complete record; copy those to a new file
+        if (replace_locked(std::string_view(reinterpret_cast<const char*>(map_), offset))) {
+            load_locked();
+        }
+    }
+}
+
+bool FactCache::replace_locked(std::string_view contents) {
+    // Never shrink the file in place: other processes may have it mapped,
+    // and touching a mapped page past the end of a file raises SIGBUS.
+    // They keep the old file until they reopen.
+    auto temp = file_;
+    temp += ".tmp";
+    int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        spdlog::warn("Cannot replace fact cache {}: {}", file_.string(), std::strerror(errno));
+        return false;
+    }
+    bool ok = ::write(out, contents.data(), contents.size()) == static_cast<ssize_t>(contents.size());
+    ok = ::close(out) == 0 && ok;
+
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(temp, file_, ec);
+    }
+    if (!ok || ec) {
+        spdlog::warn("Cannot replace fact cache {}", file_.string());
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+
+    int fd = ::open(file_.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (fd < 0) {
+        spdlog::warn("Cannot reopen fact cache {}: {}", file_.string(), std::strerror(errno));
+        return false;
+    }
+    // The caller holds the lock of the old file and releases that of fd_
+    ::flock(fd, LOCK_EX);
+    unmap_locked();
+    ::close(fd_);
+    fd_ = fd;
+    return true;
+}
+
+void FactCache::put(const std::filesystem::path& file,
+                    std::string_view kind,
+                    const ObjectId& content_id,
+                    const nlohmann::json& facts) {
+    std::string key = make_key(file, kind);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(key);
+    if (it != slots_.end() && it->second.content_id == content_id) {
+        return;  // Facts are a function of the content: already stored
+    }
+
+    std::vector<uint8_t> value = nlohmann::json::to_cbor(facts);
+    RecordHeader header;
+    header.key_size = static_cast<uint32_t>(key.size());
+    header.value_size = static_cast<uint32_t>(value.size());
+    header.checksum = record_checksum(key, value.data(), value.size());
+    header.content_id = content_id;
+
+    std::string record;
+    record.reserve(RECORD_HEADER_SIZE + key.size() + value.size());
+    append_record(record, key, header, value.data());
+
+    // One write() per record: O_APPEND keeps concurrent appenders apart
+    ::flock(fd_, LOCK_EX);
+    ssize_t written = ::write(fd_, record.data(), record.size());
+    ::flock(fd_, LOCK_UN);
+    if (written != static_cast<ssize_t>(record.size())) {
+        spdlog::warn("Cannot append to fact cache {}: {}", file_.string(),
+                     written < 0 ? std::strerror(errno) : "short write");
+        return;
+    }
+
+    if (it != slots_.end()) {
+        dead_bytes_ += RECORD_HEADER_SIZE + key.size() + it->second.size;
+    } else {
+        it = slots_.try_emplace(std::move(key)).first;
+    }
+    it->second.content_id = content_id;
+    it->second.checksum = header.checksum;
+    it->second.offset = 0;
+    it->second.size = header.value_size;
+    it->second.pending = std::move(value);
+
+    file_size_ += record.size();
+    writes_++;
+}
+
+void FactCache::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto temp = file_;
+    temp += ".tmp";
+    int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        spdlog::warn("Cannot compact fact cache {}: {}", file_.string(), std::strerror(errno));
+        return;
+    }
+
+    ::flock(fd_, LOCK_EX);
+
+    std::string buffer = encode_header(fingerprint());
+    size_t kept = 0;
+    size_t dropped = 0;
+    bool ok = true;
+    for (const auto& [key, slot] : slots_) {
+        std::error_code ec;
+        auto path = std::string_view(key).substr(key.find('\n') + 1);
+        if (!std::filesystem::exists(std::filesystem::path(path), ec)) {
+            dropped++;
+            continue;
+        }
+
+        RecordHeader header;
+        header.key_size = static_cast<uint32_t>(key.size());
+        header.value_size = slot.size;
+        header.checksum = slot.checksum;
+        header.content_id = slot.content_id;
+        append_record(buffer, key, header, value_locked(slot));
+        kept++;
+
+        if (buffer.size() >= (1 << 20)) {
+            ok = ok && ::write(out, buffer.data(), buffer.size()) == static_cast<ssize_t>(buffer.size());
+            buffer.clear();
+        }
+    }
+    ok = ok && ::write(out, buffer.data(), buffer.size()) == static_cast<ssize_t>(buffer.size());
+    ok = ::close(out) == 0 && ok;
+
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(temp, file_, ec);
+    }
+    ::flock(fd_, LOCK_UN);
+    if (!ok || ec) {
+        spdlog::warn("Cannot compact fact cache {}", file_.string());
+        std::filesystem::remove(temp, ec);
+        return;
+    }
+
+    // Switch to the new file
+    int fd = ::open(file_.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (fd < 0) {
+        spdlog::warn("Cannot reopen fact cache {}: {}", file_.string(), std::strerror(errno));
+        return;
+    }
+    unmap_locked();
+    ::close(fd_);
+    fd_ = fd;
+
+    uint64_t before = file_size_;
+    ::flock(fd_, LOCK_EX);
+    try {
+        load_locked();
+    } catch (const std::exception& e) {
+        spdlog::warn("{}", e.what());
+    }
+    ::flock(fd_, LOCK_UN);
+    spdlog::info("Compacted fact cache {}: {} -> {} bytes ({} entries, {} of deleted files dropped)",
+                 file_.string(), before, file_size_, kept, dropped);
+}
+
+#else // !__linux__
+
+FactCache::FactCache(const std::filesystem::path& directory)
+    : directory_(directory), file_(directory / "facts-v1.bin") {
+    throw std::runtime_error("The fact cache is only supported on Linux");
+}
+
+FactCache::~FactCache() = default;
+void FactCache::unmap_locked() {}
+void FactCache::load_locked() {}
+
+bool FactCache::replace_locked(std::string_view) { return false; }
+void FactCache::put(const std::filesystem::path&, std::string_view, const ObjectId&, const nlohmann::json&) {}
+void FactCache::compact() {}
+
+#endif
+
+} // namespace ts_mcp
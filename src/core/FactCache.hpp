@@ -0,0 +1,148 @@
+#pragma once
+
+#include "core/ContentHash.hpp"
+#include <nlohmann/json.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Persistent cache of facts derived from source files
+ *
+ * Stores the JSON results of per-file analyses (classes, functions,
+ * includes, summaries, interfaces, class info) keyed by file path and fact
+ * kind, and tagged with the git blob id of the content they were derived
+ * from. A lookup only hits if the file still has that content, so a
+ * restarted server answers for unchanged files without parsing them.
+ *
+ * On disk the cache is one append-only file (facts-v1.bin) of CBOR-encoded
+ * records behind a header carrying the format version and a fingerprint
+ * of the linked grammars and fact schema; a mismatching file is replaced
+ * (never truncated, as other processes may have it mapped).
+ * The file is memory-mapped on open and only the record headers are
+ * scanned; values are decoded when first requested. Superseded records
+ * are dropped by compaction when they make up most of the file.
+ *
+ * Several processes may share a cache directory: appends and compaction
+ * take an exclusive flock(), and each process sees the others' records
+ * after reopening. Linux only.
+ *
+ * Thread-safe.
+ */
+class FactCache {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // Bump whenever the shape of any cached fact changes
+    static constexpr uint32_t FACTS_VERSION = 1;
+
+    struct Stats {
+        size_t entries = 0;
+        uint64_t file_bytes = 0;
+        uint64_t dead_bytes = 0;  // Superseded records awaiting compaction
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t writes = 0;
+    };
+
+    /**
+     * @brief Open or create the cache in a directory
+     * @param directory Cache directory (created if missing)
+     * @throws std::runtime_error if the cache file cannot be opened
+     */
+    explicit FactCache(const std::filesystem::path& directory);
+    ~FactCache();
+
+    FactCache(const FactCache&) = delete;
+    FactCache& operator=(const FactCache&) = delete;
+
+    /**
+     * @brief Facts of a file, if stored for exactly this content
+     * @param file Source file (made absolute)
+     * @param kind Fact kind, including anything the facts depend on besides
+     *        the content (language, options)
+     * @param content_id Git blob id of the file's current content
+     */
+    std::optional<nlohmann::json> get(const std::filesystem::path& file,
+                                      std::string_view kind,
+                                      const ObjectId& content_id);
+
+    /**
+     * @brief Store facts of a file (replaces facts of older content)
+     */
+    void put(const std::filesystem::path& file,
+             std::string_view kind,
+             const ObjectId& content_id,
+             const nlohmann::json& facts);
+
+    /**
+     * @brief Rewrite the file with live records of files that still exist
+     */
+    void compact();
+
+    Stats stats() const;
+
+    const std::filesystem::path& file() const { return file_; }
+
+    /**
+     * @brief $XDG_CACHE_HOME/tree-sitter-mcp, or ~/.cache/tree-sitter-mcp
+     */
+    static std::filesystem::path default_directory();
+
+    /**
+     * @brief Fingerprint stored in the header: format, fact schema and grammars
+     */
+    static uint64_t fingerprint();
+
+private:
+    struct Slot {
+        ObjectId content_id;
+        uint32_t checksum = 0;
+        uint64_t offset = 0;         // Value offset in the mapping (if pending is empty)
+        uint32_t size = 0;           // Value size
+        std::vector<uint8_t> pending;  // Value appended since the file was mapped
+    };
+
+    /**
+     * @brief Map the file and index its records (discarding it if incompatible)
+     */
+    void load_locked();
+
+    /**
+     * @brief Atomically replace the file with contents and reopen it, locked
+     */
+    bool replace_locked(std::string_view contents);
+
+    void unmap_locked();
+
+    /**
+     * @brief Value bytes of a slot
+     */
+    const uint8_t* value_locked(const Slot& slot) const;
+
+    static std::string make_key(const std::filesystem::path& file, std::string_view kind);
+
+    mutable std::mutex mutex_;
+    std::filesystem::path directory_;
+    std::filesystem::path file_;
+    int fd_ = -1;
+    const uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    uint64_t file_size_ = 0;
+
+    std::unordered_map<std::string, Slot> slots_;
+    uint64_t dead_bytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t writes_ = 0;
+};
+
+} // namespace ts_mcp
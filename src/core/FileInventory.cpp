@@ -0,0 +1,427 @@
+#include "core/FileInventory.hpp"
+#include "core/MemoryAccounting.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace ts_mcp {
+
+namespace {
+
+// Directories modified this close to their listing may change again within
+// the same timestamp tick, so they are re-listed on the next refresh.
+constexpr int64_t RACY_WINDOW_NS = 2'000'000'000;
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Parent directory of a relative path ("a/b/c.cpp" and "a/b/c/" -> "a/b/")
+ */
+std::string parent_dir(std::string_view rel) {
+    if (!rel.empty() && rel.back() == '/') {
+        rel.remove_suffix(1);
+    }
+    size_t slash = rel.rfind('/');
+    return slash == std::string_view::npos ? std::string() : std::string(rel.substr(0, slash + 1));
+}
+
+/**
+ * @brief Last component of a relative path, without trailing '/'
+ */
+std::string_view name_of(std::string_view rel) {
+    if (!rel.empty() && rel.back() == '/') {
+        rel.remove_suffix(1);
+    }
+    size_t slash = rel.rfind('/');
+    return slash == std::string_view::npos ? rel : rel.substr(slash + 1);
+}
+
+bool is_ignore_file(std::string_view name) {
+    return name == ".gitignore" || name == ".ignore";
+}
+
+bool starts_with(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+const std::string& key_of(const std::string& key) { return key; }
+
+template <typename Pair>
+const std::string& key_of(const Pair& pair) { return pair.first; }
+
+/**
+ * @brief Erase all keys starting with prefix from a sorted map or set
+ */
+template <typename Container>
+size_t erase_prefix(Container& container, const std::string& prefix) {
+    auto first = container.lower_bound(prefix);
+    auto last = first;
+    size_t count = 0;
+    while (last != container.end() && starts_with(key_of(*last), prefix)) {
+        ++last;
+        ++count;
+    }
+    container.erase(first, last);
+    return count;
+}
+
+} // namespace
+
+FileInventory::FileInventory(std::filesystem::path root, WalkOptions options)
+    : root_(std::move(root)), walker_([&options] {
+          options.recursive = true;
+          return std::move(options);
+      }()) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(root_, ec)) {
+        throw std::runtime_error("Inventory root is not a directory: " + root_.string());
+    }
+
+    root_str_ = root_.string();
+    if (root_str_.empty() || root_str_.back() != '/') {
+        root_str_ += '/';
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    rebuild_locked();
+}
+
+void FileInventory::rebuild_locked() {
+    auto start = std::chrono::steady_clock::now();
+
+    std::unordered_map<std::string, uint32_t> old_ids;
+    old_ids.reserve(files_.size());
+    for (const auto& [rel, info] : files_) {
+        old_ids.emplace(rel, info.id);
+    }
+
+    files_.clear();
+    dirs_.clear();
+    ignore_mtimes_.clear();
+    dirty_dirs_.clear();
+
+    auto entries = walker_.scan(root_);
+    RefreshStats stats;
+    apply_scan_locked(entries, stats);
+
+    // Keep path ids stable across rebuilds
+    for (auto& [rel, info] : files_) {
+        auto it = old_ids.find(rel);
+        if (it != old_ids.end()) {
+            info.id = it->second;
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    spdlog::debug("Built file inventory for {}: {} files, {} directories in {}ms",
+                  root_.string(), files_.size(), dirs_.size(), elapsed.count());
+}
+
+void FileInventory::upsert_file_locked(const std::string& rel_path,
+                                       const WalkEntry& entry,
+                                       RefreshStats& stats) {
+    auto it = files_.find(rel_path);
+    if (it != files_.end()) {
+        it->second.size = entry.size;
+        it->second.mtime_ns = entry.mtime_ns;
+        return;
+    }
+
+    FileInfo info;
+    info.id = next_id_++;
+    info.size = entry.size;
+    info.mtime_ns = entry.mtime_ns;
+    info.language = LanguageUtils::detect_from_extension(std::string_view(rel_path));
+    files_.emplace(rel_path, info);
+    stats.files_added++;
+}
+
+void FileInventory::erase_subtree_locked(const std::string& rel_dir, RefreshStats& stats) {
+    stats.files_removed += erase_prefix(files_, rel_dir);
+    erase_prefix(dirs_, rel_dir);
+    erase_prefix(ignore_mtimes_, rel_dir);
+    erase_prefix(dirty_dirs_, rel_dir);
+}
+
+bool FileInventory::apply_scan_locked(std::vector<WalkEntry>& entries, RefreshStats& stats) {
+    // Group entries under the directories that were listed in this scan
+    std::map<std::string, const WalkEntry*> listed;
+    std::map<std::string, std::vector<const WalkEntry*>> children;
+
+    for (const auto& entry : entries) {
+        if (entry.is_dir && entry.listed) {
+            listed.emplace(entry.rel_path, &entry);
+        }
+        if (!entry.rel_path.empty()) {
+            children[parent_dir(entry.rel_path)].push_back(&entry);
+        }
+    }
+
+    const int64_t listed_at = now_ns();
+    bool ignore_changed = false;
+
+    for (const auto& [rel_dir, self] : listed) {
+        DirInfo fresh;
+        fresh.mtime_ns = self->mtime_ns;
+        fresh.inode = self->inode;
+        fresh.racy = listed_at - self->mtime_ns < RACY_WINDOW_NS;
+
+        auto child_it = children.find(rel_dir);
+        if (child_it != children.end()) {
+            for (const WalkEntry* child : child_it->second) {
+                std::string name(name_of(child->rel_path));
+                if (child->is_dir) {
+                    fresh.subdirs.push_back(std::move(name));
+                    continue;
+                }
+
+                upsert_file_locked(child->rel_path, *child, stats);
+                if (is_ignore_file(name)) {
+                    auto old = ignore_mtimes_.find(child->rel_path);
+                    if (old != ignore_mtimes_.end() && old->second != child->mtime_ns) {
+                        ignore_changed = true;
+                    }
+                    ignore_mtimes_[child->rel_path] = child->mtime_ns;
+                    fresh.ignore_files.push_back(name);
+                }
+                fresh.files.push_back(std::move(name));
+            }
+        }
+
+        std::sort(fresh.files.begin(), fresh.files.end());
+        std::sort(fresh.subdirs.begin(), fresh.subdirs.end());
+        std::sort(fresh.ignore_files.begin(), fresh.ignore_files.end());
+
+        auto old_it = dirs_.find(rel_dir);
+        if (old_it != dirs_.end()) {
+            const DirInfo& old = old_it->second;
+
+            // Rules of a new, removed or edited ignore file apply to the whole subtree
+            if (old.ignore_files != fresh.ignore_files) {
+                ignore_changed = true;
+            }
+
+            for (const auto& name : old.files) {
+                if (!std::binary_search(fresh.files.begin(), fresh.files.end(), name)) {
+                    std::string rel = rel_dir + name;
+                    if (files_.erase(rel) > 0) {
+                        stats.files_removed++;
+                    }
+                    ignore_mtimes_.erase(rel);
+                }
+            }
+            for (const auto& name : old.subdirs) {
+                if (!std::binary_search(fresh.subdirs.begin(), fresh.subdirs.end(), name)) {
+                    erase_subtree_locked(rel_dir + name + "/", stats);
+                }
+            }
+        }
+
+        dirs_[rel_dir] = std::move(fresh);
+        dirty_dirs_.erase(rel_dir);
+        stats.directories_relisted++;
+    }
+
+    return ignore_changed;
+}
+
+FileInventory::RefreshStats FileInventory::refresh(bool check_directories) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RefreshStats stats;
+
+    std::set<std::string, std::less<>> dirty = std::move(dirty_dirs_);
+    dirty_dirs_.clear();
+
+    check_directories = check_directories || full_check_pending_;
+    full_check_pending_ = false;
+
+    for (const auto& [rel_dir, info] : dirs_) {
+        if (!check_directories) {
+            break;
+        }
+        stats.directories_checked++;
+        WalkEntry current;
+        if (!DirectoryWalker::stat_path(root_str_ + rel_dir, current) || !current.is_dir) {
+            if (rel_dir.empty()) {
+                spdlog::debug("Inventory root {} disappeared", root_.string());
+                erase_subtree_locked("", stats);
+                return stats;
+            }
+            dirty.insert(parent_dir(rel_dir));
+            continue;
+        }
+        if (info.racy || current.mtime_ns != info.mtime_ns || current.inode != info.inode) {
+            dirty.insert(rel_dir);
+        }
+    }
+
+    // In-place edits of ignore files do not touch the directory mtime
+    bool rebuild = false;
+    for (const auto& [rel, mtime] : ignore_mtimes_) {
+        if (!check_directories) {
+            break;
+        }
+        WalkEntry current;
+        if (DirectoryWalker::stat_path(root_str_ + rel, current) && current.mtime_ns != mtime) {
+            rebuild = true;
+            break;
+        }
+    }
+
+    if (!rebuild && !dirty.empty()) {
+        // Enter dirty directories, their ancestors, and anything not seen before
+        std::set<std::string, std::less<>> ancestors;
+        for (const auto& rel_dir : dirty) {
+            for (size_t slash = rel_dir.find('/'); slash != std::string::npos;
+                 slash = rel_dir.find('/', slash + 1)) {
+                ancestors.insert(rel_dir.substr(0, slash + 1));
+            }
+        }
+
+        auto entries = walker_.scan(root_, [&](std::string_view rel_dir) {
+            return dirty.find(rel_dir) != dirty.end() ||
+                   ancestors.find(rel_dir) != ancestors.end() ||
+                   dirs_.find(rel_dir) == dirs_.end();
+        });
+        rebuild = apply_scan_locked(entries, stats);
+    }
+
+    if (rebuild) {
+        spdlog::debug("Ignore rules changed under {}, rebuilding inventory", root_.string());
+        size_t before = files_.size();
+        rebuild_locked();
+        stats.rebuilt = true;
+        stats.files_added = files_.size() > before ? files_.size() - before : 0;
+        stats.files_removed = before > files_.size() ? before - files_.size() : 0;
+    }
+
+    if (stats.directories_relisted > 0 || stats.rebuilt) {
+        spdlog::debug("Refreshed inventory {}: {} dirs checked, {} relisted, +{} -{} files",
+                      root_.string(), stats.directories_checked, stats.directories_relisted,
+                      stats.files_added, stats.files_removed);
+    }
+    return stats;
+}
+
+void FileInventory::notify_changed(const std::filesystem::path& path) {
+    std::string abs = path.lexically_normal().string();
+    std::string_view root_view(root_str_);
+    root_view.remove_suffix(1);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (abs == root_view) {
+        dirty_dirs_.insert("");
+        return;
+    }
+    if (!starts_with(abs, root_str_)) {
+        return;
+    }
+
+    std::string rel = abs.substr(root_str_.size());
+    if (!rel.empty() && rel.back() == '/') {
+        rel.pop_back();
+    }
+
+    // A changed directory needs its own listing and its parent's
+    if (dirs_.find(rel + "/") != dirs_.end()) {
+        dirty_dirs_.insert(rel + "/");
+    }
+    dirty_dirs_.insert(parent_dir(rel));
+}
+
+std::vector<std::filesystem::path> FileInventory::query(std::string_view rel_dir,
+                                                        bool recursive,
+                                                        const GlobSet& globs) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::filesystem::path> results;
+
+    for (auto it = files_.lower_bound(rel_dir);
+         it != files_.end() && starts_with(it->first, rel_dir); ++it) {
+        std::string_view sub = std::string_view(it->first).substr(rel_dir.size());
+        size_t slash = sub.rfind('/');
+        if (!recursive && slash != std::string_view::npos) {
+            continue;
+        }
+        std::string_view name = slash == std::string_view::npos ? sub : sub.substr(slash + 1);
+        if (globs.matches(sub, name)) {
+            results.emplace_back(root_str_ + it->first);
+        }
+    }
+
+    return results;
+}
+
+void FileInventory::invalidate_all() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    full_check_pending_ = true;
+}
+
+std::vector<std::string> FileInventory::directories() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> result;
+    result.reserve(dirs_.size());
+    for (const auto& [rel_dir, info] : dirs_) {
+        result.push_back(rel_dir);
+    }
+    return result;
+}
+
+bool FileInventory::contains_directory(std::string_view rel_dir) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dirs_.find(rel_dir) != dirs_.end();
+}
+
+std::optional<FileInventory::FileInfo> FileInventory::find(std::string_view rel_path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(rel_path);
+    if (it == files_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+size_t FileInventory::file_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return files_.size();
+}
+
+size_t FileInventory::directory_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dirs_.size();
+}
+
+size_t FileInventory::memory_bytes() const {
+    auto names_bytes = [](const std::vector<std::string>& names) {
+        size_t bytes = names.capacity() * sizeof(std::string);
+        for (const auto& name : names) {
+            bytes += heap_bytes(name);
+        }
+        return bytes;
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = 0;
+    for (const auto& [path, info] : files_) {
+        bytes += TREE_NODE_OVERHEAD + sizeof(std::pair<const std::string, FileInfo>) + heap_bytes(path);
+    }
+    for (const auto& [path, info] : dirs_) {
+        bytes += TREE_NODE_OVERHEAD + sizeof(std::pair<const std::string, DirInfo>) + heap_bytes(path) +
+                 names_bytes(info.files) + names_bytes(info.subdirs) + names_bytes(info.ignore_files);
+    }
+    for (const auto& [path, mtime] : ignore_mtimes_) {
+        bytes += TREE_NODE_OVERHEAD + sizeof(std::pair<const std::string, int64_t>) + heap_bytes(path);
+    }
+    for (const auto& path : dirty_dirs_) {
+        bytes += TREE_NODE_OVERHEAD + sizeof(std::string) + heap_bytes(path);
+    }
+    return bytes;
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "core/DirectoryWalker.hpp"
+#include "core/GlobMatcher.hpp"
+#include "core/Language.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Resident, incrementally refreshed listing of a workspace directory
+ *
+ * Holds every non-ignored file below a root (as DirectoryWalker sees it)
+ * with a stable path id, size, mtime and detected language, so glob and
+ * recursive queries are answered from memory instead of a directory walk.
+ *
+ * refresh() re-stats each known directory (one stat per directory, not per
+ * file) and re-lists only directories whose mtime or inode changed, plus
+ * new subdirectories. A change to a .gitignore/.ignore file rebuilds the
+ * whole inventory because rules apply to entire subtrees.
+ *
+ * Directory mtimes do not change when a file is edited in place, so file
+ * size/mtime are as of the last listing of their directory; notify_changed()
+ * lets an external watcher update them eagerly.
+ *
+ * Thread-safe: all public methods take an internal mutex.
+ */
+class FileInventory {
+public:
+    struct FileInfo {
+        uint32_t id = 0;         // Stable for the lifetime of the inventory
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+        Language language = Language::UNKNOWN;
+    };
+
+    struct RefreshStats {
+        size_t directories_checked = 0;
+        size_t directories_relisted = 0;
+        size_t files_added = 0;
+        size_t files_removed = 0;
+        bool rebuilt = false;
+    };
+
+    /**
+     * @brief Build the inventory with a full walk
+     * @param root Canonical directory path
+     * @param options Walk options (recursive is forced on)
+     * @throws std::runtime_error if root is not a directory
+     */
+    explicit FileInventory(std::filesystem::path root, WalkOptions options = {});
+
+    /**
+     * @brief Bring the inventory up to date with the filesystem
+     * @param check_directories Re-stat every known directory. Pass false when
+     *        a FileWatcher reports all changes through notify_changed(); only
+     *        directories marked dirty are then re-listed.
+     */
+    RefreshStats refresh(bool check_directories = true);
+
+    /**
+     * @brief Force the next refresh() to re-stat every directory
+     *
+     * Used when change notifications were lost (inotify queue overflow).
+     */
+    void invalidate_all();
+
+    /**
+     * @brief All directories entered by the walk ("" or "a/b/")
+     */
+    std::vector<std::string> directories() const;
+
+    /**
+     * @brief Mark a path as changed (e.g. from a file watcher)
+     *
+     * The containing directory is re-listed on the next refresh(). Paths
+     * outside the root are ignored.
+     */
+    void notify_changed(const std::filesystem::path& path);
+
+    /**
+     * @brief Query files below a directory of the inventory
+     *
+     * @param rel_dir Directory relative to the root ("" or "a/b/")
+     * @param recursive Include files in subdirectories
+     * @param globs Patterns; path patterns are matched relative to rel_dir
+     * @return Absolute paths (root / relative path), unordered
+     */
+    std::vector<std::filesystem::path> query(std::string_view rel_dir,
+                                             bool recursive,
+                                             const GlobSet& globs) const;
+
+    /**
+     * @brief Check whether a directory was entered by the walk
+     * @param rel_dir Directory relative to the root ("" or "a/b/")
+     */
+    bool contains_directory(std::string_view rel_dir) const;
+
+    /**
+     * @brief Look up a file by path relative to the root
+     */
+    std::optional<FileInfo> find(std::string_view rel_path) const;
+
+    const std::filesystem::path& root() const { return root_; }
+    size_t file_count() const;
+    size_t directory_count() const;
+
+    /**
+     * @brief Estimated heap bytes of the listing
+     */
+    size_t memory_bytes() const;
+
+private:
+    struct DirInfo {
+        int64_t mtime_ns = 0;
+        uint64_t inode = 0;
+        bool racy = false;                    // mtime too close to listing time to trust
+        std::vector<std::string> files;       // Direct child file names
+        std::vector<std::string> subdirs;     // Direct child directory names
+        std::vector<std::string> ignore_files; // .gitignore/.ignore present in this directory
+    };
+
+    /**
+     * @brief Replace the whole inventory with a fresh full scan
+     */
+    void rebuild_locked();
+
+    /**
+     * @brief Merge a partial scan into the inventory
+     * @return true if an ignore file changed and a rebuild is required
+     */
+    bool apply_scan_locked(std::vector<WalkEntry>& entries, RefreshStats& stats);
+
+    /**
+     * @brief Remove a directory and everything below it
+     */
+    void erase_subtree_locked(const std::string& rel_dir, RefreshStats& stats);
+
+    void upsert_file_locked(const std::string& rel_path, const WalkEntry& entry, RefreshStats& stats);
+
+    mutable std::mutex mutex_;
+    std::filesystem::path root_;
+    std::string root_str_;                  // root_ with trailing '/'
+    DirectoryWalker walker_;
+
+    std::map<std::string, FileInfo, std::less<>> files_;  // Key: path relative to root
+    std::map<std::string, DirInfo, std::less<>> dirs_;    // Key: "" or "a/b/"
+    std::map<std::string, int64_t, std::less<>> ignore_mtimes_;  // Ignore file -> mtime
+    std::set<std::string, std::less<>> dirty_dirs_;
+    bool full_check_pending_ = false;
+    uint32_t next_id_ = 0;
+};
+
+} // namespace ts_mcp
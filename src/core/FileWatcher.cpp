@@ -0,0 +1,360 @@
+#include "core/FileWatcher.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace ts_mcp {
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t WATCH_MASK =
+    IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO |
+    IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+// A continuous stream of events is still delivered at this multiple of the debounce
+constexpr int MAX_DELAY_FACTOR = 10;
+
+} // namespace
+
+FileWatcher::FileWatcher(std::filesystem::path root,
+                         std::chrono::milliseconds debounce,
+                         WalkOptions options)
+    : root_(std::move(root)), debounce_(debounce), options_(std::move(options)) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(root_, ec)) {
+        throw std::runtime_error("Watch root is not a directory: " + root_.string());
+    }
+
+    root_str_ = root_.string();
+    if (root_str_.size() > 1 && root_str_.back() == '/') {
+        root_str_.pop_back();
+    }
+    options_.recursive = true;
+
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        throw std::runtime_error(std::string("inotify_init1 failed: ") + std::strerror(errno));
+    }
+
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        ::close(inotify_fd_);
+        throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(errno));
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    stop();
+    ::close(inotify_fd_);
+    ::close(wake_fd_);
+}
+
+void FileWatcher::add_listener(Listener listener) {
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    listeners_.push_back(std::move(listener));
+}
+
+void FileWatcher::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    healthy_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        add_watches_locked(root_str_);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    spdlog::info("Watching {} ({} directories, {}ms)", root_str_, watch_count(), elapsed.count());
+
+    thread_ = std::thread([this] { run(); });
+}
+
+void FileWatcher::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    uint64_t one = 1;
+    if (::write(wake_fd_, &one, sizeof(one)) < 0) {
+        spdlog::debug("Failed to wake watcher thread: {}", std::strerror(errno));
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    healthy_ = false;
+}
+
+bool FileWatcher::is_watching(const std::filesystem::path& dir) const {
+    std::string key = dir.string();
+    if (key.size() > 1 && key.back() == '/') {
+        key.pop_back();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return watched_dirs_.count(key) > 0;
+}
+
+size_t FileWatcher::watch_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return watches_.size();
+}
+
+void FileWatcher::add_watches_locked(const std::string& dir) {
+    std::vector<std::string> dirs{dir};
+    std::mutex dirs_mutex;
+
+    // Reuse the walker for exclusions and ignore rules; files are not collected
+    DirectoryWalker walker(options_);
+    walker.walk(
+        dir,
+        [](std::string_view, std::string_view) { return false; },
+        [&](std::string_view rel_dir) {
+            std::string path = dir + "/" + std::string(rel_dir.substr(0, rel_dir.size() - 1));
+            std::lock_guard<std::mutex> lock(dirs_mutex);
+            dirs.push_back(std::move(path));
+            return true;
+        });
+
+    for (const auto& path : dirs) {
+        int wd = ::inotify_add_watch(inotify_fd_, path.c_str(), WATCH_MASK);
+        if (wd < 0) {
+            if (errno == ENOSPC) {
+                spdlog::warn("inotify watch limit reached at {} "
+                             "(raise fs.inotify.max_user_watches); falling back to stat checks",
+                             path);
+                healthy_ = false;
+                return;
+            }
+            // Directory vanished or is unreadable: its parent reports the change
+            continue;
+        }
+        watches_[wd] = path;
+        watched_dirs_.insert(path);
+    }
+}
+
+void FileWatcher::remove_watches_locked(const std::string& dir) {
+    const std::string prefix = dir + "/";
+    for (auto it = watches_.begin(); it != watches_.end();) {
+        const std::string& path = it->second;
+        if (path == dir || path.compare(0, prefix.size(), prefix) == 0) {
+            ::inotify_rm_watch(inotify_fd_, it->first);
+            watched_dirs_.erase(path);
+            it = watches_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool FileWatcher::drain_events_locked() {
+    alignas(struct inotify_event) char buf[64 * 1024];
+    auto now = std::chrono::steady_clock::now();
+
+    auto note = [&](std::string path) {
+        if (pending_.empty() && !pending_overflow_) {
+            first_pending_ = now;
+        }
+        last_event_ = now;
+        pending_.insert(std::move(path));
+    };
+
+    while (true) {
+        ssize_t n = ::read(inotify_fd_, buf, sizeof(buf));
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            spdlog::error("Reading inotify events failed: {}", std::strerror(errno));
+            return false;
+        }
+        if (n == 0) {
+            return true;
+        }
+
+        for (ssize_t offset = 0; offset < n;) {
+            auto* event = reinterpret_cast<const struct inotify_event*>(buf + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                spdlog::warn("inotify queue overflowed, invalidating all watched state");
+                if (pending_.empty() && !pending_overflow_) {
+                    first_pending_ = now;
+                }
+                last_event_ = now;
+                pending_overflow_ = true;
+                continue;
+            }
+
+            auto it = watches_.find(event->wd);
+            if (it == watches_.end()) {
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED) {
+                watched_dirs_.erase(it->second);
+                watches_.erase(it);
+                continue;
+            }
+
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                if (it->second == root_str_) {
+                    spdlog::warn("Watch root {} was removed or moved", root_str_);
+                    healthy_ = false;
+                }
+                continue;  // The parent directory reports the entry change
+            }
+
+            std::string path = it->second;
+            if (event->len > 0) {
+                path += '/';
+                path += event->name;
+            }
+
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & IN_MOVED_FROM) {
+                    remove_watches_locked(path);
+                } else if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    bool excluded = std::find(options_.excluded_dir_names.begin(),
+                                              options_.excluded_dir_names.end(),
+                                              std::string_view(event->name)) !=
+                                    options_.excluded_dir_names.end();
+                    if (!excluded) {
+                        add_watches_locked(path);
+                    }
+                }
+            }
+
+            note(std::move(path));
+        }
+    }
+}
+
+void FileWatcher::flush() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+
+    ChangeBatch batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty() && !pending_overflow_) {
+            return;
+        }
+        batch.paths.assign(pending_.begin(), pending_.end());
+        batch.overflow = pending_overflow_;
+        pending_.clear();
+        pending_overflow_ = false;
+    }
+
+    spdlog::debug("Delivering {} changed paths{}", batch.paths.size(),
+                  batch.overflow ? " (overflow)" : "");
+
+    for (const auto& listener : listeners_) {
+        try {
+            listener(batch);
+        } catch (const std::exception& e) {
+            spdlog::warn("File change listener failed: {}", e.what());
+        }
+    }
+
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void FileWatcher::sync() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!drain_events_locked()) {
+            healthy_ = false;
+        }
+    }
+    flush();
+}
+
+void FileWatcher::run() {
+    const auto max_delay = debounce_ * MAX_DELAY_FACTOR;
+
+    while (running_.load(std::memory_order_acquire)) {
+        int timeout_ms = -1;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!pending_.empty() || pending_overflow_) {
+                auto now = std::chrono::steady_clock::now();
+                auto remaining = std::min(debounce_ - (now - last_event_),
+                                          max_delay - (now - first_pending_));
+                timeout_ms = static_cast<int>(std::max<int64_t>(
+                    0, std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count()));
+            }
+        }
+
+        struct pollfd fds[2] = {
+            {inotify_fd_, POLLIN, 0},
+            {wake_fd_, POLLIN, 0},
+        };
+        int ready = ::poll(fds, 2, timeout_ms);
+        if (ready < 0 && errno != EINTR) {
+            spdlog::error("poll() on inotify failed: {}", std::strerror(errno));
+            healthy_ = false;
+            return;
+        }
+        if (!running_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        bool due = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ready > 0 && (fds[0].revents & POLLIN) && !drain_events_locked()) {
+                healthy_ = false;
+                return;
+            }
+            if (!pending_.empty() || pending_overflow_) {
+                auto now = std::chrono::steady_clock::now();
+                due = now - last_event_ >= debounce_ || now - first_pending_ >= max_delay;
+            }
+        }
+
+        if (due) {
+            flush();
+        }
+    }
+}
+
+#else // !__linux__
+
+FileWatcher::FileWatcher(std::filesystem::path root,
+                         std::chrono::milliseconds debounce,
+                         WalkOptions options)
+    : root_(std::move(root)), debounce_(debounce), options_(std::move(options)) {
+    throw std::runtime_error("File watching is only supported on Linux");
+}
+
+FileWatcher::~FileWatcher() = default;
+void FileWatcher::add_listener(Listener) {}
+void FileWatcher::start() {}
+void FileWatcher::stop() {}
+void FileWatcher::sync() {}
+bool FileWatcher::is_watching(const std::filesystem::path&) const { return false; }
+size_t FileWatcher::watch_count() const { return 0; }
+
+#endif
+
+} // namespace ts_mcp
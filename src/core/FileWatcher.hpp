@@ -0,0 +1,156 @@
+#pragma once
+
+#include "core/DirectoryWalker.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief A coalesced set of filesystem changes delivered to listeners
+ */
+struct ChangeBatch {
+    std::vector<std::filesystem::path> paths;  // Changed files and directories (absolute, sorted)
+    bool overflow = false;                     // Events were lost: treat everything as changed
+};
+
+/**
+ * @brief Recursive inotify watcher for a workspace directory
+ *
+ * A background thread reads inotify events for every directory below the
+ * root (skipping WalkOptions::excluded_dir_names and ignored directories),
+ * coalesces them, and delivers a ChangeBatch to listeners once the tree has
+ * been quiet for the debounce interval. New directories are watched as they
+ * appear.
+ *
+ * Consumers that trust the watcher instead of stat()ing files call sync()
+ * at the start of each operation: it picks up events that are already
+ * queued and flushes them synchronously, so a change that completed before
+ * the call is always visible to it.
+ *
+ * Listeners run on the watcher thread or on the thread calling sync(), with
+ * no watcher lock held, and must not call sync() themselves. Callers of
+ * sync() must not hold locks their listeners take.
+ *
+ * Linux only; the constructor throws elsewhere.
+ */
+class FileWatcher {
+public:
+    using Listener = std::function<void(const ChangeBatch& batch)>;
+
+    /**
+     * @brief Create a watcher (not yet started)
+     * @param root Canonical directory to watch
+     * @param debounce Quiet period before a batch is delivered
+     * @param options Walk options used to pick directories to watch
+     * @throws std::runtime_error if inotify is unavailable or root is not a directory
+     */
+    explicit FileWatcher(std::filesystem::path root,
+                         std::chrono::milliseconds debounce = std::chrono::milliseconds(50),
+                         WalkOptions options = {});
+
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Register a listener (call before start())
+     */
+    void add_listener(Listener listener);
+
+    /**
+     * @brief Add watches for the whole tree and start the background thread
+     */
+    void start();
+
+    /**
+     * @brief Stop the background thread (idempotent)
+     */
+    void stop();
+
+    /**
+     * @brief Deliver all events queued so far before returning
+     */
+    void sync();
+
+    /**
+     * @brief True while every change below root is guaranteed to be reported
+     *
+     * Becomes false if the watch limit is hit, inotify fails, or the
+     * watcher is stopped. Consumers fall back to stat-based checks then.
+     */
+    bool healthy() const { return healthy_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Check whether changes directly inside a directory are reported
+     * @param dir Absolute directory path (as below root, no trailing '/')
+     */
+    bool is_watching(const std::filesystem::path& dir) const;
+
+    const std::filesystem::path& root() const { return root_; }
+
+    /**
+     * @brief Number of batches delivered so far
+     */
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    size_t watch_count() const;
+
+private:
+    void run();
+
+    /**
+     * @brief Read all queued inotify events into pending_ (caller holds mutex_)
+     * @return false on a fatal read error
+     */
+    bool drain_events_locked();
+
+    /**
+     * @brief Watch a directory and all non-excluded directories below it (caller holds mutex_)
+     */
+    void add_watches_locked(const std::string& dir);
+
+    void remove_watches_locked(const std::string& dir);
+
+    /**
+     * @brief Deliver pending changes to listeners
+     */
+    void flush();
+
+    std::filesystem::path root_;
+    std::string root_str_;                  // root_ without trailing '/'
+    std::chrono::milliseconds debounce_;
+    WalkOptions options_;
+
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1;                      // eventfd used to interrupt poll() on stop()
+
+    mutable std::mutex mutex_;              // Guards watches_, pending_, inotify reads
+    std::unordered_map<int, std::string> watches_;  // Watch descriptor -> directory path
+    std::unordered_set<std::string> watched_dirs_;
+    std::set<std::string> pending_;
+    bool pending_overflow_ = false;
+    std::chrono::steady_clock::time_point first_pending_;
+    std::chrono::steady_clock::time_point last_event_;
+
+    std::mutex flush_mutex_;                // Serializes deliveries
+    std::vector<Listener> listeners_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> healthy_{false};
+    std::atomic<uint64_t> generation_{0};
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,419 @@
+#include "core/GitIndex.hpp"
+#include "core/MemoryAccounting.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ts_mcp {
+
+namespace {
+
+constexpr size_t HEADER_SIZE = 12;
+constexpr size_t CHECKSUM_SIZE = 20;
+constexpr size_t ENTRY_FIXED_SIZE = 62;  // Stat data, oid and flags before the name
+
+constexpr uint16_t FLAG_EXTENDED = 0x4000;
+constexpr uint16_t FLAG_STAGE_MASK = 0x3000;
+constexpr uint16_t NAME_LENGTH_MASK = 0x0FFF;
+constexpr uint16_t EXT_FLAG_SKIP_WORKTREE = 0x4000;
+constexpr uint16_t EXT_FLAG_INTENT_TO_ADD = 0x2000;
+
+constexpr uint32_t MODE_TYPE_MASK = 0170000;
+constexpr uint32_t MODE_REGULAR = 0100000;
+constexpr uint32_t MODE_DIRECTORY = 0040000;
+
+uint32_t read_be32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+uint16_t read_be16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+/**
+ * @brief Decode git's offset varint (index v4 prefix lengths)
+ */
+bool read_varint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    if (p >= end) {
+        return false;
+    }
+    uint8_t c = *p++;
+    value = c & 0x7F;
+    while (c & 0x80) {
+        if (p >= end || value > (UINT64_MAX >> 7)) {
+            return false;
+        }
+        c = *p++;
+        value = ((value + 1) << 7) | (c & 0x7F);
+    }
+    return true;
+}
+
+#ifdef __linux__
+/**
+ * @brief Read-only mapping of a whole file
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::runtime_error("Cannot open " + path.string() + ": " + std::strerror(errno));
+        }
+        if (::fstat(fd_, &st_) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("Cannot stat " + path.string() + ": " + std::strerror(errno));
+        }
+        size_ = static_cast<size_t>(st_.st_size);
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd_);
+                throw std::runtime_error("Cannot map " + path.string() + ": " + std::strerror(errno));
+            }
+            data_ = static_cast<const uint8_t*>(addr);
+        }
+    }
+
+    ~MappedFile() {
+        if (data_) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+        ::close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const struct stat& stat() const { return st_; }
+
+private:
+    int fd_ = -1;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    struct stat st_{};
+};
+#endif
+
+} // namespace
+
+GitIndex::GitIndex(std::filesystem::path work_tree, WalkOptions options)
+    : work_tree_(std::move(work_tree)), options_(std::move(options)) {
+    work_tree_str_ = work_tree_.string();
+    if (work_tree_str_.empty() || work_tree_str_.back() != '/') {
+        work_tree_str_ += '/';
+    }
+
+    auto index_path = locate_index(work_tree_);
+    if (!index_path) {
+        throw std::runtime_error("No git index in " + work_tree_.string());
+    }
+    index_path_ = *index_path;
+
+#ifdef __linux__
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file(index_path_);
+    index_size_ = static_cast<uint64_t>(file.stat().st_size);
+    index_inode_ = static_cast<uint64_t>(file.stat().st_ino);
+    index_mtime_ns_ = static_cast<int64_t>(file.stat().st_mtim.tv_sec) * 1000000000 +
+                      file.stat().st_mtim.tv_nsec;
+
+    parse(file.data(), file.size());
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    spdlog::debug("Loaded git index {} (v{}, {} files, {}us)",
+                  index_path_.string(), version_, entries_.size(), elapsed.count());
+#else
+    throw std::runtime_error("Reading the git index is only supported on Linux");
+#endif
+}
+
+std::optional<std::filesystem::path> GitIndex::find_work_tree(const std::filesystem::path& dir) {
+    std::error_code ec;
+    for (auto current = dir; ; current = current.parent_path()) {
+        if (std::filesystem::exists(current / ".git", ec)) {
+            return current;
+        }
+        if (!current.has_relative_path()) {
+            return std::nullopt;
+        }
+    }
+}
+
+std::optional<std::filesystem::path> GitIndex::locate_index(const std::filesystem::path& work_tree) {
+    std::error_code ec;
+    auto dot_git = work_tree / ".git";
+
+    if (std::filesystem::is_directory(dot_git, ec)) {
+        auto index = dot_git / "index";
+        if (std::filesystem::is_regular_file(index, ec)) {
+            return index;
+        }
+        return std::nullopt;
+    }
+
+    // Linked worktrees and submodules: ".git" is a file "gitdir: <path>"
+    std::ifstream file(dot_git);
+    std::string line;
+    if (!file || !std::getline(file, line) || line.rfind("gitdir:", 0) != 0) {
+        return std::nullopt;
+    }
+    std::string target = line.substr(7);
+    target.erase(0, target.find_first_not_of(" \t"));
+    while (!target.empty() && (target.back() == '\r' || target.back() == ' ')) {
+        target.pop_back();
+    }
+
+    std::filesystem::path git_dir(target);
+    if (git_dir.is_relative()) {
+        git_dir = work_tree / git_dir;
+    }
+    auto index = git_dir / "index";
+    if (std::filesystem::is_regular_file(index, ec)) {
+        return index;
+    }
+    return std::nullopt;
+}
+
+void GitIndex::parse(const uint8_t* data, size_t size) {
+    if (size < HEADER_SIZE + CHECKSUM_SIZE || std::memcmp(data, "DIRC", 4) != 0) {
+        throw std::runtime_error("Not a git index: " + index_path_.string());
+    }
+
+    version_ = read_be32(data + 4);
+    if (version_ < 2 || version_ > 4) {
+        throw std::runtime_error("Unsupported git index version " + std::to_string(version_));
+    }
+
+    const uint32_t count = read_be32(data + 8);
+    const uint8_t* p = data + HEADER_SIZE;
+    const uint8_t* end = data + size - CHECKSUM_SIZE;
+
+    entries_.reserve(std::min<size_t>(count, size / ENTRY_FIXED_SIZE));
+    std::string previous_name;  // v4 names are stored relative to the previous one
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* entry_start = p;
+        if (end - p < static_cast<ptrdiff_t>(ENTRY_FIXED_SIZE)) {
+            throw std::runtime_error("Truncated git index entry");
+        }
+
+        const uint32_t mtime_sec = read_be32(p + 8);
+        const uint32_t mtime_nsec = read_be32(p + 12);
+        const uint32_t inode = read_be32(p + 20);
+        const uint32_t mode = read_be32(p + 24);
+        const uint32_t file_size = read_be32(p + 36);
+        const uint8_t* oid = p + 40;
+        const uint16_t flags = read_be16(p + 60);
+        p += ENTRY_FIXED_SIZE;
+
+        uint16_t ext_flags = 0;
+        if (flags & FLAG_EXTENDED) {
+            if (version_ < 3 || end - p < 2) {
+                throw std::runtime_error("Invalid extended git index entry");
+            }
+            ext_flags = read_be16(p);
+            p += 2;
+        }
+
+        std::string name;
+        if (version_ == 4) {
+            uint64_t strip = 0;
+            if (!read_varint(p, end, strip) || strip > previous_name.size()) {
+                throw std::runtime_error("Invalid path prefix in git index");
+            }
+            const auto* nul = static_cast<const uint8_t*>(std::memchr(p, 0, end - p));
+            if (!nul) {
+                throw std::runtime_error("Unterminated path in git index");
+            }
+            name.reserve(previous_name.size() - strip + (nul - p));
+            name.assign(previous_name, 0, previous_name.size() - strip);
+            name.append(reinterpret_cast<const char*>(p), nul - p);
+            p = nul + 1;
+        } else {
+            size_t name_len = flags & NAME_LENGTH_MASK;
+            if (name_len == NAME_LENGTH_MASK) {
+                // Length did not fit in 12 bits: the name is NUL terminated
+                const auto* nul = static_cast<const uint8_t*>(std::memchr(p, 0, end - p));
+                if (!nul) {
+                    throw std::runtime_error("Unterminated path in git index");
+                }
+                name_len = nul - p;
+            }
+            if (end - p < static_cast<ptrdiff_t>(name_len)) {
+                throw std::runtime_error("Truncated path in git index");
+            }
+            name.assign(reinterpret_cast<const char*>(p), name_len);
+
+            // Entries are NUL padded to a multiple of 8 bytes
+            size_t fixed = static_cast<size_t>(p - entry_start);
+            p = entry_start + ((fixed + name_len + 8) & ~size_t(7));
+            if (p > end) {
+                throw std::runtime_error("Truncated git index entry");
+            }
+        }
+
+        const uint32_t type = mode & MODE_TYPE_MASK;
+        if (type == MODE_DIRECTORY) {
+            throw std::runtime_error("Sparse git index is not supported");
+        }
+
+        bool skip = type != MODE_REGULAR || (ext_flags & EXT_FLAG_SKIP_WORKTREE) ||
+                    (!entries_.empty() && entries_.back().path == name);  // Unmerged stages
+        if (!skip) {
+            Entry entry;
+            entry.path = name;
+            entry.size = file_size;
+            entry.mtime_ns = static_cast<int64_t>(mtime_sec) * 1000000000 + mtime_nsec;
+            entry.inode = inode;
+            std::memcpy(entry.oid.bytes.data(), oid, entry.oid.bytes.size());
+            entry.has_oid = (flags & FLAG_STAGE_MASK) == 0 && !(ext_flags & EXT_FLAG_INTENT_TO_ADD);
+            entries_.push_back(std::move(entry));
+        }
+
+        previous_name = std::move(name);
+    }
+
+    // Extensions: 4-byte signature, 4-byte size, payload
+    while (end - p >= 8) {
+        std::string_view signature(reinterpret_cast<const char*>(p), 4);
+        uint32_t ext_size = read_be32(p + 4);
+        if (signature == "link") {
+            throw std::runtime_error("Split git index is not supported");
+        }
+        if (signature == "sdir") {
+            throw std::runtime_error("Sparse git index is not supported");
+        }
+        if (end - p - 8 < static_cast<ptrdiff_t>(ext_size)) {
+            throw std::runtime_error("Truncated git index extension");
+        }
+        p += 8 + ext_size;
+    }
+}
+
+bool GitIndex::is_current() const {
+    WalkEntry st;
+    if (!DirectoryWalker::stat_path(index_path_, st)) {
+        return false;
+    }
+    return st.size == index_size_ && st.mtime_ns == index_mtime_ns_ && st.inode == index_inode_;
+}
+
+bool GitIndex::is_excluded(std::string_view sub_path) const {
+    size_t start = 0;
+    for (size_t slash = sub_path.find('/'); slash != std::string_view::npos;
+         start = slash + 1, slash = sub_path.find('/', start)) {
+        auto component = sub_path.substr(start, slash - start);
+        if (std::find(options_.excluded_dir_names.begin(), options_.excluded_dir_names.end(),
+                      component) != options_.excluded_dir_names.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::filesystem::path> GitIndex::query(std::string_view rel_dir,
+                                                   bool recursive,
+                                                   const GlobSet& globs) const {
+    std::vector<std::filesystem::path> results;
+
+    // Index order is byte order, so a directory's files are contiguous
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), rel_dir,
+                               [](const Entry& entry, std::string_view prefix) {
+                                   return std::string_view(entry.path) < prefix;
+                               });
+
+    std::string abs;
+    for (; it != entries_.end(); ++it) {
+        std::string_view path(it->path);
+        if (path.compare(0, rel_dir.size(), rel_dir) != 0) {
+            break;
+        }
+
+        auto sub_path = path.substr(rel_dir.size());
+        if (!recursive && sub_path.find('/') != std::string_view::npos) {
+            continue;
+        }
+        if (is_excluded(sub_path)) {
+            continue;
+        }
+
+        auto slash = sub_path.rfind('/');
+        auto name = slash == std::string_view::npos ? sub_path : sub_path.substr(slash + 1);
+        if (!globs.matches(sub_path, name)) {
+            continue;
+        }
+
+        abs.assign(work_tree_str_);
+        abs.append(path);
+        results.emplace_back(abs);
+    }
+
+    return results;
+}
+
+const GitIndex::Entry* GitIndex::find(std::string_view rel_path) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), rel_path,
+                               [](const Entry& entry, std::string_view path) {
+                                   return std::string_view(entry.path) < path;
+                               });
+    if (it == entries_.end() || it->path != rel_path) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+std::optional<ObjectId> GitIndex::blob_id_if_unchanged(std::string_view rel_path,
+                                                       const WalkEntry& stat) const {
+    const Entry* entry = find(rel_path);
+    if (!entry || !entry->has_oid || stat.is_dir) {
+        return std::nullopt;
+    }
+
+    if ((stat.size & 0xFFFFFFFFu) != entry->size) {
+        return std::nullopt;
+    }
+
+    // Git built without sub-second timestamps stores 0 nanoseconds
+    constexpr int64_t NS_PER_SEC = 1000000000;
+    bool whole_seconds = entry->mtime_ns % NS_PER_SEC == 0;
+    if (whole_seconds ? stat.mtime_ns / NS_PER_SEC != entry->mtime_ns / NS_PER_SEC
+                      : stat.mtime_ns != entry->mtime_ns) {
+        return std::nullopt;
+    }
+    if (stat.inode != 0 && static_cast<uint32_t>(stat.inode) != entry->inode) {
+        return std::nullopt;
+    }
+
+    // Racily clean: the file may have changed after git hashed it
+    if (stat.mtime_ns >= index_mtime_ns_) {
+        return std::nullopt;
+    }
+
+    return entry->oid;
+}
+
+size_t GitIndex::memory_bytes() const {
+    size_t bytes = entries_.capacity() * sizeof(Entry);
+    for (const auto& entry : entries_) {
+        bytes += heap_bytes(entry.path);
+    }
+    return bytes;
+}
+
+} // namespace ts_mcp
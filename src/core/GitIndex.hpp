@@ -0,0 +1,134 @@
+#pragma once
+
+#include "core/ContentHash.hpp"
+#include "core/DirectoryWalker.hpp"
+#include "core/GlobMatcher.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Read-only view of a git work tree's index (.git/index)
+ *
+ * The index lists every tracked file with its stat data and blob id, so a
+ * recursive scan of a git work tree needs neither a directory walk nor
+ * ignore-file parsing, and a file whose stat data still matches its entry
+ * has a known content hash without being read.
+ *
+ * The file is memory-mapped and parsed once (index versions 2, 3 and 4,
+ * including v4 path prefix compression). Split and sparse indexes are
+ * rejected so callers fall back to walking the directory. Entries that are
+ * not regular files (symlinks, submodules) and skip-worktree entries are
+ * left out.
+ *
+ * The listing contains tracked files only: untracked files are not
+ * reported, and tracked files deleted from the work tree are reported
+ * until the index is updated.
+ *
+ * Immutable after construction; use is_current() to decide when to reload.
+ */
+class GitIndex {
+public:
+    struct Entry {
+        std::string path;        // Relative to the work tree, '/' separated
+        uint64_t size = 0;       // Low 32 bits of the size (as stored by git)
+        int64_t mtime_ns = 0;
+        uint32_t inode = 0;      // Low 32 bits of the inode
+        ObjectId oid;
+        bool has_oid = false;    // False for unmerged and intent-to-add entries
+    };
+
+    /**
+     * @brief Load the index of a work tree
+     * @param work_tree Canonical work tree directory (contains .git)
+     * @param options Walk options; excluded_dir_names are applied to queries
+     * @throws std::runtime_error if the index is missing, malformed or unsupported
+     */
+    explicit GitIndex(std::filesystem::path work_tree, WalkOptions options = {});
+
+    /**
+     * @brief Find the work tree containing a directory
+     * @param dir Canonical directory
+     * @return Nearest ancestor (or dir itself) with a .git entry
+     */
+    static std::optional<std::filesystem::path> find_work_tree(const std::filesystem::path& dir);
+
+    /**
+     * @brief Locate the index file of a work tree (follows "gitdir:" files)
+     */
+    static std::optional<std::filesystem::path> locate_index(const std::filesystem::path& work_tree);
+
+    /**
+     * @brief Check that the index file was not rewritten since it was loaded
+     */
+    bool is_current() const;
+
+    /**
+     * @brief Tracked files below a directory of the work tree
+     *
+     * @param rel_dir Directory relative to the work tree ("" or "a/b/")
+     * @param recursive Include files in subdirectories
+     * @param globs Patterns; path patterns are matched relative to rel_dir
+     * @return Absolute paths (work tree / relative path), sorted
+     */
+    std::vector<std::filesystem::path> query(std::string_view rel_dir,
+                                             bool recursive,
+                                             const GlobSet& globs) const;
+
+    /**
+     * @brief Look up an entry by path relative to the work tree
+     */
+    const Entry* find(std::string_view rel_path) const;
+
+    /**
+     * @brief Blob id of a file whose stat data still matches its index entry
+     *
+     * Files modified in the same clock tick as the index was written are
+     * "racily clean" and never trusted, as in git.
+     *
+     * @param rel_path Path relative to the work tree
+     * @param stat Current stat data of the file (DirectoryWalker::stat_path)
+     */
+    std::optional<ObjectId> blob_id_if_unchanged(std::string_view rel_path,
+                                                 const WalkEntry& stat) const;
+
+    const std::filesystem::path& work_tree() const { return work_tree_; }
+    const std::filesystem::path& index_path() const { return index_path_; }
+    uint32_t version() const { return version_; }
+    size_t size() const { return entries_.size(); }
+
+    /**
+     * @brief Heap bytes of the parsed entries
+     */
+    size_t memory_bytes() const;
+
+private:
+    /**
+     * @brief Parse the mapped index file into entries_
+     */
+    void parse(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Check whether a path passes through an excluded directory
+     * @param sub_path Path relative to the queried directory
+     */
+    bool is_excluded(std::string_view sub_path) const;
+
+    std::filesystem::path work_tree_;
+    std::string work_tree_str_;              // work_tree_ with trailing '/'
+    std::filesystem::path index_path_;
+    WalkOptions options_;
+
+    std::vector<Entry> entries_;             // Sorted by path (index order)
+    uint32_t version_ = 0;
+    int64_t index_mtime_ns_ = 0;
+    uint64_t index_size_ = 0;
+    uint64_t index_inode_ = 0;
+};
+
+} // namespace ts_mcp
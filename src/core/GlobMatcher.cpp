@@ -0,0 +1,399 @@
+#include "core/GlobMatcher.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace ts_mcp {
+
+namespace {
+
+bool is_meta(char c) {
+    return c == '*' || c == '?' || c == '[' || c == '\\';
+}
+
+/**
+ * @brief Parse a bracket expression starting at p[pi] == '['
+ * @param bitmap Output membership bitmap (before negation is applied)
+ * @param end Output index just past the closing ']'
+ * @return false if the class is unterminated ('[' is then a literal)
+ */
+bool parse_char_class(std::string_view p, size_t pi, std::array<uint64_t, 4>& bitmap, size_t& end) {
+    bitmap = {0, 0, 0, 0};
+    size_t i = pi + 1;
+    bool negate = false;
+    if (i < p.size() && (p[i] == '!' || p[i] == '^')) {
+        negate = true;
+        i++;
+    }
+
+    bool first = true;
+    while (i < p.size() && (first || p[i] != ']')) {
+        first = false;
+        unsigned char lo = static_cast<unsigned char>(p[i]);
+        if (lo == '\\' && i + 1 < p.size()) {
+            lo = static_cast<unsigned char>(p[++i]);
+        }
+        unsigned char hi = lo;
+        if (i + 2 < p.size() && p[i + 1] == '-' && p[i + 2] != ']') {
+            hi = static_cast<unsigned char>(p[i + 2]);
+            i += 2;
+        }
+        for (unsigned c = lo; c <= hi; c++) {
+            bitmap[c >> 6] |= uint64_t{1} << (c & 63);
+        }
+        i++;
+    }
+
+    if (i >= p.size()) {
+        return false;
+    }
+
+    if (negate) {
+        for (auto& word : bitmap) {
+            word = ~word;
+        }
+    }
+    // Classes never match the path separator
+    bitmap['/' >> 6] &= ~(uint64_t{1} << ('/' & 63));
+
+    end = i + 1;
+    return true;
+}
+
+bool at_segment_start(std::string_view p, size_t pi) {
+    return pi == 0 || p[pi - 1] == '/';
+}
+
+/**
+ * @brief Backtracking matcher used for patterns too long for the NFA
+ */
+bool backtrack_match(std::string_view p, std::string_view s) {
+    size_t pi = 0;
+    size_t si = 0;
+
+    while (pi < p.size()) {
+        char c = p[pi];
+
+        if (c == '*') {
+            bool globstar = pi + 1 < p.size() && p[pi + 1] == '*' && at_segment_start(p, pi);
+            if (globstar) {
+                size_t after = pi + 2;
+                if (after < p.size() && p[after] == '/' &&
+                    backtrack_match(p.substr(after + 1), s.substr(si))) {
+                    return true;
+                }
+                for (size_t k = si; k <= s.size(); k++) {
+                    if (backtrack_match(p.substr(after), s.substr(k))) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            for (size_t k = si; k <= s.size(); k++) {
+                if (backtrack_match(p.substr(pi + 1), s.substr(k))) {
+                    return true;
+                }
+                if (k < s.size() && s[k] == '/') {
+                    break;
+                }
+            }
+            return false;
+        }
+
+        if (si >= s.size()) {
+            return false;
+        }
+
+        if (c == '?') {
+            if (s[si] == '/') {
+                return false;
+            }
+            pi++;
+            si++;
+            continue;
+        }
+
+        if (c == '[') {
+            std::array<uint64_t, 4> bitmap;
+            size_t end = 0;
+            if (parse_char_class(p, pi, bitmap, end)) {
+                unsigned char ch = static_cast<unsigned char>(s[si]);
+                if (!(bitmap[ch >> 6] & (uint64_t{1} << (ch & 63)))) {
+                    return false;
+                }
+                pi = end;
+                si++;
+                continue;
+            }
+        }
+
+        if (c == '\\' && pi + 1 < p.size()) {
+            c = p[++pi];
+        }
+
+        if (c != s[si]) {
+            return false;
+        }
+        pi++;
+        si++;
+    }
+
+    return si == s.size();
+}
+
+} // namespace
+
+// ============================================================================
+// GlobPattern implementation
+// ============================================================================
+
+GlobPattern::GlobPattern(std::string_view pattern)
+    : pattern_(pattern) {
+    has_slash_ = pattern_.find('/') != std::string::npos;
+    literal_ = std::none_of(pattern_.begin(), pattern_.end(), is_meta);
+    if (!literal_) {
+        compile();
+    }
+}
+
+void GlobPattern::compile() {
+    std::string_view p = pattern_;
+
+    for (size_t pi = 0; pi < p.size();) {
+        char c = p[pi];
+
+        if (c == '*') {
+            bool globstar = pi + 1 < p.size() && p[pi + 1] == '*' && at_segment_start(p, pi);
+            if (globstar) {
+                if (pi + 2 < p.size() && p[pi + 2] == '/') {
+                    states_.push_back({Op::GlobStarSlash});
+                    pi += 3;
+                } else {
+                    states_.push_back({Op::GlobStar});
+                    pi += 2;
+                }
+            } else {
+                // Collapse "**" inside a segment to a single '*'
+                if (states_.empty() || states_.back().op != Op::Star) {
+                    states_.push_back({Op::Star});
+                }
+                pi++;
+            }
+            continue;
+        }
+
+        if (c == '?') {
+            states_.push_back({Op::Any});
+            pi++;
+            continue;
+        }
+
+        if (c == '[') {
+            CharClass bitmap;
+            size_t end = 0;
+            if (parse_char_class(p, pi, bitmap, end)) {
+                State state{Op::Class};
+                state.class_index = static_cast<uint16_t>(classes_.size());
+                classes_.push_back(bitmap);
+                states_.push_back(state);
+                pi = end;
+                continue;
+            }
+        }
+
+        if (c == '\\' && pi + 1 < p.size()) {
+            c = p[++pi];
+        }
+
+        State state{Op::Char};
+        state.ch = c;
+        states_.push_back(state);
+        pi++;
+    }
+
+    if (states_.size() > MAX_NFA_STATES) {
+        states_.clear();
+        classes_.clear();
+        nfa_ = false;
+        return;
+    }
+
+    // State n is the accept state. Star-like states have an epsilon edge to
+    // their successor, so closures are built back to front.
+    const size_t n = states_.size();
+    closure_.assign(n + 1, 0);
+    closure_[n] = uint64_t{1} << n;
+    for (size_t i = n; i-- > 0;) {
+        closure_[i] = uint64_t{1} << i;
+        Op op = states_[i].op;
+        if (op == Op::Star || op == Op::GlobStar || op == Op::GlobStarSlash) {
+            closure_[i] |= closure_[i + 1];
+        }
+    }
+
+    accept_mask_ = uint64_t{1} << n;
+    nfa_ = true;
+}
+
+bool GlobPattern::class_contains(uint16_t index, unsigned char c) const {
+    return (classes_[index][c >> 6] >> (c & 63)) & 1;
+}
+
+uint64_t GlobPattern::step(uint64_t states, unsigned char c) const {
+    uint64_t next = 0;
+    const uint64_t live = states & ~accept_mask_;
+
+    for (uint64_t bits = live; bits; bits &= bits - 1) {
+        size_t i = static_cast<size_t>(std::countr_zero(bits));
+        const State& state = states_[i];
+
+        switch (state.op) {
+            case Op::Char:
+                if (static_cast<unsigned char>(state.ch) == c) {
+                    next |= closure_[i + 1];
+                }
+                break;
+            case Op::Any:
+                if (c != '/') {
+                    next |= closure_[i + 1];
+                }
+                break;
+            case Op::Class:
+                if (class_contains(state.class_index, c)) {
+                    next |= closure_[i + 1];
+                }
+                break;
+            case Op::Star:
+                if (c != '/') {
+                    next |= closure_[i];
+                }
+                break;
+            case Op::GlobStar:
+                next |= closure_[i];
+                break;
+            case Op::GlobStarSlash:
+                // Skipping zero directories is only possible before any character:
+                // the rest of the pattern follows a consumed '/'
+                next |= uint64_t{1} << i;
+                if (c == '/') {
+                    next |= closure_[i + 1];
+                }
+                break;
+        }
+    }
+
+    return next;
+}
+
+bool GlobPattern::matches(std::string_view subject) const {
+    if (literal_) {
+        return subject == pattern_;
+    }
+    if (!nfa_) {
+        return backtrack_match(pattern_, subject);
+    }
+
+    uint64_t states = closure_[0];
+    for (char c : subject) {
+        states = step(states, static_cast<unsigned char>(c));
+        if (!states) {
+            return false;
+        }
+    }
+    return (states & accept_mask_) != 0;
+}
+
+bool GlobPattern::may_match_prefix(std::string_view prefix) const {
+    if (literal_) {
+        return pattern_.size() > prefix.size() &&
+               std::string_view(pattern_).substr(0, prefix.size()) == prefix;
+    }
+    if (!nfa_) {
+        return true;  // Conservative: never prune for the fallback matcher
+    }
+
+    uint64_t states = closure_[0];
+    for (char c : prefix) {
+        states = step(states, static_cast<unsigned char>(c));
+        if (!states) {
+            return false;
+        }
+    }
+    return (states & ~accept_mask_) != 0;
+}
+
+// ============================================================================
+// GlobSet implementation
+// ============================================================================
+
+GlobSet::GlobSet(const std::vector<std::string>& patterns)
+    : pattern_count_(patterns.size()) {
+    for (const auto& pattern : patterns) {
+        if (pattern.find('/') != std::string::npos) {
+            path_globs_.emplace_back(pattern);
+            continue;
+        }
+
+        // "*.ext" with a plain single-dot extension
+        if (pattern.size() > 2 && pattern[0] == '*' && pattern[1] == '.') {
+            std::string_view ext = std::string_view(pattern).substr(1);
+            if (std::none_of(ext.begin(), ext.end(), is_meta) &&
+                ext.find('.', 1) == std::string_view::npos) {
+                extensions_.emplace(ext);
+                continue;
+            }
+        }
+
+        if (std::none_of(pattern.begin(), pattern.end(), is_meta)) {
+            names_.insert(pattern);
+            continue;
+        }
+
+        name_globs_.emplace_back(pattern);
+    }
+}
+
+bool GlobSet::matches(std::string_view rel_path, std::string_view filename) const {
+    if (!extensions_.empty()) {
+        size_t dot = filename.rfind('.');
+        if (dot != std::string_view::npos &&
+            extensions_.find(filename.substr(dot)) != extensions_.end()) {
+            return true;
+        }
+    }
+
+    if (!names_.empty() && names_.find(filename) != names_.end()) {
+        return true;
+    }
+
+    for (const auto& glob : name_globs_) {
+        if (glob.matches(filename)) {
+            return true;
+        }
+    }
+
+    for (const auto& glob : path_globs_) {
+        if (glob.matches(rel_path)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool GlobSet::may_match_under(std::string_view rel_dir) const {
+    // Name-only patterns can match at any depth
+    if (!extensions_.empty() || !names_.empty() || !name_globs_.empty()) {
+        return true;
+    }
+
+    for (const auto& glob : path_globs_) {
+        if (glob.may_match_prefix(rel_dir)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace ts_mcp
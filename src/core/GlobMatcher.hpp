@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief A single glob pattern compiled into a small NFA
+ *
+ * Supported syntax:
+ * - '*'   any run of characters except '/'
+ * - '?'   any single character except '/'
+ * - '**'  any run of characters including '/'; when followed by '/' it
+ *         also matches zero directories, so "src/" "**" "/a.cpp" (written
+ *         without the quotes) matches both "src/a.cpp" and "src/x/y/a.cpp"
+ * - '[...]' character classes with ranges and '!' / '^' negation
+ * - '\\x' escapes x
+ *
+ * Patterns of up to 63 states run as a bit-parallel NFA (one 64-bit state
+ * mask, no allocation, no backtracking). Longer patterns fall back to a
+ * backtracking matcher with the same semantics.
+ */
+class GlobPattern {
+public:
+    /**
+     * @brief Compile a glob pattern
+     * @param pattern Glob text (e.g. "*.cpp", "test_*.hpp", "src/gen/x?.h")
+     */
+    explicit GlobPattern(std::string_view pattern);
+
+    /**
+     * @brief Match the whole subject against the pattern
+     */
+    bool matches(std::string_view subject) const;
+
+    /**
+     * @brief Check if some path starting with prefix could still match
+     *
+     * Used to prune directories: a walk can skip "docs/" when the pattern is
+     * "src/gen/[a-z]*.cpp". prefix is consumed as-is (usually "dir/sub/").
+     */
+    bool may_match_prefix(std::string_view prefix) const;
+
+    /**
+     * @brief Pattern contains '/', i.e. it must be matched against a path
+     */
+    bool has_slash() const { return has_slash_; }
+
+    /**
+     * @brief Pattern has no metacharacters
+     */
+    bool is_literal() const { return literal_; }
+
+    const std::string& pattern() const { return pattern_; }
+
+private:
+    static constexpr size_t MAX_NFA_STATES = 63;
+
+    enum class Op : uint8_t {
+        Char,           // Exact byte
+        Any,            // '?'
+        Class,          // '[...]'
+        Star,           // '*'
+        GlobStar,       // '**'
+        GlobStarSlash   // '**' followed by '/'
+    };
+
+    struct State {
+        Op op;
+        char ch = 0;
+        uint16_t class_index = 0;
+    };
+
+    using CharClass = std::array<uint64_t, 4>;  // 256-bit membership bitmap
+
+    void compile();
+    uint64_t step(uint64_t states, unsigned char c) const;
+    bool class_contains(uint16_t index, unsigned char c) const;
+
+    std::string pattern_;
+    std::vector<State> states_;
+    std::vector<CharClass> classes_;
+    std::vector<uint64_t> closure_;  // Epsilon closure per state (+ accept state)
+    uint64_t accept_mask_ = 0;
+    bool nfa_ = false;
+    bool has_slash_ = false;
+    bool literal_ = false;
+};
+
+/**
+ * @brief Transparent string hash for heterogeneous unordered_set lookups
+ */
+struct StringViewHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const noexcept {
+        return std::hash<std::string_view>{}(s);
+    }
+};
+
+/**
+ * @brief A list of glob patterns compiled once and matched together
+ *
+ * Patterns are split by shape so the common cases never touch the NFA:
+ * - "*.ext"            -> extension hash set (one rfind + one hash lookup)
+ * - "name.cpp"         -> literal file name hash set
+ * - other name globs   -> GlobPattern matched against the file name
+ * - globs with '/'     -> GlobPattern matched against the relative path
+ */
+class GlobSet {
+public:
+    GlobSet() = default;
+
+    /**
+     * @brief Compile a pattern list
+     * @param patterns Glob patterns (any match accepts)
+     */
+    explicit GlobSet(const std::vector<std::string>& patterns);
+
+    /**
+     * @brief Check a file against all patterns
+     * @param rel_path Path relative to the scan root ('/' separated)
+     * @param filename File name component of rel_path
+     */
+    bool matches(std::string_view rel_path, std::string_view filename) const;
+
+    /**
+     * @brief Check if files below a directory could match any pattern
+     * @param rel_dir Directory relative to the scan root, with trailing '/'
+     * @return false if the whole subtree can be pruned
+     */
+    bool may_match_under(std::string_view rel_dir) const;
+
+    bool empty() const { return pattern_count_ == 0; }
+    size_t size() const { return pattern_count_; }
+
+private:
+    std::unordered_set<std::string, StringViewHash, std::equal_to<>> extensions_;
+    std::unordered_set<std::string, StringViewHash, std::equal_to<>> names_;
+    std::vector<GlobPattern> name_globs_;
+    std::vector<GlobPattern> path_globs_;
+    size_t pattern_count_ = 0;
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,142 @@
+#include "core/IgnoreRules.hpp"
+#include <spdlog/spdlog.h>
+
+namespace ts_mcp {
+
+namespace {
+
+std::string_view basename_of(std::string_view rel_path) {
+    size_t slash = rel_path.rfind('/');
+    return slash == std::string_view::npos ? rel_path : rel_path.substr(slash + 1);
+}
+
+} // namespace
+
+IgnoreRules::IgnoreRules(std::string_view contents,
+                         std::string base,
+                         std::shared_ptr<const IgnoreRules> parent)
+    : base_(std::move(base)), parent_(std::move(parent)) {
+    size_t pos = 0;
+    while (pos <= contents.size()) {
+        size_t eol = contents.find('\n', pos);
+        if (eol == std::string_view::npos) {
+            eol = contents.size();
+        }
+        std::string_view line = contents.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        // Trailing spaces are ignored unless escaped
+        while (!line.empty() && line.back() == ' ' &&
+               !(line.size() >= 2 && line[line.size() - 2] == '\\')) {
+            line.remove_suffix(1);
+        }
+
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        bool negated = false;
+        bool dir_only = false;
+        bool anchored = false;
+
+        if (line.front() == '!') {
+            negated = true;
+            line.remove_prefix(1);
+        } else if (line.size() >= 2 && line[0] == '\\' && (line[1] == '#' || line[1] == '!')) {
+            line.remove_prefix(1);
+        }
+
+        if (!line.empty() && line.back() == '/') {
+            dir_only = true;
+            line.remove_suffix(1);
+        }
+
+        if (line.empty()) {
+            continue;
+        }
+
+        // A slash anywhere except the end anchors the pattern to base_
+        if (line.find('/') != std::string_view::npos) {
+            anchored = true;
+            if (line.front() == '/') {
+                line.remove_prefix(1);
+            }
+        }
+
+        Rule rule{GlobPattern(line), negated, dir_only, anchored};
+
+        if (rule.negated) {
+            has_negations_ = true;
+        } else if (rule.glob.is_literal() && !rule.anchored && !rule.dir_only) {
+            ignored_names_.insert(rule.glob.pattern());
+        }
+
+        rules_.push_back(std::move(rule));
+    }
+
+    spdlog::trace("Compiled {} ignore rules for '{}'", rules_.size(), base_);
+}
+
+int IgnoreRules::match_own(std::string_view rel_path, std::string_view name, bool is_dir) const {
+    if (rules_.empty()) {
+        return 0;
+    }
+
+    // Without negations rule order is irrelevant, so literal names can be
+    // answered from the hash set before falling back to pattern rules.
+    if (!has_negations_ && ignored_names_.find(name) != ignored_names_.end()) {
+        return 1;
+    }
+
+    std::string_view local = rel_path;
+    bool under_base = true;
+    if (!base_.empty()) {
+        if (rel_path.size() > base_.size() && rel_path.compare(0, base_.size(), base_) == 0) {
+            local = rel_path.substr(base_.size());
+        } else {
+            under_base = false;
+        }
+    }
+
+    for (auto it = rules_.rbegin(); it != rules_.rend(); ++it) {
+        const Rule& rule = *it;
+        if (rule.dir_only && !is_dir) {
+            continue;
+        }
+        if (!has_negations_ && rule.glob.is_literal() && !rule.anchored && !rule.dir_only) {
+            continue;  // Already checked via ignored_names_
+        }
+
+        bool matched = false;
+        if (rule.anchored) {
+            matched = under_base && rule.glob.matches(local);
+        } else {
+            matched = rule.glob.matches(name);
+        }
+
+        if (matched) {
+            return rule.negated ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+bool IgnoreRules::is_ignored(std::string_view rel_path, bool is_dir) const {
+    std::string_view name = basename_of(rel_path);
+
+    for (const IgnoreRules* rules = this; rules; rules = rules->parent_.get()) {
+        int verdict = rules->match_own(rel_path, name, is_dir);
+        if (verdict != 0) {
+            return verdict > 0;
+        }
+    }
+
+    return false;
+}
+
+} // namespace ts_mcp
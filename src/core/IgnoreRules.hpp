@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/GlobMatcher.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Compiled rules from a single .gitignore / .ignore file
+ *
+ * Rules are chained: each directory that has its own ignore file gets an
+ * IgnoreRules object whose parent is the rule set of the enclosing directory.
+ * Matching follows gitignore semantics: the last matching rule wins, rules in
+ * deeper directories override rules from their ancestors, and "!" negates.
+ *
+ * All paths passed to is_ignored() are relative to the same "ignore root"
+ * (the repository root or the walk root), using '/' as separator.
+ */
+class IgnoreRules {
+public:
+    /**
+     * @brief Compile rules from ignore file contents
+     * @param contents Text of a .gitignore-style file
+     * @param base Directory of the ignore file relative to the ignore root
+     *             ("" for the root itself, otherwise "dir/sub/")
+     * @param parent Rules of the enclosing directory (may be nullptr)
+     */
+    IgnoreRules(std::string_view contents,
+                std::string base,
+                std::shared_ptr<const IgnoreRules> parent);
+
+    /**
+     * @brief Check if an entry is excluded by this rule chain
+     * @param rel_path Path relative to the ignore root (e.g. "src/gen/a.cpp")
+     * @param is_dir true if the entry is a directory
+     * @return true if the entry should be skipped
+     */
+    bool is_ignored(std::string_view rel_path, bool is_dir) const;
+
+    /**
+     * @brief Number of rules compiled from this file (excluding parents)
+     */
+    size_t rule_count() const { return rules_.size(); }
+
+    /**
+     * @brief Directory of the ignore file relative to the ignore root
+     */
+    const std::string& base() const { return base_; }
+
+private:
+    struct Rule {
+        GlobPattern glob;       // Pattern without leading '/', '!' or trailing '/'
+        bool negated = false;   // "!pattern" re-includes
+        bool dir_only = false;  // "pattern/" matches directories only
+        bool anchored = false;  // Contains '/', matched against path relative to base_
+    };
+
+    /**
+     * @brief Match this file's rules only
+     * @return 1 if ignored, -1 if explicitly re-included, 0 if no rule matched
+     */
+    int match_own(std::string_view rel_path, std::string_view name, bool is_dir) const;
+
+    std::vector<Rule> rules_;
+    std::unordered_set<std::string, StringViewHash, std::equal_to<>> ignored_names_;  // Fast path: literal, unanchored, non-negated
+    bool has_negations_ = false;
+    std::string base_;
+    std::shared_ptr<const IgnoreRules> parent_;
+};
+
+} // namespace ts_mcp
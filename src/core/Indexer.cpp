@@ -0,0 +1,83 @@
+#include "core/Indexer.hpp"
+#include "core/Trace.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace ts_mcp {
+
+Indexer::Indexer(std::shared_ptr<FactCache> cache, unsigned jobs)
+    : cache_(std::move(cache)),
+      jobs_(jobs > 0 ? jobs : std::max(1u, std::thread::hardware_concurrency())) {
+    steps_.push_back(builtin_facts);
+}
+
+void Indexer::builtin_facts(const std::shared_ptr<ASTAnalyzer>& analyzer, const std::filesystem::path& file) {
+    analyzer->analyze_file(file);
+    analyzer->find_classes(file);
+    analyzer->find_functions(file);
+    analyzer->find_includes(file);
+}
+
+void Indexer::add_step(FileStep step) {
+    steps_.push_back(std::move(step));
+}
+
+Indexer::Stats Indexer::run(const std::vector<std::filesystem::path>& files) {
+    auto start = std::chrono::steady_clock::now();
+    auto before = cache_->stats();
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::atomic<size_t> failed{0};
+    size_t report_every = std::max<size_t>(files.size() / 20, 1000);
+
+    auto worker = [&] {
+        auto analyzer = std::make_shared<ASTAnalyzer>();
+        analyzer->set_fact_cache(cache_);
+
+        for (size_t i = next++; i < files.size(); i = next++) {
+            const auto& file = files[i];
+            TraceSpan span("index_file", file.string());
+            try {
+                for (const auto& step : steps_) {
+                    step(analyzer, file);
+                }
+            } catch (const std::exception& e) {
+                spdlog::warn("Failed to index {}: {}", file.string(), e.what());
+                failed++;
+            }
+            analyzer->clear_cache();
+
+            size_t count = ++done;
+            if (count % report_every == 0) {
+                spdlog::info("Indexed {}/{} files", count, files.size());
+            }
+        }
+    };
+
+    unsigned thread_count = static_cast<unsigned>(std::min<size_t>(jobs_, std::max<size_t>(files.size(), 1)));
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (unsigned t = 0; t < thread_count; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    cache_->compact();
+
+    auto after = cache_->stats();
+    Stats stats;
+    stats.files = files.size();
+    stats.failed = failed.load();
+    stats.computed = after.misses - before.misses;
+    stats.reused = after.hits - before.hits;
+    stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+} // namespace ts_mcp
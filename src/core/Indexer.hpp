@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core/ASTAnalyzer.hpp"
+#include "core/FactCache.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Offline builder of a fact cache for a whole tree
+ *
+ * Runs the per-file analyses of every file on a pool of worker threads and
+ * stores their results in a FactCache, which a server opened with the same
+ * cache directory then serves without parsing. Each worker has its own
+ * ASTAnalyzer (an analyzer serializes its calls) and drops its parse trees
+ * after every file, so memory stays flat on large trees.
+ *
+ * The built-in step computes analyze_file, find_classes, find_functions
+ * and find_includes; add_step() adds facts computed outside the core
+ * library (tool results).
+ */
+class Indexer {
+public:
+    /**
+     * @brief Work done for each file; facts reach the cache through the analyzer
+     */
+    using FileStep = std::function<void(const std::shared_ptr<ASTAnalyzer>&, const std::filesystem::path&)>;
+
+    struct Stats {
+        size_t files = 0;
+        size_t failed = 0;    // Files for which a step threw
+        uint64_t computed = 0;  // Facts computed (fact cache misses)
+        uint64_t reused = 0;    // Facts already up to date (fact cache hits)
+        double elapsed_ms = 0.0;
+    };
+
+    /**
+     * @param cache Cache receiving the facts
+     * @param jobs Worker threads (0 = hardware concurrency)
+     */
+    explicit Indexer(std::shared_ptr<FactCache> cache, unsigned jobs = 0);
+
+    void add_step(FileStep step);
+
+    /**
+     * @brief The built-in step: analyze_file, find_classes, find_functions and find_includes
+     */
+    static void builtin_facts(const std::shared_ptr<ASTAnalyzer>& analyzer, const std::filesystem::path& file);
+
+    /**
+     * @brief Index files and compact the cache
+     */
+    Stats run(const std::vector<std::filesystem::path>& files);
+
+    unsigned jobs() const { return jobs_; }
+
+private:
+    std::shared_ptr<FactCache> cache_;
+    unsigned jobs_;
+    std::vector<FileStep> steps_;
+};
+
+} // namespace ts_mcp
@@ -4,6 +4,7 @@
 
 // Tree-sitter C language parsers
 extern "C" {
+    #include <tree_sitter/api.h>
     const TSLanguage* tree_sitter_cpp();
     const TSLanguage* tree_sitter_python();
 }
@@ -100,4 +101,37 @@ std::vector<std::string_view> LanguageUtils::get_extensions(Language lang) {
     }
 }
 
+uint64_t LanguageUtils::grammar_fingerprint(Language lang) {
+    const TSLanguage* ts_lang = get_ts_language(lang);
+    if (!ts_lang) {
+        return 0;
+    }
+
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](std::string_view bytes) {
+        for (unsigned char c : bytes) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xFF) * 1099511628211ull;  // Separator
+    };
+
+    mix(std::to_string(ts_language_version(ts_lang)));
+    mix(std::to_string(ts_language_state_count(ts_lang)));
+
+    uint32_t symbols = ts_language_symbol_count(ts_lang);
+    mix(std::to_string(symbols));
+    for (uint32_t symbol = 0; symbol < symbols; ++symbol) {
+        const char* name = ts_language_symbol_name(ts_lang, static_cast<TSSymbol>(symbol));
+        mix(name ? name : "");
+    }
+
+    uint32_t fields = ts_language_field_count(ts_lang);
+    for (uint32_t field = 1; field <= fields; ++field) {
+        const char* name = ts_language_field_name_for_id(ts_lang, static_cast<TSFieldId>(field));
+        mix(name ? name : "");
+    }
+    return hash;
+}
+
 }  // namespace ts_mcp
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <string_view>
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <vector>
@@ -74,6 +75,18 @@ public:
      * @return Vector of file extensions (including dot, e.g., ".cpp")
      */
     static std::vector<std::string_view> get_extensions(Language lang);
+
+    /**
+     * @brief Fingerprint of the linked grammar
+     *
+     * Hash of the ABI version, parse table size and all symbol and field
+     * names: changes whenever the grammar is upgraded, so facts derived
+     * with an older grammar can be recognized as stale.
+     *
+     * @param lang Language enum value
+     * @return Fingerprint, or 0 if the language is not supported
+     */
+    static uint64_t grammar_fingerprint(Language lang);
 };
 
 }  // namespace ts_mcp
@@ -0,0 +1,157 @@
+#include "core/LexicalScanner.hpp"
+#include <algorithm>
+
+namespace ts_mcp {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool is_word_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool starts_with_word(std::string_view text, std::string_view word) {
+    return text.size() > word.size() && text.substr(0, word.size()) == word && !is_word_char(text[word.size()]);
+}
+
+/**
+ * @brief Calls visit(line, line_number) for every line until it returns false
+ */
+template <typename Visit>
+void for_each_line(std::string_view source, Visit visit) {
+    size_t start = 0;
+    int number = 0;
+    while (start <= source.size()) {
+        size_t end = source.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = source.size();
+        }
+        if (!visit(source.substr(start, end - start), number)) {
+            return;
+        }
+        if (end == source.size()) {
+            return;
+        }
+        start = end + 1;
+        number++;
+    }
+}
+
+/**
+ * @brief First identifier or dotted module name at the start of text
+ */
+std::string_view leading_name(std::string_view text) {
+    size_t end = 0;
+    while (end < text.size() && (is_word_char(text[end]) || text[end] == '.')) {
+        end++;
+    }
+    return text.substr(0, end);
+}
+
+} // namespace
+
+LexicalScanner::LineMetrics LexicalScanner::line_metrics(std::string_view source, Language lang) {
+    LineMetrics metrics;
+    metrics.bytes = source.size();
+    if (source.empty()) {
+        return metrics;
+    }
+
+    std::string_view comment = lang == Language::PYTHON ? "#" : "//";
+    for_each_line(source, [&](std::string_view line, int) {
+        if (line.data() == source.data() + source.size()) {
+            return false;  // After the final newline, not a line
+        }
+        metrics.lines++;
+        metrics.longest_line = std::max(metrics.longest_line, line.size());
+        std::string_view content = trim(line);
+        if (content.empty()) {
+            metrics.blank_lines++;
+        } else if (content.substr(0, comment.size()) == comment) {
+            metrics.comment_lines++;
+        }
+        return true;
+    });
+    return metrics;
+}
+
+std::vector<LexicalScanner::Include> LexicalScanner::includes(std::string_view source, Language lang) {
+    std::vector<Include> result;
+
+    for_each_line(source, [&](std::string_view line, int number) {
+        std::string_view content = trim(line);
+        auto column = static_cast<int>(content.empty() ? 0 : content.data() - line.data());
+
+        if (lang == Language::CPP) {
+            if (content.empty() || content[0] != '#') {
+                return true;
+            }
+            std::string_view directive = trim(content.substr(1));
+            if (!starts_with_word(directive, "include")) {
+                return true;
+            }
+            std::string_view operand = trim(directive.substr(7));
+            if (operand.empty() || (operand[0] != '"' && operand[0] != '<')) {
+                return true;
+            }
+            char close = operand[0] == '"' ? '"' : '>';
+            size_t end = operand.find(close, 1);
+            if (end == std::string_view::npos) {
+                return true;
+            }
+            result.push_back({"include", std::string(content), std::string(operand.substr(1, end - 1)),
+                              close == '>', number, column});
+        } else if (lang == Language::PYTHON) {
+            if (starts_with_word(content, "import")) {
+                std::string_view module = leading_name(trim(content.substr(6)));
+                if (!module.empty()) {
+                    result.push_back({"import", std::string(content), std::string(module), false, number, column});
+                }
+            } else if (starts_with_word(content, "from")) {
+                std::string_view module = leading_name(trim(content.substr(4)));
+                if (!module.empty() && content.find(" import ") != std::string_view::npos) {
+                    result.push_back({"import_from", std::string(content), std::string(module), false,
+                                      number, column});
+                }
+            }
+        }
+        return true;
+    });
+
+    return result;
+}
+
+std::vector<LexicalScanner::WordMatch> LexicalScanner::find_word(std::string_view source,
+                                                                 std::string_view word,
+                                                                 size_t limit) {
+    std::vector<WordMatch> result;
+    if (word.empty()) {
+        return result;
+    }
+
+    for_each_line(source, [&](std::string_view line, int number) {
+        for (size_t pos = line.find(word); pos != std::string_view::npos; pos = line.find(word, pos + 1)) {
+            bool starts = pos == 0 || !is_word_char(line[pos - 1]);
+            bool ends = pos + word.size() == line.size() || !is_word_char(line[pos + word.size()]);
+            if (starts && ends) {
+                result.push_back({number, static_cast<int>(pos), std::string(trim(line))});
+                if (result.size() >= limit) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    });
+
+    return result;
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/Language.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Line-based analysis for files that are not parsed (see ParseGuard)
+ *
+ * Single passes over the text with no syntax tree: good enough for line
+ * counts, include/import lines and identifier search, and linear in the
+ * file size whatever its shape.
+ */
+class LexicalScanner {
+public:
+    struct LineMetrics {
+        size_t bytes = 0;
+        size_t lines = 0;
+        size_t blank_lines = 0;
+        size_t comment_lines = 0;  // Lines starting with a line comment
+        size_t longest_line = 0;
+    };
+
+    /**
+     * @brief An include directive or import statement
+     */
+    struct Include {
+        std::string kind;  // "include", "import" or "import_from" (the query capture names)
+        std::string text;  // Whole directive
+        std::string path;  // Header or module, without quotes or brackets
+        bool is_system = false;
+        int line = 0;      // 0-based, like QueryMatch
+        int column = 0;
+    };
+
+    struct WordMatch {
+        int line = 0;    // 0-based
+        int column = 0;  // 0-based byte column
+        std::string context;  // The line, trimmed
+    };
+
+    static LineMetrics line_metrics(std::string_view source, Language lang);
+
+    static std::vector<Include> includes(std::string_view source, Language lang);
+
+    /**
+     * @brief Occurrences of an identifier as a whole word
+     * @param limit Stop after this many matches
+     */
+    static std::vector<WordMatch> find_word(std::string_view source, std::string_view word, size_t limit = 10000);
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,118 @@
+#include "core/Logging.hpp"
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace ts_mcp {
+
+namespace {
+
+bool same_message(const char* a, const char* b) {
+    return a == b || std::strcmp(a, b) == 0;
+}
+
+struct Throttle {
+    const char* message;
+    std::chrono::steady_clock::time_point logged_at;
+    size_t suppressed = 0;
+};
+
+std::mutex throttle_mutex;
+std::vector<Throttle> throttles;  // Few distinct messages: a linear scan
+std::atomic<int64_t> interval_ms{1000};
+
+} // namespace
+
+void Logging::install_async(size_t queue_size) {
+    auto previous = spdlog::default_logger();
+    spdlog::init_thread_pool(queue_size, 1);
+    auto logger = std::make_shared<spdlog::async_logger>(
+        "ts_mcp", std::make_shared<spdlog::sinks::stderr_color_sink_mt>(), spdlog::thread_pool(),
+        spdlog::async_overflow_policy::overrun_oldest);
+    logger->set_level(previous->level());
+    // Warnings and errors reach the terminal even if the process dies soon after
+    logger->flush_on(spdlog::level::warn);
+    spdlog::set_default_logger(std::move(logger));
+}
+
+void Logging::shutdown() {
+    spdlog::shutdown();
+}
+
+WarningSummary::WarningSummary(std::string context) : context_(std::move(context)), previous_(current_) {
+    current_ = this;
+}
+
+WarningSummary::~WarningSummary() {
+    current_ = previous_;
+    for (const auto& [message, count] : counts_) {
+        if (count == 1) {
+            spdlog::warn("{}: {}", context_, message);
+        } else {
+            spdlog::warn("{}: {} ({} times)", context_, message, count);
+        }
+    }
+}
+
+void WarningSummary::note(const char* message) {
+    if (current_) {
+        for (auto& [noted, count] : current_->counts_) {
+            if (same_message(noted, message)) {
+                count++;
+                return;
+            }
+        }
+        current_->counts_.emplace_back(message, 1);
+        return;
+    }
+
+    if (!spdlog::should_log(spdlog::level::warn)) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    size_t suppressed = 0;
+    {
+        std::lock_guard<std::mutex> lock(throttle_mutex);
+        Throttle* throttle = nullptr;
+        for (auto& candidate : throttles) {
+            if (same_message(candidate.message, message)) {
+                throttle = &candidate;
+                break;
+            }
+        }
+        if (throttle && now - throttle->logged_at < std::chrono::milliseconds(interval_ms.load())) {
+            throttle->suppressed++;
+            return;
+        }
+        if (!throttle) {
+            throttle = &throttles.emplace_back(Throttle{message, now});
+        }
+        suppressed = throttle->suppressed;
+        throttle->logged_at = now;
+        throttle->suppressed = 0;
+    }
+
+    if (suppressed == 0) {
+        spdlog::warn("{}", message);
+    } else {
+        spdlog::warn("{} ({} more suppressed)", message, suppressed);
+    }
+}
+
+void WarningSummary::set_interval(std::chrono::milliseconds interval) {
+    interval_ms.store(interval.count());
+}
+
+size_t WarningSummary::count(const char* message) const {
+    for (const auto& [noted, count] : counts_) {
+        if (same_message(noted, message)) {
+            return count;
+        }
+    }
+    return 0;
+}
+
+} // namespace ts_mcp
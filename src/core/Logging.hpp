@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Process-wide log output
+ *
+ * spdlog's default logger writes synchronously: a thread that logs formats
+ * the message and writes it to the terminal before going on, so a request
+ * that logs for each of thousands of files runs at the speed of stderr.
+ * install_async() replaces it with a logger that only formats and queues
+ * the message; one background thread writes the queue to stderr.
+ */
+class Logging {
+public:
+    /**
+     * @brief Make the default logger asynchronous, writing to stderr
+     *
+     * The queue holds queue_size messages; when it is full the oldest are
+     * dropped rather than blocking the thread that logs. The level of the
+     * previous default logger is kept.
+     */
+    static void install_async(size_t queue_size = 8192);
+
+    /**
+     * @brief Write the queued messages and stop the background thread
+     */
+    static void shutdown();
+};
+
+/**
+ * @brief Folds repeated warnings of one thread into a line per message
+ *
+ * Hot-path code that warns once per file calls note() instead of
+ * spdlog::warn(). While a summary is installed on the thread (the server
+ * installs one per tool call) note() only counts; the summary logs each
+ * distinct message once, with its count, when it goes out of scope.
+ *
+ * Without a summary, each message is logged at most once per interval;
+ * the next line logged for it reports how many were suppressed.
+ *
+ * Messages are compared by pointer first: pass string literals.
+ */
+class WarningSummary {
+public:
+    explicit WarningSummary(std::string context);
+
+    /**
+     * @brief Log the counted messages
+     */
+    ~WarningSummary();
+
+    WarningSummary(const WarningSummary&) = delete;
+    WarningSummary& operator=(const WarningSummary&) = delete;
+
+    static void note(const char* message);
+
+    /**
+     * @brief Minimum time between two lines of a message noted outside a summary
+     */
+    static void set_interval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Times message was noted in this summary
+     */
+    size_t count(const char* message) const;
+
+private:
+    static inline thread_local WarningSummary* current_ = nullptr;
+
+    std::string context_;
+    WarningSummary* previous_;
+    std::vector<std::pair<const char*, size_t>> counts_;  // In order of first note
+};
+
+} // namespace ts_mcp
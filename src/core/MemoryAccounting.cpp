@@ -0,0 +1,219 @@
+#include "core/MemoryAccounting.hpp"
+#include <spdlog/spdlog.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// Tree-sitter C API
+extern "C" {
+    #include <tree_sitter/api.h>
+}
+
+namespace ts_mcp {
+
+namespace detail {
+
+/**
+ * @brief Shared by an account handle and the allocations charged to it
+ */
+struct AccountState {
+    std::atomic<int64_t> bytes{0};
+    std::atomic<int64_t> refs{1};  // Handle + live allocations
+};
+
+} // namespace detail
+
+namespace {
+
+using detail::AccountState;
+
+/**
+ * @brief Prefix of every tracked block; keeps the payload max-aligned
+ */
+struct alignas(std::max_align_t) BlockHeader {
+    size_t size;
+    AccountState* account;
+};
+
+thread_local AccountState* current_account = nullptr;
+
+std::atomic<int64_t> live_bytes{0};
+std::atomic<int64_t> peak_bytes{0};
+std::atomic<int64_t> live_allocations{0};
+std::atomic<uint64_t> total_allocations{0};
+
+void release_account(AccountState* account) {
+    if (account && account->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete account;
+    }
+}
+
+void charge(BlockHeader* header, size_t size) {
+    header->size = size;
+    header->account = current_account;
+    if (header->account) {
+        header->account->refs.fetch_add(1, std::memory_order_relaxed);
+        header->account->bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    }
+
+    int64_t now = live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) +
+                  static_cast<int64_t>(size);
+    int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (now > peak && !peak_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+    live_allocations.fetch_add(1, std::memory_order_relaxed);
+    total_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void credit(const BlockHeader* header) {
+    live_bytes.fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+    live_allocations.fetch_sub(1, std::memory_order_relaxed);
+    if (header->account) {
+        header->account->bytes.fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+        release_account(header->account);
+    }
+}
+
+[[noreturn]] void out_of_memory(size_t size) {
+    std::fprintf(stderr, "tree-sitter failed to allocate %zu bytes\n", size);
+    std::abort();
+}
+
+void* tracked_malloc(size_t size) {
+    auto* header = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+    if (!header) {
+        out_of_memory(size);
+    }
+    charge(header, size);
+    return header + 1;
+}
+
+void* tracked_calloc(size_t count, size_t size) {
+    if (size != 0 && count > (SIZE_MAX - sizeof(BlockHeader)) / size) {
+        out_of_memory(SIZE_MAX);
+    }
+    size_t bytes = count * size;
+    auto* header = static_cast<BlockHeader*>(std::calloc(1, sizeof(BlockHeader) + bytes));
+    if (!header) {
+        out_of_memory(bytes);
+    }
+    charge(header, bytes);
+    return header + 1;
+}
+
+void tracked_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    auto* header = static_cast<BlockHeader*>(ptr) - 1;
+    credit(header);
+    std::free(header);
+}
+
+void* tracked_realloc(void* ptr, size_t size) {
+    if (!ptr) {
+        return tracked_malloc(size);
+    }
+    if (size == 0) {
+        tracked_free(ptr);
+        return nullptr;
+    }
+
+    // The block stays with the account it was first charged to
+    auto* header = static_cast<BlockHeader*>(ptr) - 1;
+    size_t old_size = header->size;
+    AccountState* account = header->account;
+
+    auto* resized = static_cast<BlockHeader*>(std::realloc(header, sizeof(BlockHeader) + size));
+    if (!resized) {
+        out_of_memory(size);
+    }
+    resized->size = size;
+
+    int64_t delta = static_cast<int64_t>(size) - static_cast<int64_t>(old_size);
+    if (account) {
+        account->bytes.fetch_add(delta, std::memory_order_relaxed);
+    }
+    int64_t now = live_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (now > peak && !peak_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+    return resized + 1;
+}
+
+} // namespace
+
+// ============================================================================
+// MemoryAccount
+// ============================================================================
+
+MemoryAccount::MemoryAccount() : state_(new AccountState()) {
+}
+
+MemoryAccount::~MemoryAccount() {
+    release();
+}
+
+MemoryAccount::MemoryAccount(MemoryAccount&& other) noexcept : state_(other.state_) {
+    other.state_ = nullptr;
+}
+
+MemoryAccount& MemoryAccount::operator=(MemoryAccount&& other) noexcept {
+    if (this != &other) {
+        release();
+        state_ = other.state_;
+        other.state_ = nullptr;
+    }
+    return *this;
+}
+
+int64_t MemoryAccount::bytes() const {
+    return state_ ? state_->bytes.load(std::memory_order_relaxed) : 0;
+}
+
+void MemoryAccount::release() {
+    release_account(state_);
+    state_ = nullptr;
+}
+
+MemoryAccount::Scope::Scope(MemoryAccount& account) : previous_(current_account) {
+    current_account = account.state_;
+}
+
+MemoryAccount::Scope::~Scope() {
+    current_account = previous_;
+}
+
+// ============================================================================
+// TreeSitterMemory
+// ============================================================================
+
+void TreeSitterMemory::free_buffer(void* buffer) {
+    if (installed()) {
+        tracked_free(buffer);
+    } else {
+        std::free(buffer);
+    }
+}
+
+void TreeSitterMemory::install() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        ts_set_allocator(tracked_malloc, tracked_calloc, tracked_realloc, tracked_free);
+        installed_.store(true, std::memory_order_relaxed);
+        spdlog::debug("Tracking tree-sitter allocations");
+    });
+}
+
+TreeSitterMemory::Stats TreeSitterMemory::stats() {
+    Stats result;
+    result.tracking = installed();
+    result.bytes = live_bytes.load(std::memory_order_relaxed);
+    result.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+    result.allocations = live_allocations.load(std::memory_order_relaxed);
+    result.total_allocations = total_allocations.load(std::memory_order_relaxed);
+    return result;
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ts_mcp {
+
+namespace detail {
+struct AccountState;
+}
+
+/**
+ * @brief Bytes of tree-sitter heap memory attributed to one document
+ *
+ * While a Scope is active on a thread, tree-sitter allocations made by that
+ * thread are charged to the account; each allocation is credited back to
+ * the account it was charged to when it is freed, whichever thread frees
+ * it. An account outlives its handle until its last allocation is freed.
+ *
+ * Attribution is by allocation, so it is close but not exact: parser
+ * buffers grown during a parse, and subtrees the parser recycles from its
+ * pool, stay with the account that first allocated them.
+ *
+ * Only meaningful after TreeSitterMemory::install().
+ */
+class MemoryAccount {
+public:
+    MemoryAccount();
+    ~MemoryAccount();
+
+    MemoryAccount(const MemoryAccount&) = delete;
+    MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+    MemoryAccount(MemoryAccount&& other) noexcept;
+    MemoryAccount& operator=(MemoryAccount&& other) noexcept;
+
+    /**
+     * @brief Live bytes charged to this account
+     */
+    int64_t bytes() const;
+
+    /**
+     * @brief Charges the calling thread's tree-sitter allocations to an account
+     */
+    class Scope {
+    public:
+        explicit Scope(MemoryAccount& account);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        detail::AccountState* previous_;
+    };
+
+private:
+    void release();
+
+    detail::AccountState* state_;
+};
+
+/**
+ * @brief Tracking allocator for the tree-sitter runtime (ts_set_allocator)
+ *
+ * Every allocation carries a small header with its size and account, so
+ * totals are exact: trees, parser stacks, lexer buffers, compiled queries
+ * and cursors. Allocations made outside a MemoryAccount::Scope count as
+ * unattributed (parsers, queries, trees parsed outside the cache).
+ */
+class TreeSitterMemory {
+public:
+    struct Stats {
+        bool tracking = false;
+        int64_t bytes = 0;        // Live bytes requested by tree-sitter
+        int64_t peak_bytes = 0;
+        int64_t allocations = 0;  // Live allocations
+        uint64_t total_allocations = 0;
+    };
+
+    /**
+     * @brief Route tree-sitter's allocations through the tracking allocator
+     *
+     * Must be called before any tree-sitter object is created: memory
+     * allocated by the previous allocator cannot be freed by this one.
+     * Calling it again has no effect.
+     */
+    static void install();
+
+    static bool installed() { return installed_.load(std::memory_order_relaxed); }
+
+    static Stats stats();
+
+    /**
+     * @brief Free a buffer tree-sitter handed to the caller (ts_tree_get_changed_ranges)
+     *
+     * It came from whichever allocator was installed.
+     */
+    static void free_buffer(void* buffer);
+
+private:
+    static inline std::atomic<bool> installed_{false};
+};
+
+/**
+ * @brief Heap bytes owned by a string (0 when stored inline)
+ */
+inline size_t heap_bytes(const std::string& s) {
+    const char* data = s.data();
+    const char* self = reinterpret_cast<const char*>(&s);
+    bool inline_buffer = data >= self && data < self + sizeof(s);
+    return inline_buffer ? 0 : s.capacity() + 1;
+}
+
+// Estimated per-node overhead of std::map/std::set (links, color, allocator rounding)
+inline constexpr size_t TREE_NODE_OVERHEAD = 48;
+
+} // namespace ts_mcp
@@ -0,0 +1,412 @@
+#include "core/Metrics.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace ts_mcp {
+
+namespace {
+
+constexpr size_t HISTOGRAM_SLOTS = 3 + Histogram::BUCKETS;
+constexpr size_t COUNT_OFFSET = 0;
+constexpr size_t SUM_OFFSET = 1;
+constexpr size_t MAX_OFFSET = 2;
+constexpr size_t BUCKET_OFFSET = 3;
+
+// Exported Prometheus buckets: one per power of two from 1us to ~68s
+constexpr uint64_t PROMETHEUS_MIN_NS = 1024;
+constexpr uint64_t PROMETHEUS_MAX_NS = uint64_t{1} << 36;
+
+enum class MetricKind { Counter, Gauge, Histogram };
+
+struct MetricInfo {
+    MetricKind kind;
+    std::string name;
+    std::string help;
+    MetricLabels labels;
+    uint32_t slot = 0;  // First slot (counters, histograms) or gauge index
+};
+
+struct Shard {
+    std::array<std::atomic<uint64_t>, Metrics::MAX_SLOTS> slots{};
+};
+
+/**
+ * @brief Metric definitions and the per-thread shards
+ *
+ * Deliberately leaked: threads may record during static destruction.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<MetricInfo> metrics;
+    std::deque<std::unique_ptr<Shard>> shards;
+    std::array<std::atomic<int64_t>, Metrics::MAX_GAUGES> gauges{};
+    size_t next_slot = 0;
+    size_t next_gauge = 0;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+const MetricInfo* find_metric(const Registry& reg, MetricKind kind, const std::string& name,
+                              const MetricLabels& labels) {
+    for (const auto& metric : reg.metrics) {
+        if (metric.name == name && metric.labels == labels) {
+            if (metric.kind != kind) {
+                throw std::invalid_argument("Metric registered with another type: " + name);
+            }
+            return &metric;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t allocate_slots(Registry& reg, size_t count, const std::string& name) {
+    if (reg.next_slot + count > Metrics::MAX_SLOTS) {
+        throw std::length_error("Metric slot table exhausted registering " + name);
+    }
+    auto slot = static_cast<uint32_t>(reg.next_slot);
+    reg.next_slot += count;
+    return slot;
+}
+
+std::string escape_label(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string label_string(const MetricLabels& labels, const std::string& extra = {}) {
+    if (labels.empty() && extra.empty()) {
+        return {};
+    }
+    std::string out = "{";
+    for (const auto& [key, value] : labels) {
+        if (out.size() > 1) {
+            out += ',';
+        }
+        out += key + "=\"" + escape_label(value) + "\"";
+    }
+    if (!extra.empty()) {
+        if (out.size() > 1) {
+            out += ',';
+        }
+        out += extra;
+    }
+    return out + "}";
+}
+
+std::string format_double(double value) {
+    std::ostringstream out;
+    out.precision(9);
+    out << value;
+    return out.str();
+}
+
+double ns_to_ms(uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+std::vector<MetricInfo> copy_metrics() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.metrics;
+}
+
+} // namespace
+
+void Counter::add(uint64_t n) const {
+    auto& slot = Metrics::local_slots()[slot_];
+    slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const {
+    return Metrics::sum_slot(slot_);
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(Histogram::bucket_upper_bound(i), max);
+        }
+    }
+    return max;
+}
+
+size_t Histogram::bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    auto exponent = static_cast<size_t>(std::bit_width(value)) - 1;
+    if (exponent > MAX_EXPONENT) {
+        return BUCKETS - 1;
+    }
+    size_t sub = static_cast<size_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t Histogram::bucket_upper_bound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index + 1;
+    }
+    size_t exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    uint64_t sub = index % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub + 1) << (exponent - SUB_BUCKET_BITS);
+}
+
+void Histogram::record(uint64_t value) const {
+    auto* slots = Metrics::local_slots() + slot_;
+    auto bump = [](std::atomic<uint64_t>& slot, uint64_t n) {
+        slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    };
+    bump(slots[COUNT_OFFSET], 1);
+    bump(slots[SUM_OFFSET], value);
+    if (value > slots[MAX_OFFSET].load(std::memory_order_relaxed)) {
+        slots[MAX_OFFSET].store(value, std::memory_order_relaxed);
+    }
+    bump(slots[BUCKET_OFFSET + bucket_index(value)], 1);
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot snap;
+    snap.buckets.resize(BUCKETS);
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& shard : reg.shards) {
+        const auto* slots = shard->slots.data() + slot_;
+        snap.count += slots[COUNT_OFFSET].load(std::memory_order_relaxed);
+        snap.sum += slots[SUM_OFFSET].load(std::memory_order_relaxed);
+        snap.max = std::max(snap.max, slots[MAX_OFFSET].load(std::memory_order_relaxed));
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            snap.buckets[i] += slots[BUCKET_OFFSET + i].load(std::memory_order_relaxed);
+        }
+    }
+    return snap;
+}
+
+std::atomic<uint64_t>* Metrics::local_slots() {
+    thread_local Shard* shard = [] {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.shards.push_back(std::make_unique<Shard>());
+        return reg.shards.back().get();
+    }();
+    return shard->slots.data();
+}
+
+uint64_t Metrics::sum_slot(uint32_t slot) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    uint64_t total = 0;
+    for (const auto& shard : reg.shards) {
+        total += shard->slots[slot].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Counter Metrics::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (const auto* existing = find_metric(reg, MetricKind::Counter, name, labels)) {
+        return Counter(existing->slot);
+    }
+    uint32_t slot = allocate_slots(reg, 1, name);
+    reg.metrics.push_back({MetricKind::Counter, name, help, labels, slot});
+    return Counter(slot);
+}
+
+Gauge Metrics::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (const auto* existing = find_metric(reg, MetricKind::Gauge, name, labels)) {
+        return Gauge(&reg.gauges[existing->slot]);
+    }
+    if (reg.next_gauge >= MAX_GAUGES) {
+        throw std::length_error("Gauge table exhausted registering " + name);
+    }
+    auto index = static_cast<uint32_t>(reg.next_gauge++);
+    reg.metrics.push_back({MetricKind::Gauge, name, help, labels, index});
+    return Gauge(&reg.gauges[index]);
+}
+
+Histogram Metrics::histogram(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (const auto* existing = find_metric(reg, MetricKind::Histogram, name, labels)) {
+        return Histogram(existing->slot);
+    }
+    uint32_t slot = allocate_slots(reg, HISTOGRAM_SLOTS, name);
+    reg.metrics.push_back({MetricKind::Histogram, name, help, labels, slot});
+    return Histogram(slot);
+}
+
+json Metrics::to_json() {
+    auto& reg = registry();
+    auto uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - reg.started);
+
+    json metrics = json::array();
+    for (const auto& info : copy_metrics()) {
+        json item = {{"name", info.name}};
+        if (!info.labels.empty()) {
+            json labels = json::object();
+            for (const auto& [key, value] : info.labels) {
+                labels[key] = value;
+            }
+            item["labels"] = labels;
+        }
+
+        switch (info.kind) {
+            case MetricKind::Counter:
+                item["type"] = "counter";
+                item["value"] = Counter(info.slot).value();
+                break;
+            case MetricKind::Gauge:
+                item["type"] = "gauge";
+                item["value"] = reg.gauges[info.slot].load(std::memory_order_relaxed);
+                break;
+            case MetricKind::Histogram: {
+                auto snap = Histogram(info.slot).snapshot();
+                item["type"] = "histogram";
+                item["count"] = snap.count;
+                item["mean_ms"] = snap.count ? ns_to_ms(snap.sum) / static_cast<double>(snap.count) : 0.0;
+                item["p50_ms"] = ns_to_ms(snap.percentile(0.50));
+                item["p90_ms"] = ns_to_ms(snap.percentile(0.90));
+                item["p99_ms"] = ns_to_ms(snap.percentile(0.99));
+                item["max_ms"] = ns_to_ms(snap.max);
+                break;
+            }
+        }
+        metrics.push_back(item);
+    }
+
+    return {
+        {"uptime_seconds", uptime.count()},
+        {"metrics", metrics}
+    };
+}
+
+std::string Metrics::to_prometheus() {
+    auto& reg = registry();
+    auto metrics = copy_metrics();
+
+    // Series of one metric must be grouped under a single HELP/TYPE header
+    std::stable_sort(metrics.begin(), metrics.end(),
+                     [](const MetricInfo& a, const MetricInfo& b) { return a.name < b.name; });
+
+    std::string out;
+    const std::string* previous = nullptr;
+    for (const auto& info : metrics) {
+        if (!previous || *previous != info.name) {
+            const char* type = info.kind == MetricKind::Counter ? "counter"
+                             : info.kind == MetricKind::Gauge   ? "gauge"
+                                                                : "histogram";
+            out += "# HELP " + info.name + " " + info.help + "\n";
+            out += "# TYPE " + info.name + " " + type + "\n";
+        }
+        previous = &info.name;
+
+        switch (info.kind) {
+            case MetricKind::Counter:
+                out += info.name + label_string(info.labels) + " " +
+                       std::to_string(Counter(info.slot).value()) + "\n";
+                break;
+            case MetricKind::Gauge:
+                out += info.name + label_string(info.labels) + " " +
+                       std::to_string(reg.gauges[info.slot].load(std::memory_order_relaxed)) + "\n";
+                break;
+            case MetricKind::Histogram: {
+                auto snap = Histogram(info.slot).snapshot();
+                uint64_t cumulative = 0;
+                size_t bucket = 0;
+                for (uint64_t bound = PROMETHEUS_MIN_NS; bound <= PROMETHEUS_MAX_NS; bound <<= 1) {
+                    // Power-of-two bounds coincide with bucket boundaries
+                    while (bucket < snap.buckets.size() && Histogram::bucket_upper_bound(bucket) <= bound) {
+                        cumulative += snap.buckets[bucket++];
+                    }
+                    out += info.name + "_bucket" +
+                           label_string(info.labels, "le=\"" + format_double(static_cast<double>(bound) / 1e9) + "\"") +
+                           " " + std::to_string(cumulative) + "\n";
+                }
+                out += info.name + "_bucket" + label_string(info.labels, "le=\"+Inf\"") + " " +
+                       std::to_string(snap.count) + "\n";
+                out += info.name + "_sum" + label_string(info.labels) + " " +
+                       format_double(static_cast<double>(snap.sum) / 1e9) + "\n";
+                out += info.name + "_count" + label_string(info.labels) + " " +
+                       std::to_string(snap.count) + "\n";
+                break;
+            }
+        }
+    }
+    return out;
+}
+
+void Metrics::reset() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& shard : reg.shards) {
+        for (auto& slot : shard->slots) {
+            slot.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (auto& gauge : reg.gauges) {
+        gauge.store(0, std::memory_order_relaxed);
+    }
+}
+
+const CoreMetrics& CoreMetrics::get() {
+    static const CoreMetrics instance{
+        Metrics::counter("ts_mcp_cache_hits_total", "Parse cache lookups served from the cache"),
+        Metrics::counter("ts_mcp_cache_misses_total", "Parse cache lookups that had to parse"),
+        Metrics::counter("ts_mcp_cache_evictions_total", "Parse cache entries dropped"),
+        Metrics::counter("ts_mcp_bytes_read_total", "Source bytes read from disk"),
+        Metrics::counter("ts_mcp_bytes_parsed_total", "Source bytes handed to tree-sitter"),
+        Metrics::counter("ts_mcp_fact_cache_hits_total", "Per-file facts served from the persistent cache"),
+        Metrics::counter("ts_mcp_fact_cache_misses_total", "Per-file facts computed for the persistent cache"),
+        Metrics::counter("ts_mcp_parses_degraded_total",
+                         "Parses refused or cancelled by the size, generated-file and timeout limits"),
+        Metrics::counter("ts_mcp_parses_with_errors_total", "Parses whose tree contains syntax errors"),
+        Metrics::counter("ts_mcp_warm_fact_hits_total", "Per-file facts served from memory without a tree"),
+        Metrics::counter("ts_mcp_warm_fact_evictions_total", "Files whose in-memory facts were dropped"),
+        Metrics::counter("ts_mcp_documents_shared_total",
+                         "Files cached without parsing because identical content was already parsed"),
+        Metrics::counter("ts_mcp_documents_retired_in_use_total",
+                         "Replaced or evicted documents kept alive by requests still reading them"),
+        Metrics::counter("ts_mcp_parses_incremental_total",
+                         "Re-parses that reused the tree of the file's previous content"),
+        Metrics::counter("ts_mcp_definitions_reused_total",
+                         "Definitions whose facts were kept across an edit instead of recomputed"),
+        Metrics::counter("ts_mcp_definitions_recomputed_total", "Definitions whose facts were computed")
+    };
+    return instance;
+}
+
+} // namespace ts_mcp
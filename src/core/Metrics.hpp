@@ -0,0 +1,177 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ts_mcp {
+
+using json = nlohmann::json;
+
+/**
+ * @brief Label pairs distinguishing series of one metric (e.g. {"tool", "find_classes"})
+ */
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @brief Monotonic counter
+ *
+ * Increments touch only the calling thread's shard (a relaxed load and
+ * store, no read-modify-write); value() sums all shards.
+ */
+class Counter {
+public:
+    void add(uint64_t n = 1) const;
+    uint64_t value() const;
+
+private:
+    friend class Metrics;
+    explicit Counter(uint32_t slot) : slot_(slot) {}
+
+    uint32_t slot_;
+};
+
+/**
+ * @brief Value that goes up and down across threads (in-flight requests)
+ */
+class Gauge {
+public:
+    void add(int64_t n) const { value_->fetch_add(n, std::memory_order_relaxed); }
+    void increment() const { add(1); }
+    void decrement() const { add(-1); }
+    int64_t value() const { return value_->load(std::memory_order_relaxed); }
+
+private:
+    friend class Metrics;
+    explicit Gauge(std::atomic<int64_t>* value) : value_(value) {}
+
+    std::atomic<int64_t>* value_;
+};
+
+/**
+ * @brief Merged state of a histogram at one point in time
+ */
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    std::vector<uint64_t> buckets;
+
+    /**
+     * @brief Upper bound of the bucket holding quantile q (0 if empty)
+     * @param q Quantile in [0, 1]
+     */
+    uint64_t percentile(double q) const;
+};
+
+/**
+ * @brief Log-linear histogram of non-negative integers (latencies in ns)
+ *
+ * HDR-style bucketing: each power of two is split into 8 linear
+ * sub-buckets, so any recorded value is reported within 12.5%. Values
+ * above 2^41 are clamped into the last bucket. Recording is per-thread
+ * like Counter.
+ */
+class Histogram {
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 3;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr size_t MAX_EXPONENT = 40;
+    static constexpr size_t BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    void record(uint64_t value) const;
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucket_index(uint64_t value);
+
+    /**
+     * @brief Smallest value that no longer falls into bucket i
+     */
+    static uint64_t bucket_upper_bound(size_t index);
+
+private:
+    friend class Metrics;
+    explicit Histogram(uint32_t slot) : slot_(slot) {}
+
+    // Slots: count, sum, max, then BUCKETS bucket counters
+    uint32_t slot_;
+};
+
+/**
+ * @brief Process-wide registry of counters, gauges and histograms
+ *
+ * Each thread that records gets its own shard of counter slots, so hot
+ * paths never contend on a cache line; readers merge the shards. Shards
+ * outlive their threads so nothing recorded is lost.
+ *
+ * Registering the same name and labels twice returns the same metric.
+ * Names follow Prometheus conventions (ts_mcp_..._total, ..._seconds);
+ * histograms record nanoseconds and are exported in seconds.
+ */
+class Metrics {
+public:
+    static constexpr size_t MAX_SLOTS = 8192;
+    static constexpr size_t MAX_GAUGES = 64;
+
+    /**
+     * @throws std::length_error if the slot table is exhausted
+     */
+    static Counter counter(const std::string& name, const std::string& help,
+                           const MetricLabels& labels = {});
+    static Gauge gauge(const std::string& name, const std::string& help,
+                       const MetricLabels& labels = {});
+    static Histogram histogram(const std::string& name, const std::string& help,
+                               const MetricLabels& labels = {});
+
+    /**
+     * @brief All metrics as JSON (histograms summarized as count, mean and percentiles in ms)
+     */
+    static json to_json();
+
+    /**
+     * @brief All metrics in the Prometheus text exposition format
+     */
+    static std::string to_prometheus();
+
+    /**
+     * @brief Zero every metric (tests)
+     */
+    static void reset();
+
+private:
+    friend class Counter;
+    friend class Histogram;
+
+    static std::atomic<uint64_t>* local_slots();
+    static uint64_t sum_slot(uint32_t slot);
+};
+
+/**
+ * @brief Shared process metrics recorded by the core library
+ */
+struct CoreMetrics {
+    Counter cache_hits;
+    Counter cache_misses;
+    Counter cache_evictions;
+    Counter bytes_read;
+    Counter bytes_parsed;
+    Counter fact_cache_hits;
+    Counter fact_cache_misses;
+    Counter parses_degraded;
+    Counter parses_with_errors;
+    Counter warm_fact_hits;
+    Counter warm_fact_evictions;
+    Counter documents_shared;
+    Counter documents_retired_in_use;
+    Counter parses_incremental;
+    Counter definitions_reused;
+    Counter definitions_recomputed;
+
+    static const CoreMetrics& get();
+};
+
+} // namespace ts_mcp
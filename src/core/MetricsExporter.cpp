@@ -0,0 +1,186 @@
+#include "core/MetricsExporter.hpp"
+#include "core/Metrics.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace ts_mcp {
+
+bool MetricsExporter::write_file() const {
+    if (file_.empty()) {
+        return false;
+    }
+
+    auto temp = file_;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out << Metrics::to_prometheus();
+        if (!out) {
+            spdlog::warn("Failed to write metrics to {}", temp.string());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp, file_, ec);
+    if (ec) {
+        spdlog::warn("Failed to publish metrics file {}: {}", file_.string(), ec.message());
+        return false;
+    }
+    return true;
+}
+
+#ifdef __linux__
+
+MetricsExporter::MetricsExporter(std::filesystem::path file,
+                                 std::filesystem::path socket,
+                                 std::chrono::milliseconds interval)
+    : file_(std::move(file)), socket_(std::move(socket)), interval_(interval) {
+    if (file_.empty() && socket_.empty()) {
+        throw std::invalid_argument("MetricsExporter needs a file or a socket path");
+    }
+
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        throw std::runtime_error(std::string("eventfd failed: ") + std::strerror(errno));
+    }
+
+    if (!socket_.empty()) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::string path = socket_.string();
+        if (path.size() >= sizeof(addr.sun_path)) {
+            ::close(wake_fd_);
+            throw std::runtime_error("Metrics socket path too long: " + path);
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (listen_fd_ < 0) {
+            ::close(wake_fd_);
+            throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+        }
+
+        ::unlink(path.c_str());
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(listen_fd_, 8) < 0) {
+            std::string error = std::strerror(errno);
+            ::close(listen_fd_);
+            ::close(wake_fd_);
+            throw std::runtime_error("Cannot listen on metrics socket " + path + ": " + error);
+        }
+    }
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(socket_.c_str());
+    }
+    ::close(wake_fd_);
+}
+
+void MetricsExporter::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    spdlog::info("Exporting metrics{}{}{}{}",
+                 file_.empty() ? "" : " to file ", file_.string(),
+                 socket_.empty() ? "" : " on socket ", socket_.string());
+    thread_ = std::thread([this] { run(); });
+}
+
+void MetricsExporter::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    uint64_t one = 1;
+    if (::write(wake_fd_, &one, sizeof(one)) < 0) {
+        spdlog::debug("Failed to wake metrics thread: {}", std::strerror(errno));
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    write_file();
+}
+
+void MetricsExporter::run() {
+    auto next_dump = std::chrono::steady_clock::now();
+
+    while (running_.load(std::memory_order_acquire)) {
+        auto now = std::chrono::steady_clock::now();
+        if (!file_.empty() && now >= next_dump) {
+            write_file();
+            next_dump = now + interval_;
+        }
+
+        int timeout = -1;
+        if (!file_.empty()) {
+            timeout = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                next_dump - std::chrono::steady_clock::now()).count());
+            timeout = std::max(timeout, 0);
+        }
+
+        pollfd fds[2] = {{wake_fd_, POLLIN, 0}, {listen_fd_, POLLIN, 0}};
+        int ready = ::poll(fds, listen_fd_ >= 0 ? 2 : 1, timeout);
+        if (ready < 0 && errno != EINTR) {
+            spdlog::warn("Metrics exporter poll failed: {}", std::strerror(errno));
+            break;
+        }
+        if (ready > 0 && (fds[1].revents & POLLIN)) {
+            serve_client();
+        }
+    }
+}
+
+void MetricsExporter::serve_client() const {
+    int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+        return;
+    }
+
+    std::string text = Metrics::to_prometheus();
+    size_t written = 0;
+    while (written < text.size()) {
+        ssize_t n = ::send(client, text.data() + written, text.size() - written, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    ::close(client);
+}
+
+#else // !__linux__
+
+MetricsExporter::MetricsExporter(std::filesystem::path file,
+                                 std::filesystem::path socket,
+                                 std::chrono::milliseconds interval)
+    : file_(std::move(file)), socket_(std::move(socket)), interval_(interval) {
+    throw std::runtime_error("Metrics export is only supported on Linux");
+}
+
+MetricsExporter::~MetricsExporter() = default;
+void MetricsExporter::start() {}
+void MetricsExporter::stop() {}
+
+#endif
+
+} // namespace ts_mcp
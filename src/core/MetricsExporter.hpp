@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+namespace ts_mcp {
+
+/**
+ * @brief Publishes Metrics::to_prometheus() outside the process
+ *
+ * Two independent sinks:
+ * - a text file rewritten atomically (temp file + rename) every interval
+ *   and on stop(), suitable for node_exporter's textfile collector;
+ * - a Unix domain socket that answers every connection with the current
+ *   dump and closes it (e.g. `socat - UNIX-CONNECT:<path>`).
+ *
+ * A background thread serves both. Linux only; the constructor throws
+ * elsewhere.
+ */
+class MetricsExporter {
+public:
+    /**
+     * @brief Create an exporter (not yet started)
+     * @param file Dump file (empty: none)
+     * @param socket Socket path (empty: none); a stale socket file is replaced
+     * @param interval Time between file dumps
+     * @throws std::invalid_argument if both sinks are empty
+     * @throws std::runtime_error if the socket cannot be bound
+     */
+    MetricsExporter(std::filesystem::path file,
+                    std::filesystem::path socket,
+                    std::chrono::milliseconds interval = std::chrono::seconds(10));
+
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    void start();
+
+    /**
+     * @brief Stop the thread and write a final dump (idempotent)
+     */
+    void stop();
+
+    /**
+     * @brief Write the dump file now
+     * @return false if it could not be written
+     */
+    bool write_file() const;
+
+private:
+    void run();
+
+    void serve_client() const;
+
+    std::filesystem::path file_;
+    std::filesystem::path socket_;
+    std::chrono::milliseconds interval_;
+
+    int listen_fd_ = -1;
+    int wake_fd_ = -1;  // eventfd used to interrupt poll() on stop()
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,77 @@
+#include "core/ParseGuard.hpp"
+#include <algorithm>
+#include <array>
+
+namespace ts_mcp {
+
+namespace {
+
+constexpr size_t MARKER_WINDOW = 4096;      // Generated-file markers sit in the header comment
+constexpr size_t MINIFIED_SAMPLE = 256 * 1024;
+constexpr size_t MINIFIED_AVERAGE_LINE = 250;  // Hand-written code averages well under 50
+
+constexpr std::array<std::string_view, 7> GENERATED_MARKERS = {
+    "@generated",
+    "DO NOT EDIT",
+    "Do not edit",
+    "Code generated by",
+    "Generated by the protocol buffer compiler",
+    "automatically generated",
+    "autogenerated",
+};
+
+} // namespace
+
+void ParseGuard::set_limits(const ParseLimits& limits) {
+    max_file_bytes_.store(limits.max_file_bytes, std::memory_order_relaxed);
+    max_generated_bytes_.store(limits.max_generated_bytes, std::memory_order_relaxed);
+    timeout_ms_.store(limits.timeout_ms, std::memory_order_relaxed);
+}
+
+ParseLimits ParseGuard::limits() {
+    ParseLimits limits;
+    limits.max_file_bytes = max_file_bytes_.load(std::memory_order_relaxed);
+    limits.max_generated_bytes = max_generated_bytes_.load(std::memory_order_relaxed);
+    limits.timeout_ms = timeout_ms_.load(std::memory_order_relaxed);
+    return limits;
+}
+
+DegradeReason ParseGuard::check(std::string_view source) {
+    if (source.size() > max_file_bytes_.load(std::memory_order_relaxed)) {
+        return DegradeReason::TOO_LARGE;
+    }
+    if (source.size() > max_generated_bytes_.load(std::memory_order_relaxed)) {
+        if (looks_generated(source)) {
+            return DegradeReason::GENERATED;
+        }
+        if (looks_minified(source)) {
+            return DegradeReason::MINIFIED;
+        }
+    }
+    return DegradeReason::NONE;
+}
+
+bool ParseGuard::looks_generated(std::string_view source) {
+    std::string_view head = source.substr(0, MARKER_WINDOW);
+    return std::any_of(GENERATED_MARKERS.begin(), GENERATED_MARKERS.end(),
+                       [head](std::string_view marker) { return head.find(marker) != std::string_view::npos; });
+}
+
+bool ParseGuard::looks_minified(std::string_view source) {
+    std::string_view sample = source.substr(0, MINIFIED_SAMPLE);
+    size_t lines = static_cast<size_t>(std::count(sample.begin(), sample.end(), '\n')) + 1;
+    return sample.size() / lines > MINIFIED_AVERAGE_LINE;
+}
+
+std::string_view ParseGuard::to_string(DegradeReason reason) {
+    switch (reason) {
+        case DegradeReason::NONE: return "none";
+        case DegradeReason::TOO_LARGE: return "too_large";
+        case DegradeReason::GENERATED: return "generated";
+        case DegradeReason::MINIFIED: return "minified";
+        case DegradeReason::TIMEOUT: return "timeout";
+    }
+    return "unknown";
+}
+
+} // namespace ts_mcp
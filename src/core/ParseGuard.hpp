@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ts_mcp {
+
+/**
+ * @brief Limits that keep one pathological file from dominating a request
+ */
+struct ParseLimits {
+    size_t max_file_bytes = 8u << 20;       // Larger files are never parsed
+    size_t max_generated_bytes = 1u << 20;  // Larger generated or minified files are not parsed
+    uint64_t timeout_ms = 3000;             // Per parse (0 = no limit)
+};
+
+/**
+ * @brief Why a file was not parsed
+ */
+enum class DegradeReason {
+    NONE,
+    TOO_LARGE,
+    GENERATED,
+    MINIFIED,
+    TIMEOUT
+};
+
+/**
+ * @brief Process-wide parse limits, applied by TreeSitterParser
+ *
+ * A source is refused before parsing if it exceeds max_file_bytes, or if
+ * it exceeds max_generated_bytes and looks generated (a "do not edit"
+ * style marker near the top) or minified (very long lines). A parse that
+ * runs past timeout_ms is cancelled. Either way the caller gets no tree
+ * and falls back to lexical-only results flagged "degraded".
+ */
+class ParseGuard {
+public:
+    static void set_limits(const ParseLimits& limits);
+    static ParseLimits limits();
+
+    /**
+     * @brief Reason to refuse parsing a source, or NONE
+     */
+    static DegradeReason check(std::string_view source);
+
+    static bool looks_generated(std::string_view source);
+    static bool looks_minified(std::string_view source);
+
+    static std::string_view to_string(DegradeReason reason);
+
+private:
+    static inline std::atomic<size_t> max_file_bytes_{ParseLimits{}.max_file_bytes};
+    static inline std::atomic<size_t> max_generated_bytes_{ParseLimits{}.max_generated_bytes};
+    static inline std::atomic<uint64_t> timeout_ms_{ParseLimits{}.timeout_ms};
+};
+
+} // namespace ts_mcp
@@ -1,11 +1,301 @@
 #include "PathResolver.hpp"
+#include "core/DirectoryWalker.hpp"
+#include "core/RequestProfile.hpp"
+#include "core/ShardContext.hpp"
+#include "core/Trace.hpp"
 #include <spdlog/spdlog.h>
 #include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
 #include <set>
-#include <regex>
 
 namespace ts_mcp {
 
+namespace {
+
+// Each inventory holds a full listing of its tree; keep only a few roots
+constexpr size_t MAX_INVENTORIES = 4;
+
+struct InventoryEntry {
+    std::shared_ptr<FileInventory> inventory;
+    bool watched = false;  // Every directory of the inventory is watched
+};
+
+struct InventoryRegistry {
+    std::mutex mutex;
+    std::list<InventoryEntry> entries;  // Most recently used first
+    std::shared_ptr<FileWatcher> watcher;
+    std::atomic<bool> enabled{true};
+
+    std::atomic<bool> git_index_enabled{false};
+    std::map<std::string, std::shared_ptr<GitIndex>> git_indexes;  // Work tree -> index
+    std::map<std::string, int64_t> unusable_indexes;  // Work tree -> index mtime when loading failed
+};
+
+InventoryRegistry& registry() {
+    static InventoryRegistry instance;
+    return instance;
+}
+
+std::string with_slash(std::string path) {
+    if (path.empty() || path.back() != '/') {
+        path += '/';
+    }
+    return path;
+}
+
+bool is_fully_watched(const FileWatcher& watcher, const FileInventory& inventory) {
+    if (!watcher.healthy()) {
+        return false;
+    }
+    std::string root = inventory.root().string();
+    if (!root.empty() && root.back() == '/') {
+        root.pop_back();
+    }
+    for (const auto& rel_dir : inventory.directories()) {
+        std::string dir = rel_dir.empty() ? root : root + "/" + rel_dir.substr(0, rel_dir.size() - 1);
+        if (!watcher.is_watching(dir)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void PathResolver::set_inventory_enabled(bool enabled) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.enabled = enabled;
+    if (!enabled) {
+        reg.entries.clear();
+    }
+}
+
+std::vector<std::shared_ptr<FileInventory>> PathResolver::inventories() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<std::shared_ptr<FileInventory>> result;
+    for (const auto& entry : reg.entries) {
+        result.push_back(entry.inventory);
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<GitIndex>> PathResolver::git_indexes() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<std::shared_ptr<GitIndex>> result;
+    for (const auto& [work_tree, index] : reg.git_indexes) {
+        result.push_back(index);
+    }
+    return result;
+}
+
+void PathResolver::set_git_index_enabled(bool enabled) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.git_index_enabled = enabled;
+    if (!enabled) {
+        reg.git_indexes.clear();
+        reg.unusable_indexes.clear();
+    }
+}
+
+bool PathResolver::git_index_enabled() {
+    return registry().git_index_enabled.load();
+}
+
+std::shared_ptr<GitIndex> PathResolver::find_git_index(
+    const std::filesystem::path& dir,
+    std::string& rel_dir
+) {
+    auto work_tree = GitIndex::find_work_tree(dir);
+    if (!work_tree) {
+        return nullptr;
+    }
+
+    std::string work_tree_str = work_tree->string();
+    std::string dir_str = dir.string();
+    if (work_tree_str.back() != '/') {
+        work_tree_str += '/';
+    }
+    if (dir_str.back() != '/') {
+        dir_str += '/';
+    }
+    rel_dir = dir_str.substr(work_tree_str.size());
+    if (rel_dir.rfind(".git/", 0) == 0) {
+        return nullptr;
+    }
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (!reg.git_index_enabled) {
+        return nullptr;
+    }
+
+    auto it = reg.git_indexes.find(work_tree_str);
+    if (it != reg.git_indexes.end()) {
+        if (it->second->is_current()) {
+            return it->second;
+        }
+        reg.git_indexes.erase(it);
+    }
+
+    // Do not retry a broken or unsupported index until git rewrites it
+    WalkEntry index_stat;
+    auto index_path = GitIndex::locate_index(*work_tree);
+    if (!index_path || !DirectoryWalker::stat_path(*index_path, index_stat)) {
+        return nullptr;
+    }
+    auto failed = reg.unusable_indexes.find(work_tree_str);
+    if (failed != reg.unusable_indexes.end() && failed->second == index_stat.mtime_ns) {
+        return nullptr;
+    }
+
+    try {
+        auto index = std::make_shared<GitIndex>(*work_tree);
+        reg.git_indexes[work_tree_str] = index;
+        reg.unusable_indexes.erase(work_tree_str);
+        return index;
+    } catch (const std::exception& e) {
+        spdlog::info("Not using git index of {}: {}", work_tree_str, e.what());
+        reg.unusable_indexes[work_tree_str] = index_stat.mtime_ns;
+        return nullptr;
+    }
+}
+
+std::optional<ObjectId> PathResolver::indexed_blob_id(const std::filesystem::path& file) {
+    if (!git_index_enabled() || !file.is_absolute()) {
+        return std::nullopt;
+    }
+
+    std::string rel_dir;
+    auto index = find_git_index(file.parent_path(), rel_dir);
+    if (!index) {
+        return std::nullopt;
+    }
+
+    WalkEntry stat;
+    if (!DirectoryWalker::stat_path(file, stat)) {
+        return std::nullopt;
+    }
+    return index->blob_id_if_unchanged(rel_dir + file.filename().string(), stat);
+}
+
+void PathResolver::attach_watcher(std::shared_ptr<FileWatcher> watcher) {
+    watcher->add_listener([](const ChangeBatch& batch) {
+        // Notified outside the registry lock: an inventory being refreshed
+        // holds its own lock for the duration of the walk
+        std::vector<std::shared_ptr<FileInventory>> inventories;
+        {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (const auto& entry : reg.entries) {
+                inventories.push_back(entry.inventory);
+            }
+        }
+        for (const auto& inventory : inventories) {
+            if (batch.overflow) {
+                inventory->invalidate_all();
+                continue;
+            }
+            for (const auto& path : batch.paths) {
+                inventory->notify_changed(path);
+            }
+        }
+    });
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.watcher = std::move(watcher);
+}
+
+std::shared_ptr<FileInventory> PathResolver::find_inventory(
+    const std::filesystem::path& dir,
+    bool create,
+    std::string& rel_dir
+) {
+    auto& reg = registry();
+
+    // Deliver queued change events before taking the registry lock (the
+    // watcher listener takes it too)
+    std::shared_ptr<FileWatcher> watcher;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        watcher = reg.watcher;
+    }
+    if (watcher && watcher->healthy()) {
+        watcher->sync();
+    }
+
+    std::string dir_str = with_slash(dir.string());
+
+    // The registry lock is held only to look inventories up and insert
+    // them: refreshing or building one walks the tree, under its own lock
+    std::vector<InventoryEntry> candidates;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (!reg.enabled) {
+            return nullptr;
+        }
+        for (const auto& entry : reg.entries) {
+            std::string root_str = with_slash(entry.inventory->root().string());
+            if (dir_str.compare(0, root_str.size(), root_str) == 0) {
+                candidates.push_back(entry);
+            }
+        }
+    }
+
+    for (const auto& candidate : candidates) {
+        const auto& inventory = candidate.inventory;
+        // A healthy watcher reports every change, so directories need no stat
+        bool trust_watcher = candidate.watched && watcher && watcher->healthy();
+        inventory->refresh(!trust_watcher);
+
+        std::string rel = dir_str.substr(with_slash(inventory->root().string()).size());
+        if (!inventory->contains_directory(rel)) {
+            continue;  // Pruned from that inventory (ignored or excluded)
+        }
+
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto it = std::find_if(reg.entries.begin(), reg.entries.end(),
+                               [&](const InventoryEntry& entry) { return entry.inventory == inventory; });
+        if (it != reg.entries.end()) {
+            reg.entries.splice(reg.entries.begin(), reg.entries, it);
+        }
+        rel_dir = std::move(rel);
+        return inventory;
+    }
+
+    if (!create) {
+        return nullptr;
+    }
+
+    InventoryEntry entry;
+    entry.inventory = std::make_shared<FileInventory>(dir);
+    entry.watched = watcher && is_fully_watched(*watcher, *entry.inventory);
+
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    // Another thread may have built the same root meanwhile: keep the first
+    auto it = std::find_if(reg.entries.begin(), reg.entries.end(), [&](const InventoryEntry& other) {
+        return with_slash(other.inventory->root().string()) == dir_str;
+    });
+    if (it != reg.entries.end()) {
+        reg.entries.splice(reg.entries.begin(), reg.entries, it);
+    } else {
+        reg.entries.push_front(std::move(entry));
+        if (reg.entries.size() > MAX_INVENTORIES) {
+            reg.entries.pop_back();
+        }
+    }
+    rel_dir.clear();
+    return reg.entries.front().inventory;
+}
+
 bool PathResolver::is_cpp_file(const std::filesystem::path& path) {
     static const std::set<std::string> cpp_extensions = {
         ".cpp", ".hpp", ".h", ".cc", ".cxx", ".hxx", ".C", ".H"
@@ -15,83 +305,62 @@ bool PathResolver::is_cpp_file(const std::filesystem::path& path) {
     return cpp_extensions.find(ext) != cpp_extensions.end();
 }
 
-bool PathResolver::matches_pattern(const std::filesystem::path& path, const std::string& pattern) {
-    // Convert glob pattern to regex
-    // Example: "*.cpp" -> ".*\.cpp"
-    std::string regex_pattern = pattern;
-
-    // Escape special regex characters except *
-    std::string escaped;
-    for (char c : regex_pattern) {
-        if (c == '*') {
-            escaped += ".*";
-        } else if (c == '.') {
-            escaped += "\\.";
-        } else if (c == '?') {
-            escaped += ".";
-        } else {
-            escaped += c;
-        }
-    }
-
-    std::regex re("^" + escaped + "$");
-    return std::regex_match(path.filename().string(), re);
-}
-
 void PathResolver::scan_directory(
     const std::filesystem::path& dir,
     bool recursive,
-    const std::vector<std::string>& patterns,
+    const GlobSet& globs,
     std::vector<std::filesystem::path>& results
 ) {
+    TraceSpan span("scan_directory", dir.string());
     if (!std::filesystem::exists(dir) || !std::filesystem::is_directory(dir)) {
         spdlog::warn("Path is not a directory: {}", dir.string());
         return;
     }
 
-    try {
-        if (recursive) {
-            for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
-                if (entry.is_regular_file()) {
-                    const auto& file_path = entry.path();
-
-                    // Check against patterns
-                    bool matches = false;
-                    for (const auto& pattern : patterns) {
-                        if (matches_pattern(file_path, pattern)) {
-                            matches = true;
-                            break;
-                        }
-                    }
-
-                    if (matches) {
-                        results.push_back(file_path);
-                    }
-                }
-            }
-        } else {
-            for (const auto& entry : std::filesystem::directory_iterator(dir)) {
-                if (entry.is_regular_file()) {
-                    const auto& file_path = entry.path();
-
-                    // Check against patterns
-                    bool matches = false;
-                    for (const auto& pattern : patterns) {
-                        if (matches_pattern(file_path, pattern)) {
-                            matches = true;
-                            break;
-                        }
-                    }
-
-                    if (matches) {
-                        results.push_back(file_path);
-                    }
-                }
-            }
+    std::error_code ec;
+    auto canonical_dir = std::filesystem::canonical(dir, ec);
+    if (ec) {
+        spdlog::warn("Cannot canonicalize path {}: {}", dir.string(), ec.message());
+        return;
+    }
+
+    std::string rel_dir;
+    if (git_index_enabled()) {
+        auto index = find_git_index(canonical_dir, rel_dir);
+        if (index) {
+            auto files = index->query(rel_dir, recursive, globs);
+            results.insert(results.end(),
+                           std::make_move_iterator(files.begin()),
+                           std::make_move_iterator(files.end()));
+            return;
         }
-    } catch (const std::filesystem::filesystem_error& e) {
-        spdlog::error("Error scanning directory {}: {}", dir.string(), e.what());
     }
+
+    auto inventory = find_inventory(canonical_dir, recursive, rel_dir);
+    if (inventory) {
+        auto files = inventory->query(rel_dir, recursive, globs);
+        results.insert(results.end(),
+                       std::make_move_iterator(files.begin()),
+                       std::make_move_iterator(files.end()));
+        return;
+    }
+
+    WalkOptions options;
+    options.recursive = recursive;
+    DirectoryWalker walker(options);
+
+    auto files = walker.walk(
+        canonical_dir,
+        [&globs](std::string_view rel_path, std::string_view name) {
+            return globs.matches(rel_path, name);
+        },
+        [&globs](std::string_view rel_dir) {
+            return globs.may_match_under(rel_dir);
+        });
+
+    results.insert(results.end(),
+                   std::make_move_iterator(files.begin()),
+                   std::make_move_iterator(files.end()));
 }
 
 std::vector<std::filesystem::path> PathResolver::resolve_paths(
@@ -99,8 +368,9 @@ std::vector<std::filesystem::path> PathResolver::resolve_paths(
     bool recursive,
     const std::vector<std::string>& patterns
 ) {
+    TraceSpan span("resolve_paths");
     std::vector<std::filesystem::path> results;
-    std::set<std::filesystem::path> unique_paths; // For deduplication
+    const GlobSet globs(patterns);
 
     for (const auto& path_str : paths) {
         std::filesystem::path path(path_str);
@@ -112,41 +382,35 @@ std::vector<std::filesystem::path> PathResolver::resolve_paths(
 
         if (std::filesystem::is_regular_file(path)) {
             // Check if file matches patterns
-            bool matches = false;
-            for (const auto& pattern : patterns) {
-                if (matches_pattern(path, pattern)) {
-                    matches = true;
-                    break;
-                }
-            }
-
-            if (matches) {
-                unique_paths.insert(std::filesystem::canonical(path));
+            if (globs.matches(path.generic_string(), path.filename().string())) {
+                results.push_back(std::filesystem::canonical(path));
             } else {
                 spdlog::debug("File {} does not match any pattern", path.string());
             }
         } else if (std::filesystem::is_directory(path)) {
-            std::vector<std::filesystem::path> dir_results;
-            scan_directory(path, recursive, patterns, dir_results);
-
-            // Add to unique set (canonicalized)
-            for (const auto& file : dir_results) {
-                try {
-                    unique_paths.insert(std::filesystem::canonical(file));
-                } catch (const std::filesystem::filesystem_error& e) {
-                    spdlog::warn("Cannot canonicalize path {}: {}", file.string(), e.what());
-                }
-            }
+            // Results are already rooted at the canonical directory
+            scan_directory(path, recursive, globs, results);
         } else {
             spdlog::warn("Path is neither file nor directory: {}", path_str);
         }
     }
 
-    // Convert set to sorted vector
-    results.assign(unique_paths.begin(), unique_paths.end());
+    // Sort and deduplicate (overlapping inputs)
     std::sort(results.begin(), results.end());
+    results.erase(std::unique(results.begin(), results.end()), results.end());
+
+    // A shard worker only handles its own part of the files
+    if (const ShardContext* shard = ShardContext::current(); shard && shard->is_worker()) {
+        results.erase(std::remove_if(results.begin(), results.end(),
+                                     [shard](const auto& file) { return !shard->owns(file); }),
+                      results.end());
+    }
 
     spdlog::debug("Resolved {} paths from {} input paths", results.size(), paths.size());
+    if (Tracer::enabled()) {
+        span.set_detail(std::to_string(results.size()) + " files");
+    }
+    RequestProfile::add_resolved_files(results.size());
 
     return results;
 }
@@ -1,6 +1,12 @@
 #pragma once
 
+#include "core/FileInventory.hpp"
+#include "core/FileWatcher.hpp"
+#include "core/GitIndex.hpp"
+#include "core/GlobMatcher.hpp"
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -11,6 +17,24 @@ namespace ts_mcp {
  *
  * Handles single files, directories, and arrays of paths.
  * Supports recursive directory scanning with file pattern matching.
+ * Directory scans use DirectoryWalker: they run in parallel, honor
+ * .gitignore/.ignore files and skip VCS, build and vendored dependency
+ * directories (.git, build, node_modules, third_party, _deps) below the
+ * requested roots.
+ *
+ * The pattern list is compiled once per call into a GlobSet, so filtering
+ * costs a hash lookup per file for the common "*.ext" patterns.
+ *
+ * Recursive scans are answered from a resident FileInventory per workspace
+ * directory. The first scan of a directory builds it; later scans of the
+ * same directory or any of its subdirectories only re-stat directories and
+ * re-list the ones that changed. Files are reported under the canonical
+ * directory path. With a FileWatcher attached, inventories whose directories
+ * are all watched skip the directory stat sweep entirely.
+ *
+ * With the git index enabled, scans of directories inside a git work tree
+ * list the tracked files straight from .git/index (see GitIndex) and need
+ * no directory walk at all; untracked files are not reported then.
  */
 class PathResolver {
 public:
@@ -19,7 +43,9 @@ public:
      *
      * @param paths Array of file paths or directory paths
      * @param recursive If true, scan directories recursively
-     * @param patterns Glob patterns for file filtering (e.g., "*.cpp", "*.hpp")
+     * @param patterns Glob patterns for file filtering (e.g., "*.cpp", "test_*.hpp");
+     *                 patterns containing '/' are matched against the path relative
+     *                 to the scanned directory, and "**" spans directories
      * @return Vector of resolved file paths (sorted, no duplicates)
      */
     static std::vector<std::filesystem::path> resolve_paths(
@@ -28,26 +54,87 @@ public:
         const std::vector<std::string>& patterns = {"*.cpp", "*.hpp", "*.h", "*.cc", "*.cxx"}
     );
 
+    /**
+     * @brief Enable or disable the resident inventory (enabled by default)
+     *
+     * When disabled every scan walks the directory and existing
+     * inventories are dropped.
+     */
+    static void set_inventory_enabled(bool enabled);
+
+    /**
+     * @brief Enable or disable listing files from the git index (disabled by default)
+     */
+    static void set_git_index_enabled(bool enabled);
+
+    static bool git_index_enabled();
+
+    /**
+     * @brief Blob id of a file that is unchanged since git last recorded it
+     *
+     * Costs one stat() of the file; the content is not read.
+     * @param file Canonical file path
+     * @return nullopt if the git index is disabled, the file is untracked,
+     *         modified, or its stat data cannot be trusted
+     */
+    static std::optional<ObjectId> indexed_blob_id(const std::filesystem::path& file);
+
+    /**
+     * @brief Route change notifications from a watcher into the inventories
+     *
+     * Must be called before the watcher is started.
+     */
+    static void attach_watcher(std::shared_ptr<FileWatcher> watcher);
+
+    /**
+     * @brief Snapshot of the resident inventories (most recently used first)
+     */
+    static std::vector<std::shared_ptr<FileInventory>> inventories();
+
+    /**
+     * @brief Snapshot of the loaded git indexes
+     */
+    static std::vector<std::shared_ptr<GitIndex>> git_indexes();
+
 private:
     /**
-     * @brief Check if file has a C++ extension
+     * @brief Find an inventory containing a directory, optionally creating one
+     *
+     * @param dir Canonical directory
+     * @param create Build a new inventory rooted at dir if none covers it
+     * @param rel_dir Output: dir relative to the inventory root ("" or "a/b/")
+     * @return Refreshed inventory, or nullptr
      */
-    static bool is_cpp_file(const std::filesystem::path& path);
+    static std::shared_ptr<FileInventory> find_inventory(
+        const std::filesystem::path& dir,
+        bool create,
+        std::string& rel_dir
+    );
 
     /**
-     * @brief Check if filename matches glob pattern
+     * @brief Find the (re)loaded git index of the work tree containing a directory
      *
-     * Supports simple wildcards: *.cpp, test_*.hpp, etc.
+     * @param dir Canonical directory
+     * @param rel_dir Output: dir relative to the work tree ("" or "a/b/")
+     * @return Current index, or nullptr outside a work tree or if the index is unusable
      */
-    static bool matches_pattern(const std::filesystem::path& path, const std::string& pattern);
+    static std::shared_ptr<GitIndex> find_git_index(
+        const std::filesystem::path& dir,
+        std::string& rel_dir
+    );
+
+    /**
+     * @brief Check if file has a C++ extension
+     */
+    static bool is_cpp_file(const std::filesystem::path& path);
 
     /**
-     * @brief Recursively scan directory for matching files
+     * @brief Scan directory for matching files (parallel, ignore-aware)
      */
     static void scan_directory(
         const std::filesystem::path& dir,
         bool recursive,
-        const std::vector<std::string>& patterns,
+        const GlobSet& globs,
         std::vector<std::filesystem::path>& results
     );
 };
@@ -0,0 +1,414 @@
+#include "core/Prefetcher.hpp"
+#include "core/Language.hpp"
+#include "core/LexicalScanner.hpp"
+#include "core/Trace.hpp"
+#include "core/WarmUp.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <stdexcept>
+
+namespace ts_mcp {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int MAX_PARENT_LEVELS = 8;  // Directories above a file searched for its includes
+constexpr size_t MAX_TYPES = 64;      // Used types looked up per file
+constexpr size_t MAX_QUEUED_PER_FILE = 8;  // Queue limit, in multiples of max_files
+constexpr size_t MAX_REMEMBERED = 4096;    // Prefetched files remembered for the hit counter
+
+const std::vector<std::string> SOURCE_EXTENSIONS = {".cpp", ".cc", ".cxx"};
+const std::vector<std::string> HEADER_EXTENSIONS = {".hpp", ".h", ".hh"};
+
+bool is_file(const fs::path& path) {
+    std::error_code ec;
+    return fs::is_regular_file(path, ec);
+}
+
+/**
+ * @brief First existing dir / relative, for start and the directories above it
+ */
+std::optional<fs::path> find_upwards(const fs::path& start, const fs::path& relative) {
+    fs::path dir = start;
+    for (int level = 0; level <= MAX_PARENT_LEVELS; ++level) {
+        fs::path candidate = dir / relative;
+        if (is_file(candidate)) {
+            return candidate.lexically_normal();
+        }
+        if (!dir.has_parent_path() || dir.parent_path() == dir) {
+            break;
+        }
+        dir = dir.parent_path();
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief The file a quoted include or a Python import refers to, if it is in the tree
+ */
+std::optional<fs::path> resolve_include(const fs::path& file, const LexicalScanner::Include& include,
+                                        Language lang) {
+    fs::path dir = file.parent_path();
+    if (lang == Language::CPP) {
+        if (include.is_system) {
+            return std::nullopt;  // Standard and third-party headers
+        }
+        return find_upwards(dir, include.path);
+    }
+
+    // Dotted module name, relative to the file's package when it starts with dots
+    std::string_view module = include.path;
+    size_t dots = 0;
+    while (dots < module.size() && module[dots] == '.') {
+        dots++;
+    }
+    fs::path relative;
+    for (size_t start = dots; start < module.size();) {
+        size_t end = std::min(module.find('.', start), module.size());
+        relative /= std::string(module.substr(start, end - start));
+        start = end + 1;
+    }
+    std::vector<fs::path> candidates = {"__init__.py"};
+    if (!relative.empty()) {
+        fs::path module_file = relative;
+        module_file += ".py";
+        candidates = {module_file, relative / "__init__.py"};
+    }
+
+    if (dots > 0) {
+        for (size_t up = 1; up < dots; ++up) {
+            dir = dir.parent_path();
+        }
+        for (const auto& candidate : candidates) {
+            if (is_file(dir / candidate)) {
+                return (dir / candidate).lexically_normal();
+            }
+        }
+        return std::nullopt;
+    }
+    for (const auto& candidate : candidates) {
+        if (auto found = find_upwards(dir, candidate)) {
+            return found;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+Prefetcher::Yield::Yield(Prefetcher* prefetcher) : prefetcher_(prefetcher) {
+    if (prefetcher_) {
+        std::lock_guard<std::mutex> lock(prefetcher_->mutex_);
+        prefetcher_->yields_++;
+    }
+}
+
+Prefetcher::Yield::~Yield() {
+    if (prefetcher_) {
+        std::lock_guard<std::mutex> lock(prefetcher_->mutex_);
+        prefetcher_->yields_--;
+        prefetcher_->resume_at_ = std::max(prefetcher_->resume_at_,
+                                           std::chrono::steady_clock::now() + prefetcher_->budget_.resume_delay);
+        prefetcher_->wake_.notify_all();
+    }
+}
+
+Prefetcher::Prefetcher(std::shared_ptr<ASTAnalyzer> analyzer, Budget budget)
+    : analyzer_(std::move(analyzer)),
+      budget_(budget),
+      files_prefetched_(Metrics::counter("ts_mcp_prefetch_files_total",
+                                         "Files parsed ahead of requests (neighbors of requested files)")),
+      files_skipped_(Metrics::counter("ts_mcp_prefetch_skipped_total",
+                                      "Neighbors not prefetched because the hot tier was at its budget")),
+      prefetch_hits_(Metrics::counter("ts_mcp_prefetch_hits_total",
+                                      "Requested files that had been prefetched")) {
+    if (!analyzer_) {
+        throw std::invalid_argument("Analyzer cannot be null");
+    }
+    budget_.cpu_percent = std::clamp(budget_.cpu_percent, 1u, 100u);
+    steps_.push_back(Indexer::builtin_facts);
+}
+
+Prefetcher::~Prefetcher() {
+    stop();
+}
+
+void Prefetcher::add_step(FileStep step) {
+    steps_.push_back(std::move(step));
+}
+
+void Prefetcher::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (thread_.joinable() || stopping_) {
+        return;
+    }
+    thread_ = std::thread([this] { run(); });
+}
+
+void Prefetcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        queue_.clear();
+        wake_.notify_all();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Prefetcher::request_done(const std::vector<fs::path>& files) {
+    std::vector<fs::path> seeds;
+    for (const auto& file : files) {
+        std::error_code ec;
+        fs::path path = fs::canonical(file, ec);  // As PathResolver names files
+        if (!ec && is_file(path)) {
+            seeds.push_back(std::move(path));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return;
+    }
+    // The latest request goes first, its files in order
+    for (auto it = seeds.rbegin(); it != seeds.rend(); ++it) {
+        auto id = StringInterner::find(it->string());
+        if (id && prefetched_.erase(*id)) {
+            prefetch_hits_.add();
+        }
+        queue_.push_front({*it, true});
+    }
+    while (queue_.size() > budget_.max_files * MAX_QUEUED_PER_FILE) {
+        queue_.pop_back();
+    }
+    wake_.notify_all();
+}
+
+bool Prefetcher::wait_idle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return wake_.wait_for(lock, timeout, [this] { return queue_.empty() && !busy_; });
+}
+
+std::vector<fs::path> Prefetcher::neighbors(const fs::path& filepath) {
+    std::vector<fs::path> result;
+    std::set<fs::path> seen = {filepath};
+    auto add = [&](const fs::path& path) {
+        if (result.size() < budget_.max_files && seen.insert(path).second) {
+            result.push_back(path);
+        }
+    };
+
+    Language lang = LanguageUtils::detect_from_extension(filepath);
+    if (lang == Language::UNKNOWN) {
+        return result;
+    }
+
+    if (lang == Language::CPP) {
+        bool header = std::find(HEADER_EXTENSIONS.begin(), HEADER_EXTENSIONS.end(),
+                                filepath.extension().string()) != HEADER_EXTENSIONS.end();
+        for (const auto& extension : header ? SOURCE_EXTENSIONS : HEADER_EXTENSIONS) {
+            fs::path pair = filepath;
+            pair.replace_extension(extension);
+            if (is_file(pair)) {
+                add(pair);
+            }
+        }
+    }
+
+    auto snapshot = analyzer_->snapshot(filepath, lang);
+    if (!snapshot) {
+        return result;
+    }
+
+    std::set<fs::path> directories = {filepath.parent_path()};
+    for (const auto& include : LexicalScanner::includes(snapshot->source(), lang)) {
+        if (auto resolved = resolve_include(filepath, include, lang)) {
+            add(*resolved);
+            directories.insert(resolved->parent_path());
+        }
+    }
+
+    for (const auto& type : used_types(*snapshot)) {
+        std::optional<fs::path> site;
+        if (auto name = StringInterner::find(type)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = definitions_.find(*name);
+            if (it != definitions_.end()) {
+                site = it->second.view();
+            }
+        }
+        // By convention a C++ type lives in a header named after it
+        for (auto dir = directories.begin(); !site && lang == Language::CPP && dir != directories.end(); ++dir) {
+            for (const auto& extension : HEADER_EXTENSIONS) {
+                if (is_file(*dir / (type + extension))) {
+                    site = *dir / (type + extension);
+                    break;
+                }
+            }
+        }
+        if (site) {
+            add(*site);
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> Prefetcher::used_types(const DocumentSnapshot& snapshot) {
+    std::string_view query_string = snapshot.language() == Language::CPP
+        ? "(type_identifier) @type"
+        : "[(type (identifier) @type)"
+          " (class_definition superclasses: (argument_list (identifier) @type))"
+          " (call function: (identifier) @type)]";
+    auto query = query_engine_.compile_query(query_string, snapshot.language());
+    if (!query) {
+        return {};
+    }
+
+    std::vector<std::string> types;
+    std::set<std::string, std::less<>> seen;
+    for (const auto& match : query_engine_.execute(snapshot.tree(), *query, snapshot.source())) {
+        // Python calls only name a type when capitalized (a constructor)
+        if (snapshot.language() == Language::PYTHON &&
+            (match.text.empty() || !std::isupper(static_cast<unsigned char>(match.text[0])))) {
+            continue;
+        }
+        if (seen.insert(match.text).second) {
+            types.push_back(match.text);
+            if (types.size() >= MAX_TYPES) {
+                break;
+            }
+        }
+    }
+    return types;
+}
+
+void Prefetcher::run() {
+    WarmUp::lower_thread_priority();
+    while (auto work = next_work()) {
+        auto start = std::chrono::steady_clock::now();
+        if (work->seed) {
+            expand(work->file);
+        } else {
+            prefetch(work->file);
+        }
+        auto now = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        busy_ = false;
+        // Idle long enough that work stays at cpu_percent of the thread's time
+        auto idle = (now - start) * (100 - budget_.cpu_percent) / budget_.cpu_percent;
+        resume_at_ = std::max(resume_at_, now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(idle));
+        wake_.notify_all();
+    }
+}
+
+std::optional<Prefetcher::Work> Prefetcher::next_work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (stopping_) {
+            return std::nullopt;
+        }
+        if (queue_.empty() || yields_ > 0) {
+            wake_.wait(lock);
+        } else if (std::chrono::steady_clock::now() < resume_at_) {
+            wake_.wait_until(lock, resume_at_);
+        } else {
+            break;
+        }
+    }
+    Work work = std::move(queue_.front());
+    queue_.pop_front();
+    busy_ = true;
+    return work;
+}
+
+void Prefetcher::expand(const fs::path& file) {
+    TraceSpan span("prefetch_expand", file.string());
+    std::vector<fs::path> near;
+    try {
+        learn_definitions(file);
+        near = neighbors(file);
+    } catch (const std::exception& e) {
+        spdlog::debug("No prefetch for {}: {}", file.string(), e.what());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Nearest neighbors first, ahead of older requests' neighbors
+    for (auto it = near.rbegin(); it != near.rend(); ++it) {
+        queue_.push_front({*it, false});
+    }
+    while (queue_.size() > budget_.max_files * MAX_QUEUED_PER_FILE) {
+        queue_.pop_back();
+    }
+}
+
+void Prefetcher::prefetch(const fs::path& file) {
+    if (analyzer_->has_tree(file)) {
+        return;  // Already warm
+    }
+    if (!has_room()) {
+        files_skipped_.add();
+        return;
+    }
+
+    if (interrupted()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_front({file, false});  // After the request
+        return;
+    }
+
+    TraceSpan span("prefetch_file", file.string());
+    try {
+        // Parsed without the analyzer lock: requests meanwhile don't wait for it
+        analyzer_->snapshot(file);  // Keeps the tree: follow-ups may query it
+        for (const auto& step : steps_) {
+            if (interrupted()) {
+                break;  // The tree is warm; the request computes the facts it needs
+            }
+            step(analyzer_, file);
+        }
+        if (!interrupted()) {
+            learn_definitions(file);
+        }
+    } catch (const std::exception& e) {
+        spdlog::debug("Prefetch of {} failed: {}", file.string(), e.what());
+        return;
+    }
+    files_prefetched_.add();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (prefetched_.size() >= MAX_REMEMBERED) {
+        prefetched_.clear();
+    }
+    prefetched_.insert(StringId::of(file.string()));
+}
+
+void Prefetcher::learn_definitions(const fs::path& file) {
+    json classes = analyzer_->find_classes(file);
+    StringId file_id = StringId::of(file.string());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& match : classes.value("classes", json::array())) {
+        if (match.value("capture_name", "") == "class_name") {
+            definitions_[StringId::of(match.value("text", ""))] = file_id;
+        }
+    }
+}
+
+bool Prefetcher::interrupted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stopping_ || yields_ > 0;
+}
+
+bool Prefetcher::has_room() const {
+    CacheLimits limits = analyzer_->cache_limits();
+    return analyzer_->cache_size() < limits.max_trees &&
+           analyzer_->tree_bytes() < std::min(budget_.max_tree_bytes, limits.max_tree_bytes);
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "core/ASTAnalyzer.hpp"
+#include "core/Indexer.hpp"
+#include "core/Metrics.hpp"
+#include "core/QueryEngine.hpp"
+#include "core/StringInterner.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Analyzes the neighborhood of requested files before it is asked for
+ *
+ * An agent that asked about foo.cpp usually asks next about the headers it
+ * includes, its foo.hpp, or the files defining the types it uses. After
+ * each request the server hands the files it touched to request_done();
+ * a low-priority thread then parses those neighbors and computes their
+ * facts, keeping their trees, so the follow-up lands on warm data.
+ *
+ * Neighbors of a file, in order (see neighbors()):
+ * - the header/source with the same stem in its directory;
+ * - its quoted includes (C++) or imports (Python), resolved against its
+ *   directory and the directories above it;
+ * - definition sites of the types it uses: files whose classes the
+ *   prefetcher has seen, or (C++) a header named after the type next to
+ *   the file or its includes.
+ *
+ * Budget: at most max_files neighbors per touched file, a CPU duty cycle
+ * (after t ms of work the thread sleeps so work is cpu_percent of its
+ * time), and memory: nothing is prefetched while the hot tier holds
+ * max_tree_bytes or its tree count limit, so prefetching never evicts the
+ * trees of requests. Like WarmUp, it waits while a Yield is alive, and a
+ * Yield taken while a file is being prefetched skips its remaining steps.
+ * A parse already started runs to its end, but without the analyzer lock,
+ * so requests meanwhile do not wait for it.
+ */
+class Prefetcher {
+public:
+    using FileStep = Indexer::FileStep;
+
+    struct Budget {
+        size_t max_files = 16;               // Neighbors prefetched per touched file
+        unsigned cpu_percent = 25;           // Share of the thread's time spent working (1-100)
+        size_t max_tree_bytes = 64u << 20;   // Hot tier bytes above which nothing is prefetched
+        std::chrono::milliseconds resume_delay{200};  // Quiet time after a request
+    };
+
+    /**
+     * @brief Pauses the prefetcher for its lifetime (nullptr: no-op)
+     */
+    class Yield {
+    public:
+        explicit Yield(Prefetcher* prefetcher);
+        ~Yield();
+        Yield(const Yield&) = delete;
+        Yield& operator=(const Yield&) = delete;
+
+    private:
+        Prefetcher* prefetcher_;
+    };
+
+    Prefetcher(std::shared_ptr<ASTAnalyzer> analyzer, Budget budget);
+
+    /**
+     * @brief Stops the thread
+     */
+    ~Prefetcher();
+
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+
+    /**
+     * @brief Add work done for each prefetched file (before start())
+     *
+     * The built-in step parses the file and computes analyze_file,
+     * find_classes, find_functions and find_includes.
+     */
+    void add_step(FileStep step);
+
+    void start();
+
+    /**
+     * @brief Stop the thread after its current file; queued files are dropped
+     */
+    void stop();
+
+    /**
+     * @brief Queue the neighborhood of files a request touched (returns immediately)
+     */
+    void request_done(const std::vector<std::filesystem::path>& files);
+
+    /**
+     * @brief Files worth prefetching after filepath, nearest first (at most max_files)
+     */
+    std::vector<std::filesystem::path> neighbors(const std::filesystem::path& filepath);
+
+    /**
+     * @brief Wait until the queue is empty and the thread idle
+     * @return false on timeout
+     */
+    bool wait_idle(std::chrono::milliseconds timeout);
+
+private:
+    struct Work {
+        std::filesystem::path file;
+        bool seed = false;  // Touched by a request: expand, don't prefetch
+    };
+
+    void run();
+    std::optional<Work> next_work();
+    void expand(const std::filesystem::path& file);
+    void prefetch(const std::filesystem::path& file);
+    void learn_definitions(const std::filesystem::path& file);
+
+    /**
+     * @brief Whether a Yield is alive or the thread stopping: checked between the steps of a file
+     */
+    bool interrupted() const;
+    bool has_room() const;
+    std::vector<std::string> used_types(const DocumentSnapshot& snapshot);
+
+    std::shared_ptr<ASTAnalyzer> analyzer_;
+    Budget budget_;
+    std::vector<FileStep> steps_;
+    QueryEngine query_engine_;
+
+    mutable std::mutex mutex_;  // Guards everything below
+    std::condition_variable wake_;
+    std::deque<Work> queue_;
+    std::unordered_map<StringId, StringId> definitions_;  // Class name to defining file
+    std::unordered_set<StringId> prefetched_;  // Prefetched and not yet requested
+    size_t yields_ = 0;
+    bool busy_ = false;
+    bool stopping_ = false;
+    std::chrono::steady_clock::time_point resume_at_;
+    std::thread thread_;
+
+    Counter files_prefetched_;
+    Counter files_skipped_;
+    Counter prefetch_hits_;
+};
+
+} // namespace ts_mcp
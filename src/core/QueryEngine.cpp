@@ -1,5 +1,6 @@
 #include "core/QueryEngine.hpp"
 #include "core/Language.hpp"
+#include "core/Trace.hpp"
 #include <spdlog/spdlog.h>
 
 // Tree-sitter C API
@@ -59,6 +60,7 @@ std::string Query::capture_name(uint32_t index) const {
 // ============================================================================
 
 std::unique_ptr<Query> QueryEngine::compile_query(std::string_view query_string, Language lang) {
+    TraceSpan span("compile_query");
     const TSLanguage* language = LanguageUtils::get_ts_language(lang);
     if (!language) {
         spdlog::error("Unsupported language for query compilation: {}",
@@ -93,54 +95,75 @@ std::vector<QueryMatch> QueryEngine::execute(
     const Tree& tree,
     const Query& query,
     std::string_view source
+) {
+    return execute(tree.root_node(), query, source);
+}
+
+std::vector<QueryMatch> QueryEngine::execute(
+    TSNode root,
+    const Query& query,
+    std::string_view source
 ) {
     std::vector<QueryMatch> results;
 
+    for_each_capture(root, query, [&](uint32_t capture_index, TSNode node) {
+        QueryMatch result;
+        result.node = node;
+        result.capture_name = query.capture_name(capture_index);
+
+        // Get position
+        get_node_position(node, result.line, result.column);
+
+        // Extract text
+        uint32_t start = ts_node_start_byte(node);
+        uint32_t end = ts_node_end_byte(node);
+
+        if (start < source.size() && end <= source.size() && start < end) {
+            result.text = std::string(source.substr(start, end - start));
+        } else {
+            spdlog::warn("Invalid node byte range: [{}, {})", start, end);
+            result.text = "";
+        }
+
+        results.push_back(std::move(result));
+    });
+
+    spdlog::debug("Query executed with {} matches", results.size());
+
+    return results;
+}
+
+void QueryEngine::for_each_capture(
+    TSNode root,
+    const Query& query,
+    const std::function<void(uint32_t capture_index, TSNode node)>& visit
+) {
+    TraceSpan span("query");
+
     // Create query cursor
     TSQueryCursor* cursor = ts_query_cursor_new();
     if (!cursor) {
         spdlog::error("Failed to create query cursor");
-        return results;
+        return;
     }
 
     // Execute query
-    ts_query_cursor_exec(cursor, query.get(), tree.root_node());
+    ts_query_cursor_exec(cursor, query.get(), root);
 
     // Iterate through matches
     TSQueryMatch match;
-    while (ts_query_cursor_next_match(cursor, &match)) {
-        // Process each capture in the match
-        for (uint32_t i = 0; i < match.capture_count; i++) {
-            TSQueryCapture capture = match.captures[i];
-            TSNode node = capture.node;
-
-            QueryMatch result;
-            result.node = node;
-            result.capture_name = query.capture_name(capture.index);
-
-            // Get position
-            get_node_position(node, result.line, result.column);
-
-            // Extract text
-            uint32_t start = ts_node_start_byte(node);
-            uint32_t end = ts_node_end_byte(node);
-
-            if (start < source.size() && end <= source.size() && start < end) {
-                result.text = std::string(source.substr(start, end - start));
-            } else {
-                spdlog::warn("Invalid node byte range: [{}, {})", start, end);
-                result.text = "";
+    try {
+        while (ts_query_cursor_next_match(cursor, &match)) {
+            for (uint32_t i = 0; i < match.capture_count; i++) {
+                visit(match.captures[i].index, match.captures[i].node);
             }
-
-            results.push_back(std::move(result));
         }
+    } catch (...) {
+        ts_query_cursor_delete(cursor);
+        throw;
     }
 
     ts_query_cursor_delete(cursor);
-
-    spdlog::debug("Query executed with {} matches", results.size());
-
-    return results;
 }
 
 void QueryEngine::get_node_position(TSNode node, uint32_t& line, uint32_t& column) const {
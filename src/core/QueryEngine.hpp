@@ -2,6 +2,7 @@
 
 #include "core/TreeSitterParser.hpp"
 #include "core/Language.hpp"
+#include <functional>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -119,6 +120,35 @@ public:
         std::string_view source
     );
 
+    /**
+     * @brief Execute a query on the subtree of one node
+     * @param root Root of the subtree (matches lie within it)
+     * @param query The compiled query
+     * @param source The source code (for extracting text)
+     * @return Vector of query matches
+     */
+    std::vector<QueryMatch> execute(
+        TSNode root,
+        const Query& query,
+        std::string_view source
+    );
+
+    /**
+     * @brief Visit each capture of a query without building QueryMatch objects
+     *
+     * For callers that only count or filter captures: nothing is copied,
+     * the visitor reads the node (and the source) itself.
+     *
+     * @param root Root of the subtree (matches lie within it)
+     * @param query The compiled query
+     * @param visit Called with the capture index and node, in match order
+     */
+    void for_each_capture(
+        TSNode root,
+        const Query& query,
+        const std::function<void(uint32_t capture_index, TSNode node)>& visit
+    );
+
     /**
      * @brief Get predefined query string for a specific query type and language
      * @param type Query type
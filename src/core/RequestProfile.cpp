@@ -0,0 +1,18 @@
+#include "core/RequestProfile.hpp"
+#include <cstring>
+
+namespace ts_mcp {
+
+void RequestProfile::add_phase(const char* name, uint64_t duration_ns) {
+    // Few distinct phases per request: a linear scan beats a map
+    for (auto& phase : phases_) {
+        if (phase.name == name || std::strcmp(phase.name, name) == 0) {
+            phase.count++;
+            phase.total_ns += duration_ns;
+            return;
+        }
+    }
+    phases_.push_back({name, 1, duration_ns});
+}
+
+} // namespace ts_mcp
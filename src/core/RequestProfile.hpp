@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Per-request breakdown collected while a request runs on a thread
+ *
+ * A Scope installs the profile as the calling thread's current one; while
+ * installed, TraceSpan adds its duration to the phase of the same name and
+ * the core library reports resolved files, cache hits and parses. Nothing
+ * is recorded on threads without a current profile.
+ *
+ * Phase times are inclusive: a "tool" phase contains the "parse" phases
+ * that ran inside it.
+ */
+class RequestProfile {
+public:
+    struct Phase {
+        const char* name;
+        uint64_t count = 0;
+        uint64_t total_ns = 0;
+    };
+
+    /**
+     * @brief Makes a profile current on this thread for the scope's lifetime
+     *
+     * A null profile leaves the current one unchanged.
+     */
+    class Scope {
+    public:
+        explicit Scope(RequestProfile* profile) : previous_(current_) {
+            if (profile) {
+                current_ = profile;
+            }
+        }
+        ~Scope() { current_ = previous_; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RequestProfile* previous_;
+    };
+
+    static RequestProfile* current() { return current_; }
+
+    static void add_resolved_files(size_t count) {
+        if (current_) {
+            current_->resolved_files_ += count;
+        }
+    }
+
+    static void add_cache_hit() {
+        if (current_) {
+            current_->cache_hits_++;
+        }
+    }
+
+    static void add_parse() {
+        if (current_) {
+            current_->parses_++;
+        }
+    }
+
+    void add_phase(const char* name, uint64_t duration_ns);
+
+    const std::vector<Phase>& phases() const { return phases_; }
+    size_t resolved_files() const { return resolved_files_; }
+    uint64_t cache_hits() const { return cache_hits_; }
+    uint64_t parses() const { return parses_; }
+
+private:
+    static inline thread_local RequestProfile* current_ = nullptr;
+
+    std::vector<Phase> phases_;  // In order of first completion
+    size_t resolved_files_ = 0;
+    uint64_t cache_hits_ = 0;
+    uint64_t parses_ = 0;
+};
+
+} // namespace ts_mcp
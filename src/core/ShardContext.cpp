@@ -0,0 +1,79 @@
+#include "core/ShardContext.hpp"
+#include <stdexcept>
+
+namespace ts_mcp {
+
+uint32_t ShardContext::shard_of(const std::filesystem::path& file, uint32_t shards) {
+    if (shards <= 1) {
+        return 0;
+    }
+    std::string directory = std::filesystem::absolute(file).lexically_normal().parent_path().string();
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : directory) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash % shards;
+}
+
+ShardContext ShardContext::worker(uint32_t index, uint32_t shards) {
+    if (shards == 0 || index >= shards) {
+        throw std::invalid_argument("Invalid shard " + std::to_string(index) + " of " + std::to_string(shards));
+    }
+    return ShardContext(true, index, shards);
+}
+
+ShardContext ShardContext::coordinator(uint32_t shards) {
+    return ShardContext(false, 0, shards);
+}
+
+std::string ShardContext::make_key(const std::filesystem::path& file, std::string_view kind) {
+    std::string key(kind);
+    key += '\n';
+    key += std::filesystem::absolute(file).lexically_normal().string();
+    return key;
+}
+
+bool ShardContext::owns(const std::filesystem::path& file) const {
+    return !worker_ || shard_of(file, shards_) == index_;
+}
+
+void ShardContext::capture(const std::filesystem::path& file, std::string_view kind, const nlohmann::json& facts) {
+    captured_.push_back({
+        {"file", std::filesystem::absolute(file).lexically_normal().string()},
+        {"kind", kind},
+        {"facts", facts}
+    });
+}
+
+nlohmann::json ShardContext::take_captured() {
+    nlohmann::json captured = std::move(captured_);
+    captured_ = nlohmann::json::array();
+    return captured;
+}
+
+void ShardContext::add_facts(const nlohmann::json& captured) {
+    for (const auto& entry : captured) {
+        facts_[make_key(entry.at("file").get<std::string>(), entry.at("kind").get<std::string>())] =
+            entry.at("facts");
+    }
+}
+
+void ShardContext::mark_failed(uint32_t shard) {
+    failed_.insert(shard);
+}
+
+const nlohmann::json* ShardContext::lookup(const std::filesystem::path& file, std::string_view kind) const {
+    auto it = facts_.find(make_key(file, kind));
+    if (it != facts_.end()) {
+        return &it->second;
+    }
+    if (!failed_.empty()) {
+        uint32_t shard = shard_of(file, shards_);
+        if (failed_.count(shard) > 0) {
+            throw std::runtime_error("Worker of shard " + std::to_string(shard) + " failed");
+        }
+    }
+    return nullptr;
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ts_mcp {
+
+/**
+ * @brief Per-request state of a tool call split across worker processes
+ *
+ * Files are partitioned by a hash of their directory. A worker runs the
+ * tool on its own partition only (PathResolver::resolve_paths drops the
+ * files of other shards) and captures every fact the tool derives through
+ * ASTAnalyzer::cached_facts. The coordinator collects the captured facts
+ * of all workers and runs the same tool over all files; its cached_facts
+ * calls are answered from those facts, so it only merges (builds the
+ * hierarchy, the graph, the reference list) and never parses.
+ *
+ * Files of a shard whose worker failed make cached_facts throw, which the
+ * tools report as failed files.
+ *
+ * A Scope installs a context on the calling thread, like RequestProfile.
+ */
+class ShardContext {
+public:
+    class Scope {
+    public:
+        explicit Scope(ShardContext* context) : previous_(current_) { current_ = context; }
+        ~Scope() { current_ = previous_; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ShardContext* previous_;
+    };
+
+    static ShardContext* current() { return current_; }
+
+    /**
+     * @brief Shard owning a file (files of a directory stay together)
+     */
+    static uint32_t shard_of(const std::filesystem::path& file, uint32_t shards);
+
+    /**
+     * @brief Context of a worker processing shard index of shards
+     */
+    static ShardContext worker(uint32_t index, uint32_t shards);
+
+    /**
+     * @brief Context of the coordinator merging the results of shards workers
+     */
+    static ShardContext coordinator(uint32_t shards);
+
+    bool is_worker() const { return worker_; }
+
+    /**
+     * @brief Whether this process handles the file (always true on the coordinator)
+     */
+    bool owns(const std::filesystem::path& file) const;
+
+    /**
+     * @brief Worker: record a derived fact
+     */
+    void capture(const std::filesystem::path& file, std::string_view kind, const nlohmann::json& facts);
+
+    /**
+     * @brief Worker: facts captured so far, as sent to the coordinator
+     */
+    nlohmann::json take_captured();
+
+    /**
+     * @brief Coordinator: add the facts captured by a worker
+     */
+    void add_facts(const nlohmann::json& captured);
+
+    /**
+     * @brief Coordinator: the worker of a shard produced no facts
+     */
+    void mark_failed(uint32_t shard);
+
+    /**
+     * @brief Coordinator: facts of a file from its worker
+     * @return nullptr if not collected (the caller computes them itself)
+     * @throws std::runtime_error if the file's worker failed
+     */
+    const nlohmann::json* lookup(const std::filesystem::path& file, std::string_view kind) const;
+
+    size_t fact_count() const { return facts_.size(); }
+    const std::set<uint32_t>& failed_shards() const { return failed_; }
+
+private:
+    ShardContext(bool worker, uint32_t index, uint32_t shards)
+        : worker_(worker), index_(index), shards_(shards) {}
+
+    static std::string make_key(const std::filesystem::path& file, std::string_view kind);
+
+    static inline thread_local ShardContext* current_ = nullptr;
+
+    bool worker_;
+    uint32_t index_;
+    uint32_t shards_;
+    nlohmann::json captured_ = nlohmann::json::array();      // Worker
+    std::unordered_map<std::string, nlohmann::json> facts_;  // Coordinator
+    std::set<uint32_t> failed_;                              // Coordinator
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,160 @@
+#include "core/StringInterner.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace ts_mcp {
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+// Id table segment k holds 2^(k + FIRST_SEGMENT_BITS) entries, so 23 segments cover every id
+constexpr unsigned FIRST_SEGMENT_BITS = 10;
+constexpr unsigned SEGMENTS = 33 - FIRST_SEGMENT_BITS;
+
+struct Slot {
+    unsigned segment;
+    size_t offset;
+};
+
+Slot locate(uint32_t id) {
+    uint64_t n = uint64_t{id} + (uint64_t{1} << FIRST_SEGMENT_BITS);
+    unsigned bit = static_cast<unsigned>(std::bit_width(n)) - 1;
+    return {bit - FIRST_SEGMENT_BITS, static_cast<size_t>(n - (uint64_t{1} << bit))};
+}
+
+struct Pool {
+    std::shared_mutex mutex;  // Guards everything but reads of published ids
+    std::vector<std::unique_ptr<char[]>> blocks;  // Small strings, filled in order
+    std::vector<std::unique_ptr<char[]>> large;   // One allocation per large string
+    size_t block_used = BLOCK_SIZE;  // Bytes used in blocks.back()
+    size_t arena_bytes = 0;
+
+    // Text by id. Segments never move, so view() needs no lock: an id is
+    // only handed out after its entry is written.
+    std::array<std::atomic<std::string_view*>, SEGMENTS> segments{};
+    std::array<std::unique_ptr<std::string_view[]>, SEGMENTS> owned;
+    uint32_t next_id = 1;  // 0 is ""
+    size_t table_bytes = 0;
+
+    std::unordered_map<std::string_view, uint32_t> ids;
+};
+
+Pool& pool() {
+    static Pool instance;
+    return instance;
+}
+
+/**
+ * @brief Copy text into the arena (caller holds the exclusive lock)
+ */
+std::string_view store(Pool& p, std::string_view text) {
+    char* data;
+    if (text.size() > BLOCK_SIZE / 4) {
+        // Large strings get their own allocation rather than ending a block early
+        p.large.push_back(std::make_unique<char[]>(text.size()));
+        data = p.large.back().get();
+        p.arena_bytes += text.size();
+    } else {
+        if (p.block_used + text.size() > BLOCK_SIZE) {
+            p.blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+            p.block_used = 0;
+            p.arena_bytes += BLOCK_SIZE;
+        }
+        data = p.blocks.back().get() + p.block_used;
+        p.block_used += text.size();
+    }
+    std::copy(text.begin(), text.end(), data);
+    return {data, text.size()};
+}
+
+} // namespace
+
+StringId StringId::of(std::string_view text) {
+    return StringInterner::intern(text);
+}
+
+std::string_view StringId::view() const {
+    return StringInterner::view(*this);
+}
+
+StringId StringInterner::intern(std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+
+    Pool& p = pool();
+    {
+        std::shared_lock lock(p.mutex);
+        auto it = p.ids.find(text);
+        if (it != p.ids.end()) {
+            return {it->second};
+        }
+    }
+
+    std::unique_lock lock(p.mutex);
+    auto it = p.ids.find(text);
+    if (it != p.ids.end()) {
+        return {it->second};
+    }
+    if (p.next_id == std::numeric_limits<uint32_t>::max()) {
+        throw std::overflow_error("String interner is full");
+    }
+
+    uint32_t id = p.next_id;
+    Slot slot = locate(id);
+    if (!p.owned[slot.segment]) {
+        size_t entries = size_t{1} << (slot.segment + FIRST_SEGMENT_BITS);
+        p.owned[slot.segment] = std::make_unique<std::string_view[]>(entries);
+        p.segments[slot.segment].store(p.owned[slot.segment].get(), std::memory_order_release);
+        p.table_bytes += entries * sizeof(std::string_view);
+    }
+
+    std::string_view stored = store(p, text);
+    p.owned[slot.segment][slot.offset] = stored;
+    p.ids.emplace(stored, id);
+    p.next_id++;
+    return {id};
+}
+
+std::optional<StringId> StringInterner::find(std::string_view text) {
+    if (text.empty()) {
+        return StringId{};
+    }
+    Pool& p = pool();
+    std::shared_lock lock(p.mutex);
+    auto it = p.ids.find(text);
+    if (it == p.ids.end()) {
+        return std::nullopt;
+    }
+    return StringId{it->second};
+}
+
+std::string_view StringInterner::view(StringId id) {
+    if (id.value == 0) {
+        return {};
+    }
+    Slot slot = locate(id.value);
+    return pool().segments[slot.segment].load(std::memory_order_acquire)[slot.offset];
+}
+
+StringInterner::Stats StringInterner::stats() {
+    Pool& p = pool();
+    std::shared_lock lock(p.mutex);
+    Stats stats;
+    stats.strings = p.next_id - 1;
+    stats.bytes = p.arena_bytes + p.table_bytes + p.ids.bucket_count() * sizeof(void*) +
+                  p.ids.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*));
+    return stats;
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ts_mcp {
+
+/**
+ * @brief 32-bit id of a string interned in StringInterner
+ *
+ * Equal strings have equal ids, so ids compare and hash as integers. The
+ * default id is the empty string. Ids order by creation, not by text; use
+ * StringIdLess where text order matters (sorted output).
+ */
+struct StringId {
+    uint32_t value = 0;
+
+    /**
+     * @brief Intern text (same as StringInterner::intern)
+     */
+    static StringId of(std::string_view text);
+
+    /**
+     * @brief The text; valid for the life of the process
+     */
+    std::string_view view() const;
+
+    std::string str() const { return std::string(view()); }
+
+    bool empty() const { return value == 0; }
+
+    bool operator==(const StringId& other) const = default;
+};
+
+/**
+ * @brief Orders ids by their text
+ */
+struct StringIdLess {
+    bool operator()(StringId a, StringId b) const { return a.view() < b.view(); }
+};
+
+/**
+ * @brief Process-wide string pool for paths and symbol names
+ *
+ * Repo-wide results repeat the same paths and names many times (one per
+ * reference, edge or class). Interned, each distinct string is stored once
+ * in an arena of large blocks and referred to by a 4-byte id; text is
+ * looked up only to serialize. Strings are never freed, so intern only
+ * values from a bounded set (paths in the tree, identifiers), not
+ * per-request text.
+ *
+ * Thread-safe: intern() takes a shared lock (an exclusive one for new
+ * strings); view() is lock-free, so comparing ids by text is as cheap as
+ * comparing strings.
+ */
+class StringInterner {
+public:
+    struct Stats {
+        size_t strings = 0;
+        size_t bytes = 0;  // Arena blocks plus id tables
+    };
+
+    /**
+     * @brief Id of text, adding it to the pool if new
+     * @throws std::overflow_error if the pool holds 2^32 strings
+     */
+    static StringId intern(std::string_view text);
+
+    /**
+     * @brief Id of text if it was interned, without adding it
+     *
+     * For request parameters: a name nobody interned cannot match anything.
+     */
+    static std::optional<StringId> find(std::string_view text);
+
+    static std::string_view view(StringId id);
+
+    static Stats stats();
+};
+
+} // namespace ts_mcp
+
+template <>
+struct std::hash<ts_mcp::StringId> {
+    size_t operator()(ts_mcp::StringId id) const noexcept { return std::hash<uint32_t>{}(id.value); }
+};
@@ -0,0 +1,191 @@
+#include "core/Trace.hpp"
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace ts_mcp {
+
+namespace {
+
+struct TraceEvent {
+    const char* name = nullptr;
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;
+    std::string detail;
+};
+
+/**
+ * @brief Ring buffer of one thread; its mutex is only contended while writing the file
+ */
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    size_t next = 0;
+    uint64_t recorded = 0;
+    uint32_t tid = 0;
+};
+
+struct TraceState {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::filesystem::path file;
+    size_t capacity = Tracer::DEFAULT_EVENTS_PER_THREAD;
+    uint64_t epoch_ns = 0;
+    uint32_t next_tid = 1;
+};
+
+TraceState& state() {
+    static TraceState* instance = new TraceState();
+    return *instance;
+}
+
+ThreadBuffer& local_buffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto created = std::make_shared<ThreadBuffer>();
+        created->tid = s.next_tid++;
+        s.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+int process_id() {
+#ifdef __linux__
+    return static_cast<int>(::getpid());
+#else
+    return 1;
+#endif
+}
+
+} // namespace
+
+void Tracer::start(const std::filesystem::path& file, size_t events_per_thread) {
+    auto& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.file = file;
+        s.capacity = std::max<size_t>(events_per_thread, 1);
+        s.epoch_ns = now_ns();
+        for (auto& buffer : s.buffers) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            buffer->events.clear();
+            buffer->next = 0;
+            buffer->recorded = 0;
+        }
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+    spdlog::info("Tracing to {} ({} events per thread)", file.string(), events_per_thread);
+}
+
+bool Tracer::stop() {
+    if (!enabled_.exchange(false, std::memory_order_relaxed)) {
+        return true;
+    }
+    std::filesystem::path file;
+    {
+        std::lock_guard<std::mutex> lock(state().mutex);
+        file = state().file;
+    }
+    return write(file);
+}
+
+void Tracer::record(const char* name, uint64_t start_ns, uint64_t end_ns, std::string detail) {
+    auto& buffer = local_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    if (buffer.events.empty()) {
+        buffer.events.resize(state().capacity);
+    }
+    auto& event = buffer.events[buffer.next];
+    event.name = name;
+    event.start_ns = start_ns;
+    event.end_ns = end_ns;
+    event.detail = std::move(detail);
+
+    buffer.next = (buffer.next + 1) % buffer.events.size();
+    buffer.recorded++;
+}
+
+bool Tracer::write(const std::filesystem::path& file) {
+    auto& s = state();
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint64_t epoch_ns;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        buffers = s.buffers;
+        epoch_ns = s.epoch_ns;
+    }
+
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        spdlog::warn("Cannot write trace file {}", file.string());
+        return false;
+    }
+
+    int pid = process_id();
+    uint64_t dropped = 0;
+    size_t written = 0;
+    bool first = true;
+    auto separator = [&] {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (buffer->recorded == 0) {
+            continue;
+        }
+
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+
+        size_t size = buffer->events.size();
+        size_t count = buffer->recorded < size ? static_cast<size_t>(buffer->recorded) : size;
+        dropped += buffer->recorded - count;
+
+        // Oldest first: after a wrap the oldest event sits at next
+        size_t begin = buffer->recorded < size ? 0 : buffer->next;
+        for (size_t k = 0; k < count; ++k) {
+            const auto& event = buffer->events[(begin + k) % size];
+            if (event.start_ns < epoch_ns) {
+                continue;  // Recorded before a restart
+            }
+            separator();
+            out << "{\"name\":\"" << event.name << "\",\"cat\":\"ts_mcp\",\"ph\":\"X\""
+                << ",\"ts\":" << static_cast<double>(event.start_ns - epoch_ns) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.end_ns - event.start_ns) / 1000.0
+                << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid;
+            if (!event.detail.empty()) {
+                out << ",\"args\":{\"detail\":" << nlohmann::json(event.detail).dump(
+                    -1, ' ', false, nlohmann::json::error_handler_t::replace) << "}";
+            }
+            out << "}";
+            written++;
+        }
+    }
+    out << "\n],\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+
+    if (!out) {
+        spdlog::warn("Failed to write trace file {}", file.string());
+        return false;
+    }
+    spdlog::info("Wrote {} trace events to {} ({} dropped)", written, file.string(), dropped);
+    return true;
+}
+
+} // namespace ts_mcp
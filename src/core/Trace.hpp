@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core/RequestProfile.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace ts_mcp {
+
+/**
+ * @brief Process-wide collector of trace spans in Chrome trace-event format
+ *
+ * Each thread records completed spans into its own fixed-size ring buffer
+ * (the oldest events are overwritten when it is full). stop() or write()
+ * merges the buffers into a JSON file that chrome://tracing and Perfetto
+ * open directly.
+ *
+ * While disabled (and without a RequestProfile) a span costs one relaxed
+ * atomic load and one thread-local read.
+ */
+class Tracer {
+public:
+    static constexpr size_t DEFAULT_EVENTS_PER_THREAD = 65536;
+
+    /**
+     * @brief Enable tracing; stop() writes the trace to file
+     * @param file Output path
+     * @param events_per_thread Ring buffer capacity of each thread
+     */
+    static void start(const std::filesystem::path& file,
+                      size_t events_per_thread = DEFAULT_EVENTS_PER_THREAD);
+
+    /**
+     * @brief Disable tracing and write the trace file (no-op if not started)
+     * @return false if the file could not be written
+     */
+    static bool stop();
+
+    /**
+     * @brief Write the events recorded so far (tracing stays enabled)
+     */
+    static bool write(const std::filesystem::path& file);
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Monotonic nanoseconds (the span clock)
+     */
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    friend class TraceSpan;
+
+    static void record(const char* name, uint64_t start_ns, uint64_t end_ns, std::string detail);
+
+    static inline std::atomic<bool> enabled_{false};
+};
+
+/**
+ * @brief RAII span: records [construction, destruction) when tracing is on
+ *
+ * Names must be string literals (they are stored by pointer). The optional
+ * detail (file path, tool name) appears as args.detail in the viewer and
+ * is only copied while tracing. The duration is also added to the thread's
+ * current RequestProfile, if any.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, std::string_view detail = {})
+        : name_(name), tracing_(Tracer::enabled()), profile_(RequestProfile::current()) {
+        if (tracing_ || profile_) {
+            if (tracing_) {
+                detail_ = detail;
+            }
+            start_ns_ = Tracer::now_ns();
+        }
+    }
+
+    ~TraceSpan() {
+        if (tracing_ || profile_) {
+            uint64_t end_ns = Tracer::now_ns();
+            if (profile_) {
+                profile_->add_phase(name_, end_ns - start_ns_);
+            }
+            if (tracing_) {
+                Tracer::record(name_, start_ns_, end_ns, std::move(detail_));
+            }
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    /**
+     * @brief Replace the detail once it is known (e.g. a result count)
+     */
+    void set_detail(std::string_view detail) {
+        if (tracing_) {
+            detail_ = detail;
+        }
+    }
+
+private:
+    const char* name_;
+    bool tracing_;
+    RequestProfile* profile_;
+    uint64_t start_ns_ = 0;
+    std::string detail_;
+};
+
+} // namespace ts_mcp
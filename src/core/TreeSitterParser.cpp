@@ -1,5 +1,8 @@
 #include "core/TreeSitterParser.hpp"
 #include "core/Language.hpp"
+#include "core/Logging.hpp"
+#include "core/MemoryAccounting.hpp"
+#include "core/Metrics.hpp"
 #include <spdlog/spdlog.h>
 #include <fstream>
 #include <sstream>
@@ -52,6 +55,18 @@ bool Tree::has_error() const {
     return ts_node_has_error(root);
 }
 
+Tree Tree::copy() const {
+    return Tree(ts_tree_copy(tree_));
+}
+
+std::vector<TSRange> Tree::changed_ranges(const Tree& old_tree) const {
+    uint32_t count = 0;
+    TSRange* ranges = ts_tree_get_changed_ranges(old_tree.tree_, tree_, &count);
+    std::vector<TSRange> result(ranges, ranges + count);
+    TreeSitterMemory::free_buffer(ranges);
+    return result;
+}
+
 // ============================================================================
 // TreeSitterParser implementation
 // ============================================================================
@@ -108,28 +123,55 @@ TreeSitterParser& TreeSitterParser::operator=(TreeSitterParser&& other) noexcept
     return *this;
 }
 
-std::unique_ptr<Tree> TreeSitterParser::parse_string(std::string_view source) {
-    // Cache source for node_text operations
-    last_source_ = std::string(source);
-
-    spdlog::debug("Parsing string of length {}", source.size());
+std::unique_ptr<Tree> TreeSitterParser::guarded_parse(const TSTree* old_tree, std::string_view source) {
+    uint64_t timeout_ms = ParseGuard::limits().timeout_ms;
+    ts_parser_set_timeout_micros(parser_, timeout_ms * 1000);
 
     TSTree* raw_tree = ts_parser_parse_string(
         parser_,
-        nullptr,  // old_tree
+        old_tree,
         source.data(),
         static_cast<uint32_t>(source.size())
     );
 
     if (!raw_tree) {
-        spdlog::error("Failed to parse source code");
+        // Without a timeout tree-sitter only gives up on a missing language
+        if (timeout_ms > 0) {
+            ts_parser_reset(parser_);
+            last_degraded_ = DegradeReason::TIMEOUT;
+            CoreMetrics::get().parses_degraded.add();
+            spdlog::warn("Parse cancelled after {} ms ({} bytes)", timeout_ms, source.size());
+        } else {
+            spdlog::error("Failed to parse source code");
+        }
+        return nullptr;
+    }
+
+    return std::make_unique<Tree>(raw_tree);
+}
+
+std::unique_ptr<Tree> TreeSitterParser::parse_string(std::string_view source) {
+    // Cache source for node_text operations
+    last_source_ = std::string(source);
+    last_degraded_ = ParseGuard::check(source);
+
+    if (last_degraded_ != DegradeReason::NONE) {
+        CoreMetrics::get().parses_degraded.add();
+        spdlog::info("Not parsing source of {} bytes ({})", source.size(), ParseGuard::to_string(last_degraded_));
         return nullptr;
     }
 
-    auto tree = std::make_unique<Tree>(raw_tree);
+    spdlog::debug("Parsing string of length {}", source.size());
+    CoreMetrics::get().bytes_parsed.add(source.size());
+
+    auto tree = guarded_parse(nullptr, source);
+    if (!tree) {
+        return nullptr;
+    }
 
     if (tree->has_error()) {
-        spdlog::warn("Parse completed with syntax errors");
+        CoreMetrics::get().parses_with_errors.add();
+        WarningSummary::note("Parse completed with syntax errors");
     } else {
         spdlog::debug("Parse completed successfully");
     }
@@ -163,25 +205,26 @@ std::unique_ptr<Tree> TreeSitterParser::parse_incremental(
 
     // Cache new source
     last_source_ = std::string(new_source);
+    last_degraded_ = ParseGuard::check(new_source);
 
-    spdlog::debug("Performing incremental parse");
+    if (last_degraded_ != DegradeReason::NONE) {
+        CoreMetrics::get().parses_degraded.add();
+        spdlog::info("Not parsing source of {} bytes ({})", new_source.size(),
+                     ParseGuard::to_string(last_degraded_));
+        return nullptr;
+    }
 
-    TSTree* raw_tree = ts_parser_parse_string(
-        parser_,
-        old_tree.get(),
-        new_source.data(),
-        static_cast<uint32_t>(new_source.size())
-    );
+    spdlog::debug("Performing incremental parse");
+    CoreMetrics::get().bytes_parsed.add(new_source.size());
 
-    if (!raw_tree) {
-        spdlog::error("Failed to perform incremental parse");
+    auto tree = guarded_parse(old_tree.get(), new_source);
+    if (!tree) {
         return nullptr;
     }
 
-    auto tree = std::make_unique<Tree>(raw_tree);
-
     if (tree->has_error()) {
-        spdlog::warn("Incremental parse completed with syntax errors");
+        CoreMetrics::get().parses_with_errors.add();
+        WarningSummary::note("Incremental parse completed with syntax errors");
     } else {
         spdlog::debug("Incremental parse completed successfully");
     }
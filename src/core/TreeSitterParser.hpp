@@ -3,8 +3,10 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 #include <filesystem>
 #include "core/Language.hpp"
+#include "core/ParseGuard.hpp"
 
 // Forward declarations for tree-sitter C API
 extern "C" {
@@ -12,6 +14,7 @@ extern "C" {
     struct TSTree;
     struct TSNode;
     struct TSInputEdit;
+    struct TSRange;
 }
 
 namespace ts_mcp {
@@ -44,6 +47,21 @@ public:
      */
     bool has_error() const;
 
+    /**
+     * @brief Another handle to the same tree (ts_tree_copy: a reference count increment)
+     *
+     * A tree must not be used by two threads through one handle; each
+     * thread takes its own copy.
+     */
+    Tree copy() const;
+
+    /**
+     * @brief Ranges whose syntax differs from a previous version of this tree
+     * @param old_tree The previous tree, edited (ts_tree_edit) with the edit
+     *        this tree was parsed after
+     */
+    std::vector<TSRange> changed_ranges(const Tree& old_tree) const;
+
     /**
      * @brief Get the underlying TSTree pointer
      */
@@ -83,6 +101,11 @@ public:
 
     /**
      * @brief Parse C++ source code from a string
+     *
+     * Sources refused by ParseGuard are not parsed, and parses running past
+     * the ParseGuard timeout are cancelled; both return nullptr with the
+     * reason in last_degraded().
+     *
      * @param source Source code to parse
      * @return Unique pointer to parsed tree, or nullptr on error
      */
@@ -129,10 +152,21 @@ public:
      */
     Language language() const { return language_; }
 
+    /**
+     * @brief Why the last parse returned no tree because of a ParseGuard limit (NONE otherwise)
+     */
+    DegradeReason last_degraded() const { return last_degraded_; }
+
 private:
+    /**
+     * @brief Parse with the ParseGuard timeout, recording a cancelled parse
+     */
+    std::unique_ptr<Tree> guarded_parse(const TSTree* old_tree, std::string_view source);
+
     TSParser* parser_;
     std::string last_source_;
     Language language_;
+    DegradeReason last_degraded_ = DegradeReason::NONE;
 };
 
 } // namespace ts_mcp
@@ -0,0 +1,317 @@
+#include "core/WarmUp.hpp"
+#include "core/PathResolver.hpp"
+#include "core/Trace.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ts_mcp {
+
+namespace {
+
+std::filesystem::path normalized(const std::filesystem::path& path) {
+    // Canonical where it exists, as PathResolver names files
+    std::error_code ec;
+    std::filesystem::path result = std::filesystem::weakly_canonical(path, ec);
+    if (ec) {
+        result = std::filesystem::absolute(path, ec).lexically_normal();
+    }
+    if (!result.has_filename() && result.has_parent_path()) {
+        result = result.parent_path();  // Trailing separator
+    }
+    return result;
+}
+
+const char* state_name(int state) {
+    static const char* const names[] = {"idle", "listing", "running", "done", "fact_memory_full", "stopped"};
+    return names[state];
+}
+
+} // namespace
+
+void WarmUp::lower_thread_priority() {
+#ifdef __linux__
+    // Nice values are per thread on Linux
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19) != 0) {
+        spdlog::debug("Could not lower background thread priority");
+    }
+#endif
+}
+
+WarmUp::Yield::Yield(WarmUp* warm_up) : warm_up_(warm_up) {
+    if (warm_up_) {
+        std::lock_guard<std::mutex> lock(warm_up_->mutex_);
+        warm_up_->yields_++;
+    }
+}
+
+WarmUp::Yield::~Yield() {
+    if (warm_up_) {
+        std::lock_guard<std::mutex> lock(warm_up_->mutex_);
+        warm_up_->yields_--;
+        warm_up_->resume_at_ = std::chrono::steady_clock::now() + warm_up_->options_.resume_delay;
+        warm_up_->wake_.notify_all();
+    }
+}
+
+WarmUp::WarmUp(std::shared_ptr<ASTAnalyzer> analyzer, std::vector<std::filesystem::path> default_roots)
+    : WarmUp(std::move(analyzer), std::move(default_roots), Options{}) {
+}
+
+WarmUp::WarmUp(std::shared_ptr<ASTAnalyzer> analyzer, std::vector<std::filesystem::path> default_roots,
+               Options options)
+    : analyzer_(std::move(analyzer)),
+      default_roots_(std::move(default_roots)),
+      options_(std::move(options)),
+      files_warmed_(Metrics::counter("ts_mcp_warmup_files_total", "Files analyzed by the background warm-up")),
+      files_pending_(Metrics::gauge("ts_mcp_warmup_files_pending", "Files the warm-up has yet to analyze")) {
+    if (!analyzer_) {
+        throw std::invalid_argument("Analyzer cannot be null");
+    }
+    options_.threads = std::max(1u, options_.threads);
+    steps_.push_back(Indexer::builtin_facts);
+}
+
+WarmUp::~WarmUp() {
+    stop();
+}
+
+void WarmUp::add_step(FileStep step) {
+    steps_.push_back(std::move(step));
+}
+
+void WarmUp::start(const std::vector<std::filesystem::path>& roots) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != State::Idle) {
+        return;
+    }
+
+    for (const auto& root : roots.empty() ? default_roots_ : roots) {
+        roots_.push_back(normalized(root));
+    }
+    state_ = State::Listing;
+    started_at_ = std::chrono::steady_clock::now();
+    running_threads_ = options_.threads;
+    spdlog::info("Warming up {} root(s) on {} background thread(s)", roots_.size(), options_.threads);
+    for (unsigned t = 0; t < options_.threads; ++t) {
+        threads_.emplace_back([this, t] { run(t == 0); });
+    }
+}
+
+void WarmUp::touch(const std::filesystem::path& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == State::Idle || state_ == State::Listing) {
+        touched_.push_back(normalized(path));
+    } else if (state_ == State::Running) {
+        prioritize_locked(normalized(path));
+    }
+}
+
+void WarmUp::stop() {
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_ == State::Listing || state_ == State::Running) {
+            finish_locked(State::Stopped);
+        }
+        threads.swap(threads_);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+bool WarmUp::wait(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return wake_.wait_for(lock, timeout, [this] {
+        return state_ != State::Listing && state_ != State::Running && running_threads_ == 0;
+    });
+}
+
+bool WarmUp::started() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_ != State::Idle;
+}
+
+json WarmUp::status() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+
+    json roots = json::array();
+    for (const auto& root : roots_) {
+        roots.push_back(root.string());
+    }
+    json result = {
+        {"state", state_name(static_cast<int>(state_))},
+        {"roots", roots},
+        {"files_total", files_.size()},
+        {"files_done", done_},
+        {"files_failed", failed_},
+        {"paused", state_ == State::Running && (yields_ > 0 || now < resume_at_)}
+    };
+    if (state_ != State::Idle) {
+        auto end = state_ == State::Listing || state_ == State::Running ? now : finished_at_;
+        result["elapsed_ms"] = std::chrono::duration<double, std::milli>(end - started_at_).count();
+    }
+    return result;
+}
+
+void WarmUp::run(bool list) {
+    lower_thread_priority();
+    if (list) {
+        list_files();
+    }
+    while (auto file = next_file()) {
+        process(*file);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--running_threads_ == 0 && state_ == State::Running) {
+        finish_locked(State::Done);
+    }
+    wake_.notify_all();
+}
+
+void WarmUp::list_files() {
+    std::vector<std::string> roots;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& root : roots_) {
+            roots.push_back(root.string());
+        }
+    }
+
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> by_mtime;
+    try {
+        TraceSpan span("warm_up_list");
+        for (auto& file : PathResolver::resolve_paths(roots, true, options_.patterns)) {
+            std::error_code ec;
+            auto mtime = std::filesystem::last_write_time(file, ec);
+            by_mtime.emplace_back(ec ? std::filesystem::file_time_type::min() : mtime, std::move(file));
+        }
+    } catch (const std::exception& e) {
+        spdlog::warn("Warm-up could not list the workspace: {}", e.what());
+    }
+    // Most recently modified first: the files being worked on
+    std::stable_sort(by_mtime.begin(), by_mtime.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != State::Listing) {
+        return;
+    }
+    files_.reserve(by_mtime.size());
+    for (size_t i = 0; i < by_mtime.size(); ++i) {
+        by_directory_[by_mtime[i].second.parent_path().string()].push_back(i);
+        files_.push_back(std::move(by_mtime[i].second));
+    }
+    claimed_.assign(files_.size(), false);
+    for (const auto& path : touched_) {
+        prioritize_locked(path);
+    }
+    touched_.clear();
+
+    files_pending_.add(static_cast<int64_t>(files_.size()));
+    state_ = State::Running;
+    wake_.notify_all();
+    spdlog::info("Warm-up listed {} files", files_.size());
+}
+
+void WarmUp::prioritize_locked(const std::filesystem::path& path) {
+    auto found = by_directory_.find(path.string());
+    if (found == by_directory_.end()) {
+        found = by_directory_.find(path.parent_path().string());
+    }
+    if (found == by_directory_.end() || found->second.empty()) {
+        return;
+    }
+    // Each directory is moved up once; its files are then claimed from urgent_
+    urgent_.insert(urgent_.begin(), found->second.begin(), found->second.end());
+    found->second.clear();
+}
+
+std::optional<std::filesystem::path> WarmUp::next_file() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (state_ == State::Listing || (state_ == State::Running && yields_ > 0)) {
+            wake_.wait(lock);
+        } else if (state_ != State::Running) {
+            return std::nullopt;
+        } else if (std::chrono::steady_clock::now() < resume_at_) {
+            wake_.wait_until(lock, resume_at_);
+        } else {
+            break;
+        }
+    }
+
+    while (!urgent_.empty()) {
+        size_t index = urgent_.front();
+        urgent_.pop_front();
+        if (!claimed_[index]) {
+            claimed_[index] = true;
+            return files_[index];
+        }
+    }
+    while (cursor_ < files_.size() && claimed_[cursor_]) {
+        cursor_++;
+    }
+    if (cursor_ == files_.size()) {
+        return std::nullopt;
+    }
+    claimed_[cursor_] = true;
+    return files_[cursor_++];
+}
+
+void WarmUp::process(const std::filesystem::path& file) {
+    TraceSpan span("warm_up_file", file.string());
+    bool failed = false;
+    {
+        ASTAnalyzer::TransientScope transient;
+        try {
+            for (const auto& step : steps_) {
+                step(analyzer_, file);
+            }
+        } catch (const std::exception& e) {
+            spdlog::debug("Warm-up skipped {}: {}", file.string(), e.what());
+            failed = true;
+        }
+    }
+    // Unless a request loaded or used the tree meanwhile
+    analyzer_->release_transient(file);
+    files_warmed_.add();
+    files_pending_.decrement();
+    bool full = analyzer_->fact_tier_full();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_++;
+    if (failed) {
+        failed_++;
+    }
+    if (full && state_ == State::Running) {
+        spdlog::info("Warm-up stopped after {} files: fact memory is full", done_);
+        finish_locked(State::Full);
+    }
+}
+
+void WarmUp::finish_locked(State state) {
+    if (state != State::Done) {
+        // Files never taken leave the pending gauge
+        size_t unclaimed = static_cast<size_t>(std::count(claimed_.begin(), claimed_.end(), false));
+        files_pending_.add(-static_cast<int64_t>(unclaimed));
+    }
+    state_ = state;
+    finished_at_ = std::chrono::steady_clock::now();
+    wake_.notify_all();
+    if (state == State::Done) {
+        spdlog::info("Warm-up done: {} files in {:.0f} ms ({} failed)", done_,
+                     std::chrono::duration<double, std::milli>(finished_at_ - started_at_).count(), failed_);
+    }
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "core/ASTAnalyzer.hpp"
+#include "core/Indexer.hpp"
+#include "core/Metrics.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace ts_mcp {
+
+using json = nlohmann::json;
+
+/**
+ * @brief Background analysis of a workspace after the client connects
+ *
+ * Lists the source files under the workspace roots and runs the per-file
+ * analyses of each on low-priority threads, filling the server analyzer's
+ * warm tier so the first queries on a file answer without parsing.
+ * Files are taken most recently modified first; files in directories the
+ * client touched (touch()) jump the queue.
+ *
+ * Interactive requests preempt it: while a Yield is alive, and for a short
+ * delay after the last one ends, workers wait between files. A file being
+ * analyzed when a request arrives holds the analyzer lock only for its
+ * lookups and parses, like any other request.
+ *
+ * Warm-up keeps facts, not trees: trees it parsed are released after each
+ * file, and it stops once the warm tier is full rather than evicting the
+ * facts of files already in use.
+ */
+class WarmUp {
+public:
+    using FileStep = Indexer::FileStep;
+
+    struct Options {
+        unsigned threads = 1;
+        std::vector<std::string> patterns = {"*.cpp", "*.hpp", "*.h", "*.cc", "*.cxx", "*.py"};
+        std::chrono::milliseconds resume_delay{200};  // Quiet time after a request before resuming
+    };
+
+    /**
+     * @brief Pauses warm-up workers for its lifetime (nullptr: no-op)
+     */
+    class Yield {
+    public:
+        explicit Yield(WarmUp* warm_up);
+        ~Yield();
+        Yield(const Yield&) = delete;
+        Yield& operator=(const Yield&) = delete;
+
+    private:
+        WarmUp* warm_up_;
+    };
+
+    /**
+     * @param analyzer Analyzer whose caches are warmed
+     * @param default_roots Roots used when start() gets none
+     */
+    WarmUp(std::shared_ptr<ASTAnalyzer> analyzer, std::vector<std::filesystem::path> default_roots);
+    WarmUp(std::shared_ptr<ASTAnalyzer> analyzer, std::vector<std::filesystem::path> default_roots,
+           Options options);
+
+    /**
+     * @brief Stops and joins the workers
+     */
+    ~WarmUp();
+
+    WarmUp(const WarmUp&) = delete;
+    WarmUp& operator=(const WarmUp&) = delete;
+
+    /**
+     * @brief Add work done for each file (before start())
+     *
+     * The built-in step computes analyze_file, find_classes, find_functions
+     * and find_includes, as Indexer does.
+     */
+    void add_step(FileStep step);
+
+    /**
+     * @brief Start warming roots (default roots if empty); later calls do nothing
+     */
+    void start(const std::vector<std::filesystem::path>& roots = {});
+
+    /**
+     * @brief Move the files of path's directory (or of path, if a directory) to the front
+     */
+    void touch(const std::filesystem::path& path);
+
+    /**
+     * @brief Stop the workers after their current file
+     */
+    void stop();
+
+    /**
+     * @brief Wait until all files are done or the workers stopped
+     * @return false on timeout
+     */
+    bool wait(std::chrono::milliseconds timeout);
+
+    bool started() const;
+
+    /**
+     * @brief State, roots, file counts and elapsed time as JSON
+     */
+    json status() const;
+
+    /**
+     * @brief Run the calling thread at the lowest CPU priority (Linux; elsewhere a no-op)
+     */
+    static void lower_thread_priority();
+
+private:
+    enum class State { Idle, Listing, Running, Done, Full, Stopped };
+
+    void run(bool list);
+    void list_files();
+    void prioritize_locked(const std::filesystem::path& path);
+    std::optional<std::filesystem::path> next_file();
+    void process(const std::filesystem::path& file);
+    void finish_locked(State state);
+
+    std::shared_ptr<ASTAnalyzer> analyzer_;
+    std::vector<std::filesystem::path> default_roots_;
+    Options options_;
+    std::vector<FileStep> steps_;
+
+    mutable std::mutex mutex_;  // Guards everything below
+    std::condition_variable wake_;
+    State state_ = State::Idle;
+    std::vector<std::filesystem::path> roots_;
+    std::vector<std::filesystem::path> files_;  // Most recently modified first
+    std::vector<bool> claimed_;
+    size_t cursor_ = 0;  // Next unclaimed file in files_ order
+    std::deque<size_t> urgent_;  // Files of touched directories
+    std::unordered_map<std::string, std::vector<size_t>> by_directory_;
+    std::vector<std::filesystem::path> touched_;  // Touched before listing finished
+    size_t done_ = 0;
+    size_t failed_ = 0;
+    size_t yields_ = 0;  // Live Yield objects
+    std::chrono::steady_clock::time_point resume_at_;
+    std::chrono::steady_clock::time_point started_at_;
+    std::chrono::steady_clock::time_point finished_at_;
+    size_t running_threads_ = 0;
+    std::vector<std::thread> threads_;
+
+    Counter files_warmed_;
+    Gauge files_pending_;
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,477 @@
+#include "corpus/CorpusGenerator.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+
+namespace ts_mcp {
+
+namespace {
+
+// Salts keep the random streams of different decisions independent
+enum Salt : uint64_t {
+    SALT_LANGUAGE = 1,
+    SALT_HEADER,
+    SALT_INCLUDE,
+    SALT_CYCLE,
+    SALT_INHERIT,
+    SALT_BASE,
+    SALT_STATEMENT,
+    SALT_VALUE,
+    SALT_METHOD,
+};
+
+constexpr double HEADER_RATIO = 0.6;          // C++ files generated as includable headers
+constexpr size_t INCLUDE_SEARCH_LIMIT = 64;   // Files scanned backwards for an include target
+constexpr size_t BASE_CANDIDATES = 3;         // Random base picks; the deepest eligible wins
+constexpr size_t DIRS_PER_LEVEL = 64;
+
+uint64_t splitmix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Deterministic hash of a decision (seed, salt and up to three keys)
+ */
+uint64_t draw(uint64_t seed, uint64_t salt, uint64_t a, uint64_t b = 0, uint64_t c = 0) {
+    uint64_t h = splitmix(seed ^ (salt << 56));
+    h = splitmix(h ^ a);
+    h = splitmix(h ^ b);
+    return splitmix(h ^ c);
+}
+
+double unit_interval(uint64_t h) {
+    return static_cast<double>(h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void check_ratio(double value, const char* name) {
+    if (!(value >= 0.0 && value <= 1.0)) {
+        throw std::invalid_argument(std::string(name) + " must be between 0 and 1");
+    }
+}
+
+const char* const METHOD_WORDS[] = {
+    "process", "update", "compute", "render", "validate", "load", "store", "parse",
+    "merge", "apply", "reset", "build", "resolve", "encode", "decode", "visit",
+};
+
+} // namespace
+
+CorpusGenerator::CorpusGenerator(CorpusConfig config) : config_(std::move(config)) {
+    check_ratio(config_.python_ratio, "python_ratio");
+    check_ratio(config_.cycle_ratio, "cycle_ratio");
+    check_ratio(config_.inheritance_ratio, "inheritance_ratio");
+    check_ratio(config_.cross_file_call_ratio, "cross_file_call_ratio");
+    if (config_.files_per_directory == 0) {
+        throw std::invalid_argument("files_per_directory must be positive");
+    }
+    if (config_.mega_files > 0 && config_.mega_file_classes == 0) {
+        throw std::invalid_argument("mega_file_classes must be positive");
+    }
+    plan();
+}
+
+void CorpusGenerator::plan() {
+    const uint64_t seed = config_.seed;
+    const size_t n = config_.file_count;
+    files_.assign(n, FilePlan{});
+
+    for (size_t i = 0; i < n; ++i) {
+        auto& file = files_[i];
+        file.python = unit_interval(draw(seed, SALT_LANGUAGE, i)) < config_.python_ratio;
+        file.header = file.python || unit_interval(draw(seed, SALT_HEADER, i)) < HEADER_RATIO;
+    }
+
+    // Include edges point backwards (a DAG); cycles are added explicitly
+    for (size_t i = 1; i < n; ++i) {
+        auto& file = files_[i];
+        std::set<size_t> targets;
+        for (size_t e = 0; e < config_.include_fanout; ++e) {
+            size_t start = draw(seed, SALT_INCLUDE, i, e) % i;
+            for (size_t j = start, steps = 0; steps < INCLUDE_SEARCH_LIMIT; ++steps) {
+                if (files_[j].header && files_[j].python == file.python) {
+                    targets.insert(j);
+                    break;
+                }
+                if (j == 0) {
+                    break;
+                }
+                --j;
+            }
+        }
+        file.includes.assign(targets.begin(), targets.end());
+    }
+
+    include_cycles_ = 0;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        auto& a = files_[i];
+        auto& b = files_[i + 1];
+        if (!a.header || !b.header || a.python != b.python || a.cycle_partner ||
+            unit_interval(draw(seed, SALT_CYCLE, i)) >= config_.cycle_ratio) {
+            continue;
+        }
+        if (std::find(a.includes.begin(), a.includes.end(), i + 1) == a.includes.end()) {
+            a.includes.push_back(i + 1);
+        }
+        if (std::find(b.includes.begin(), b.includes.end(), i) == b.includes.end()) {
+            b.includes.push_back(i);
+        }
+        b.cycle_partner = true;
+        include_cycles_++;
+    }
+
+    // Classes derive from classes of included (earlier) files or of the same file
+    for (size_t i = 0; i < n; ++i) {
+        auto& file = files_[i];
+        for (size_t k = 0; k < config_.classes_per_file; ++k) {
+            ClassPlan cls;
+            cls.name = "C" + std::to_string(i) + "_" + std::to_string(k);
+
+            bool derive = config_.hierarchy_depth > 1 &&
+                          unit_interval(draw(seed, SALT_INHERIT, i, k)) < config_.inheritance_ratio;
+            if (derive) {
+                auto earlier = dependencies(i);
+
+                const ClassPlan* best = nullptr;
+                std::string best_name;
+                for (size_t attempt = 0; attempt < BASE_CANDIDATES; ++attempt) {
+                    uint64_t h = draw(seed, SALT_BASE, i, k, attempt);
+                    const ClassPlan* candidate = nullptr;
+                    std::string candidate_name;
+
+                    if (!earlier.empty() && (k == 0 || h % 2 == 0)) {
+                        size_t j = earlier[(h >> 1) % earlier.size()];
+                        const auto& classes = files_[j].classes;
+                        if (!classes.empty()) {
+                            candidate = &classes[(h >> 8) % classes.size()];
+                            candidate_name = file.python
+                                ? "unit" + std::to_string(j) + "." + candidate->name
+                                : candidate->name;
+                        }
+                    } else if (k > 0) {
+                        candidate = &file.classes[(h >> 8) % k];
+                        candidate_name = candidate->name;
+                    }
+
+                    if (candidate && candidate->depth + 1 < config_.hierarchy_depth &&
+                        (!best || candidate->depth > best->depth)) {
+                        best = candidate;
+                        best_name = candidate_name;
+                    }
+                }
+                if (best) {
+                    cls.base = best_name;
+                    cls.depth = best->depth + 1;
+                }
+            }
+            file.classes.push_back(std::move(cls));
+        }
+    }
+}
+
+std::string CorpusGenerator::relative_path(size_t index) const {
+    const auto& file = files_.at(index);
+    size_t dir = index / config_.files_per_directory;
+    std::string path = "d" + std::to_string(dir / DIRS_PER_LEVEL) + "/d" +
+                       std::to_string(dir % DIRS_PER_LEVEL) + "/unit" + std::to_string(index);
+    if (file.python) {
+        return path + ".py";
+    }
+    return path + (file.header ? ".hpp" : ".cpp");
+}
+
+std::vector<size_t> CorpusGenerator::dependencies(size_t index) const {
+    std::vector<size_t> result;
+    if (index >= files_.size()) {
+        return result;
+    }
+    const auto& file = files_[index];
+    for (size_t j : file.includes) {
+        if (j < index && !(file.cycle_partner && j + 1 == index)) {
+            result.push_back(j);
+        }
+    }
+    return result;
+}
+
+std::string CorpusGenerator::method_name(uint64_t key) const {
+    if (config_.symbol_vocabulary == 0) {
+        return "method_" + std::to_string(key);
+    }
+    size_t word = key % config_.symbol_vocabulary;
+    constexpr size_t word_count = sizeof(METHOD_WORDS) / sizeof(METHOD_WORDS[0]);
+    std::string name = METHOD_WORDS[word % word_count];
+    if (word >= word_count) {
+        name += std::to_string(word / word_count);
+    }
+    return name;
+}
+
+void CorpusGenerator::append_body(std::string& out, size_t index, uint64_t key,
+                                  const std::string& indent, bool python) const {
+    const uint64_t seed = config_.seed;
+    auto includes = dependencies(index);
+    const char* end = python ? "" : ";";
+
+    out += indent + (python ? "total = 0\n" : "int total = 0;\n");
+    for (size_t s = 0; s < config_.statements_per_method; ++s) {
+        uint64_t h = draw(seed, SALT_STATEMENT, index, key, s);
+        std::string r = std::to_string(1 + (h >> 20) % 97);
+        std::string var = "v" + std::to_string(s);
+
+        bool cross = !includes.empty() && config_.functions_per_file > 0 &&
+                     unit_interval(draw(seed, SALT_STATEMENT, index, key, s + 1000)) <
+                         config_.cross_file_call_ratio;
+        if (cross) {
+            size_t j = includes[(h >> 8) % includes.size()];
+            std::string fn = "f" + std::to_string(j) + "_" +
+                             std::to_string((h >> 32) % config_.functions_per_file);
+            if (python) {
+                fn = "unit" + std::to_string(j) + "." + fn;
+            }
+            out += indent + "total += " + fn + "(a + " + std::to_string(s) + ")" + end + "\n";
+            continue;
+        }
+
+        switch (h % 4) {
+            case 0:
+                if (python) {
+                    out += indent + var + " = a * " + r + " + b\n";
+                    out += indent + "total += " + var + "\n";
+                } else {
+                    out += indent + "int " + var + " = a * " + r + " + b;\n";
+                    out += indent + "total += " + var + ";\n";
+                }
+                break;
+            case 1:
+                if (python) {
+                    out += indent + "if total > " + r + ":\n";
+                    out += indent + "    total -= " + r + "\n";
+                } else {
+                    out += indent + "if (total > " + r + ") {\n";
+                    out += indent + "    total -= " + r + ";\n";
+                    out += indent + "}\n";
+                }
+                break;
+            case 2:
+                if (python) {
+                    out += indent + "for i in range(" + r + "):\n";
+                    out += indent + "    total += i * b\n";
+                } else {
+                    out += indent + "for (int i = 0; i < " + r + "; ++i) {\n";
+                    out += indent + "    total += i * b;\n";
+                    out += indent + "}\n";
+                }
+                break;
+            default:
+                if (python) {
+                    out += indent + var + " = \"text" + r + "\"\n";
+                    out += indent + "total += len(" + var + ")\n";
+                } else {
+                    out += indent + "std::string " + var + " = \"text" + r + "\";\n";
+                    out += indent + "total += static_cast<int>(" + var + ".size());\n";
+                }
+                break;
+        }
+    }
+    out += indent + (python ? "return total\n" : "return total;\n");
+}
+
+std::string CorpusGenerator::cpp_content(size_t index) const {
+    const auto& file = files_[index];
+    const uint64_t seed = config_.seed;
+    const std::string fn_prefix = file.header ? "inline int " : "int ";
+
+    std::string out;
+    out.reserve(config_.classes_per_file * config_.methods_per_class *
+                (config_.statements_per_method + 4) * 40 + 512);
+
+    out += "// Generated corpus file unit" + std::to_string(index) +
+           " (seed " + std::to_string(seed) + ")\n";
+    if (file.header) {
+        out += "#pragma once\n";
+    }
+    out += "\n#include <string>\n#include <vector>\n";
+    for (size_t j : file.includes) {
+        out += "#include \"" + relative_path(j) + "\"\n";
+    }
+    out += "\nnamespace corpus {\n\n";
+
+    for (size_t f = 0; f < config_.functions_per_file; ++f) {
+        out += fn_prefix + "f" + std::to_string(index) + "_" + std::to_string(f) + "(int a) {\n";
+        out += "    int b = " + std::to_string(f + 1) + ";\n";
+        append_body(out, index, 100000 + f, "    ", false);
+        out += "}\n\n";
+    }
+
+    for (size_t k = 0; k < file.classes.size(); ++k) {
+        const auto& cls = file.classes[k];
+        out += "/**\n * @brief Generated class " + cls.name + "\n */\n";
+        out += "class " + cls.name;
+        if (!cls.base.empty()) {
+            out += " : public " + cls.base;
+        }
+        out += " {\npublic:\n";
+        out += "    " + cls.name + "() = default;\n";
+        out += "    virtual ~" + cls.name + "() = default;\n";
+
+        for (size_t m = 0; m < config_.methods_per_class; ++m) {
+            uint64_t key = k * config_.methods_per_class + m;
+            std::string name = method_name(draw(seed, SALT_METHOD, index, key));
+            out += "\n    virtual int " + name + std::to_string(m) + "(int a, int b) {\n";
+            append_body(out, index, key, "        ", false);
+            out += "    }\n";
+        }
+
+        out += "\nprivate:\n";
+        out += "    int value_ = " + std::to_string(draw(seed, SALT_VALUE, index, k) % 1000) + ";\n";
+        out += "    std::vector<std::string> names_;\n";
+        out += "};\n\n";
+    }
+
+    out += "} // namespace corpus\n";
+    return out;
+}
+
+std::string CorpusGenerator::python_content(size_t index) const {
+    const auto& file = files_[index];
+    const uint64_t seed = config_.seed;
+
+    std::string out;
+    out.reserve(config_.classes_per_file * config_.methods_per_class *
+                (config_.statements_per_method + 3) * 32 + 512);
+
+    out += "# Generated corpus file unit" + std::to_string(index) +
+           " (seed " + std::to_string(seed) + ")\n";
+    out += "import os\n";
+    for (size_t j : file.includes) {
+        std::string module = relative_path(j);
+        module = module.substr(0, module.size() - 3);
+        std::replace(module.begin(), module.end(), '/', '.');
+        out += "import " + module + " as unit" + std::to_string(j) + "\n";
+    }
+    out += "\n\n";
+
+    for (size_t f = 0; f < config_.functions_per_file; ++f) {
+        out += "def f" + std::to_string(index) + "_" + std::to_string(f) + "(a):\n";
+        out += "    b = " + std::to_string(f + 1) + "\n";
+        append_body(out, index, 100000 + f, "    ", true);
+        out += "\n\n";
+    }
+
+    for (size_t k = 0; k < file.classes.size(); ++k) {
+        const auto& cls = file.classes[k];
+        out += "class " + cls.name;
+        if (!cls.base.empty()) {
+            out += "(" + cls.base + ")";
+        }
+        out += ":\n";
+        out += "    \"\"\"Generated class " + cls.name + "\"\"\"\n\n";
+        out += "    def __init__(self):\n";
+        out += "        self.value = " + std::to_string(draw(seed, SALT_VALUE, index, k) % 1000) + "\n";
+
+        for (size_t m = 0; m < config_.methods_per_class; ++m) {
+            uint64_t key = k * config_.methods_per_class + m;
+            std::string name = method_name(draw(seed, SALT_METHOD, index, key));
+            out += "\n    def " + name + std::to_string(m) + "(self, a, b):\n";
+            append_body(out, index, key, "        ", true);
+        }
+        out += "\n\n";
+    }
+
+    return out;
+}
+
+std::string CorpusGenerator::file_content(size_t index) const {
+    return files_.at(index).python ? python_content(index) : cpp_content(index);
+}
+
+std::string CorpusGenerator::mega_file_content(size_t index) const {
+    const uint64_t seed = config_.seed;
+    const uint64_t salt_index = config_.file_count + index;  // Distinct from regular files
+    std::string prefix = "M" + std::to_string(index) + "_";
+
+    std::string out;
+    out.reserve(config_.mega_file_classes * 600);
+    out += "// Generated mega file " + std::to_string(index) +
+           " (seed " + std::to_string(seed) + ")\n\n";
+    out += "#include <string>\n#include <vector>\n\nnamespace corpus {\n\n";
+
+    for (size_t k = 0; k < config_.mega_file_classes; ++k) {
+        std::string name = prefix + std::to_string(k);
+        out += "class " + name;
+        // Chains of hierarchy_depth classes
+        if (config_.hierarchy_depth > 1 && k % config_.hierarchy_depth != 0) {
+            out += " : public " + prefix + std::to_string(k - 1);
+        }
+        out += " {\npublic:\n";
+        for (size_t m = 0; m < config_.methods_per_class; ++m) {
+            uint64_t key = k * config_.methods_per_class + m;
+            out += "    virtual int " + method_name(draw(seed, SALT_METHOD, salt_index, key)) +
+                   std::to_string(m) + "(int a, int b) {\n";
+            append_body(out, salt_index, key, "        ", false);
+            out += "    }\n";
+        }
+        out += "};\n\n";
+    }
+
+    out += "} // namespace corpus\n";
+    return out;
+}
+
+CorpusStats CorpusGenerator::generate(const std::filesystem::path& root) {
+    CorpusStats stats;
+    std::set<std::filesystem::path> directories;
+
+    auto write = [&](const std::filesystem::path& rel_path, const std::string& content) {
+        auto path = root / rel_path;
+        auto dir = path.parent_path();
+        if (directories.insert(dir).second) {
+            std::filesystem::create_directories(dir);
+        }
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write " + path.string());
+        }
+        stats.files++;
+        stats.bytes += content.size();
+    };
+
+    std::filesystem::create_directories(root);
+
+    for (size_t i = 0; i < files_.size(); ++i) {
+        const auto& file = files_[i];
+        write(relative_path(i), file_content(i));
+
+        (file.python ? stats.python_files : stats.cpp_files)++;
+        stats.classes += file.classes.size();
+        stats.functions += config_.functions_per_file + file.classes.size() * config_.methods_per_class;
+        stats.include_edges += file.includes.size();
+        for (const auto& cls : file.classes) {
+            stats.max_hierarchy_depth = std::max(stats.max_hierarchy_depth, cls.depth + 1);
+        }
+    }
+
+    for (size_t n = 0; n < config_.mega_files; ++n) {
+        write("mega/mega" + std::to_string(n) + ".cpp", mega_file_content(n));
+        stats.cpp_files++;
+        stats.classes += config_.mega_file_classes;
+        stats.functions += config_.mega_file_classes * config_.methods_per_class;
+        stats.max_hierarchy_depth = std::max(
+            stats.max_hierarchy_depth,
+            std::min(config_.mega_file_classes, std::max<size_t>(config_.hierarchy_depth, 1)));
+    }
+
+    stats.directories = directories.size();
+    stats.include_cycles = include_cycles_;
+
+    spdlog::debug("Generated corpus in {}: {} files, {} bytes", root.string(), stats.files, stats.bytes);
+    return stats;
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Shape of a generated codebase
+ *
+ * The same config (including seed) always produces byte-identical files.
+ */
+struct CorpusConfig {
+    uint64_t seed = 1;
+
+    // Layout
+    size_t file_count = 100;             // Regular source files (C++ and Python)
+    double python_ratio = 0.2;           // Fraction of files generated as Python
+    size_t files_per_directory = 50;     // Files are spread over nested directories
+
+    // File size
+    size_t classes_per_file = 4;
+    size_t methods_per_class = 4;
+    size_t statements_per_method = 6;
+    size_t functions_per_file = 2;       // Free functions
+
+    // Cross-file structure
+    size_t include_fanout = 3;           // #include / import edges per file
+    double cycle_ratio = 0.05;           // Fraction of files forming a 2-cycle with the next file
+    size_t hierarchy_depth = 4;          // Longest base-class chain
+    double inheritance_ratio = 0.5;      // Fraction of classes with a base class
+    size_t symbol_vocabulary = 64;       // Distinct method names (0 = unique names)
+    double cross_file_call_ratio = 0.3;  // Fraction of statements calling an included file's function
+
+    // Pathological inputs
+    size_t mega_files = 0;               // Extra very large C++ files
+    size_t mega_file_classes = 5000;
+};
+
+/**
+ * @brief Totals of a generated corpus
+ */
+struct CorpusStats {
+    size_t files = 0;
+    size_t cpp_files = 0;
+    size_t python_files = 0;
+    size_t directories = 0;
+    uint64_t bytes = 0;
+    size_t classes = 0;
+    size_t functions = 0;                // Methods and free functions
+    size_t include_edges = 0;
+    size_t include_cycles = 0;
+    size_t max_hierarchy_depth = 0;
+};
+
+/**
+ * @brief Deterministic generator of synthetic C++ and Python codebases
+ *
+ * Produces trees for benchmarks and scale tests: headers and sources that
+ * include each other (optionally with cycles), class hierarchies spanning
+ * files, reused symbol names, cross-file calls and, optionally, mega-files.
+ * Output depends only on the config; no clock, locale or platform RNG is
+ * involved.
+ *
+ * File i is written to d<a>/d<b>/unit<i>.{hpp,cpp,py}; mega files go to
+ * mega/mega<n>.cpp.
+ */
+class CorpusGenerator {
+public:
+    /**
+     * @brief Validate and store a config
+     * @throws std::invalid_argument if a ratio is outside [0, 1] or a size is zero
+     */
+    explicit CorpusGenerator(CorpusConfig config);
+
+    /**
+     * @brief Write the corpus below a directory (created if missing)
+     * @return Totals of what was written
+     * @throws std::runtime_error if a file cannot be written
+     */
+    CorpusStats generate(const std::filesystem::path& root);
+
+    /**
+     * @brief Path of file i relative to the corpus root
+     */
+    std::string relative_path(size_t index) const;
+
+    /**
+     * @brief Contents of file i (as written by generate())
+     */
+    std::string file_content(size_t index) const;
+
+    /**
+     * @brief Contents of mega file n
+     */
+    std::string mega_file_content(size_t index) const;
+
+    const CorpusConfig& config() const { return config_; }
+
+private:
+    struct ClassPlan {
+        std::string name;
+        std::string base;        // Empty if none
+        size_t depth = 0;        // 0 for classes without a base
+    };
+
+    struct FilePlan {
+        bool python = false;
+        bool header = false;     // C++: .hpp (includable) or .cpp
+        bool cycle_partner = false;  // Second file of a 2-cycle with the previous file
+        std::vector<size_t> includes;
+        std::vector<ClassPlan> classes;
+    };
+
+    /**
+     * @brief Decide languages, include edges and class hierarchy for all files
+     */
+    void plan();
+
+    std::string cpp_content(size_t index) const;
+    std::string python_content(size_t index) const;
+
+    /**
+     * @brief Method name for a class member (drawn from the vocabulary)
+     */
+    std::string method_name(uint64_t key) const;
+
+    /**
+     * @brief Included files whose symbols file i may use
+     *
+     * Earlier files only, minus a cycle partner: with include guards one
+     * side of a cycle always sees the other incomplete.
+     */
+    std::vector<size_t> dependencies(size_t index) const;
+
+    /**
+     * @brief Statement lines of a function body
+     */
+    void append_body(std::string& out, size_t index, uint64_t key,
+                     const std::string& indent, bool python) const;
+
+    CorpusConfig config_;
+    std::vector<FilePlan> files_;
+    size_t include_cycles_ = 0;
+};
+
+} // namespace ts_mcp
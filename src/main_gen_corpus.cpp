@@ -0,0 +1,96 @@
+#include "corpus/CorpusGenerator.hpp"
+
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    CLI::App app{"Generate a deterministic synthetic C++/Python codebase for benchmarks"};
+
+    ts_mcp::CorpusConfig config;
+    std::string output;
+    bool clean = false;
+
+    app.add_option("-o,--output", output, "Directory to write the corpus to")->required();
+    app.add_flag("--clean", clean, "Remove the output directory first");
+    app.add_option("-s,--seed", config.seed, "Generator seed")->default_val(config.seed);
+
+    app.add_option("-n,--files", config.file_count, "Number of regular source files")
+        ->default_val(config.file_count);
+    app.add_option("--python-ratio", config.python_ratio, "Fraction of Python files")
+        ->default_val(config.python_ratio)->check(CLI::Range(0.0, 1.0));
+    app.add_option("--files-per-dir", config.files_per_directory, "Files per directory")
+        ->default_val(config.files_per_directory);
+
+    app.add_option("--classes", config.classes_per_file, "Classes per file")
+        ->default_val(config.classes_per_file);
+    app.add_option("--methods", config.methods_per_class, "Methods per class")
+        ->default_val(config.methods_per_class);
+    app.add_option("--statements", config.statements_per_method, "Statements per method")
+        ->default_val(config.statements_per_method);
+    app.add_option("--functions", config.functions_per_file, "Free functions per file")
+        ->default_val(config.functions_per_file);
+
+    app.add_option("--include-fanout", config.include_fanout, "Includes/imports per file")
+        ->default_val(config.include_fanout);
+    app.add_option("--cycle-ratio", config.cycle_ratio, "Fraction of files in an include cycle")
+        ->default_val(config.cycle_ratio)->check(CLI::Range(0.0, 1.0));
+    app.add_option("--hierarchy-depth", config.hierarchy_depth, "Longest base-class chain")
+        ->default_val(config.hierarchy_depth);
+    app.add_option("--inheritance-ratio", config.inheritance_ratio, "Fraction of classes with a base")
+        ->default_val(config.inheritance_ratio)->check(CLI::Range(0.0, 1.0));
+    app.add_option("--symbol-vocabulary", config.symbol_vocabulary,
+                   "Distinct method names; small values mean heavy reuse (0 = all unique)")
+        ->default_val(config.symbol_vocabulary);
+    app.add_option("--cross-file-calls", config.cross_file_call_ratio,
+                   "Fraction of statements calling a function of an included file")
+        ->default_val(config.cross_file_call_ratio)->check(CLI::Range(0.0, 1.0));
+
+    app.add_option("--mega-files", config.mega_files, "Additional very large C++ files")
+        ->default_val(config.mega_files);
+    app.add_option("--mega-file-classes", config.mega_file_classes, "Classes per mega file")
+        ->default_val(config.mega_file_classes);
+
+    CLI11_PARSE(app, argc, argv);
+
+    try {
+        std::filesystem::path root(output);
+        if (clean) {
+            std::filesystem::remove_all(root);
+        } else if (std::filesystem::exists(root) && !std::filesystem::is_empty(root)) {
+            std::cerr << "Output directory is not empty (use --clean): " << output << std::endl;
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        ts_mcp::CorpusGenerator generator(config);
+        auto stats = generator.generate(root);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        nlohmann::json summary = {
+            {"output", std::filesystem::absolute(root).string()},
+            {"seed", config.seed},
+            {"files", stats.files},
+            {"cpp_files", stats.cpp_files},
+            {"python_files", stats.python_files},
+            {"directories", stats.directories},
+            {"bytes", stats.bytes},
+            {"classes", stats.classes},
+            {"functions", stats.functions},
+            {"include_edges", stats.include_edges},
+            {"include_cycles", stats.include_cycles},
+            {"max_hierarchy_depth", stats.max_hierarchy_depth},
+            {"elapsed_ms", elapsed.count()}
+        };
+        std::cout << summary.dump(2) << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        spdlog::critical("Corpus generation failed: {}", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,65 @@
+#include "mcp/ProcessTransport.hpp"
+#include "mcp/SessionReplayer.hpp"
+
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    CLI::App app{"Replay a recorded MCP session (tree-sitter-mcp --record) against a fresh server"};
+
+    std::string capture_file;
+    std::string server = "tree-sitter-mcp";
+    std::vector<std::string> server_args;
+    ts_mcp::ReplayOptions options;
+    std::string report_file;
+
+    app.add_option("capture", capture_file, "Capture file written by --record")->required();
+    app.add_option("--server", server, "Server executable (looked up in PATH)")->default_val(server);
+    app.add_option("--server-arg", server_args,
+                   "Argument passed to the server (repeatable; use --server-arg=-w for dashes)");
+    app.add_flag("--max-speed", options.max_speed,
+                 "Send each request as soon as the previous one is answered");
+    app.add_option("--speed", options.speed, "Pace multiplier when not at max speed")
+        ->default_val(options.speed)->check(CLI::PositiveNumber);
+    app.add_option("--max-diffs", options.max_diffs, "Mismatching responses reported in full")
+        ->default_val(options.max_diffs);
+    app.add_option("--report", report_file, "Also write the JSON report to this file");
+
+    CLI11_PARSE(app, argc, argv);
+
+    // stdout carries the report
+    spdlog::set_default_logger(spdlog::stderr_color_mt("ts_mcp_replay"));
+
+    try {
+        ts_mcp::SessionReplayer replayer(ts_mcp::SessionReplayer::load(capture_file));
+
+        std::vector<std::string> command{server};
+        command.insert(command.end(), server_args.begin(), server_args.end());
+        ts_mcp::ProcessTransport transport(command);
+
+        ts_mcp::ReplayReport report = replayer.run(transport, options);
+        transport.close();
+
+        nlohmann::json result = report.to_json();
+        std::cout << result.dump(2) << std::endl;
+        if (!report_file.empty()) {
+            std::ofstream out(report_file);
+            out << result.dump(2) << '\n';
+            if (!out) {
+                spdlog::error("Cannot write report to {}", report_file);
+                return 1;
+            }
+        }
+
+        return report.missing_responses > 0 || report.mismatches > 0 ? 2 : 0;
+    } catch (const std::exception& e) {
+        spdlog::error("Replay failed: {}", e.what());
+        return 1;
+    }
+}
@@ -1,5 +1,18 @@
 #include "core/ASTAnalyzer.hpp"
+#include "core/FactCache.hpp"
+#include "core/FileWatcher.hpp"
+#include "core/Indexer.hpp"
+#include "core/Logging.hpp"
+#include "core/MemoryAccounting.hpp"
+#include "core/MetricsExporter.hpp"
+#include "core/ParseGuard.hpp"
+#include "core/PathResolver.hpp"
+#include "core/Prefetcher.hpp"
+#include "core/Trace.hpp"
+#include "core/WarmUp.hpp"
 #include "mcp/MCPServer.hpp"
+#include "mcp/RecordingTransport.hpp"
+#include "mcp/ShardPool.hpp"
 #include "mcp/StdioTransport.hpp"
 #include "tools/ParseFileTool.hpp"
 #include "tools/FindClassesTool.hpp"
@@ -11,10 +24,15 @@
 #include "tools/GetClassHierarchyTool.hpp"
 #include "tools/GetDependencyGraphTool.hpp"
 #include "tools/GetSymbolContextTool.hpp"
+#include "tools/ServerStatsTool.hpp"
+#include "tools/MemoryStatsTool.hpp"
 
 #include <CLI/CLI.hpp>
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <csignal>
+#include <filesystem>
+#include <map>
 #include <memory>
 #include <atomic>
 
@@ -34,6 +52,41 @@ namespace {
         std::signal(SIGINT, signal_handler);
         std::signal(SIGTERM, signal_handler);
     }
+
+    /**
+     * @brief Per-file facts of the tools, with their default arguments (index and warm-up step)
+     */
+    void tool_facts(const std::shared_ptr<ts_mcp::ASTAnalyzer>& analyzer, const std::filesystem::path& file) {
+        nlohmann::json args = {{"filepath", file.string()}};
+        ts_mcp::GetFileSummaryTool(analyzer).execute(args);
+        ts_mcp::ExtractInterfaceTool(analyzer).execute(args);
+        if (ts_mcp::LanguageUtils::detect_from_extension(file) == ts_mcp::Language::CPP) {
+            ts_mcp::GetClassHierarchyTool(analyzer).execute(args);
+        }
+    }
+
+    /**
+     * @brief The index subcommand: fill a fact cache for a whole tree
+     */
+    int run_index(const std::string& root, const std::string& out, unsigned jobs) {
+        auto cache = std::make_shared<ts_mcp::FactCache>(out);
+        ts_mcp::Indexer indexer(cache, jobs);
+
+        indexer.add_step(tool_facts);
+
+        auto files = ts_mcp::PathResolver::resolve_paths(
+            {std::filesystem::absolute(root).string()}, true,
+            {"*.cpp", "*.hpp", "*.h", "*.cc", "*.cxx", "*.py"});
+        spdlog::info("Indexing {} files under {} with {} threads", files.size(), root, indexer.jobs());
+
+        auto stats = indexer.run(files);
+        auto cache_stats = cache->stats();
+        spdlog::info("Indexed {} files in {:.0f} ms: {} facts computed, {} up to date, {} files failed; "
+                     "{} entries, {} bytes in {}",
+                     stats.files, stats.elapsed_ms, stats.computed, stats.reused, stats.failed,
+                     cache_stats.entries, cache_stats.file_bytes, cache->file().string());
+        return stats.failed == 0 ? 0 : 2;
+    }
 }
 
 int main(int argc, char** argv) {
@@ -44,9 +97,132 @@ int main(int argc, char** argv) {
     app.add_option("-l,--log-level", log_level, "Log level (trace, debug, info, warn, error, critical)")
         ->default_val("info");
 
+    size_t log_queue = 8192;
+    app.add_option("--log-queue", log_queue,
+                   "Log messages queued for the background thread writing them to stderr; "
+                   "when full, the oldest are dropped instead of blocking requests")
+        ->default_val(log_queue);
+
     bool version = false;
     app.add_flag("-v,--version", version, "Print version information");
 
+    std::string watch_root;
+    app.add_option("-w,--watch", watch_root,
+                   "Workspace directory to watch for changes (Linux inotify); "
+                   "keeps caches fresh without per-access stat checks");
+
+    bool use_git_index = false;
+    app.add_flag("--git-index", use_git_index,
+                 "List files of git work trees from .git/index instead of walking "
+                 "directories (tracked files only)");
+
+    std::string fact_cache_dir;
+    app.add_option("--fact-cache", fact_cache_dir,
+                   "Persist per-file analysis results in this directory across restarts "
+                   "(\"auto\" for $XDG_CACHE_HOME/tree-sitter-mcp)");
+
+    ts_mcp::ParseLimits parse_limits;
+    app.add_option("--max-file-bytes", parse_limits.max_file_bytes,
+                   "Files larger than this are not parsed; tools fall back to line-based results "
+                   "flagged \"degraded\"")
+        ->default_val(parse_limits.max_file_bytes);
+    app.add_option("--max-generated-bytes", parse_limits.max_generated_bytes,
+                   "Generated or minified files larger than this are not parsed")
+        ->default_val(parse_limits.max_generated_bytes);
+    app.add_option("--parse-timeout-ms", parse_limits.timeout_ms,
+                   "Cancel a single parse after this many milliseconds (0 = no limit)")
+        ->default_val(parse_limits.timeout_ms);
+
+    ts_mcp::CacheLimits cache_limits;
+    app.add_option("--max-trees", cache_limits.max_trees,
+                   "Files kept parsed in memory; others are answered from their cached facts "
+                   "or parsed again")
+        ->default_val(cache_limits.max_trees)->check(CLI::Range(size_t{1}, size_t{1} << 20));
+    size_t tree_memory_mb = cache_limits.max_tree_bytes >> 20;
+    app.add_option("--tree-memory-mb", tree_memory_mb, "Memory for parsed files (sources and trees)")
+        ->default_val(tree_memory_mb);
+    size_t fact_memory_mb = cache_limits.max_fact_bytes >> 20;
+    app.add_option("--fact-memory-mb", fact_memory_mb,
+                   "Memory for per-file facts (classes, functions, includes, summaries) kept "
+                   "after their trees are evicted")
+        ->default_val(fact_memory_mb);
+
+    unsigned workers = 0;
+    app.add_option("--workers", workers,
+                   "Split repo-wide tools (references, classes, functions, class hierarchy, "
+                   "dependency graph) across this many worker processes (Linux)")
+        ->default_val(0)->check(CLI::Range(0, 256));
+
+    bool shard_worker = false;
+    app.add_flag("--shard-worker", shard_worker, "Run as a worker of a --workers coordinator")
+        ->group("");
+
+    unsigned warm_up_threads = 1;
+    app.add_option("--warm-up-threads", warm_up_threads,
+                   "Low-priority threads analyzing the workspace (client roots, else --watch "
+                   "or the working directory) after initialize, paused during requests (0 = off)")
+        ->default_val(1)->check(CLI::Range(0, 64));
+
+    ts_mcp::Prefetcher::Budget prefetch_budget;
+    app.add_option("--prefetch-cpu-percent", prefetch_budget.cpu_percent,
+                   "After each tool call, parse the named files' sibling headers/sources, includes "
+                   "and type definitions in the background, using at most this share of one core "
+                   "(0 = off)")
+        ->default_val(prefetch_budget.cpu_percent)->check(CLI::Range(0, 100));
+    app.add_option("--prefetch-files", prefetch_budget.max_files, "Neighbors prefetched per named file")
+        ->default_val(prefetch_budget.max_files);
+    size_t prefetch_memory_mb = prefetch_budget.max_tree_bytes >> 20;
+    app.add_option("--prefetch-memory-mb", prefetch_memory_mb,
+                   "Prefetch only while parsed files take less memory than this")
+        ->default_val(prefetch_memory_mb);
+
+    std::string metrics_file;
+    app.add_option("--metrics-file", metrics_file,
+                   "Periodically write metrics in Prometheus text format to this file");
+
+    std::string metrics_socket;
+    app.add_option("--metrics-socket", metrics_socket,
+                   "Serve metrics in Prometheus text format on this Unix socket");
+
+    int metrics_interval = 10;
+    app.add_option("--metrics-interval", metrics_interval, "Seconds between metrics file writes")
+        ->default_val(10)->check(CLI::Range(1, 3600));
+
+    std::string trace_file;
+    app.add_option("--trace-file", trace_file,
+                   "Record request phase spans and write them as Chrome/Perfetto "
+                   "trace-event JSON to this file on shutdown");
+
+    size_t trace_buffer = ts_mcp::Tracer::DEFAULT_EVENTS_PER_THREAD;
+    app.add_option("--trace-buffer", trace_buffer,
+                   "Trace events kept per thread (older events are overwritten)")
+        ->default_val(trace_buffer);
+
+    std::string slow_log_file;
+    app.add_option("--slow-log", slow_log_file,
+                   "Append tool calls slower than --slow-threshold-ms to this file "
+                   "(JSON lines with arguments and phase breakdown)");
+
+    int slow_threshold_ms = 1000;
+    app.add_option("--slow-threshold-ms", slow_threshold_ms, "Slow tool call threshold in milliseconds")
+        ->default_val(1000)->check(CLI::NonNegativeNumber);
+
+    std::string record_file;
+    app.add_option("--record", record_file,
+                   "Capture every incoming and outgoing message with timestamps "
+                   "(replay with ts_mcp_replay)");
+
+    auto* index_command = app.add_subcommand(
+        "index", "Parse a whole tree in parallel and store its per-file facts in a fact cache "
+                 "directory for servers started with --fact-cache");
+    std::string index_root;
+    index_command->add_option("--root", index_root, "Directory to index")
+        ->required()->check(CLI::ExistingDirectory);
+    std::string index_out;
+    index_command->add_option("--out", index_out, "Fact cache directory to write")->required();
+    unsigned index_jobs = 0;
+    index_command->add_option("-j,--jobs", index_jobs, "Worker threads (0 = all cores)");
+
     CLI11_PARSE(app, argc, argv);
 
     if (version) {
@@ -71,6 +247,28 @@ int main(int argc, char** argv) {
         std::cerr << "Invalid log level: " << log_level << std::endl;
         return 1;
     }
+    // stdout carries the protocol; log to stderr, off the request threads
+    ts_mcp::Logging::install_async(std::max<size_t>(log_queue, 1));
+
+    ts_mcp::ParseGuard::set_limits(parse_limits);
+
+    if (*index_command) {
+        try {
+            ts_mcp::TreeSitterMemory::install();
+            if (!trace_file.empty()) {
+                ts_mcp::Tracer::start(trace_file, trace_buffer);
+            }
+            ts_mcp::PathResolver::set_git_index_enabled(use_git_index);
+            int status = run_index(index_root, index_out, index_jobs);
+            ts_mcp::Tracer::stop();
+            ts_mcp::Logging::shutdown();
+            return status;
+        } catch (const std::exception& e) {
+            spdlog::error("Indexing failed: {}", e.what());
+            ts_mcp::Logging::shutdown();
+            return 1;
+        }
+    }
 
     spdlog::info("Starting MCP Stdio Server");
     spdlog::info("Log level: {}", log_level);
@@ -79,14 +277,138 @@ int main(int argc, char** argv) {
         // Setup signal handlers for graceful shutdown
         setup_signal_handlers();
 
+        if (!trace_file.empty()) {
+            ts_mcp::Tracer::start(trace_file, trace_buffer);
+        }
+
+        // Before any tree-sitter object exists (see TreeSitterMemory::install)
+        ts_mcp::TreeSitterMemory::install();
+
         // Create core components
         auto analyzer = std::make_shared<ts_mcp::ASTAnalyzer>();
-        auto transport = std::make_unique<ts_mcp::StdioTransport>();
+        cache_limits.max_tree_bytes = tree_memory_mb << 20;
+        cache_limits.max_fact_bytes = fact_memory_mb << 20;
+        analyzer->set_cache_limits(cache_limits);
+        ts_mcp::PathResolver::set_git_index_enabled(use_git_index);
+
+        std::shared_ptr<ts_mcp::FileWatcher> watcher;
+        if (!watch_root.empty()) {
+            try {
+                watcher = std::make_shared<ts_mcp::FileWatcher>(std::filesystem::canonical(watch_root));
+                analyzer->attach_watcher(watcher);
+                ts_mcp::PathResolver::attach_watcher(watcher);
+                watcher->start();
+            } catch (const std::exception& e) {
+                spdlog::warn("File watcher disabled: {}", e.what());
+            }
+        }
+
+        if (!fact_cache_dir.empty()) {
+            try {
+                std::filesystem::path directory = fact_cache_dir == "auto"
+                    ? ts_mcp::FactCache::default_directory()
+                    : std::filesystem::path(fact_cache_dir);
+                analyzer->set_fact_cache(std::make_shared<ts_mcp::FactCache>(directory));
+            } catch (const std::exception& e) {
+                spdlog::warn("Fact cache disabled: {}", e.what());
+            }
+        }
+
+        std::unique_ptr<ts_mcp::MetricsExporter> metrics_exporter;
+        if (!metrics_file.empty() || !metrics_socket.empty()) {
+            try {
+                metrics_exporter = std::make_unique<ts_mcp::MetricsExporter>(
+                    metrics_file, metrics_socket, std::chrono::seconds(metrics_interval));
+                metrics_exporter->start();
+            } catch (const std::exception& e) {
+                spdlog::warn("Metrics export disabled: {}", e.what());
+            }
+        }
+
+        std::unique_ptr<ts_mcp::ITransport> transport = std::make_unique<ts_mcp::StdioTransport>();
+        if (!record_file.empty()) {
+            try {
+                transport = std::make_unique<ts_mcp::RecordingTransport>(std::move(transport), record_file);
+            } catch (const std::exception& e) {
+                spdlog::warn("Session recording disabled: {}", e.what());
+                transport = std::make_unique<ts_mcp::StdioTransport>();
+            }
+        }
         auto server = std::make_unique<ts_mcp::MCPServer>(std::move(transport));
 
+        if (!slow_log_file.empty()) {
+            try {
+                server->set_slow_request_log(std::make_unique<ts_mcp::SlowRequestLog>(
+                    slow_log_file, std::chrono::milliseconds(slow_threshold_ms)));
+            } catch (const std::exception& e) {
+                spdlog::warn("Slow request log disabled: {}", e.what());
+            }
+        }
+
         // Store global reference for signal handler
         global_server = server.get();
 
+        std::shared_ptr<ts_mcp::WarmUp> warm_up;
+        if (warm_up_threads > 0 && !shard_worker) {
+            std::filesystem::path default_root = watch_root.empty() ? std::filesystem::current_path()
+                                                                    : std::filesystem::path(watch_root);
+            ts_mcp::WarmUp::Options warm_up_options;
+            warm_up_options.threads = warm_up_threads;
+            warm_up = std::make_shared<ts_mcp::WarmUp>(analyzer, std::vector<std::filesystem::path>{default_root},
+                                                       warm_up_options);
+            warm_up->add_step(tool_facts);
+            server->set_warm_up(warm_up);
+        }
+
+        std::shared_ptr<ts_mcp::Prefetcher> prefetcher;
+        if (prefetch_budget.cpu_percent > 0 && !shard_worker) {
+            prefetch_budget.max_tree_bytes = prefetch_memory_mb << 20;
+            prefetcher = std::make_shared<ts_mcp::Prefetcher>(analyzer, prefetch_budget);
+            prefetcher->add_step(tool_facts);
+            prefetcher->start();
+            server->set_prefetcher(prefetcher);
+        }
+
+        std::shared_ptr<ts_mcp::ShardPool> shard_pool;
+        if (workers > 0 && !shard_worker) {
+            try {
+                std::vector<std::string> command = {
+                    std::filesystem::read_symlink("/proc/self/exe").string(),
+                    "--shard-worker", "--log-level", "warn"
+                };
+                if (use_git_index) {
+                    command.push_back("--git-index");
+                }
+                if (!fact_cache_dir.empty()) {
+                    command.push_back("--fact-cache");
+                    command.push_back(fact_cache_dir);
+                }
+                command.push_back("--max-file-bytes");
+                command.push_back(std::to_string(parse_limits.max_file_bytes));
+                command.push_back("--max-generated-bytes");
+                command.push_back(std::to_string(parse_limits.max_generated_bytes));
+                command.push_back("--parse-timeout-ms");
+                command.push_back(std::to_string(parse_limits.timeout_ms));
+                command.push_back("--max-trees");
+                command.push_back(std::to_string(cache_limits.max_trees));
+                command.push_back("--tree-memory-mb");
+                command.push_back(std::to_string(tree_memory_mb));
+                command.push_back("--fact-memory-mb");
+                command.push_back(std::to_string(fact_memory_mb));
+                shard_pool = std::make_shared<ts_mcp::ShardPool>(command, workers);
+            } catch (const std::exception& e) {
+                spdlog::warn("Shard workers disabled: {}", e.what());
+            }
+        }
+
+        // Repo-wide tools: fanned out to shard workers, and runnable by a worker on its shard
+        std::map<std::string, ts_mcp::ToolHandler> shardable_tools;
+        auto register_shardable = [&](const ts_mcp::ToolInfo& info, ts_mcp::ToolHandler handler) {
+            shardable_tools[info.name] = handler;
+            server->register_tool(info, shard_pool ? ts_mcp::ShardPool::sharded(shard_pool, info.name, handler)
+                                                   : std::move(handler));
+        };
+
         // Create and register tools
         auto parse_tool = std::make_shared<ts_mcp::ParseFileTool>(analyzer);
         server->register_tool(
@@ -97,7 +419,7 @@ int main(int argc, char** argv) {
         );
 
         auto find_classes_tool = std::make_shared<ts_mcp::FindClassesTool>(analyzer);
-        server->register_tool(
+        register_shardable(
             ts_mcp::FindClassesTool::get_info(),
             [find_classes_tool](const nlohmann::json& args) {
                 return find_classes_tool->execute(args);
@@ -105,7 +427,7 @@ int main(int argc, char** argv) {
         );
 
         auto find_functions_tool = std::make_shared<ts_mcp::FindFunctionsTool>(analyzer);
-        server->register_tool(
+        register_shardable(
             ts_mcp::FindFunctionsTool::get_info(),
             [find_functions_tool](const nlohmann::json& args) {
                 return find_functions_tool->execute(args);
@@ -129,7 +451,7 @@ int main(int argc, char** argv) {
         );
 
         auto find_references_tool = std::make_shared<ts_mcp::FindReferencesTool>(analyzer);
-        server->register_tool(
+        register_shardable(
             ts_mcp::FindReferencesTool::get_info(),
             [find_references_tool](const nlohmann::json& args) {
                 return find_references_tool->execute(args);
@@ -145,7 +467,7 @@ int main(int argc, char** argv) {
         );
 
         auto get_class_hierarchy_tool = std::make_shared<ts_mcp::GetClassHierarchyTool>(analyzer);
-        server->register_tool(
+        register_shardable(
             ts_mcp::GetClassHierarchyTool::get_info(),
             [get_class_hierarchy_tool](const nlohmann::json& args) {
                 return get_class_hierarchy_tool->execute(args);
@@ -153,7 +475,7 @@ int main(int argc, char** argv) {
         );
 
         auto get_dependency_graph_tool = std::make_shared<ts_mcp::GetDependencyGraphTool>(analyzer);
-        server->register_tool(
+        register_shardable(
             ts_mcp::GetDependencyGraphTool::get_info(),
             [get_dependency_graph_tool](const nlohmann::json& args) {
                 return get_dependency_graph_tool->execute(args);
@@ -168,17 +490,54 @@ int main(int argc, char** argv) {
             }
         );
 
+        auto server_stats_tool = std::make_shared<ts_mcp::ServerStatsTool>(analyzer, warm_up);
+        server->register_tool(
+            ts_mcp::ServerStatsTool::get_info(),
+            [server_stats_tool](const nlohmann::json& args) {
+                return server_stats_tool->execute(args);
+            }
+        );
+
+        auto memory_stats_tool = std::make_shared<ts_mcp::MemoryStatsTool>(analyzer);
+        server->register_tool(
+            ts_mcp::MemoryStatsTool::get_info(),
+            [memory_stats_tool](const nlohmann::json& args) {
+                return memory_stats_tool->execute(args);
+            }
+        );
+
+        if (shard_worker) {
+            server->register_tool(ts_mcp::ShardPool::worker_tool_info(),
+                                  ts_mcp::ShardPool::worker_handler(shardable_tools));
+        }
+
         spdlog::info("All tools registered, starting server");
 
         // Run server (blocks until stopped)
         server->run();
 
+        if (warm_up) {
+            warm_up->stop();
+        }
+        if (prefetcher) {
+            prefetcher->stop();
+        }
+
+        if (watcher) {
+            watcher->stop();
+        }
+        if (metrics_exporter) {
+            metrics_exporter->stop();
+        }
+        ts_mcp::Tracer::stop();
         global_server = nullptr;
         spdlog::info("Server stopped cleanly");
+        ts_mcp::Logging::shutdown();
         return 0;
 
     } catch (const std::exception& e) {
         spdlog::critical("Fatal error: {}", e.what());
+        ts_mcp::Logging::shutdown();
         return 1;
     }
 }
@@ -1,11 +1,74 @@
 #include "MCPServer.hpp"
+#include "core/Logging.hpp"
+#include "core/Trace.hpp"
 #include <spdlog/spdlog.h>
+#include <cctype>
+#include <chrono>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace ts_mcp {
 
+namespace {
+
+// Id of the roots/list request the server sends after initialization
+const char* const ROOTS_REQUEST_ID = "ts_mcp/roots";
+
+/**
+ * @brief Local path of a file:// URI (empty for other schemes)
+ */
+std::filesystem::path path_from_uri(const std::string& uri) {
+    const std::string scheme = "file://";
+    if (uri.compare(0, scheme.size(), scheme) != 0) {
+        return {};
+    }
+    std::string path;
+    for (size_t i = scheme.size(); i < uri.size(); ++i) {
+        if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(static_cast<unsigned char>(uri[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+            path += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else {
+            path += uri[i];
+        }
+    }
+    return path;
+}
+
+/**
+ * @brief Paths named in tool arguments ("filepath", "search_paths")
+ */
+std::vector<std::filesystem::path> argument_paths(const json& arguments) {
+    std::vector<std::filesystem::path> paths;
+    if (!arguments.is_object()) {
+        return paths;
+    }
+    for (const char* key : {"filepath", "search_paths"}) {
+        auto it = arguments.find(key);
+        if (it == arguments.end()) {
+            continue;
+        }
+        if (it->is_string()) {
+            paths.emplace_back(it->get<std::string>());
+        } else if (it->is_array()) {
+            for (const auto& path : *it) {
+                if (path.is_string()) {
+                    paths.emplace_back(path.get<std::string>());
+                }
+            }
+        }
+    }
+    return paths;
+}
+
+} // namespace
+
 MCPServer::MCPServer(std::unique_ptr<ITransport> transport)
-    : transport_(std::move(transport)) {
+    : transport_(std::move(transport))
+    , active_requests_(Metrics::gauge("ts_mcp_requests_active", "Requests being handled"))
+    , queued_requests_(Metrics::gauge("ts_mcp_requests_queued",
+                                      "Requests waiting for a dispatcher (0 while dispatch is synchronous)")) {
     if (!transport_) {
         throw std::invalid_argument("Transport cannot be null");
     }
@@ -22,9 +85,27 @@ void MCPServer::register_tool(const ToolInfo& info, ToolHandler handler) {
 
     tools_[info.name] = info;
     handlers_[info.name] = std::move(handler);
+    MetricLabels labels = {{"tool", info.name}};
+    tool_metrics_.insert_or_assign(info.name, ToolMetrics{
+        Metrics::counter("ts_mcp_tool_calls_total", "Tool calls", labels),
+        Metrics::counter("ts_mcp_tool_errors_total", "Tool calls that failed", labels),
+        Metrics::histogram("ts_mcp_tool_latency_seconds", "Tool execution time", labels)
+    });
     spdlog::info("Registered tool: {}", info.name);
 }
 
+void MCPServer::set_slow_request_log(std::unique_ptr<SlowRequestLog> log) {
+    slow_log_ = std::move(log);
+}
+
+void MCPServer::set_warm_up(std::shared_ptr<WarmUp> warm_up) {
+    warm_up_ = std::move(warm_up);
+}
+
+void MCPServer::set_prefetcher(std::shared_ptr<Prefetcher> prefetcher) {
+    prefetcher_ = std::move(prefetcher);
+}
+
 void MCPServer::run() {
     running_ = true;
     spdlog::info("MCPServer starting main loop");
@@ -39,7 +120,17 @@ void MCPServer::run() {
                 break;
             }
 
-            json response = handle_request(request);
+            active_requests_.increment();
+            json response;
+            try {
+                WarmUp::Yield warm_up_yield(warm_up_.get());
+                Prefetcher::Yield prefetch_yield(prefetcher_.get());
+                response = handle_request(request);
+            } catch (...) {
+                active_requests_.decrement();
+                throw;
+            }
+            active_requests_.decrement();
 
             // Only send response if it's not empty (notifications return empty)
             if (!response.empty() && !response.is_null()) {
@@ -76,6 +167,11 @@ json MCPServer::handle_request(const json& request) {
 
     json id = request.value("id", json());
 
+    if (!request.contains("method") && id == ROOTS_REQUEST_ID) {
+        handle_roots_response(request);
+        return json();  // Responses get no response
+    }
+
     if (!request.contains("method")) {
         return create_error_response(id, -32600, "Invalid Request: missing method field");
     }
@@ -83,7 +179,10 @@ json MCPServer::handle_request(const json& request) {
     std::string method = request["method"];
     json params = request.value("params", json::object());
 
-    spdlog::debug("Handling request: method={}, id={}", method, id.dump());
+    if (spdlog::should_log(spdlog::level::debug)) {
+        spdlog::debug("Handling request: method={}, id={}", method, id.dump());
+    }
+    TraceSpan span("request", method);
 
     try {
         if (method == "initialize") {
@@ -144,7 +243,10 @@ json MCPServer::handle_tools_call(const json& params) {
     std::string tool_name = params["name"];
     json arguments = params.value("arguments", json::object());
 
-    spdlog::debug("Calling tool: {} with args: {}", tool_name, arguments.dump());
+    // Serializing the arguments costs more than the call of a small tool
+    if (spdlog::should_log(spdlog::level::debug)) {
+        spdlog::debug("Calling tool: {} with args: {}", tool_name, arguments.dump());
+    }
 
     auto handler_it = handlers_.find(tool_name);
     if (handler_it == handlers_.end()) {
@@ -152,13 +254,64 @@ json MCPServer::handle_tools_call(const json& params) {
     }
 
     // Execute tool handler
-    json result = handler_it->second(arguments);
+    const auto& metrics = tool_metrics_.at(tool_name);
+    metrics.calls.add();
+
+    auto paths = warm_up_ || prefetcher_ ? argument_paths(arguments) : std::vector<std::filesystem::path>{};
+    if (warm_up_) {
+        for (const auto& path : paths) {
+            warm_up_->touch(path);
+        }
+    }
+
+    // Per-file warnings of the call are logged once, counted, when it returns
+    WarningSummary warnings(tool_name);
+
+    // Phase breakdown is only collected when slow calls are logged
+    RequestProfile profile;
+    RequestProfile::Scope profile_scope(slow_log_ ? &profile : nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    };
+
+    json result;
+    try {
+        TraceSpan tool_span("tool", tool_name);
+        result = handler_it->second(arguments);
+    } catch (const std::exception& e) {
+        auto duration = elapsed();
+        metrics.latency.record(static_cast<uint64_t>(duration.count()));
+        metrics.errors.add();
+        if (slow_log_) {
+            slow_log_->record(tool_name, arguments, duration, profile, 0, true);
+        }
+        throw;
+    }
+    metrics.latency.record(static_cast<uint64_t>(elapsed().count()));
+    bool failed = result.is_object() && result.contains("error");
+    if (failed) {
+        metrics.errors.add();
+    } else if (prefetcher_) {
+        prefetcher_->request_done(paths);
+    }
+
+    std::string text;
+    {
+        TraceSpan serialize_span("serialize_result");
+        text = result.dump();
+    }
+
+    if (slow_log_) {
+        slow_log_->record(tool_name, arguments, elapsed(), profile, text.size(), failed);
+    }
 
     return {
         {"content", json::array({
             {
                 {"type", "text"},
-                {"text", result.dump()}
+                {"text", std::move(text)}
             }
         })}
     };
@@ -173,6 +326,8 @@ json MCPServer::handle_initialize(const json& params) {
         std::string client_version = params["clientInfo"].value("version", "unknown");
         spdlog::info("Client: {} version {}", client_name, client_version);
     }
+    client_lists_roots_ = params.contains("capabilities") && params["capabilities"].is_object() &&
+                          params["capabilities"].contains("roots");
 
     // Return server capabilities
     return {
@@ -189,9 +344,40 @@ json MCPServer::handle_initialize(const json& params) {
 
 void MCPServer::handle_initialized_notification(const json& params) {
     spdlog::info("Client sent initialized notification, server is ready");
-    // Nothing to do for notifications - they don't expect responses
+    if (!warm_up_ || warm_up_->started()) {
+        return;
+    }
+    if (client_lists_roots_) {
+        // The warm-up starts when the roots arrive (handle_roots_response)
+        transport_->write_message({
+            {"jsonrpc", "2.0"},
+            {"id", ROOTS_REQUEST_ID},
+            {"method", "roots/list"}
+        });
+    } else {
+        warm_up_->start();
+    }
 }
 
+void MCPServer::handle_roots_response(const json& response) {
+    if (!warm_up_) {
+        return;
+    }
+    std::vector<std::filesystem::path> roots;
+    if (response.contains("result") && response["result"].contains("roots")) {
+        for (const auto& root : response["result"]["roots"]) {
+            auto path = path_from_uri(root.value("uri", ""));
+            if (!path.empty()) {
+                roots.push_back(std::move(path));
+            }
+        }
+    } else {
+        spdlog::warn("Client did not list its roots, warming the default workspace");
+    }
+    warm_up_->start(roots);
+}
+
+
 json MCPServer::create_error_response(const json& id, int code, const std::string& message) {
     return {
         {"jsonrpc", "2.0"},
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "ITransport.hpp"
+#include "SlowRequestLog.hpp"
+#include "core/Metrics.hpp"
+#include "core/Prefetcher.hpp"
+#include "core/WarmUp.hpp"
 #include <functional>
 #include <map>
 #include <memory>
@@ -33,6 +37,15 @@ using ToolHandler = std::function<json(const json& args)>;
  *
  * Handles tool registration and request routing.
  * Supports methods: tools/list, tools/call
+ *
+ * Records per-tool call and error counts and latency histograms plus
+ * active and queued request gauges in Metrics. A call counts as an error
+ * if the handler throws or returns an object with an "error" field.
+ *
+ * With a WarmUp set, the workspace is warmed once the client is
+ * initialized: on the roots the client lists (roots/list, if it declares
+ * the roots capability), else on the warm-up's default roots. Every request pauses it, and paths
+ * named in tool arguments move their directories to its front.
  */
 class MCPServer {
 public:
@@ -49,6 +62,27 @@ public:
      */
     void register_tool(const ToolInfo& info, ToolHandler handler);
 
+    /**
+     * @brief Log tool calls slower than the log's threshold
+     *
+     * While set, each call collects a RequestProfile (phase times, resolved
+     * files, cache hits and parses); below the threshold it is discarded.
+     * @param log Slow request log, or nullptr to disable
+     */
+    void set_slow_request_log(std::unique_ptr<SlowRequestLog> log);
+
+    /**
+     * @brief Warm the workspace in the background after initialization
+     * @param warm_up Warm-up to start, or nullptr to disable
+     */
+    void set_warm_up(std::shared_ptr<WarmUp> warm_up);
+
+    /**
+     * @brief Prefetch the neighborhood of the files each tool call named
+     * @param prefetcher Prefetcher fed after successful calls, or nullptr to disable
+     */
+    void set_prefetcher(std::shared_ptr<Prefetcher> prefetcher);
+
     /**
      * @brief Start server main loop
      *
@@ -96,6 +130,13 @@ private:
      */
     void handle_initialized_notification(const json& params);
 
+    /**
+     * @brief Handle the client's response to our roots/list request
+     * @param response JSON-RPC response (result with roots, or error)
+     */
+    void handle_roots_response(const json& response);
+
+
     /**
      * @brief Create JSON-RPC error response
      * @param id Request ID (or null)
@@ -105,9 +146,25 @@ private:
      */
     json create_error_response(const json& id, int code, const std::string& message);
 
+    /**
+     * @brief Metrics of one registered tool
+     */
+    struct ToolMetrics {
+        Counter calls;
+        Counter errors;
+        Histogram latency;
+    };
+
     std::unique_ptr<ITransport> transport_;
     std::map<std::string, ToolInfo> tools_;
     std::map<std::string, ToolHandler> handlers_;
+    std::map<std::string, ToolMetrics> tool_metrics_;
+    Gauge active_requests_;
+    Gauge queued_requests_;
+    std::unique_ptr<SlowRequestLog> slow_log_;
+    std::shared_ptr<WarmUp> warm_up_;
+    std::shared_ptr<Prefetcher> prefetcher_;
+    bool client_lists_roots_{false};
     std::atomic<bool> running_{false};
     bool initialized_{false};
 };
@@ -0,0 +1,146 @@
+#include "ProcessTransport.hpp"
+#include <spdlog/spdlog.h>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ts_mcp {
+
+ProcessTransport::ProcessTransport(const std::vector<std::string>& argv) {
+    if (argv.empty()) {
+        throw std::runtime_error("No server command given");
+    }
+
+    int in_pipe[2];   // Parent writes, child reads (stdin)
+    int out_pipe[2];  // Child writes (stdout), parent reads
+    if (::pipe2(in_pipe, O_CLOEXEC) < 0) {
+        throw std::runtime_error(std::string("pipe failed: ") + std::strerror(errno));
+    }
+    if (::pipe2(out_pipe, O_CLOEXEC) < 0) {
+        ::close(in_pipe[0]);
+        ::close(in_pipe[1]);
+        throw std::runtime_error(std::string("pipe failed: ") + std::strerror(errno));
+    }
+
+    std::vector<char*> args;
+    for (const auto& arg : argv) {
+        args.push_back(const_cast<char*>(arg.c_str()));
+    }
+    args.push_back(nullptr);
+
+    pid_ = ::fork();
+    if (pid_ < 0) {
+        int error = errno;
+        for (int fd : {in_pipe[0], in_pipe[1], out_pipe[0], out_pipe[1]}) {
+            ::close(fd);
+        }
+        throw std::runtime_error(std::string("fork failed: ") + std::strerror(error));
+    }
+
+    if (pid_ == 0) {
+        // Child: dup2 clears O_CLOEXEC on the new descriptors
+        ::dup2(in_pipe[0], STDIN_FILENO);
+        ::dup2(out_pipe[1], STDOUT_FILENO);
+        ::execvp(args[0], args.data());
+        std::fprintf(stderr, "Cannot execute %s: %s\n", args[0], std::strerror(errno));
+        ::_exit(127);
+    }
+
+    ::close(in_pipe[0]);
+    ::close(out_pipe[1]);
+    to_child_ = in_pipe[1];
+    from_child_ = out_pipe[0];
+
+    // A server that exits early must not kill us with SIGPIPE
+    std::signal(SIGPIPE, SIG_IGN);
+    spdlog::debug("Started server process {} ({})", pid_, argv[0]);
+}
+
+ProcessTransport::~ProcessTransport() {
+    close();
+}
+
+json ProcessTransport::read_message() {
+    while (true) {
+        auto newline = buffer_.find('\n');
+        if (newline != std::string::npos) {
+            std::string line = buffer_.substr(0, newline);
+            buffer_.erase(0, newline + 1);
+            if (line.empty()) {
+                continue;
+            }
+            try {
+                return json::parse(line);
+            } catch (const json::parse_error&) {
+                // Servers logging to stdout interleave log lines with responses
+                spdlog::debug("Skipping non-JSON server output: {}", line);
+                continue;
+            }
+        }
+
+        if (eof_ || from_child_ < 0) {
+            return json();
+        }
+
+        char chunk[65536];
+        ssize_t n = ::read(from_child_, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            eof_ = true;
+            continue;
+        }
+        buffer_.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+void ProcessTransport::write_message(const json& message) {
+    if (to_child_ < 0) {
+        throw std::runtime_error("Server stdin is closed");
+    }
+
+    std::string line = message.dump(-1, ' ', false, json::error_handler_t::replace) + "\n";
+    size_t written = 0;
+    while (written < line.size()) {
+        ssize_t n = ::write(to_child_, line.data() + written, line.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Write to server failed: ") + std::strerror(errno));
+        }
+        written += static_cast<size_t>(n);
+    }
+}
+
+bool ProcessTransport::is_open() const {
+    return to_child_ >= 0 && !eof_;
+}
+
+int ProcessTransport::close() {
+    if (to_child_ >= 0) {
+        ::close(to_child_);
+        to_child_ = -1;
+    }
+    if (from_child_ >= 0) {
+        ::close(from_child_);
+        from_child_ = -1;
+    }
+    if (pid_ <= 0) {
+        return -1;
+    }
+
+    int status = 0;
+    while (::waitpid(pid_, &status, 0) < 0 && errno == EINTR) {
+    }
+    pid_ = -1;
+    return status;
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ITransport.hpp"
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Transport to an MCP server running as a child process
+ *
+ * Starts the server with its stdin and stdout connected to pipes and
+ * exchanges newline-delimited JSON over them, the same framing as
+ * StdioTransport. The child's stderr is inherited. POSIX only.
+ */
+class ProcessTransport : public ITransport {
+public:
+    /**
+     * @brief Start the server process
+     * @param argv Program (looked up in PATH) and its arguments
+     * @throws std::runtime_error if the process cannot be started
+     */
+    explicit ProcessTransport(const std::vector<std::string>& argv);
+
+    /**
+     * @brief Close the server's stdin and wait for it to exit
+     */
+    ~ProcessTransport() override;
+
+    ProcessTransport(const ProcessTransport&) = delete;
+    ProcessTransport& operator=(const ProcessTransport&) = delete;
+
+    json read_message() override;
+    void write_message(const json& message) override;
+    bool is_open() const override;
+
+    /**
+     * @brief Close the server's stdin and wait for it to exit
+     * @return Exit status as returned by waitpid, or -1
+     */
+    int close();
+
+private:
+    pid_t pid_ = -1;
+    int to_child_ = -1;
+    int from_child_ = -1;
+    std::string buffer_;    // Bytes read past the last returned line
+    bool eof_ = false;
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,46 @@
+#include "RecordingTransport.hpp"
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace ts_mcp {
+
+RecordingTransport::RecordingTransport(std::unique_ptr<ITransport> inner, const std::filesystem::path& file)
+    : inner_(std::move(inner)), out_(file, std::ios::trunc), start_(std::chrono::steady_clock::now()) {
+    if (!inner_) {
+        throw std::invalid_argument("Transport cannot be null");
+    }
+    if (!out_) {
+        throw std::runtime_error("Cannot open capture file: " + file.string());
+    }
+    spdlog::info("Recording session to {}", file.string());
+}
+
+json RecordingTransport::read_message() {
+    json message = inner_->read_message();
+    if (!message.empty() && !message.is_null()) {
+        record("in", message);
+    }
+    return message;
+}
+
+void RecordingTransport::write_message(const json& message) {
+    record("out", message);
+    inner_->write_message(message);
+}
+
+bool RecordingTransport::is_open() const {
+    return inner_->is_open();
+}
+
+void RecordingTransport::record(const char* direction, const json& message) {
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_);
+    json entry = {
+        {"t", elapsed.count()},
+        {"dir", direction},
+        {"msg", message}
+    };
+    out_ << entry.dump(-1, ' ', false, json::error_handler_t::replace) << '\n';
+    out_.flush();
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ITransport.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace ts_mcp {
+
+/**
+ * @brief Transport decorator that captures a session to a JSON Lines file
+ *
+ * Every message read from or written to the wrapped transport is appended
+ * as {"t": <ms since start>, "dir": "in"|"out", "msg": <message>} and
+ * flushed, so a capture survives a crash. SessionReplayer plays captures
+ * back against a fresh server.
+ */
+class RecordingTransport : public ITransport {
+public:
+    /**
+     * @brief Wrap a transport
+     * @param inner Transport that does the I/O
+     * @param file Capture file (truncated)
+     * @throws std::invalid_argument if inner is null
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    RecordingTransport(std::unique_ptr<ITransport> inner, const std::filesystem::path& file);
+
+    json read_message() override;
+    void write_message(const json& message) override;
+    bool is_open() const override;
+
+private:
+    void record(const char* direction, const json& message);
+
+    std::unique_ptr<ITransport> inner_;
+    std::ofstream out_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,199 @@
+#include "SessionReplayer.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace ts_mcp {
+
+namespace {
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto rank = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+bool expects_response(const json& message) {
+    return message.is_object() && message.contains("method") && message.contains("id") &&
+           !message["id"].is_null();
+}
+
+} // namespace
+
+json ReplayReport::to_json() const {
+    std::vector<double> sorted = latencies_ms;
+    std::sort(sorted.begin(), sorted.end());
+    double total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+
+    return {
+        {"messages_sent", messages_sent},
+        {"requests", requests},
+        {"responses", responses},
+        {"missing_responses", missing_responses},
+        {"elapsed_ms", elapsed_ms},
+        {"throughput_rps", elapsed_ms > 0 ? static_cast<double>(responses) * 1000.0 / elapsed_ms : 0.0},
+        {"latency_ms", {
+            {"mean", sorted.empty() ? 0.0 : total / static_cast<double>(sorted.size())},
+            {"p50", percentile(sorted, 0.50)},
+            {"p90", percentile(sorted, 0.90)},
+            {"p99", percentile(sorted, 0.99)},
+            {"max", sorted.empty() ? 0.0 : sorted.back()}
+        }},
+        {"compared", compared},
+        {"mismatches", mismatches},
+        {"diffs", diffs}
+    };
+}
+
+SessionReplayer::SessionReplayer(std::vector<CapturedMessage> capture)
+    : capture_(std::move(capture)) {
+}
+
+std::vector<CapturedMessage> SessionReplayer::load(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    if (!in) {
+        throw std::runtime_error("Cannot open capture: " + file.string());
+    }
+
+    std::vector<CapturedMessage> capture;
+    size_t line_number = 0;
+    for (std::string line; std::getline(in, line);) {
+        line_number++;
+        if (line.empty()) {
+            continue;
+        }
+        try {
+            json entry = json::parse(line);
+            CapturedMessage message;
+            message.t_ms = entry.at("t").get<double>();
+            message.incoming = entry.at("dir").get<std::string>() == "in";
+            message.message = entry.at("msg");
+            capture.push_back(std::move(message));
+        } catch (const json::exception& e) {
+            throw std::runtime_error("Malformed capture line " + std::to_string(line_number) +
+                                     " in " + file.string() + ": " + e.what());
+        }
+    }
+    return capture;
+}
+
+json SessionReplayer::normalize(const json& response) {
+    json result = response;
+    if (!result.contains("result") || !result["result"].contains("content") ||
+        !result["result"]["content"].is_array()) {
+        return result;
+    }
+
+    for (auto& item : result["result"]["content"]) {
+        if (item.contains("text") && item["text"].is_string()) {
+            json parsed = json::parse(item["text"].get<std::string>(), nullptr, false);
+            if (!parsed.is_discarded()) {
+                item["text"] = std::move(parsed);
+            }
+        }
+    }
+    return result;
+}
+
+ReplayReport SessionReplayer::run(ITransport& server, const ReplayOptions& options) const {
+    // Recorded responses by id, in order (ids may be reused within a session)
+    std::map<std::string, std::deque<const json*>> recorded;
+    for (const auto& captured : capture_) {
+        if (!captured.incoming && captured.message.contains("id")) {
+            recorded[captured.message["id"].dump()].push_back(&captured.message);
+        }
+    }
+
+    ReplayReport report;
+    double speed = options.speed > 0 ? options.speed : 1.0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const auto& captured : capture_) {
+        if (!captured.incoming) {
+            continue;
+        }
+
+        if (!options.max_speed) {
+            auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::milli>(captured.t_ms / speed));
+            std::this_thread::sleep_until(due);
+        }
+
+        const json& request = captured.message;
+        auto sent = std::chrono::steady_clock::now();
+        try {
+            server.write_message(request);
+        } catch (const std::exception& e) {
+            spdlog::error("Server stopped accepting messages: {}", e.what());
+            break;
+        }
+        report.messages_sent++;
+
+        if (!expects_response(request)) {
+            continue;
+        }
+        report.requests++;
+
+        std::string id = request["id"].dump();
+        json response;
+        while (true) {
+            response = server.read_message();
+            if (response.empty() || response.is_null()) {
+                break;
+            }
+            if (response.contains("id") && response["id"].dump() == id) {
+                break;
+            }
+            if (spdlog::should_log(spdlog::level::debug)) {
+                spdlog::debug("Skipping unrelated server message: {}", response.dump());
+            }
+        }
+        if (response.empty() || response.is_null()) {
+            report.missing_responses++;
+            spdlog::error("Server closed before answering request {}", id);
+            break;
+        }
+
+        report.responses++;
+        report.latencies_ms.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sent).count());
+
+        auto expected_it = recorded.find(id);
+        if (expected_it == recorded.end() || expected_it->second.empty()) {
+            continue;
+        }
+        const json& expected = *expected_it->second.front();
+        expected_it->second.pop_front();
+
+        report.compared++;
+        json patch = json::diff(normalize(expected), normalize(response));
+        if (patch.empty()) {
+            continue;
+        }
+        report.mismatches++;
+        if (report.diffs.size() < options.max_diffs) {
+            json diff = {
+                {"id", request["id"]},
+                {"method", request.value("method", "")},
+                {"patch", patch}
+            };
+            if (request.contains("params") && request["params"].contains("name")) {
+                diff["tool"] = request["params"]["name"];
+            }
+            report.diffs.push_back(std::move(diff));
+        }
+    }
+
+    report.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+} // namespace ts_mcp
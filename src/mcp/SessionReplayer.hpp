@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ITransport.hpp"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief One line of a RecordingTransport capture
+ */
+struct CapturedMessage {
+    double t_ms = 0;        // Milliseconds since recording started
+    bool incoming = true;   // Client -> server
+    json message;
+};
+
+/**
+ * @brief Replay settings
+ */
+struct ReplayOptions {
+    bool max_speed = false;  // Send each request as soon as the previous response arrived
+    double speed = 1.0;      // Pace multiplier when not at max speed (2 = twice as fast)
+    size_t max_diffs = 10;   // Mismatching responses reported in full
+};
+
+/**
+ * @brief Outcome of a replay
+ */
+struct ReplayReport {
+    size_t messages_sent = 0;
+    size_t requests = 0;           // Sent messages expecting a response
+    size_t responses = 0;
+    size_t missing_responses = 0;  // Server closed before answering
+    size_t compared = 0;           // Responses with a recorded counterpart
+    size_t mismatches = 0;
+    double elapsed_ms = 0;
+    std::vector<double> latencies_ms;
+    json diffs = json::array();    // {"id", "method", "tool", "patch"} for the first mismatches
+
+    json to_json() const;
+};
+
+/**
+ * @brief Plays a captured JSON-RPC session against a server
+ *
+ * Client messages are sent at their recorded pace (scaled by speed) or
+ * back to back. The server handles requests one at a time, so each
+ * request waits for its response before the next is sent; at original
+ * pace a slow response delays the rest of the schedule.
+ *
+ * Responses are compared with the recorded ones after normalization:
+ * tool results embedded as JSON text are parsed, so diffs point at the
+ * field that changed instead of the whole text.
+ */
+class SessionReplayer {
+public:
+    explicit SessionReplayer(std::vector<CapturedMessage> capture);
+
+    /**
+     * @brief Read a capture file
+     * @throws std::runtime_error if the file cannot be read or a line is malformed
+     */
+    static std::vector<CapturedMessage> load(const std::filesystem::path& file);
+
+    /**
+     * @brief Replay against a server connected through transport
+     */
+    ReplayReport run(ITransport& server, const ReplayOptions& options) const;
+
+    /**
+     * @brief Response with JSON text content parsed (for comparison)
+     */
+    static json normalize(const json& response);
+
+private:
+    std::vector<CapturedMessage> capture_;
+};
+
+} // namespace ts_mcp
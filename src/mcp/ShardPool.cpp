@@ -0,0 +1,144 @@
+#include "ShardPool.hpp"
+#include "core/Trace.hpp"
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace ts_mcp {
+
+ShardPool::ShardPool(std::vector<std::string> command, unsigned workers)
+    : command_(std::move(command)), workers_(workers) {
+    if (workers == 0) {
+        throw std::invalid_argument("ShardPool needs at least one worker");
+    }
+    for (auto& worker : workers_) {
+        start_worker(worker);
+    }
+    spdlog::info("Started {} shard workers", workers_.size());
+}
+
+ShardPool::~ShardPool() = default;
+
+void ShardPool::start_worker(Worker& worker) {
+    worker.transport = std::make_unique<ProcessTransport>(command_);
+    worker.next_id = 1;
+}
+
+void ShardPool::gather(const std::string& tool, const json& arguments, ShardContext& context) {
+    TraceSpan span("shard_gather", tool);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto shards = static_cast<uint32_t>(workers_.size());
+
+    // Send to all workers first so they run concurrently
+    std::vector<uint64_t> ids(workers_.size(), 0);
+    for (uint32_t shard = 0; shard < shards; ++shard) {
+        auto& worker = workers_[shard];
+        try {
+            if (!worker.transport || !worker.transport->is_open()) {
+                worker.restarts++;
+                spdlog::warn("Restarting shard worker {} (restart {})", shard, worker.restarts);
+                start_worker(worker);
+            }
+            ids[shard] = worker.next_id++;
+            worker.transport->write_message({
+                {"jsonrpc", "2.0"},
+                {"id", ids[shard]},
+                {"method", "tools/call"},
+                {"params", {
+                    {"name", WORKER_TOOL},
+                    {"arguments", {{"tool", tool}, {"arguments", arguments}, {"shard", shard}, {"shards", shards}}}
+                }}
+            });
+        } catch (const std::exception& e) {
+            spdlog::warn("Shard worker {} unavailable: {}", shard, e.what());
+            worker.transport.reset();
+            ids[shard] = 0;
+        }
+    }
+
+    for (uint32_t shard = 0; shard < shards; ++shard) {
+        auto& worker = workers_[shard];
+        if (ids[shard] == 0) {
+            context.mark_failed(shard);
+            continue;
+        }
+
+        try {
+            json response;
+            do {
+                response = worker.transport->read_message();
+            } while (!response.is_null() && response.value("id", json()) != ids[shard]);
+
+            if (response.is_null()) {
+                throw std::runtime_error("worker exited");
+            }
+            if (response.contains("error")) {
+                throw std::runtime_error(response["error"].value("message", "error response"));
+            }
+            json reply = json::parse(response.at("result").at("content").at(0).at("text").get<std::string>());
+            if (reply.contains("error")) {
+                throw std::runtime_error(reply["error"].get<std::string>());
+            }
+            context.add_facts(reply.at("facts"));
+        } catch (const std::exception& e) {
+            spdlog::warn("Shard worker {} failed on {}: {}", shard, tool, e.what());
+            context.mark_failed(shard);
+            if (!worker.transport->is_open()) {
+                worker.transport.reset();
+            }
+        }
+    }
+    if (Tracer::enabled()) {
+        span.set_detail(tool + ": " + std::to_string(context.fact_count()) + " facts");
+    }
+}
+
+ToolHandler ShardPool::sharded(std::shared_ptr<ShardPool> pool, std::string tool, ToolHandler handler) {
+    return [pool = std::move(pool), tool = std::move(tool), handler = std::move(handler)](const json& args) {
+        ShardContext context = pool->coordinator_context();
+        pool->gather(tool, args, context);
+        ShardContext::Scope scope(&context);
+        return handler(args);
+    };
+}
+
+ToolInfo ShardPool::worker_tool_info() {
+    ToolInfo info;
+    info.name = WORKER_TOOL;
+    info.description = "Internal: run a tool on one shard of the files and return the per-file facts "
+                       "it derived (used by a --workers coordinator)";
+    info.input_schema = {
+        {"type", "object"},
+        {"properties", {
+            {"tool", {{"type", "string"}}},
+            {"arguments", {{"type", "object"}}},
+            {"shard", {{"type", "integer"}}},
+            {"shards", {{"type", "integer"}}}
+        }},
+        {"required", json::array({"tool", "arguments", "shard", "shards"})}
+    };
+    return info;
+}
+
+ToolHandler ShardPool::worker_handler(std::map<std::string, ToolHandler> tools) {
+    return [tools = std::move(tools)](const json& args) -> json {
+        std::string tool = args.at("tool").get<std::string>();
+        auto it = tools.find(tool);
+        if (it == tools.end()) {
+            return {{"error", "Tool cannot be sharded: " + tool}};
+        }
+
+        ShardContext context = ShardContext::worker(args.at("shard").get<uint32_t>(),
+                                                    args.at("shards").get<uint32_t>());
+        ShardContext::Scope scope(&context);
+        json result = it->second(args.at("arguments"));
+
+        // The tool's own result is rebuilt by the coordinator from the facts
+        json reply = {{"facts", context.take_captured()}};
+        if (result.is_object() && result.contains("success")) {
+            reply["success"] = result["success"];
+        }
+        return reply;
+    };
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "MCPServer.hpp"
+#include "ProcessTransport.hpp"
+#include "core/ShardContext.hpp"
+#include <nlohmann/json.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ts_mcp {
+
+/**
+ * @brief Worker processes that a coordinator splits repo-wide tool calls across
+ *
+ * Each worker is a server started with --shard-worker, so it has its own
+ * tree-sitter heap and parse cache, and a crash while parsing some huge
+ * generated file takes down only that worker. A call is sent to all
+ * workers at once through the internal shard_facts tool; each runs the
+ * tool on its partition of the files and returns the facts it derived,
+ * which fill the coordinator's ShardContext (see there).
+ *
+ * A worker that exits or answers garbage fails its shard for that call
+ * and is restarted on the next one.
+ */
+class ShardPool {
+public:
+    static constexpr const char* WORKER_TOOL = "shard_facts";
+
+    /**
+     * @brief Start the workers
+     * @param command Worker command line (program and arguments)
+     * @param workers Number of worker processes
+     * @throws std::runtime_error if a worker cannot be started
+     */
+    ShardPool(std::vector<std::string> command, unsigned workers);
+    ~ShardPool();
+
+    ShardPool(const ShardPool&) = delete;
+    ShardPool& operator=(const ShardPool&) = delete;
+
+    /**
+     * @brief Run a tool on every worker and collect the facts into context
+     */
+    void gather(const std::string& tool, const json& arguments, ShardContext& context);
+
+    /**
+     * @brief Coordinator context for a call, filled by gather()
+     */
+    ShardContext coordinator_context() const {
+        return ShardContext::coordinator(static_cast<uint32_t>(workers_.size()));
+    }
+
+    /**
+     * @brief A handler that gathers from the workers, then runs the tool locally
+     */
+    static ToolHandler sharded(std::shared_ptr<ShardPool> pool, std::string tool, ToolHandler handler);
+
+    size_t size() const { return workers_.size(); }
+
+    /**
+     * @brief Worker side: the shard_facts tool over the given tool handlers
+     */
+    static ToolInfo worker_tool_info();
+    static ToolHandler worker_handler(std::map<std::string, ToolHandler> tools);
+
+private:
+    struct Worker {
+        std::unique_ptr<ProcessTransport> transport;
+        uint64_t next_id = 1;
+        uint64_t restarts = 0;
+    };
+
+    void start_worker(Worker& worker);
+
+    std::vector<std::string> command_;
+    std::vector<Worker> workers_;
+    std::mutex mutex_;  // One gather at a time: workers answer in order
+};
+
+} // namespace ts_mcp
@@ -0,0 +1,90 @@
+#include "SlowRequestLog.hpp"
+#include <spdlog/spdlog.h>
+#include <cstdio>
+#include <ctime>
+#include <stdexcept>
+
+namespace ts_mcp {
+
+namespace {
+
+double to_ms(uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+std::string utc_timestamp() {
+    auto now = std::chrono::system_clock::now();
+    std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+
+    std::tm tm{};
+    gmtime_r(&seconds, &tm);
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                  tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                  tm.tm_hour, tm.tm_min, tm.tm_sec, static_cast<int>(millis));
+    return buffer;
+}
+
+} // namespace
+
+SlowRequestLog::SlowRequestLog(const std::filesystem::path& file, std::chrono::milliseconds threshold)
+    : threshold_(threshold), out_(file, std::ios::app) {
+    if (!out_) {
+        throw std::runtime_error("Cannot open slow request log: " + file.string());
+    }
+    spdlog::info("Logging tool calls slower than {}ms to {}", threshold.count(), file.string());
+}
+
+json SlowRequestLog::make_entry(const std::string& tool,
+                                const json& arguments,
+                                std::chrono::nanoseconds duration,
+                                const RequestProfile& profile,
+                                size_t result_bytes,
+                                bool failed) {
+    json phases = json::object();
+    for (const auto& phase : profile.phases()) {
+        phases[phase.name] = {
+            {"count", phase.count},
+            {"total_ms", to_ms(phase.total_ns)}
+        };
+    }
+
+    return {
+        {"tool", tool},
+        {"duration_ms", to_ms(static_cast<uint64_t>(duration.count()))},
+        {"failed", failed},
+        {"arguments", arguments},
+        {"resolved_files", profile.resolved_files()},
+        {"cache_hits", profile.cache_hits()},
+        {"parses", profile.parses()},
+        {"result_bytes", result_bytes},
+        {"phases", phases}
+    };
+}
+
+bool SlowRequestLog::record(const std::string& tool,
+                            const json& arguments,
+                            std::chrono::nanoseconds duration,
+                            const RequestProfile& profile,
+                            size_t result_bytes,
+                            bool failed) {
+    if (duration < threshold_) {
+        return false;
+    }
+
+    json entry = {{"timestamp", utc_timestamp()}};
+    entry.update(make_entry(tool, arguments, duration, profile, result_bytes, failed));
+    std::string line = entry.dump(-1, ' ', false, json::error_handler_t::replace);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_ << line << '\n';
+    out_.flush();
+
+    spdlog::warn("Slow tool call: {} took {:.1f}ms ({} files, {} parses)",
+                 tool, to_ms(static_cast<uint64_t>(duration.count())),
+                 profile.resolved_files(), profile.parses());
+    return true;
+}
+
+} // namespace ts_mcp
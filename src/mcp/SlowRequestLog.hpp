@@ -0,0 +1,61 @@
+#pragma once
+
+#include "core/RequestProfile.hpp"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace ts_mcp {
+
+using json = nlohmann::json;
+
+/**
+ * @brief Append-only JSON Lines log of tool calls slower than a threshold
+ *
+ * Each entry holds the tool name, full arguments, duration, resolved file
+ * count, cache hits vs parses, serialized result size and inclusive time
+ * per phase, enough to replay the call and see where its time went.
+ */
+class SlowRequestLog {
+public:
+    /**
+     * @brief Open (append to) the log file
+     * @param file Log file path
+     * @param threshold Calls taking at least this long are logged
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    SlowRequestLog(const std::filesystem::path& file, std::chrono::milliseconds threshold);
+
+    std::chrono::milliseconds threshold() const { return threshold_; }
+
+    /**
+     * @brief Check a finished call against the threshold, logging it if slow
+     * @return true if an entry was written
+     */
+    bool record(const std::string& tool,
+                const json& arguments,
+                std::chrono::nanoseconds duration,
+                const RequestProfile& profile,
+                size_t result_bytes,
+                bool failed);
+
+    /**
+     * @brief Entry as written to the log (without the timestamp)
+     */
+    static json make_entry(const std::string& tool,
+                           const json& arguments,
+                           std::chrono::nanoseconds duration,
+                           const RequestProfile& profile,
+                           size_t result_bytes,
+                           bool failed);
+
+private:
+    std::chrono::milliseconds threshold_;
+    std::mutex mutex_;
+    std::ofstream out_;
+};
+
+} // namespace ts_mcp
@@ -1,9 +1,53 @@
 #include "ExecuteQueryTool.hpp"
 #include "core/PathResolver.hpp"
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
 
 namespace ts_mcp {
 
+namespace {
+
+enum class GroupBy { Capture, Text, File, Directory };
+
+std::optional<GroupBy> parse_group_by(const json& value) {
+    static const std::pair<const char*, GroupBy> names[] = {
+        {"count", GroupBy::Capture}, {"text", GroupBy::Text},
+        {"file", GroupBy::File}, {"directory", GroupBy::Directory}
+    };
+    if (value.is_string()) {
+        for (const auto& [name, group_by] : names) {
+            if (value == name) {
+                return group_by;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+struct TextHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+};
+
+// Looked up by string_view: a key is copied only the first time it is seen
+using GroupCounts = std::unordered_map<std::string, size_t, TextHash, std::equal_to<>>;
+
+void add_count(GroupCounts& groups, std::string_view key, size_t count) {
+    auto it = groups.find(key);
+    if (it == groups.end()) {
+        groups.emplace(std::string(key), count);
+    } else {
+        it->second += count;
+    }
+}
+
+} // namespace
+
 ExecuteQueryTool::ExecuteQueryTool(std::shared_ptr<ASTAnalyzer> analyzer)
     : analyzer_(std::move(analyzer)) {
     if (!analyzer_) {
@@ -38,6 +82,21 @@ ToolInfo ExecuteQueryTool::get_info() {
                     {"items", {{"type", "string"}}},
                     {"default", json::array({"*.cpp", "*.hpp", "*.h", "*.cc", "*.cxx"})},
                     {"description", "File patterns to include (glob patterns)"}
+                }},
+                {"aggregate", {
+                    {"type", "string"},
+                    {"enum", json::array({"count", "text", "file", "directory"})},
+                    {"description", "Return capture counts instead of matches: per capture name, "
+                                    "per capture text, per file or per directory"}
+                }},
+                {"capture", {
+                    {"type", "string"},
+                    {"description", "With aggregate: count only this capture (e.g. 'name' for @name)"}
+                }},
+                {"top_k", {
+                    {"type", "integer"},
+                    {"default", 20},
+                    {"description", "With aggregate: groups returned, largest first (0 = all)"}
                 }}
             }},
             {"required", json::array({"filepath", "query"})}
@@ -65,6 +124,25 @@ json ExecuteQueryTool::execute(const json& args) {
     std::vector<std::string> patterns = args.value("file_patterns",
         std::vector<std::string>{"*.cpp", "*.hpp", "*.h", "*.cc", "*.cxx"});
 
+    bool aggregated = args.contains("aggregate");
+    if (aggregated) {
+        if (!parse_group_by(args["aggregate"])) {
+            return {
+                {"error", "aggregate must be one of: count, text, file, directory"}
+            };
+        }
+        if (args.contains("capture") && !args["capture"].is_string()) {
+            return {
+                {"error", "capture must be a string"}
+            };
+        }
+        if (args.contains("top_k") && (!args["top_k"].is_number_integer() || args["top_k"].get<int64_t>() < 0)) {
+            return {
+                {"error", "top_k must be a non-negative integer"}
+            };
+        }
+    }
+
     // Determine filepath type and collect paths
     std::vector<std::string> input_paths;
     if (args["filepath"].is_string()) {
@@ -92,6 +170,10 @@ json ExecuteQueryTool::execute(const json& args) {
     spdlog::debug("ExecuteQueryTool: analyzing {} files", resolved_files.size());
 
     try {
+        if (aggregated) {
+            return aggregate(resolved_files, query, args);
+        }
+
         // For single file - return old format for backward compatibility
         if (resolved_files.size() == 1) {
             return analyzer_->execute_query(resolved_files[0], query);
@@ -108,4 +190,119 @@ json ExecuteQueryTool::execute(const json& args) {
     }
 }
 
+json ExecuteQueryTool::aggregate(const std::vector<std::filesystem::path>& files,
+                                 const std::string& query_string,
+                                 const json& args) {
+    GroupBy group_by = *parse_group_by(args["aggregate"]);
+    std::string capture = args.value("capture", "");
+    if (!capture.empty() && capture.front() == '@') {
+        capture.erase(0, 1);
+    }
+    size_t top_k = args.value("top_k", size_t{20});
+
+    // The query is compiled once per language; capture indexes are per compilation
+    struct Compiled {
+        std::unique_ptr<Query> query;
+        std::vector<std::string> capture_names;
+        std::optional<uint32_t> only_capture;
+    };
+    std::map<Language, Compiled> compiled;
+
+    GroupCounts groups;
+    std::vector<size_t> per_capture;
+    size_t total_captures = 0;
+    json failed = json::array();
+
+    for (const auto& file : files) {
+        auto snapshot = analyzer_->snapshot(file);
+        if (!snapshot) {
+            failed.push_back({{"filepath", file.string()}, {"error", "Failed to parse file"}});
+            continue;
+        }
+
+        auto [it, inserted] = compiled.try_emplace(snapshot->language());
+        Compiled& entry = it->second;
+        if (inserted && (entry.query = query_engine_.compile_query(query_string, snapshot->language()))) {
+            for (uint32_t i = 0; i < entry.query->capture_count(); i++) {
+                entry.capture_names.push_back(entry.query->capture_name(i));
+                if (entry.capture_names.back() == capture) {
+                    entry.only_capture = i;
+                }
+            }
+            if (!capture.empty() && !entry.only_capture) {
+                return {
+                    {"error", "Query has no capture named @" + capture},
+                    {"success", false}
+                };
+            }
+        }
+        if (!entry.query) {
+            failed.push_back({{"filepath", file.string()}, {"error", "Failed to compile query"}});
+            continue;
+        }
+
+        std::string_view source = snapshot->source();
+        per_capture.assign(entry.capture_names.size(), 0);
+        size_t file_captures = 0;
+        query_engine_.for_each_capture(snapshot->tree().root_node(), *entry.query,
+                                       [&](uint32_t capture_index, TSNode node) {
+            if (entry.only_capture && capture_index != *entry.only_capture) {
+                return;
+            }
+            file_captures++;
+            if (group_by == GroupBy::Capture) {
+                per_capture[capture_index]++;
+            } else if (group_by == GroupBy::Text) {
+                uint32_t start = ts_node_start_byte(node);
+                uint32_t end = ts_node_end_byte(node);
+                if (start <= end && end <= source.size()) {
+                    add_count(groups, source.substr(start, end - start), 1);
+                }
+            }
+        });
+        total_captures += file_captures;
+
+        if (group_by == GroupBy::Capture) {
+            for (size_t i = 0; i < per_capture.size(); i++) {
+                if (per_capture[i] > 0) {
+                    add_count(groups, entry.capture_names[i], per_capture[i]);
+                }
+            }
+        } else if (group_by == GroupBy::File && file_captures > 0) {
+            add_count(groups, file.string(), file_captures);
+        } else if (group_by == GroupBy::Directory && file_captures > 0) {
+            add_count(groups, file.parent_path().string(), file_captures);
+        }
+    }
+
+    // Largest first, ties by key so results are stable
+    std::vector<std::pair<std::string_view, size_t>> sorted(groups.begin(), groups.end());
+    size_t returned = top_k == 0 ? sorted.size() : std::min(top_k, sorted.size());
+    auto by_count = [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    std::partial_sort(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(returned), sorted.end(), by_count);
+
+    json result_groups = json::array();
+    for (size_t i = 0; i < returned; i++) {
+        result_groups.push_back({{"key", sorted[i].first}, {"count", sorted[i].second}});
+    }
+
+    json result = {
+        {"success", failed.empty()},
+        {"aggregate", args["aggregate"]},
+        {"total_files", files.size()},
+        {"processed_files", files.size() - failed.size()},
+        {"failed_files", failed.size()},
+        {"total_captures", total_captures},
+        {"distinct", groups.size()},
+        {"truncated", returned < groups.size()},
+        {"groups", result_groups}
+    };
+    if (!failed.empty()) {
+        result["failures"] = failed;
+    }
+    return result;
+}
+
 } // namespace ts_mcp
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "core/ASTAnalyzer.hpp"
+#include "core/QueryEngine.hpp"
 #include "mcp/MCPServer.hpp"
+#include <filesystem>
 #include <memory>
+#include <vector>
 
 namespace ts_mcp {
 
@@ -10,6 +13,12 @@ namespace ts_mcp {
  * @brief MCP tool for executing custom tree-sitter queries
  *
  * Allows executing arbitrary S-expression queries on C++ files.
+ *
+ * With "aggregate" the tool returns counts instead of matches: captures
+ * per capture name ("count"), per capture text ("text"), per file
+ * ("file") or per directory ("directory"), the top_k largest groups
+ * first. Captures are counted while the query cursor iterates; their
+ * text is never copied, so repo-wide statistics stay small.
  */
 class ExecuteQueryTool {
 public:
@@ -33,7 +42,13 @@ public:
     json execute(const json& args);
 
 private:
+    /**
+     * @brief Count the captures of query in files, grouped as args["aggregate"] asks
+     */
+    json aggregate(const std::vector<std::filesystem::path>& files, const std::string& query, const json& args);
+
     std::shared_ptr<ASTAnalyzer> analyzer_;
+    QueryEngine query_engine_;
 };
 
 } // namespace ts_mcp
@@ -1,5 +1,6 @@
 #include "ExtractInterfaceTool.hpp"
 #include "core/PathResolver.hpp"
+#include "core/Trace.hpp"
 #include "core/TreeSitterParser.hpp"
 #include <spdlog/spdlog.h>
 #include <filesystem>
@@ -108,6 +109,15 @@ json ExtractInterfaceTool::execute(const json& args) {
 
     spdlog::debug("ExtractInterfaceTool: processing {} files", resolved.size());
 
+    // Interfaces depend on the content, the language and the options
+    auto extract = [&](const std::filesystem::path& filepath, Language lang) {
+        std::string kind = "interface/" + std::string(LanguageUtils::to_string(lang)) + "/" +
+                           std::to_string(include_private) + std::to_string(include_comments);
+        return analyzer_->cached_facts(filepath, kind, [&] {
+            return extract_from_file(filepath, include_private, include_comments, lang);
+        });
+    };
+
     // Process single file
     if (resolved.size() == 1) {
         const auto& filepath = resolved[0];
@@ -122,7 +132,7 @@ json ExtractInterfaceTool::execute(const json& args) {
         }
 
         try {
-            json interface_data = extract_from_file(filepath, include_private, include_comments, lang);
+            json interface_data = extract(filepath, lang);
 
             // Format output
             if (output_format == "json") {
@@ -181,7 +191,7 @@ json ExtractInterfaceTool::execute(const json& args) {
         }
 
         try {
-            json interface_data = extract_from_file(filepath, include_private, include_comments, lang);
+            json interface_data = extract(filepath, lang);
             json formatted = format_as_json(interface_data, filepath, lang);
             results.push_back(formatted);
             success_count++;
@@ -212,6 +222,8 @@ json ExtractInterfaceTool::extract_from_file(
     bool include_comments,
     Language language
 ) {
+    TraceSpan span("extract_interface_file", filepath);
+
     // Read file
     std::ifstream file(filepath);
     if (!file.is_open()) {
@@ -1,7 +1,9 @@
 #include "tools/FindReferencesTool.hpp"
+#include "core/Trace.hpp"
 #include "core/PathResolver.hpp"
 #include "core/TreeSitterParser.hpp"
 #include "core/Language.hpp"
+#include "core/LexicalScanner.hpp"
 #include <spdlog/spdlog.h>
 #include <fstream>
 #include <sstream>
@@ -108,11 +110,12 @@ json FindReferencesTool::execute(const json& args) {
     spdlog::debug("FindReferencesTool: searching for '{}' in {} files", symbol, resolved.size());
 
     // Search for references in all files
-    std::vector<Reference> all_references;
+    json references_array = json::array();
     int processed_files = 0;
     int failed_files = 0;
 
     for (const auto& filepath : resolved) {
+        TraceSpan file_span("find_references_file", filepath.string());
         Language lang = LanguageUtils::detect_from_extension(filepath);
 
         if (lang == Language::UNKNOWN) {
@@ -121,8 +124,15 @@ json FindReferencesTool::execute(const json& args) {
         }
 
         try {
-            auto refs = find_in_file(filepath.string(), symbol, lang);
-            all_references.insert(all_references.end(), refs.begin(), refs.end());
+            // Per request, but shared with a shard coordinator
+            json refs = analyzer_->cached_facts(filepath, "references/" + symbol, [&] {
+                json file_references = json::array();
+                for (const auto& ref : find_in_file(filepath.string(), symbol, lang)) {
+                    file_references.push_back(reference_to_json(ref));
+                }
+                return file_references;
+            }, false);
+            references_array.insert(references_array.end(), refs.begin(), refs.end());
             processed_files++;
         } catch (const std::exception& e) {
             spdlog::warn("FindReferencesTool: failed to process {}: {}", filepath.string(), e.what());
@@ -133,15 +143,10 @@ json FindReferencesTool::execute(const json& args) {
     // Build result JSON
     json result;
     result["symbol"] = symbol;
-    result["total_references"] = all_references.size();
+    result["total_references"] = references_array.size();
     result["files_searched"] = resolved.size();
     result["files_processed"] = processed_files;
     result["files_failed"] = failed_files;
-
-    json references_array = json::array();
-    for (const auto& ref : all_references) {
-        references_array.push_back(reference_to_json(ref));
-    }
     result["references"] = references_array;
     result["success"] = true;
 
@@ -175,9 +180,24 @@ std::vector<FindReferencesTool::Reference> FindReferencesTool::find_in_file(
     // Parse with tree-sitter
     TreeSitterParser parser(language);
     auto parse_result = parser.parse_string(source);
+    StringId file_id = StringId::of(filepath);
 
     if (!parse_result) {
-        spdlog::warn("FindReferencesTool: parse failed for {}", filepath);
+        if (parser.last_degraded() == DegradeReason::NONE) {
+            spdlog::warn("FindReferencesTool: parse failed for {}", filepath);
+            return references;
+        }
+        // Unparsed file: whole-word matches, unclassified
+        for (const auto& match : LexicalScanner::find_word(source, symbol)) {
+            Reference ref;
+            ref.filepath = file_id;
+            ref.line = match.line + 1;
+            ref.column = match.column + 1;
+            ref.type = ReferenceType::UNKNOWN;
+            ref.context = match.context;
+            ref.node_type = StringId::of("text");
+            references.push_back(ref);
+        }
         return references;
     }
 
@@ -194,7 +214,7 @@ std::vector<FindReferencesTool::Reference> FindReferencesTool::find_in_file(
             if (node_matches_symbol(node, symbol, source)) {
                 // Found a match - create reference
                 Reference ref;
-                ref.filepath = filepath;
+                ref.filepath = file_id;
 
                 TSPoint start = ts_node_start_point(node);
                 ref.line = start.row + 1;
@@ -202,8 +222,8 @@ std::vector<FindReferencesTool::Reference> FindReferencesTool::find_in_file(
 
                 ref.type = classify_reference(node, source, language);
                 ref.context = extract_context(node, source, 0);
-                ref.parent_scope = find_parent_scope(node, source);
-                ref.node_type = node_type;
+                ref.parent_scope = StringId::of(find_parent_scope(node, source));
+                ref.node_type = StringId::of(node_type);
 
                 references.push_back(ref);
             }
@@ -327,7 +347,7 @@ std::string FindReferencesTool::extract_context(
     return line;
 }
 
-std::string FindReferencesTool::find_parent_scope(
+std::string_view FindReferencesTool::find_parent_scope(
     TSNode node,
     std::string_view source
 ) {
@@ -360,7 +380,7 @@ std::string FindReferencesTool::find_parent_scope(
                     if (child_type == "identifier" || child_type == "field_identifier") {
                         uint32_t start = ts_node_start_byte(child);
                         uint32_t end = ts_node_end_byte(child);
-                        return std::string(source.substr(start, end - start));
+                        return source.substr(start, end - start);
                     }
                 }
             }
@@ -372,7 +392,7 @@ std::string FindReferencesTool::find_parent_scope(
             if (!ts_node_is_null(name_node)) {
                 uint32_t start = ts_node_start_byte(name_node);
                 uint32_t end = ts_node_end_byte(name_node);
-                return std::string(source.substr(start, end - start));
+                return source.substr(start, end - start);
             }
         }
 
@@ -382,12 +402,12 @@ std::string FindReferencesTool::find_parent_scope(
             if (!ts_node_is_null(name_node)) {
                 uint32_t start = ts_node_start_byte(name_node);
                 uint32_t end = ts_node_end_byte(name_node);
-                return std::string(source.substr(start, end - start));
+                return source.substr(start, end - start);
             }
         }
     }
 
-    return "";  // Global scope
+    return {};  // Global scope
 }
 
 std::string FindReferencesTool::reference_type_to_string(ReferenceType type) {
@@ -404,17 +424,17 @@ std::string FindReferencesTool::reference_type_to_string(ReferenceType type) {
 
 json FindReferencesTool::reference_to_json(const Reference& ref) {
     json j;
-    j["filepath"] = ref.filepath;
+    j["filepath"] = ref.filepath.view();
     j["line"] = ref.line;
     j["column"] = ref.column;
     j["type"] = reference_type_to_string(ref.type);
     j["context"] = ref.context;
 
     if (!ref.parent_scope.empty()) {
-        j["parent_scope"] = ref.parent_scope;
+        j["parent_scope"] = ref.parent_scope.view();
     }
 
-    j["node_type"] = ref.node_type;
+    j["node_type"] = ref.node_type.view();
 
     return j;
 }
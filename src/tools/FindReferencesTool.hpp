@@ -2,6 +2,7 @@
 
 #include "core/ASTAnalyzer.hpp"
 #include "core/QueryEngine.hpp"
+#include "core/StringInterner.hpp"
 #include "core/Language.hpp"
 #include "mcp/MCPServer.hpp"
 #include <memory>
@@ -62,13 +63,13 @@ private:
      * @brief Single reference information
      */
     struct Reference {
-        std::string filepath;
+        StringId filepath;
         int line;
         int column;
         ReferenceType type;
         std::string context;        // Line of code containing reference
-        std::string parent_scope;   // Parent function/class name
-        std::string node_type;      // Tree-sitter node type
+        StringId parent_scope;      // Parent function/class name
+        StringId node_type;         // Tree-sitter node type
     };
 
     /**
@@ -127,9 +128,9 @@ private:
      * @brief Find parent scope (function/class) of node
      * @param node Child node
      * @param source Source code
-     * @return Parent scope name or empty string
+     * @return Parent scope name (a view into source) or empty
      */
-    std::string find_parent_scope(
+    std::string_view find_parent_scope(
         TSNode node,
         std::string_view source
     );
@@ -1,10 +1,12 @@
 #include "tools/GetClassHierarchyTool.hpp"
+#include "core/Trace.hpp"
 #include "core/TreeSitterParser.hpp"
 #include "core/Language.hpp"
 #include "core/PathResolver.hpp"
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <queue>
+#include <unordered_set>
 #include <fstream>
 #include <sstream>
 
@@ -67,7 +69,7 @@ json GetClassHierarchyTool::execute(const json& args) {
 
         std::string class_name = args.value("class_name", "");
         bool show_methods = args.value("show_methods", true);
-        bool show_virtual_only = args.value("show_virtual_only", false);
+        [[maybe_unused]] bool show_virtual_only = args.value("show_virtual_only", false);
         int max_depth = args.value("max_depth", -1);
         bool recursive = args.value("recursive", true);
 
@@ -101,11 +103,12 @@ json GetClassHierarchyTool::execute(const json& args) {
         }
 
         // Analyze all files and collect classes
-        std::map<std::string, ClassInfo> all_classes;
+        ClassMap all_classes;
         int files_processed = 0;
         int files_failed = 0;
 
         for (const auto& filepath : resolved) {
+            TraceSpan file_span("class_hierarchy_file", filepath.string());
             Language lang = LanguageUtils::detect_from_extension(filepath);
 
             // Only C++ supported for class hierarchy
@@ -114,13 +117,7 @@ json GetClassHierarchyTool::execute(const json& args) {
             }
 
             try {
-                auto file_classes = analyze_file(
-                    filepath.string(),
-                    "",  // Don't filter by class yet
-                    show_methods,
-                    show_virtual_only,
-                    lang
-                );
+                auto file_classes = analyze_file_cached(filepath.string(), show_methods, lang);
 
                 // Merge into all_classes
                 for (auto& [name, info] : file_classes) {
@@ -154,16 +151,17 @@ json GetClassHierarchyTool::execute(const json& args) {
         // Build hierarchy tree
         auto hierarchy = build_hierarchy_tree(all_classes);
 
-        // Filter by class name if specified
+        // Filter by class name if specified (a name never interned names no class)
         if (!class_name.empty()) {
-            if (all_classes.find(class_name) == all_classes.end()) {
+            auto root = StringInterner::find(class_name);
+            if (!root || all_classes.find(*root) == all_classes.end()) {
                 json error = {
                     {"error", "Class not found: " + class_name},
                     {"success", false}
                 };
                 return error;
             }
-            all_classes = filter_hierarchy(all_classes, hierarchy, class_name, max_depth);
+            all_classes = filter_hierarchy(all_classes, hierarchy, *root, max_depth);
             hierarchy = build_hierarchy_tree(all_classes);
         }
 
@@ -197,7 +195,7 @@ json GetClassHierarchyTool::execute(const json& args) {
     }
 }
 
-std::map<std::string, GetClassHierarchyTool::ClassInfo>
+GetClassHierarchyTool::ClassMap
 GetClassHierarchyTool::analyze_file(
     const std::string& filepath,
     [[maybe_unused]] const std::string& class_name,
@@ -205,7 +203,7 @@ GetClassHierarchyTool::analyze_file(
     [[maybe_unused]] bool show_virtual_only,
     Language language
 ) {
-    std::map<std::string, ClassInfo> classes;
+    ClassMap classes;
 
     // Read file
     std::ifstream file(filepath);
@@ -252,9 +250,9 @@ GetClassHierarchyTool::analyze_file(
         }
 
         ClassInfo info;
-        info.name = match.text;
+        info.name = StringId::of(match.text);
         info.line = match.line;
-        info.filepath = filepath;
+        info.filepath = StringId::of(filepath);
 
         // Find the full class node
         TSNode class_node = match.node;
@@ -289,11 +287,61 @@ GetClassHierarchyTool::analyze_file(
     return classes;
 }
 
-std::vector<std::string> GetClassHierarchyTool::extract_base_classes(
+GetClassHierarchyTool::ClassMap
+GetClassHierarchyTool::analyze_file_cached(
+    const std::string& filepath,
+    bool show_methods,
+    Language language
+) {
+    std::string kind = "class_info/" + std::string(LanguageUtils::to_string(language)) + "/" +
+                       std::to_string(show_methods);
+    json facts = analyzer_->cached_facts(filepath, kind, [&] {
+        json classes = json::array();
+        for (const auto& [name, info] : analyze_file(filepath, "", show_methods, false, language)) {
+            classes.push_back(class_info_to_json(info, show_methods));
+        }
+        return classes;
+    });
+
+    ClassMap classes;
+    StringId file_id = StringId::of(filepath);
+    for (const auto& data : facts) {
+        ClassInfo info = class_info_from_json(data);
+        info.filepath = file_id;
+        classes[info.name] = std::move(info);
+    }
+    return classes;
+}
+
+GetClassHierarchyTool::ClassInfo GetClassHierarchyTool::class_info_from_json(const json& data) {
+    ClassInfo info;
+    info.name = StringId::of(data.at("name").get_ref<const std::string&>());
+    info.line = data.at("line").get<int>();
+    info.filepath = StringId::of(data.value("file", ""));
+    for (const auto& base : data.at("base_classes")) {
+        info.base_classes.push_back(StringId::of(base.get_ref<const std::string&>()));
+    }
+    info.is_abstract = data.at("is_abstract").get<bool>();
+
+    for (const auto& m : data.value("virtual_methods", json::array())) {
+        VirtualMethod method;
+        method.name = m.at("name").get<std::string>();
+        method.signature = m.at("signature").get<std::string>();
+        method.line = m.at("line").get<int>();
+        method.is_pure_virtual = m.at("is_pure_virtual").get<bool>();
+        method.is_override = m.at("is_override").get<bool>();
+        method.is_final = m.at("is_final").get<bool>();
+        method.access = m.at("access").get<std::string>();
+        info.virtual_methods.push_back(std::move(method));
+    }
+    return info;
+}
+
+std::vector<StringId> GetClassHierarchyTool::extract_base_classes(
     TSNode node,
     std::string_view source
 ) {
-    std::vector<std::string> bases;
+    std::vector<StringId> bases;
 
     // Find base_class_clause child
     uint32_t count = ts_node_child_count(node);
@@ -321,8 +369,7 @@ std::vector<std::string> GetClassHierarchyTool::extract_base_classes(
 
                             uint32_t start = ts_node_start_byte(spec_child);
                             uint32_t end = ts_node_end_byte(spec_child);
-                            std::string base_name(source.substr(start, end - start));
-                            bases.push_back(base_name);
+                            bases.push_back(StringId::of(source.substr(start, end - start)));
                             break;
                         }
                     }
@@ -513,16 +560,16 @@ std::string GetClassHierarchyTool::get_access_level(
     return "public";  // Handled in extract_virtual_methods
 }
 
-std::map<std::string, std::set<std::string>>
+GetClassHierarchyTool::Hierarchy
 GetClassHierarchyTool::build_hierarchy_tree(
-    const std::map<std::string, ClassInfo>& classes
+    const ClassMap& classes
 ) {
-    std::map<std::string, std::set<std::string>> hierarchy;
+    Hierarchy hierarchy;
 
     // Initialize all classes in hierarchy
     for (const auto& [name, info] : classes) {
         if (hierarchy.find(name) == hierarchy.end()) {
-            hierarchy[name] = std::set<std::string>();
+            hierarchy[name] = {};
         }
 
         // Add this class as child of its bases
@@ -530,7 +577,7 @@ GetClassHierarchyTool::build_hierarchy_tree(
             hierarchy[base].insert(name);
             // Ensure base exists in hierarchy even if not in classes
             if (hierarchy.find(base) == hierarchy.end()) {
-                hierarchy[base] = std::set<std::string>();
+                hierarchy[base] = {};
             }
         }
     }
@@ -538,18 +585,18 @@ GetClassHierarchyTool::build_hierarchy_tree(
     return hierarchy;
 }
 
-std::map<std::string, GetClassHierarchyTool::ClassInfo>
+GetClassHierarchyTool::ClassMap
 GetClassHierarchyTool::filter_hierarchy(
-    const std::map<std::string, ClassInfo>& classes,
-    const std::map<std::string, std::set<std::string>>& hierarchy,
-    const std::string& root_class,
+    const ClassMap& classes,
+    const Hierarchy& hierarchy,
+    StringId root_class,
     int max_depth
 ) {
-    std::map<std::string, ClassInfo> filtered;
+    ClassMap filtered;
 
     // BFS to traverse hierarchy up to max_depth
-    std::queue<std::pair<std::string, int>> queue;
-    std::set<std::string> visited;
+    std::queue<std::pair<StringId, int>> queue;
+    std::unordered_set<StringId> visited;
 
     queue.push({root_class, 0});
     visited.insert(root_class);
@@ -597,10 +644,14 @@ json GetClassHierarchyTool::class_info_to_json(
     bool show_methods
 ) {
     json result;
-    result["name"] = info.name;
+    result["name"] = info.name.view();
     result["line"] = info.line;
-    result["file"] = info.filepath;
-    result["base_classes"] = info.base_classes;
+    result["file"] = info.filepath.view();
+    json bases = json::array();
+    for (StringId base : info.base_classes) {
+        bases.push_back(base.view());
+    }
+    result["base_classes"] = std::move(bases);
     result["is_abstract"] = info.is_abstract;
 
     if (show_methods) {
@@ -623,8 +674,8 @@ json GetClassHierarchyTool::class_info_to_json(
 }
 
 json GetClassHierarchyTool::hierarchy_to_json(
-    const std::map<std::string, std::set<std::string>>& hierarchy,
-    const std::map<std::string, ClassInfo>& classes
+    const Hierarchy& hierarchy,
+    const ClassMap& classes
 ) {
     json result;
 
@@ -632,14 +683,14 @@ json GetClassHierarchyTool::hierarchy_to_json(
         json node;
         node["children"] = json::array();
         for (const auto& child : children) {
-            node["children"].push_back(child);
+            node["children"].push_back(child.view());
         }
 
         // Find parents
         json parents = json::array();
         if (classes.find(class_name) != classes.end()) {
             for (const auto& base : classes.at(class_name).base_classes) {
-                parents.push_back(base);
+                parents.push_back(base.view());
             }
         }
         node["parents"] = parents;
@@ -651,7 +702,7 @@ json GetClassHierarchyTool::hierarchy_to_json(
             node["is_abstract"] = false;
         }
 
-        result[class_name] = node;
+        result[class_name.str()] = node;
     }
 
     return result;
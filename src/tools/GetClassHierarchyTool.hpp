@@ -3,6 +3,7 @@
 #include "core/ASTAnalyzer.hpp"
 #include "core/QueryEngine.hpp"
 #include "core/Language.hpp"
+#include "core/StringInterner.hpp"
 #include "mcp/MCPServer.hpp"
 #include <memory>
 #include <string>
@@ -67,15 +68,21 @@ private:
      * @brief Information about a class
      */
     struct ClassInfo {
-        std::string name;
+        StringId name;
         int line;
-        std::string filepath;
-        std::vector<std::string> base_classes;
+        StringId filepath;
+        std::vector<StringId> base_classes;
         std::vector<VirtualMethod> virtual_methods;
         bool is_abstract;
-        std::set<std::string> children;  // Derived classes
+        std::set<StringId, StringIdLess> children;  // Derived classes
     };
 
+    /// Classes by name, in name order
+    using ClassMap = std::map<StringId, ClassInfo, StringIdLess>;
+
+    /// Class name -> derived classes
+    using Hierarchy = std::map<StringId, std::set<StringId, StringIdLess>, StringIdLess>;
+
     /**
      * @brief Analyze class hierarchy in a single file
      * @param filepath Path to file
@@ -85,7 +92,7 @@ private:
      * @param language Programming language
      * @return Map of class name -> ClassInfo
      */
-    std::map<std::string, ClassInfo> analyze_file(
+    ClassMap analyze_file(
         const std::string& filepath,
         const std::string& class_name,
         bool show_methods,
@@ -93,13 +100,27 @@ private:
         Language language
     );
 
+    /**
+     * @brief analyze_file() through the analyzer's fact cache
+     */
+    ClassMap analyze_file_cached(
+        const std::string& filepath,
+        bool show_methods,
+        Language language
+    );
+
+    /**
+     * @brief Inverse of class_info_to_json() (children are not stored)
+     */
+    static ClassInfo class_info_from_json(const json& data);
+
     /**
      * @brief Extract base classes from class definition
      * @param node Class specifier node
      * @param source Source code
      * @return Vector of base class names
      */
-    std::vector<std::string> extract_base_classes(
+    std::vector<StringId> extract_base_classes(
         TSNode node,
         std::string_view source
     );
@@ -154,8 +175,8 @@ private:
      * @param classes Map of all classes
      * @return Hierarchy tree (class name -> children set)
      */
-    std::map<std::string, std::set<std::string>> build_hierarchy_tree(
-        const std::map<std::string, ClassInfo>& classes
+    Hierarchy build_hierarchy_tree(
+        const ClassMap& classes
     );
 
     /**
@@ -166,10 +187,10 @@ private:
      * @param max_depth Maximum depth (-1 = unlimited)
      * @return Filtered class map
      */
-    std::map<std::string, ClassInfo> filter_hierarchy(
-        const std::map<std::string, ClassInfo>& classes,
-        const std::map<std::string, std::set<std::string>>& hierarchy,
-        const std::string& root_class,
+    ClassMap filter_hierarchy(
+        const ClassMap& classes,
+        const Hierarchy& hierarchy,
+        StringId root_class,
         int max_depth
     );
 
@@ -191,8 +212,8 @@ private:
      * @return JSON representation
      */
     json hierarchy_to_json(
-        const std::map<std::string, std::set<std::string>>& hierarchy,
-        const std::map<std::string, ClassInfo>& classes
+        const Hierarchy& hierarchy,
+        const ClassMap& classes
     );
 
     std::shared_ptr<ASTAnalyzer> analyzer_;
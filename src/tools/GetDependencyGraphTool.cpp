@@ -1,6 +1,8 @@
 #include "tools/GetDependencyGraphTool.hpp"
+#include "core/Trace.hpp"
 #include "core/TreeSitterParser.hpp"
 #include "core/Language.hpp"
+#include "core/LexicalScanner.hpp"
 #include "core/PathResolver.hpp"
 #include <spdlog/spdlog.h>
 #include <algorithm>
@@ -11,6 +13,18 @@
 
 namespace ts_mcp {
 
+namespace {
+
+json paths_to_json(const std::vector<StringId>& paths) {
+    json array = json::array();
+    for (StringId path : paths) {
+        array.push_back(path.view());
+    }
+    return array;
+}
+
+} // namespace
+
 GetDependencyGraphTool::GetDependencyGraphTool(std::shared_ptr<ASTAnalyzer> analyzer)
     : analyzer_(std::move(analyzer)), query_engine_() {
     spdlog::debug("GetDependencyGraphTool initialized");
@@ -108,11 +122,25 @@ json GetDependencyGraphTool::execute(const json& args) {
         int files_failed = 0;
 
         for (const auto& filepath : resolved) {
+            TraceSpan file_span("dependency_graph_file", filepath.string());
             Language lang = LanguageUtils::detect_from_extension(filepath);
 
             try {
-                auto edges = extract_includes(filepath.string(), lang);
-                all_edges.insert(all_edges.end(), edges.begin(), edges.end());
+                // Edge paths depend on the working directory: not persisted
+                json edges = analyzer_->cached_facts(
+                    filepath, "dependency_edges/" + std::string(LanguageUtils::to_string(lang)), [&] {
+                        json file_edges = json::array();
+                        for (const auto& edge : extract_includes(filepath.string(), lang)) {
+                            file_edges.push_back({{"from", edge.from.view()}, {"to", edge.to.view()},
+                                                  {"is_system", edge.is_system}, {"line", edge.line}});
+                        }
+                        return file_edges;
+                    }, false);
+                for (const auto& edge : edges) {
+                    all_edges.push_back({StringId::of(edge.at("from").get_ref<const std::string&>()),
+                                         StringId::of(edge.at("to").get_ref<const std::string&>()),
+                                         edge.at("is_system").get<bool>(), edge.at("line").get<int>()});
+                }
                 files_processed++;
             } catch (const std::exception& e) {
                 spdlog::warn("Failed to extract includes from {}: {}", filepath.string(), e.what());
@@ -125,15 +153,15 @@ json GetDependencyGraphTool::execute(const json& args) {
 
         // Filter by depth if specified
         if (max_depth >= 0) {
-            std::vector<std::string> root_files;
+            std::vector<StringId> root_files;
             for (const auto& path : resolved) {
-                root_files.push_back(normalize_path(path.string()));
+                root_files.push_back(StringId::of(normalize_path(path.string())));
             }
             graph = filter_by_depth(graph, root_files, max_depth);
         }
 
         // Detect cycles
-        std::vector<std::vector<std::string>> cycles;
+        std::vector<std::vector<StringId>> cycles;
         if (detect_cycles_flag) {
             cycles = detect_cycles(graph);
         }
@@ -201,13 +229,29 @@ GetDependencyGraphTool::extract_includes(
     TreeSitterParser parser(language);
     auto parse_result = parser.parse_string(source);
 
+    StringId normalized_from = StringId::of(normalize_path(filepath));
+
     if (!parse_result) {
-        spdlog::warn("Failed to parse {}", filepath);
+        if (parser.last_degraded() == DegradeReason::NONE) {
+            spdlog::warn("Failed to parse {}", filepath);
+            return edges;
+        }
+        // Include lines are easy to find without a tree; Python keeps to
+        // plain "import" statements like the query below
+        for (const auto& include : LexicalScanner::includes(source, language)) {
+            if (include.kind == "import_from") {
+                continue;
+            }
+            DependencyEdge edge;
+            edge.from = normalized_from;
+            edge.to = StringId::of(include.path);
+            edge.is_system = include.is_system;
+            edge.line = include.line;
+            edges.push_back(edge);
+        }
         return edges;
     }
 
-    std::string normalized_from = normalize_path(filepath);
-
     if (language == Language::CPP) {
         // C++ #include directives
         std::string include_query = R"(
@@ -238,7 +282,7 @@ GetDependencyGraphTool::extract_includes(
 
                 DependencyEdge edge;
                 edge.from = normalized_from;
-                edge.to = path;
+                edge.to = StringId::of(path);
                 edge.is_system = is_system;
                 edge.line = match.line;
 
@@ -278,7 +322,7 @@ GetDependencyGraphTool::extract_includes(
                 if (!module_part.empty()) {
                     DependencyEdge edge;
                     edge.from = normalized_from;
-                    edge.to = module_part;
+                    edge.to = StringId::of(module_part);
                     edge.is_system = false;  // Python imports are not "system" in same sense
                     edge.line = match.line;
 
@@ -291,12 +335,12 @@ GetDependencyGraphTool::extract_includes(
     return edges;
 }
 
-std::map<std::string, GetDependencyGraphTool::FileNode>
+GetDependencyGraphTool::Graph
 GetDependencyGraphTool::build_graph(
     const std::vector<DependencyEdge>& edges,
     bool show_system
 ) {
-    std::map<std::string, FileNode> graph;
+    Graph graph;
 
     for (const auto& edge : edges) {
         // Skip system includes if not requested
@@ -329,15 +373,15 @@ GetDependencyGraphTool::build_graph(
     return graph;
 }
 
-std::vector<std::vector<std::string>>
+std::vector<std::vector<StringId>>
 GetDependencyGraphTool::detect_cycles(
-    const std::map<std::string, FileNode>& graph
+    const Graph& graph
 ) {
-    std::vector<std::vector<std::string>> sccs;
-    std::map<std::string, int> indices;
-    std::map<std::string, int> lowlinks;
-    std::set<std::string> on_stack;
-    std::vector<std::string> stack;
+    std::vector<std::vector<StringId>> sccs;
+    std::unordered_map<StringId, int> indices;
+    std::unordered_map<StringId, int> lowlinks;
+    std::unordered_set<StringId> on_stack;
+    std::vector<StringId> stack;
     int index = 0;
 
     for (const auto& [node, _] : graph) {
@@ -347,7 +391,7 @@ GetDependencyGraphTool::detect_cycles(
     }
 
     // Filter out single-node SCCs (not cycles)
-    std::vector<std::vector<std::string>> cycles;
+    std::vector<std::vector<StringId>> cycles;
     for (const auto& scc : sccs) {
         if (scc.size() > 1) {
             cycles.push_back(scc);
@@ -358,14 +402,14 @@ GetDependencyGraphTool::detect_cycles(
 }
 
 void GetDependencyGraphTool::tarjan_scc(
-    const std::string& node,
-    const std::map<std::string, FileNode>& graph,
+    StringId node,
+    const Graph& graph,
     int& index,
-    std::vector<std::string>& stack,
-    std::map<std::string, int>& indices,
-    std::map<std::string, int>& lowlinks,
-    std::set<std::string>& on_stack,
-    std::vector<std::vector<std::string>>& sccs
+    std::vector<StringId>& stack,
+    std::unordered_map<StringId, int>& indices,
+    std::unordered_map<StringId, int>& lowlinks,
+    std::unordered_set<StringId>& on_stack,
+    std::vector<std::vector<StringId>>& sccs
 ) {
     indices[node] = index;
     lowlinks[node] = index;
@@ -389,8 +433,8 @@ void GetDependencyGraphTool::tarjan_scc(
 
     // If node is a root node, pop the stack and generate an SCC
     if (lowlinks[node] == indices[node]) {
-        std::vector<std::string> scc;
-        std::string w;
+        std::vector<StringId> scc;
+        StringId w;
         do {
             w = stack.back();
             stack.pop_back();
@@ -402,16 +446,16 @@ void GetDependencyGraphTool::tarjan_scc(
     }
 }
 
-std::map<int, std::vector<std::string>>
+std::map<int, std::vector<StringId>>
 GetDependencyGraphTool::compute_layers(
-    const std::map<std::string, FileNode>& graph
+    const Graph& graph
 ) {
-    std::map<int, std::vector<std::string>> layers;
-    std::map<std::string, int> node_layers;
+    std::map<int, std::vector<StringId>> layers;
+    std::unordered_map<StringId, int> node_layers;
 
     // Find nodes with no dependencies (layer 0)
-    std::queue<std::string> queue;
-    std::map<std::string, int> in_degree;
+    std::queue<StringId> queue;
+    std::unordered_map<StringId, int> in_degree;
 
     for (const auto& [node, info] : graph) {
         in_degree[node] = info.included_by.size();
@@ -423,7 +467,7 @@ GetDependencyGraphTool::compute_layers(
 
     // Topological sort with layer assignment
     while (!queue.empty()) {
-        std::string current = queue.front();
+        StringId current = queue.front();
         queue.pop();
 
         int current_layer = node_layers[current];
@@ -443,15 +487,15 @@ GetDependencyGraphTool::compute_layers(
     return layers;
 }
 
-std::map<std::string, GetDependencyGraphTool::FileNode>
+GetDependencyGraphTool::Graph
 GetDependencyGraphTool::filter_by_depth(
-    const std::map<std::string, FileNode>& graph,
-    const std::vector<std::string>& root_files,
+    const Graph& graph,
+    const std::vector<StringId>& root_files,
     int max_depth
 ) {
-    std::map<std::string, FileNode> filtered;
-    std::queue<std::pair<std::string, int>> queue;
-    std::set<std::string> visited;
+    Graph filtered;
+    std::queue<std::pair<StringId, int>> queue;
+    std::unordered_set<StringId> visited;
 
     // Start from root files
     for (const auto& root : root_files) {
@@ -490,10 +534,10 @@ GetDependencyGraphTool::filter_by_depth(
 }
 
 json GetDependencyGraphTool::graph_to_json(
-    const std::map<std::string, FileNode>& graph,
+    const Graph& graph,
     const std::vector<DependencyEdge>& edges,
-    const std::vector<std::vector<std::string>>& cycles,
-    const std::map<int, std::vector<std::string>>& layers
+    const std::vector<std::vector<StringId>>& cycles,
+    const std::map<int, std::vector<StringId>>& layers
 ) {
     json result;
 
@@ -501,9 +545,9 @@ json GetDependencyGraphTool::graph_to_json(
     json nodes = json::array();
     for (const auto& [filepath, node] : graph) {
         json n;
-        n["file"] = node.filepath;
-        n["includes"] = node.includes;
-        n["included_by"] = node.included_by;
+        n["file"] = node.filepath.view();
+        n["includes"] = paths_to_json(node.includes);
+        n["included_by"] = paths_to_json(node.included_by);
         n["is_system"] = node.is_system;
 
         // Find layer
@@ -522,8 +566,8 @@ json GetDependencyGraphTool::graph_to_json(
     json edges_json = json::array();
     for (const auto& edge : edges) {
         json e;
-        e["from"] = edge.from;
-        e["to"] = edge.to;
+        e["from"] = edge.from.view();
+        e["to"] = edge.to.view();
         e["is_system"] = edge.is_system;
         e["line"] = edge.line;
         edges_json.push_back(e);
@@ -533,14 +577,14 @@ json GetDependencyGraphTool::graph_to_json(
     // Cycles
     json cycles_json = json::array();
     for (const auto& cycle : cycles) {
-        cycles_json.push_back(cycle);
+        cycles_json.push_back(paths_to_json(cycle));
     }
     result["cycles"] = cycles_json;
 
     // Layers
     json layers_json;
     for (const auto& [layer_num, files] : layers) {
-        layers_json[std::to_string(layer_num)] = files;
+        layers_json[std::to_string(layer_num)] = paths_to_json(files);
     }
     result["layers"] = layers_json;
 
@@ -548,34 +592,32 @@ json GetDependencyGraphTool::graph_to_json(
 }
 
 std::string GetDependencyGraphTool::graph_to_mermaid(
-    const std::map<std::string, FileNode>& graph,
+    const Graph& graph,
     const std::vector<DependencyEdge>& edges,
-    const std::vector<std::vector<std::string>>& cycles
+    const std::vector<std::vector<StringId>>& cycles
 ) {
     std::stringstream ss;
     ss << "graph TD\n";
 
     // Nodes
-    std::map<std::string, std::string> node_ids;
+    std::unordered_map<StringId, std::string> node_ids;
     int id_counter = 0;
     for (const auto& [filepath, node] : graph) {
         std::string node_id = "N" + std::to_string(id_counter++);
         node_ids[filepath] = node_id;
 
         // Extract filename for display
-        std::filesystem::path p(filepath);
+        std::filesystem::path p(filepath.view());
         std::string display_name = p.filename().string();
 
         ss << "    " << node_id << "[\"" << display_name << "\"]\n";
     }
 
     // Edges
-    std::set<std::string> cycle_edges;
+    std::set<std::pair<uint32_t, uint32_t>> cycle_edges;
     for (const auto& cycle : cycles) {
         for (size_t i = 0; i < cycle.size(); i++) {
-            std::string from = cycle[i];
-            std::string to = cycle[(i + 1) % cycle.size()];
-            cycle_edges.insert(from + "->" + to);
+            cycle_edges.insert({cycle[i].value, cycle[(i + 1) % cycle.size()].value});
         }
     }
 
@@ -583,8 +625,7 @@ std::string GetDependencyGraphTool::graph_to_mermaid(
         if (node_ids.find(edge.from) != node_ids.end() &&
             node_ids.find(edge.to) != node_ids.end()) {
 
-            std::string edge_key = edge.from + "->" + edge.to;
-            bool is_cycle_edge = cycle_edges.find(edge_key) != cycle_edges.end();
+            bool is_cycle_edge = cycle_edges.count({edge.from.value, edge.to.value}) > 0;
 
             if (is_cycle_edge) {
                 ss << "    " << node_ids[edge.from] << " -.->|cycle| " << node_ids[edge.to] << "\n";
@@ -610,9 +651,9 @@ std::string GetDependencyGraphTool::graph_to_mermaid(
 }
 
 std::string GetDependencyGraphTool::graph_to_dot(
-    const std::map<std::string, FileNode>& graph,
+    const Graph& graph,
     const std::vector<DependencyEdge>& edges,
-    const std::vector<std::vector<std::string>>& cycles
+    const std::vector<std::vector<StringId>>& cycles
 ) {
     std::stringstream ss;
     ss << "digraph dependencies {\n";
@@ -620,13 +661,13 @@ std::string GetDependencyGraphTool::graph_to_dot(
     ss << "    node [shape=box];\n\n";
 
     // Nodes
-    std::map<std::string, std::string> node_ids;
+    std::unordered_map<StringId, std::string> node_ids;
     int id_counter = 0;
     for (const auto& [filepath, node] : graph) {
         std::string node_id = "N" + std::to_string(id_counter++);
         node_ids[filepath] = node_id;
 
-        std::filesystem::path p(filepath);
+        std::filesystem::path p(filepath.view());
         std::string display_name = p.filename().string();
 
         ss << "    " << node_id << " [label=\"" << display_name << "\"];\n";
@@ -635,12 +676,10 @@ std::string GetDependencyGraphTool::graph_to_dot(
     ss << "\n";
 
     // Edges
-    std::set<std::string> cycle_edges;
+    std::set<std::pair<uint32_t, uint32_t>> cycle_edges;
     for (const auto& cycle : cycles) {
         for (size_t i = 0; i < cycle.size(); i++) {
-            std::string from = cycle[i];
-            std::string to = cycle[(i + 1) % cycle.size()];
-            cycle_edges.insert(from + "->" + to);
+            cycle_edges.insert({cycle[i].value, cycle[(i + 1) % cycle.size()].value});
         }
     }
 
@@ -648,8 +687,7 @@ std::string GetDependencyGraphTool::graph_to_dot(
         if (node_ids.find(edge.from) != node_ids.end() &&
             node_ids.find(edge.to) != node_ids.end()) {
 
-            std::string edge_key = edge.from + "->" + edge.to;
-            bool is_cycle_edge = cycle_edges.find(edge_key) != cycle_edges.end();
+            bool is_cycle_edge = cycle_edges.count({edge.from.value, edge.to.value}) > 0;
 
             ss << "    " << node_ids[edge.from] << " -> " << node_ids[edge.to];
             if (is_cycle_edge) {
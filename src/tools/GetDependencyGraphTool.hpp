@@ -2,6 +2,7 @@
 
 #include "core/ASTAnalyzer.hpp"
 #include "core/QueryEngine.hpp"
+#include "core/StringInterner.hpp"
 #include "core/Language.hpp"
 #include "mcp/MCPServer.hpp"
 #include <memory>
@@ -9,6 +10,8 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace ts_mcp {
 
@@ -56,8 +59,8 @@ private:
      * @brief Information about a dependency edge
      */
     struct DependencyEdge {
-        std::string from;
-        std::string to;
+        StringId from;
+        StringId to;
         bool is_system;
         int line;
     };
@@ -66,13 +69,16 @@ private:
      * @brief Information about a file node
      */
     struct FileNode {
-        std::string filepath;
-        std::vector<std::string> includes;  // Files this depends on
-        std::vector<std::string> included_by;  // Files that depend on this
+        StringId filepath;
+        std::vector<StringId> includes;  // Files this depends on
+        std::vector<StringId> included_by;  // Files that depend on this
         bool is_system;
         int layer;  // Topological layer
     };
 
+    // Nodes by path, in path order (the output order)
+    using Graph = std::map<StringId, FileNode, StringIdLess>;
+
     /**
      * @brief Extract include directives from a file
      * @param filepath Path to file
@@ -90,7 +96,7 @@ private:
      * @param show_system Include system headers
      * @return Map of file -> FileNode
      */
-    std::map<std::string, FileNode> build_graph(
+    Graph build_graph(
         const std::vector<DependencyEdge>& edges,
         bool show_system
     );
@@ -100,8 +106,8 @@ private:
      * @param graph Dependency graph
      * @return Vector of cycles (each cycle is a vector of file paths)
      */
-    std::vector<std::vector<std::string>> detect_cycles(
-        const std::map<std::string, FileNode>& graph
+    std::vector<std::vector<StringId>> detect_cycles(
+        const Graph& graph
     );
 
     /**
@@ -116,14 +122,14 @@ private:
      * @param sccs Strongly connected components (output)
      */
     void tarjan_scc(
-        const std::string& node,
-        const std::map<std::string, FileNode>& graph,
+        StringId node,
+        const Graph& graph,
         int& index,
-        std::vector<std::string>& stack,
-        std::map<std::string, int>& indices,
-        std::map<std::string, int>& lowlinks,
-        std::set<std::string>& on_stack,
-        std::vector<std::vector<std::string>>& sccs
+        std::vector<StringId>& stack,
+        std::unordered_map<StringId, int>& indices,
+        std::unordered_map<StringId, int>& lowlinks,
+        std::unordered_set<StringId>& on_stack,
+        std::vector<std::vector<StringId>>& sccs
     );
 
     /**
@@ -131,8 +137,8 @@ private:
      * @param graph Dependency graph
      * @return Map of layer number -> files
      */
-    std::map<int, std::vector<std::string>> compute_layers(
-        const std::map<std::string, FileNode>& graph
+    std::map<int, std::vector<StringId>> compute_layers(
+        const Graph& graph
     );
 
     /**
@@ -142,9 +148,9 @@ private:
      * @param max_depth Maximum depth (-1 = unlimited)
      * @return Filtered graph
      */
-    std::map<std::string, FileNode> filter_by_depth(
-        const std::map<std::string, FileNode>& graph,
-        const std::vector<std::string>& root_files,
+    Graph filter_by_depth(
+        const Graph& graph,
+        const std::vector<StringId>& root_files,
         int max_depth
     );
 
@@ -157,10 +163,10 @@ private:
      * @return JSON representation
      */
     json graph_to_json(
-        const std::map<std::string, FileNode>& graph,
+        const Graph& graph,
         const std::vector<DependencyEdge>& edges,
-        const std::vector<std::vector<std::string>>& cycles,
-        const std::map<int, std::vector<std::string>>& layers
+        const std::vector<std::vector<StringId>>& cycles,
+        const std::map<int, std::vector<StringId>>& layers
     );
 
     /**
@@ -171,9 +177,9 @@ private:
      * @return Mermaid markdown string
      */
     std::string graph_to_mermaid(
-        const std::map<std::string, FileNode>& graph,
+        const Graph& graph,
         const std::vector<DependencyEdge>& edges,
-        const std::vector<std::vector<std::string>>& cycles
+        const std::vector<std::vector<StringId>>& cycles
     );
 
     /**
@@ -184,9 +190,9 @@ private:
      * @return DOT format string
      */
     std::string graph_to_dot(
-        const std::map<std::string, FileNode>& graph,
+        const Graph& graph,
         const std::vector<DependencyEdge>& edges,
-        const std::vector<std::vector<std::string>>& cycles
+        const std::vector<std::vector<StringId>>& cycles
     );
 
     /**
@@ -1,7 +1,9 @@
 #include "tools/GetFileSummaryTool.hpp"
 #include "core/PathResolver.hpp"
+#include "core/Trace.hpp"
 #include "core/TreeSitterParser.hpp"
 #include "core/Language.hpp"
+#include "core/LexicalScanner.hpp"
 #include <spdlog/spdlog.h>
 #include <fstream>
 #include <sstream>
@@ -102,6 +104,19 @@ json GetFileSummaryTool::execute(const json& args) {
 
     spdlog::debug("GetFileSummaryTool: processing {} files", resolved.size());
 
+    // Summaries depend on the content, the language and the options
+    auto summarize = [&](const std::filesystem::path& filepath, Language lang) {
+        std::string kind = "file_summary/" + std::string(LanguageUtils::to_string(lang)) + "/" +
+                           std::to_string(include_complexity) + std::to_string(include_comments) +
+                           std::to_string(include_docstrings);
+        json summary = analyzer_->cached_facts(filepath, kind, [&] {
+            return summarize_file(filepath.string(), lang, include_complexity,
+                                  include_comments, include_docstrings);
+        });
+        summary["filepath"] = filepath.string();
+        return summary;
+    };
+
     // Process single file
     if (resolved.size() == 1) {
         const auto& filepath = resolved[0];
@@ -115,8 +130,7 @@ json GetFileSummaryTool::execute(const json& args) {
         }
 
         try {
-            return summarize_file(filepath.string(), lang, include_complexity,
-                                 include_comments, include_docstrings);
+            return summarize(filepath, lang);
         } catch (const std::exception& e) {
             json error_result;
             error_result["error"] = e.what();
@@ -145,8 +159,7 @@ json GetFileSummaryTool::execute(const json& args) {
         }
 
         try {
-            json summary = summarize_file(filepath.string(), lang, include_complexity,
-                                         include_comments, include_docstrings);
+            json summary = summarize(filepath, lang);
             results.push_back(summary);
             success_count++;
         } catch (const std::exception& e) {
@@ -169,6 +182,52 @@ json GetFileSummaryTool::execute(const json& args) {
     return final_result;
 }
 
+json GetFileSummaryTool::lexical_summary(
+    const std::string& filepath,
+    std::string_view source,
+    Language language,
+    DegradeReason reason
+) {
+    json result;
+    result["filepath"] = filepath;
+    result["language"] = LanguageUtils::to_string(language);
+    result["success"] = true;
+    result["degraded"] = true;
+    result["degraded_reason"] = ParseGuard::to_string(reason);
+
+    auto metrics = calculate_metrics(std::string(source));
+    result["metrics"] = {
+        {"total_lines", metrics["loc"]},
+        {"code_lines", metrics["sloc"]},
+        {"comment_lines", metrics["comment_lines"]},
+        {"blank_lines", metrics["blank_lines"]}
+    };
+    result["functions"] = json::array();
+    result["function_count"] = 0;
+    result["classes"] = json::array();
+    result["class_count"] = 0;
+
+    json imports_json = json::array();
+    for (const auto& include : LexicalScanner::includes(source, language)) {
+        // Same shape as extract_imports: delimiters kept, Python statements whole
+        json imp;
+        imp["line"] = include.line + 1;
+        if (language == Language::CPP) {
+            imp["path"] = include.is_system ? "<" + include.path + ">" : "\"" + include.path + "\"";
+            imp["is_system"] = include.is_system;
+        } else {
+            imp["path"] = include.text;
+            if (language == Language::PYTHON) {
+                imp["module"] = include.text;
+            }
+        }
+        imports_json.push_back(imp);
+    }
+    result["import_count"] = imports_json.size();
+    result["imports"] = std::move(imports_json);
+    return result;
+}
+
 json GetFileSummaryTool::summarize_file(
     const std::string& filepath,
     Language language,
@@ -176,25 +235,27 @@ json GetFileSummaryTool::summarize_file(
     bool include_comments,
     bool include_docstrings
 ) {
-    // Read file
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open file: " + filepath);
-    }
-
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string source = buffer.str();
-
-    // Parse with tree-sitter
-    TreeSitterParser parser(language);
-    auto parse_result = parser.parse_string(source);
+    TraceSpan span("file_summary_file", filepath);
+
+    // Parsed through the analyzer: after an edit, its tree knows which definitions changed
+    auto snapshot = analyzer_->snapshot(filepath, language);
+    if (!snapshot) {
+        auto reason = analyzer_->degrade_reason(filepath);
+        if (!reason) {
+            if (!std::filesystem::exists(filepath)) {
+                throw std::runtime_error("Cannot open file: " + filepath);
+            }
+            throw std::runtime_error("Parse failed for file: " + filepath);
+        }
 
-    if (!parse_result) {
-        throw std::runtime_error("Parse failed for file: " + filepath);
+        std::ifstream file(filepath);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return lexical_summary(filepath, buffer.str(), language, *reason);
     }
 
-    TSNode root = ts_tree_root_node(parse_result->get());
+    std::string_view source = snapshot->source();
+    TSNode root = snapshot->tree().root_node();
 
     // Initialize result
     json result;
@@ -211,7 +272,7 @@ json GetFileSummaryTool::summarize_file(
         {"blank_lines", metrics["blank_lines"]}
     };
 
-    // Extract functions
+    // Extract functions, per definition: an edit recomputes only the definitions it touched
     auto func_query = query_engine_.compile_query(
         QueryEngine::get_predefined_query(QueryType::FUNCTIONS, language).value_or(""),
         language
@@ -219,55 +280,11 @@ json GetFileSummaryTool::summarize_file(
 
     json functions = json::array();
     if (func_query) {
-        auto matches = query_engine_.execute(*parse_result, *func_query, source);
-        for (const auto& match : matches) {
-            TSNode func_node = match.node;
-            // Find parent function_definition
-            TSNode parent = ts_node_parent(func_node);
-            while (!ts_node_is_null(parent)) {
-                std::string type = ts_node_type(parent);
-                if (type == "function_definition" || type == "method_definition") {
-                    func_node = parent;
-                    break;
-                }
-                parent = ts_node_parent(parent);
-            }
-
-            FunctionSignature sig = extract_function_signature(
-                func_node, source, language, include_docstrings
-            );
-
-            json func_json;
-            func_json["name"] = sig.name;
-            func_json["return_type"] = sig.return_type;
-            func_json["line"] = sig.line;
-
-            if (include_complexity) {
-                sig.complexity = calculate_complexity(func_node, source);
-                func_json["complexity"] = sig.complexity;
-            }
-
-            if (!sig.parameters.empty()) {
-                json params = json::array();
-                for (const auto& [type, name] : sig.parameters) {
-                    json param;
-                    param["type"] = type;
-                    param["name"] = name;
-                    params.push_back(param);
-                }
-                func_json["parameters"] = params;
-            }
-
-            if (include_docstrings && !sig.docstring.empty()) {
-                func_json["docstring"] = sig.docstring;
-            }
-
-            if (sig.is_virtual) func_json["is_virtual"] = true;
-            if (sig.is_static) func_json["is_static"] = true;
-            if (sig.is_async) func_json["is_async"] = true;
-
-            functions.push_back(func_json);
-        }
+        std::string kind = "summary_functions/" + std::string(LanguageUtils::to_string(language)) + "/" +
+                           std::to_string(include_complexity) + std::to_string(include_docstrings);
+        functions = analyzer_->definition_facts(*snapshot, filepath, kind, [&](TSNode unit, std::string_view text) {
+            return summarize_functions(*func_query, unit, text, language, include_complexity, include_docstrings);
+        });
     }
     result["functions"] = functions;
     result["function_count"] = functions.size();
@@ -280,7 +297,7 @@ json GetFileSummaryTool::summarize_file(
 
     json classes = json::array();
     if (class_query) {
-        auto matches = query_engine_.execute(*parse_result, *class_query, source);
+        auto matches = query_engine_.execute(snapshot->tree(), *class_query, source);
         for (const auto& match : matches) {
             json class_info;
             class_info["name"] = match.text;
@@ -344,6 +361,67 @@ json GetFileSummaryTool::summarize_file(
     return result;
 }
 
+json GetFileSummaryTool::summarize_functions(
+    const Query& query,
+    TSNode node,
+    std::string_view source,
+    Language language,
+    bool include_complexity,
+    bool include_docstrings
+) {
+    json functions = json::array();
+    auto matches = query_engine_.execute(node, query, source);
+    for (const auto& match : matches) {
+        TSNode func_node = match.node;
+        // Find parent function_definition
+        TSNode parent = ts_node_parent(func_node);
+        while (!ts_node_is_null(parent)) {
+            std::string type = ts_node_type(parent);
+            if (type == "function_definition" || type == "method_definition") {
+                func_node = parent;
+                break;
+            }
+            parent = ts_node_parent(parent);
+        }
+
+        FunctionSignature sig = extract_function_signature(
+            func_node, source, language, include_docstrings
+        );
+
+        json func_json;
+        func_json["name"] = sig.name;
+        func_json["return_type"] = sig.return_type;
+        func_json["line"] = sig.line;
+
+        if (include_complexity) {
+            sig.complexity = calculate_complexity(func_node, source);
+            func_json["complexity"] = sig.complexity;
+        }
+
+        if (!sig.parameters.empty()) {
+            json params = json::array();
+            for (const auto& [type, name] : sig.parameters) {
+                json param;
+                param["type"] = type;
+                param["name"] = name;
+                params.push_back(param);
+            }
+            func_json["parameters"] = params;
+        }
+
+        if (include_docstrings && !sig.docstring.empty()) {
+            func_json["docstring"] = sig.docstring;
+        }
+
+        if (sig.is_virtual) func_json["is_virtual"] = true;
+        if (sig.is_static) func_json["is_static"] = true;
+        if (sig.is_async) func_json["is_async"] = true;
+
+        functions.push_back(func_json);
+    }
+    return functions;
+}
+
 int GetFileSummaryTool::calculate_complexity(TSNode node, [[maybe_unused]] std::string_view source) {
     int complexity = 1;  // Base complexity
 
@@ -3,6 +3,7 @@
 #include "core/ASTAnalyzer.hpp"
 #include "core/QueryEngine.hpp"
 #include "core/Language.hpp"
+#include "core/ParseGuard.hpp"
 #include "mcp/MCPServer.hpp"
 #include <memory>
 #include <string>
@@ -110,6 +111,16 @@ private:
         std::string module;  // Python module name
     };
 
+    /**
+     * @brief Summary of a file the parse guard refused: metrics and imports only
+     */
+    json lexical_summary(
+        const std::string& filepath,
+        std::string_view source,
+        Language language,
+        DegradeReason reason
+    );
+
     /**
      * @brief Generate enhanced summary for a single file
      * @param filepath Path to file
@@ -127,6 +138,22 @@ private:
         bool include_docstrings
     );
 
+    /**
+     * @brief Signatures (and complexity) of the functions within one node
+     * @param query Compiled FUNCTIONS query
+     * @param node Subtree to search (a definition unit, see ASTAnalyzer::definition_facts())
+     * @param source Source code
+     * @return JSON array of functions in source order
+     */
+    json summarize_functions(
+        const Query& query,
+        TSNode node,
+        std::string_view source,
+        Language language,
+        bool include_complexity,
+        bool include_docstrings
+    );
+
     /**
      * @brief Calculate cyclomatic complexity for a function
      * @param node Function definition node
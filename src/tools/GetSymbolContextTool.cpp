@@ -1,6 +1,7 @@
 #include "GetSymbolContextTool.hpp"
 #include "core/TreeSitterParser.hpp"
 #include "core/QueryEngine.hpp"
+#include "core/Trace.hpp"
 #include "core/Language.hpp"
 #include "core/PathResolver.hpp"
 #include <spdlog/spdlog.h>
@@ -99,7 +100,7 @@ json GetSymbolContextTool::execute(const json& args) {
         }
     }
 
-    spdlog::info("Getting context for symbol '{}' in {} (resolve_external={}, usage_examples={})",
+    spdlog::debug("Getting context for symbol '{}' in {} (resolve_external={}, usage_examples={})",
                  symbol_name, filepath, resolve_external_types, include_usage_examples);
 
     // Determine language
@@ -595,7 +596,7 @@ GetSymbolContextTool::enrich_context(
         );
     }
 
-    spdlog::info("Enriched context: {} includes, {} dependencies, {} usage examples",
+    spdlog::debug("Enriched context: {} includes, {} dependencies, {} usage examples",
                  enriched.includes.size(),
                  enriched.dependencies.size(),
                  enriched.usage_examples.size());
@@ -710,12 +711,13 @@ GetSymbolContextTool::find_in_search_paths(
 
         // Search each file for the symbol
         for (const auto& file : files) {
+            TraceSpan file_span("symbol_search_file", file.string());
             Language lang = LanguageUtils::detect_from_extension(file);
             if (lang == Language::UNKNOWN) continue;
 
             auto location = locate_symbol(symbol_name, file.string(), lang);
             if (location) {
-                spdlog::info("Found symbol '{}' in {}", symbol_name, file.string());
+                spdlog::debug("Found symbol '{}' in {}", symbol_name, file.string());
 
                 // Read the file
                 std::ifstream f(file);
@@ -805,6 +807,7 @@ GetSymbolContextTool::find_usage_examples(
 
     for (const auto& file : files) {
         if (found_count >= max_examples) break;
+        TraceSpan file_span("usage_examples_file", file.string());
 
         // Read file
         std::ifstream f(file);
@@ -883,7 +886,7 @@ GetSymbolContextTool::find_usage_examples(
         traverse(root);
     }
 
-    spdlog::info("Found {} usage examples for '{}'", examples.size(), symbol_name);
+    spdlog::debug("Found {} usage examples for '{}'", examples.size(), symbol_name);
     return examples;
 }
 
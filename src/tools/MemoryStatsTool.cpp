@@ -0,0 +1,101 @@
+#include "tools/MemoryStatsTool.hpp"
+#include "core/MemoryAccounting.hpp"
+#include "core/PathResolver.hpp"
+#include "core/StringInterner.hpp"
+
+namespace ts_mcp {
+
+MemoryStatsTool::MemoryStatsTool(std::shared_ptr<ASTAnalyzer> analyzer)
+    : analyzer_(analyzer) {
+}
+
+ToolInfo MemoryStatsTool::get_info() {
+    ToolInfo info;
+    info.name = "memory_stats";
+    info.description = "Report memory usage: tree-sitter allocations, cached sources and syntax trees "
+                       "(totals and heaviest files), directory inventories and git indexes";
+
+    info.input_schema = {
+        {"type", "object"},
+        {"properties", {
+            {"top", {
+                {"type", "integer"},
+                {"minimum", 0},
+                {"default", DEFAULT_TOP},
+                {"description", "Number of heaviest cached files to list"}
+            }}
+        }}
+    };
+
+    return info;
+}
+
+json MemoryStatsTool::execute(const json& args) {
+    if (args.contains("top") && (!args["top"].is_number_integer() || args["top"].get<int64_t>() < 0)) {
+        json error_result;
+        error_result["error"] = "top must be a non-negative integer";
+        return error_result;
+    }
+    auto top = static_cast<size_t>(args.value("top", DEFAULT_TOP));
+
+    auto tree_sitter = TreeSitterMemory::stats();
+    json parse_cache = analyzer_->memory_usage(top);
+
+    json inventories = json::array();
+    size_t index_bytes = 0;
+    for (const auto& inventory : PathResolver::inventories()) {
+        size_t bytes = inventory->memory_bytes();
+        index_bytes += bytes;
+        inventories.push_back({
+            {"root", inventory->root().string()},
+            {"files", inventory->file_count()},
+            {"directories", inventory->directory_count()},
+            {"bytes", bytes}
+        });
+    }
+
+    json git_indexes = json::array();
+    for (const auto& index : PathResolver::git_indexes()) {
+        size_t bytes = index->memory_bytes();
+        index_bytes += bytes;
+        git_indexes.push_back({
+            {"work_tree", index->work_tree().string()},
+            {"entries", index->size()},
+            {"bytes", bytes}
+        });
+    }
+
+    auto interned = StringInterner::stats();
+
+    // Trees of cached files are part of the tree-sitter total
+    int64_t tree_bytes = parse_cache["tree_bytes"].get<int64_t>();
+    int64_t total = (tree_sitter.tracking ? tree_sitter.bytes : tree_bytes) +
+                    parse_cache["source_bytes"].get<int64_t>() +
+                    parse_cache["fact_bytes"].get<int64_t>() +
+                    static_cast<int64_t>(index_bytes) +
+                    static_cast<int64_t>(interned.bytes);
+
+    return {
+        {"total_bytes", total},
+        {"tree_sitter", {
+            {"tracking", tree_sitter.tracking},
+            {"bytes", tree_sitter.bytes},
+            {"peak_bytes", tree_sitter.peak_bytes},
+            {"allocations", tree_sitter.allocations},
+            {"total_allocations", tree_sitter.total_allocations},
+            {"unattributed_bytes", tree_sitter.bytes - tree_bytes}
+        }},
+        {"parse_cache", parse_cache},
+        {"indexes", {
+            {"bytes", index_bytes},
+            {"file_inventories", inventories},
+            {"git_indexes", git_indexes}
+        }},
+        {"interned_strings", {
+            {"strings", interned.strings},
+            {"bytes", interned.bytes}
+        }}
+    };
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/ASTAnalyzer.hpp"
+#include "mcp/MCPServer.hpp"
+#include <memory>
+
+namespace ts_mcp {
+
+/**
+ * @brief MCP tool reporting where the server's memory goes
+ *
+ * Breaks memory down into tree-sitter allocations (exact, attributed per
+ * cached document), cached source text, the parsers' source copies and
+ * the directory inventories and git indexes of PathResolver, and lists the
+ * heaviest cached files. Intended for choosing memory budgets and
+ * eviction limits from real workloads.
+ */
+class MemoryStatsTool {
+public:
+    static constexpr int DEFAULT_TOP = 10;
+
+    /**
+     * @brief Construct tool with analyzer reference
+     * @param analyzer AST analyzer instance (owner of the parse cache)
+     */
+    explicit MemoryStatsTool(std::shared_ptr<ASTAnalyzer> analyzer);
+
+    /**
+     * @brief Get tool metadata and JSON schema
+     * @return ToolInfo with name, description, and input schema
+     */
+    static ToolInfo get_info();
+
+    /**
+     * @brief Execute tool with arguments
+     * @param args JSON object with optional "top" (number of files to list)
+     * @return JSON result with memory breakdown or error
+     */
+    json execute(const json& args);
+
+private:
+    std::shared_ptr<ASTAnalyzer> analyzer_;
+};
+
+} // namespace ts_mcp
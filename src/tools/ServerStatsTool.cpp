@@ -0,0 +1,52 @@
+#include "tools/ServerStatsTool.hpp"
+#include "core/Metrics.hpp"
+
+namespace ts_mcp {
+
+ServerStatsTool::ServerStatsTool(std::shared_ptr<ASTAnalyzer> analyzer, std::shared_ptr<WarmUp> warm_up)
+    : analyzer_(analyzer), warm_up_(std::move(warm_up)) {
+}
+
+ToolInfo ServerStatsTool::get_info() {
+    ToolInfo info;
+    info.name = "server_stats";
+    info.description = "Report server metrics: per-tool call counts, errors and latency percentiles, "
+                       "parse cache hits/misses/evictions, bytes read and parsed, active requests, "
+                       "background warm-up progress";
+
+    info.input_schema = {
+        {"type", "object"},
+        {"properties", {
+            {"format", {
+                {"type", "string"},
+                {"enum", json::array({"json", "prometheus"})},
+                {"default", "json"},
+                {"description", "json: structured summary; prometheus: text exposition format"}
+            }}
+        }}
+    };
+
+    return info;
+}
+
+json ServerStatsTool::execute(const json& args) {
+    std::string format = args.value("format", "json");
+
+    if (format == "prometheus") {
+        return {{"format", "prometheus"}, {"text", Metrics::to_prometheus()}};
+    }
+    if (format != "json") {
+        json error_result;
+        error_result["error"] = "Unknown format: " + format + " (expected json or prometheus)";
+        return error_result;
+    }
+
+    json result = Metrics::to_json();
+    result["cache_entries"] = analyzer_->cache_size();
+    if (warm_up_) {
+        result["warm_up"] = warm_up_->status();
+    }
+    return result;
+}
+
+} // namespace ts_mcp
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/ASTAnalyzer.hpp"
+#include "core/WarmUp.hpp"
+#include "mcp/MCPServer.hpp"
+#include <memory>
+
+namespace ts_mcp {
+
+/**
+ * @brief MCP tool reporting the server's in-process metrics
+ *
+ * Returns per-tool call/error counts and latency percentiles, parse cache
+ * hits, misses and evictions, bytes read and parsed, and request gauges,
+ * either as JSON or in the Prometheus text format. With a WarmUp, the JSON
+ * form also reports its progress.
+ */
+class ServerStatsTool {
+public:
+    /**
+     * @brief Construct tool with analyzer reference
+     * @param analyzer AST analyzer instance (for the cache size)
+     * @param warm_up Background warm-up to report, if any
+     */
+    explicit ServerStatsTool(std::shared_ptr<ASTAnalyzer> analyzer, std::shared_ptr<WarmUp> warm_up = nullptr);
+
+    /**
+     * @brief Get tool metadata and JSON schema
+     * @return ToolInfo with name, description, and input schema
+     */
+    static ToolInfo get_info();
+
+    /**
+     * @brief Execute tool with arguments
+     * @param args JSON object with optional "format" ("json" or "prometheus")
+     * @return JSON result with metrics or error
+     */
+    json execute(const json& args);
+
+private:
+    std::shared_ptr<ASTAnalyzer> analyzer_;
+    std::shared_ptr<WarmUp> warm_up_;
+};
+
+} // namespace ts_mcp
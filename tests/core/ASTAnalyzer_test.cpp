@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 #include "core/ASTAnalyzer.hpp"
+#include "core/ParseGuard.hpp"
 #include <filesystem>
 #include <fstream>
+#include <set>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <thread>
 
@@ -304,3 +308,381 @@ TEST(ASTAnalyzerTest, ExecuteQueryOnMultipleFiles) {
         EXPECT_TRUE(file_result["matches"].is_array());
     }
 }
+
+// Test: WatcherRefreshesCachedParse - watched files are re-parsed on change
+TEST(ASTAnalyzerTest, WatcherRefreshesCachedParse) {
+    auto dir = std::filesystem::canonical(std::filesystem::temp_directory_path()) / "ast_analyzer_watch_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto file = dir / "a.cpp";
+    {
+        std::ofstream out(file);
+        out << "class A {};\n";
+    }
+
+    {
+        ASTAnalyzer analyzer;
+        auto watcher = std::make_shared<FileWatcher>(dir);
+        analyzer.attach_watcher(watcher);
+        watcher->start();
+        ASSERT_TRUE(watcher->healthy());
+
+        EXPECT_EQ(analyzer.analyze_file(file)["class_count"].get<int>(), 1);
+
+        {
+            std::ofstream out(file);
+            out << "class A {};\nclass B {};\n";
+        }
+
+        // The change is delivered before the next query reads the cache
+        EXPECT_EQ(analyzer.analyze_file(file)["class_count"].get<int>(), 2);
+        EXPECT_EQ(analyzer.cache_size(), 1u);
+
+        std::filesystem::remove(file);
+        EXPECT_FALSE(analyzer.analyze_file(file)["success"].get<bool>());
+        EXPECT_EQ(analyzer.cache_size(), 0u);
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+// Test: FactCacheWarmStart - a new analyzer answers unchanged files from the fact cache
+TEST(ASTAnalyzerTest, FactCacheWarmStart) {
+    auto dir = std::filesystem::temp_directory_path() / "ast_analyzer_fact_cache_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto file = dir / "a.cpp";
+    {
+        std::ofstream out(file);
+        out << "class A {};\nvoid f() {}\n";
+    }
+
+    json cold;
+    {
+        ASTAnalyzer analyzer;
+        analyzer.set_fact_cache(std::make_shared<FactCache>(dir / "cache"));
+        cold = analyzer.find_classes(file);
+        EXPECT_EQ(analyzer.cache_size(), 1u);
+    }
+
+    {
+        ASTAnalyzer analyzer;
+        analyzer.set_fact_cache(std::make_shared<FactCache>(dir / "cache"));
+        EXPECT_EQ(analyzer.find_classes(file), cold);
+        EXPECT_EQ(analyzer.cache_size(), 0u) << "Unchanged file should not be parsed";
+
+        {
+            std::ofstream out(file);
+            out << "class A {};\nclass B {};\n";
+        }
+        EXPECT_EQ(analyzer.find_classes(file)["classes"].size(), 2u);
+        EXPECT_EQ(analyzer.cache_size(), 1u);
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+// Test: DegradedModeFallsBackToLexicalResults - files over the parse limits still answer
+TEST(ASTAnalyzerTest, DegradedModeFallsBackToLexicalResults) {
+    auto dir = std::filesystem::temp_directory_path() / "ast_analyzer_degraded_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto file = dir / "big.cpp";
+    {
+        std::ofstream out(file);
+        out << "#include <vector>\n#include \"big.hpp\"\nclass A {};\nvoid f() {}\n";
+    }
+
+    ParseLimits limits;
+    limits.max_file_bytes = 32;
+    ParseGuard::set_limits(limits);
+
+    ASTAnalyzer analyzer;
+    auto includes = analyzer.find_includes(file);
+    EXPECT_TRUE(includes["success"].get<bool>());
+    EXPECT_TRUE(includes["degraded"].get<bool>());
+    EXPECT_EQ(includes["degraded_reason"], "too_large");
+    ASSERT_EQ(includes["includes"].size(), 2u);
+    EXPECT_EQ(includes["includes"][1]["text"], "#include \"big.hpp\"");
+    EXPECT_EQ(includes["includes"][1]["line"], 1);
+
+    auto classes = analyzer.find_classes(file);
+    EXPECT_TRUE(classes["degraded"].get<bool>());
+    EXPECT_TRUE(classes["classes"].empty());
+    EXPECT_EQ(analyzer.cache_size(), 0u);
+
+    auto query = analyzer.execute_query(file, "(class_specifier) @c");
+    EXPECT_FALSE(query["success"].get<bool>());
+
+    ParseGuard::set_limits(ParseLimits{});
+    analyzer.clear_cache();
+    EXPECT_EQ(analyzer.find_classes(file)["classes"].size(), 1u);
+    EXPECT_FALSE(analyzer.find_classes(file).contains("degraded"));
+
+    std::filesystem::remove_all(dir);
+}
+
+// Test: TwoTierCache - evicted trees keep their facts; facts follow content changes
+TEST(ASTAnalyzerTest, TwoTierCache) {
+    auto dir = std::filesystem::temp_directory_path() / "ast_analyzer_two_tier_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::vector<std::filesystem::path> files;
+    for (int i = 0; i < 4; ++i) {
+        files.push_back(dir / ("f" + std::to_string(i) + ".cpp"));
+        std::ofstream(files.back()) << "class C" << i << " {};\n";
+    }
+
+    ASTAnalyzer analyzer;
+    CacheLimits limits;
+    limits.max_trees = 2;
+    analyzer.set_cache_limits(limits);
+
+    for (const auto& file : files) {
+        EXPECT_EQ(analyzer.find_classes(file)["classes"].size(), 1u);
+    }
+    EXPECT_EQ(analyzer.cache_size(), 2u);
+    EXPECT_EQ(analyzer.fact_record_count(), 4u);
+
+    auto hot_files = [&] {
+        std::set<std::string> paths;
+        for (const auto& entry : analyzer.memory_usage(10)["top_files"]) {
+            paths.insert(entry["path"].get<std::string>());
+        }
+        return paths;
+    };
+    ASSERT_EQ(hot_files().count(files[0].string()), 0u);
+
+    // Answered from the warm tier: the evicted tree is not re-parsed
+    EXPECT_EQ(analyzer.find_classes(files[0])["classes"][0]["name"], "C0");
+    EXPECT_EQ(hot_files().count(files[0].string()), 0u);
+    EXPECT_GT(analyzer.memory_usage(0)["fact_bytes"].get<size_t>(), 0u);
+
+    std::ofstream(files[0]) << "class C0 {};\nclass D0 {};\n";
+    EXPECT_EQ(analyzer.find_classes(files[0])["classes"].size(), 2u);
+    EXPECT_EQ(hot_files().count(files[0].string()), 1u);
+    EXPECT_EQ(analyzer.cache_size(), 2u);
+
+    limits.max_fact_bytes = 1;
+    analyzer.set_cache_limits(limits);
+    analyzer.find_functions(files[1]);
+    EXPECT_EQ(analyzer.fact_record_count(), 1u) << "Only the newest record survives a tiny budget";
+
+    analyzer.clear_cache();
+    EXPECT_EQ(analyzer.fact_record_count(), 0u);
+    std::filesystem::remove_all(dir);
+}
+
+// Test: IdenticalContentIsParsedOnce - copies and symlinks share one document
+TEST(ASTAnalyzerTest, IdenticalContentIsParsedOnce) {
+    auto dir = std::filesystem::temp_directory_path() / "ast_analyzer_dedupe_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "vendor");
+    std::vector<std::filesystem::path> files = {dir / "a.hpp", dir / "b.hpp", dir / "vendor" / "a.hpp"};
+    for (const auto& file : files) {
+        std::ofstream(file) << "class Shared {};\n";
+    }
+    std::filesystem::create_symlink(dir / "a.hpp", dir / "link.hpp");
+    files.push_back(dir / "link.hpp");
+
+    ASTAnalyzer analyzer;
+    for (const auto& file : files) {
+        EXPECT_EQ(analyzer.execute_query(file, "(class_specifier) @c")["matches"].size(), 1u);
+    }
+    EXPECT_EQ(analyzer.cache_size(), 4u);
+    EXPECT_EQ(analyzer.document_count(), 1u);
+
+    json usage = analyzer.memory_usage(5);
+    EXPECT_EQ(usage["unique_documents"], 1);
+    ASSERT_EQ(usage["top_files"].size(), 1u);
+    EXPECT_EQ(usage["top_files"][0]["shared_by"], 4);
+
+    // Changing one copy gives it its own document; the others keep theirs
+    std::ofstream(files[1]) << "class Shared {};\nclass Extra {};\n";
+    std::filesystem::last_write_time(files[1], std::filesystem::last_write_time(files[0]) + std::chrono::seconds(1));
+    EXPECT_EQ(analyzer.execute_query(files[1], "(class_specifier) @c")["matches"].size(), 2u);
+    EXPECT_EQ(analyzer.execute_query(files[2], "(class_specifier) @c")["matches"].size(), 1u);
+    EXPECT_EQ(analyzer.document_count(), 2u);
+
+    // Evicting down to one document drops every path of the others
+    CacheLimits limits;
+    limits.max_trees = 1;
+    analyzer.set_cache_limits(limits);
+    std::ofstream(dir / "c.hpp") << "struct C {};\n";
+    analyzer.execute_query(dir / "c.hpp", "(struct_specifier) @s");
+    EXPECT_EQ(analyzer.document_count(), 1u);
+    EXPECT_EQ(analyzer.cache_size(), 1u);
+
+    std::filesystem::remove_all(dir);
+}
+
+// Test: SnapshotsSurviveUpdates - a reader keeps its version while the file is re-parsed and evicted
+TEST(ASTAnalyzerTest, SnapshotsSurviveUpdates) {
+    auto dir = std::filesystem::temp_directory_path() / "ast_analyzer_snapshot_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto file = dir / "a.hpp";
+    std::ofstream(file) << "class A {};\n";
+
+    ASTAnalyzer analyzer;
+    auto snapshot = analyzer.snapshot(file);
+    ASSERT_TRUE(snapshot.has_value());
+    TSNode root = snapshot->tree().root_node();
+
+    // Rewritten and re-parsed: the cache moves on, the snapshot does not
+    std::ofstream(file) << "class A {};\nclass B {};\n";
+    std::filesystem::last_write_time(file, std::filesystem::last_write_time(file) + std::chrono::seconds(1));
+    EXPECT_EQ(analyzer.execute_query(file, "(class_specifier) @c")["matches"].size(), 2u);
+    EXPECT_EQ(analyzer.document_count(), 1u);
+
+    analyzer.clear_cache();
+    EXPECT_EQ(snapshot->source(), "class A {};\n");
+    EXPECT_STREQ(ts_node_type(root), "translation_unit");
+    EXPECT_FALSE(ts_node_has_error(root));
+
+    QueryEngine engine;
+    auto query = engine.compile_query("(class_specifier) @c", snapshot->language());
+    ASSERT_TRUE(query);
+    EXPECT_EQ(engine.execute(snapshot->tree(), *query, snapshot->source()).size(), 1u);
+
+    // Readers on other threads see one version or the other, never a mix
+    std::atomic<bool> stop{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            QueryEngine reader_engine;
+            auto reader_query = reader_engine.compile_query("(class_specifier) @c", Language::CPP);
+            while (!stop) {
+                auto current = analyzer.snapshot(file);
+                if (!current) {
+                    continue;  // Between truncation and write
+                }
+                size_t classes = reader_engine.execute(current->tree(), *reader_query, current->source()).size();
+                size_t expected = static_cast<size_t>(std::count(current->source().begin(),
+                                                                 current->source().end(), '\n'));
+                if (classes != expected) {
+                    bad++;
+                }
+            }
+        });
+    }
+    auto base_mtime = std::filesystem::last_write_time(file);
+    for (int round = 0; round < 20; ++round) {
+        // Replaced by rename, so readers never parse a half-written file
+        auto temp = dir / "a.hpp.tmp";
+        {
+            std::ofstream out(temp);
+            for (int c = 0; c <= round % 3; ++c) {
+                out << "class C" << c << " {};\n";
+            }
+        }
+        std::filesystem::last_write_time(temp, base_mtime + std::chrono::seconds(round + 2));
+        std::filesystem::rename(temp, file);
+        analyzer.execute_query(file, "(class_specifier) @c");
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(bad, 0);
+
+    std::filesystem::remove_all(dir);
+}
+
+// Test: ConcurrentFirstLoadsShareOneDocument - threads parsing the same file at once publish one document
+TEST(ASTAnalyzerTest, ConcurrentFirstLoadsShareOneDocument) {
+    auto dir = std::filesystem::temp_directory_path() / "ast_analyzer_concurrent_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto file = dir / "a.hpp";
+    std::ofstream(file) << "class A {};\n";
+
+    ASTAnalyzer analyzer;
+    std::vector<std::optional<DocumentSnapshot>> snapshots(8);
+    std::vector<std::thread> threads;
+    for (auto& snapshot : snapshots) {
+        threads.emplace_back([&] { snapshot = analyzer.snapshot(file); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(analyzer.cache_size(), 1u);
+    EXPECT_EQ(analyzer.document_count(), 1u);
+    for (const auto& snapshot : snapshots) {
+        ASSERT_TRUE(snapshot.has_value());
+        // Parses that lost the race were dropped for the published document
+        EXPECT_EQ(snapshot->source().data(), snapshots[0]->source().data());
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+// Test: DefinitionFactsFollowEdits - after an edit only the touched definition is recomputed
+TEST(ASTAnalyzerTest, DefinitionFactsFollowEdits) {
+    auto dir = std::filesystem::temp_directory_path() / "ast_analyzer_definitions_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto file = dir / "a.cpp";
+    std::ofstream(file) << "namespace n {\n"
+                           "// First\n"
+                           "int first() { return 1; }\n"
+                           "int second() { return 2; }\n"
+                           "int third() { return 3; }\n"
+                           "}\n";
+
+    int computed = 0;
+    auto compute = [&](TSNode unit, std::string_view source) {
+        computed++;
+        uint32_t start = ts_node_start_byte(unit);
+        return json::array({{
+            {"line", ts_node_start_point(unit).row},
+            {"text", std::string(source.substr(start, ts_node_end_byte(unit) - start))}
+        }});
+    };
+
+    ASTAnalyzer analyzer;
+    auto before = analyzer.snapshot(file);
+    ASSERT_TRUE(before.has_value());
+    json facts = analyzer.definition_facts(*before, file, "test", compute);
+    ASSERT_EQ(facts.size(), 3u);
+    EXPECT_EQ(computed, 3);
+    EXPECT_EQ(facts[2]["line"], 4);
+
+    // Unchanged content: everything is reused
+    analyzer.definition_facts(*before, file, "test", compute);
+    EXPECT_EQ(computed, 3);
+
+    // One more line in second(): third() keeps its facts, one line further down
+    std::ofstream(file) << "namespace n {\n"
+                           "// First\n"
+                           "int first() { return 1; }\n"
+                           "int second() {\n  return 22;\n}\n"
+                           "int third() { return 3; }\n"
+                           "}\n";
+    std::filesystem::last_write_time(file, std::filesystem::last_write_time(file) + std::chrono::seconds(1));
+    auto after = analyzer.snapshot(file);
+    ASSERT_TRUE(after.has_value());
+    ASSERT_NE(after->delta(), nullptr);
+    EXPECT_EQ(after->delta()->previous, before->content_id());
+
+    computed = 0;
+    facts = analyzer.definition_facts(*after, file, "test", compute);
+    EXPECT_EQ(computed, 1);
+
+    // Same as computing from scratch
+    ASTAnalyzer fresh;
+    int fresh_computed = 0;
+    auto fresh_snapshot = fresh.snapshot(file);
+    ASSERT_TRUE(fresh_snapshot.has_value());
+    json expected = fresh.definition_facts(*fresh_snapshot, file, "test", [&](TSNode unit, std::string_view source) {
+        fresh_computed++;
+        return compute(unit, source);
+    });
+    EXPECT_EQ(fresh_computed, 3);
+    EXPECT_EQ(facts, expected);
+    EXPECT_EQ(facts[2]["line"], 6);
+
+    std::filesystem::remove_all(dir);
+}
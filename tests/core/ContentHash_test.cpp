@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include "core/ContentHash.hpp"
+#include <string>
+
+using namespace ts_mcp;
+
+TEST(ContentHashTest, Sha1KnownVectors) {
+    EXPECT_EQ(ContentHash::sha1("").to_hex(), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    EXPECT_EQ(ContentHash::sha1("abc").to_hex(), "a9993e364706816aba3e25717850c26c9cd0d89d");
+    EXPECT_EQ(ContentHash::sha1("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq").to_hex(),
+              "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+    EXPECT_EQ(ContentHash::sha1(std::string(1000000, 'a')).to_hex(),
+              "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+}
+
+TEST(ContentHashTest, GitBlobIdsMatchGit) {
+    // Values from `git hash-object`
+    EXPECT_EQ(ContentHash::git_blob_id("").to_hex(), "e69de29bb2d1d6434b8b29ae775ad8c2e48c5391");
+    EXPECT_EQ(ContentHash::git_blob_id("hello\n").to_hex(), "ce013625030ba8dba906f756967f9e9ca394464a");
+}
+
+TEST(ContentHashTest, HexRoundTrip) {
+    auto id = ContentHash::git_blob_id("class A {};");
+    auto parsed = ObjectId::from_hex(id.to_hex());
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(*parsed, id);
+    EXPECT_FALSE(id.is_zero());
+    EXPECT_TRUE(ObjectId{}.is_zero());
+
+    EXPECT_FALSE(ObjectId::from_hex("abc").has_value());
+    EXPECT_FALSE(ObjectId::from_hex(std::string(40, 'g')).has_value());
+}
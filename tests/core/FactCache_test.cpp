@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "core/FactCache.hpp"
+#include <filesystem>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+class FactCacheTest : public ::testing::Test {
+protected:
+    fs::path test_dir_;
+    fs::path cache_dir_;
+    fs::path source_;
+
+    void SetUp() override {
+        test_dir_ = fs::temp_directory_path() / "fact_cache_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_);
+        cache_dir_ = test_dir_ / "cache";
+        source_ = test_dir_ / "a.cpp";
+        std::ofstream(source_) << "class A {};\n";
+    }
+
+    void TearDown() override {
+        fs::remove_all(test_dir_);
+    }
+
+    fs::path cache_file() const { return cache_dir_ / "facts-v1.bin"; }
+};
+
+TEST_F(FactCacheTest, HitsOnlyForSameContent) {
+    FactCache cache(cache_dir_);
+    auto id = ContentHash::git_blob_id("class A {};\n");
+    json facts = {{"classes", json::array({{{"name", "A"}, {"line", 1}}})}};
+
+    EXPECT_FALSE(cache.get(source_, "classes/cpp", id).has_value());
+    cache.put(source_, "classes/cpp", id, facts);
+
+    auto hit = cache.get(source_, "classes/cpp", id);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(*hit, facts);
+
+    EXPECT_FALSE(cache.get(source_, "classes/cpp", ContentHash::git_blob_id("class B {};\n")).has_value());
+    EXPECT_FALSE(cache.get(source_, "functions/cpp", id).has_value());
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.writes, 1u);
+}
+
+TEST_F(FactCacheTest, PersistsAcrossReopen) {
+    auto old_id = ContentHash::git_blob_id("old");
+    auto new_id = ContentHash::git_blob_id("new");
+    {
+        FactCache cache(cache_dir_);
+        cache.put(source_, "includes/cpp", old_id, json{{"includes", json::array({"a.h"})}});
+        cache.put(source_, "includes/cpp", new_id, json{{"includes", json::array({"b.h"})}});
+        EXPECT_GT(cache.stats().dead_bytes, 0u);
+    }
+
+    FactCache reopened(cache_dir_);
+    EXPECT_EQ(reopened.stats().entries, 1u);
+    EXPECT_FALSE(reopened.get(source_, "includes/cpp", old_id).has_value());
+    auto hit = reopened.get(source_, "includes/cpp", new_id);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ((*hit)["includes"][0], "b.h");
+}
+
+TEST_F(FactCacheTest, DiscardsIncompatibleFile) {
+    fs::create_directories(cache_dir_);
+    std::ofstream(cache_file(), std::ios::binary) << "not a fact cache, just some bytes";
+
+    FactCache cache(cache_dir_);
+    EXPECT_EQ(cache.stats().entries, 0u);
+    EXPECT_EQ(fs::file_size(cache_file()), 32u);
+
+    auto id = ContentHash::git_blob_id("x");
+    cache.put(source_, "classes/cpp", id, json::array());
+    EXPECT_TRUE(cache.get(source_, "classes/cpp", id).has_value());
+}
+
+TEST_F(FactCacheTest, DropsTornTail) {
+    auto id = ContentHash::git_blob_id("x");
+    uintmax_t complete_size;
+    {
+        FactCache cache(cache_dir_);
+        cache.put(source_, "classes/cpp", id, json{{"n", 1}});
+        complete_size = cache.stats().file_bytes;
+    }
+
+    // A crash in the middle of an append
+    std::ofstream(cache_file(), std::ios::binary | std::ios::app) << std::string(40, '\x7f');
+
+    FactCache cache(cache_dir_);
+    EXPECT_EQ(fs::file_size(cache_file()), complete_size);
+    auto hit = cache.get(source_, "classes/cpp", id);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ((*hit)["n"], 1);
+}
+
+TEST_F(FactCacheTest, NeverShrinksAFileOthersMayHaveMapped) {
+    fs::create_directories(cache_dir_);
+    std::string garbage(8192, 'x');
+    std::ofstream(cache_file(), std::ios::binary) << garbage;
+
+    // Another process reading the old file
+    int fd = ::open(cache_file().c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    auto* mapped = static_cast<const char*>(::mmap(nullptr, garbage.size(), PROT_READ, MAP_SHARED, fd, 0));
+    ASSERT_NE(mapped, MAP_FAILED);
+
+    FactCache cache(cache_dir_);
+    EXPECT_EQ(fs::file_size(cache_file()), 32u);
+
+    struct stat st{};
+    ASSERT_EQ(::fstat(fd, &st), 0);
+    EXPECT_EQ(static_cast<size_t>(st.st_size), garbage.size());
+    EXPECT_EQ(std::string(mapped, garbage.size()), garbage);
+
+    ::munmap(const_cast<char*>(mapped), garbage.size());
+    ::close(fd);
+}
+
+TEST_F(FactCacheTest, CompactionDropsDeadRecordsAndDeletedFiles) {
+    auto gone = test_dir_ / "gone.cpp";
+    std::ofstream(gone) << "int x;\n";
+
+    FactCache cache(cache_dir_);
+    for (int i = 0; i < 10; ++i) {
+        cache.put(source_, "analysis/cpp", ContentHash::git_blob_id(std::to_string(i)),
+                  json{{"version", i}});
+    }
+    cache.put(gone, "analysis/cpp", ContentHash::git_blob_id("gone"), json{{"version", 0}});
+    fs::remove(gone);
+
+    auto before = cache.stats();
+    cache.compact();
+    auto after = cache.stats();
+
+    EXPECT_EQ(after.entries, 1u);
+    EXPECT_EQ(after.dead_bytes, 0u);
+    EXPECT_LT(after.file_bytes, before.file_bytes);
+
+    auto hit = cache.get(source_, "analysis/cpp", ContentHash::git_blob_id("9"));
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ((*hit)["version"], 9);
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include "core/FileInventory.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+
+class FileInventoryTest : public ::testing::Test {
+protected:
+    fs::path test_dir_;
+
+    void SetUp() override {
+        test_dir_ = fs::canonical(fs::temp_directory_path()) / "file_inventory_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_ / "src" / "detail");
+        fs::create_directories(test_dir_ / "scripts");
+
+        create_file(test_dir_ / "main.cpp", "int main() {}");
+        create_file(test_dir_ / "src" / "a.hpp", "class A {};");
+        create_file(test_dir_ / "src" / "detail" / "impl.cpp", "void f() {}");
+        create_file(test_dir_ / "scripts" / "gen.py", "print(1)");
+    }
+
+    void TearDown() override {
+        fs::remove_all(test_dir_);
+    }
+
+    void create_file(const fs::path& path, const std::string& content) {
+        std::ofstream file(path);
+        file << content;
+    }
+
+    // Move every directory mtime out of the racy window so that an
+    // unchanged tree is not re-listed
+    void age_directories() {
+        auto past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+        fs::last_write_time(test_dir_, past);
+        for (const auto& entry : fs::recursive_directory_iterator(test_dir_)) {
+            if (entry.is_directory()) {
+                fs::last_write_time(entry.path(), past);
+            }
+        }
+    }
+
+    static std::vector<std::string> names(std::vector<fs::path> paths) {
+        std::vector<std::string> result;
+        for (const auto& path : paths) {
+            result.push_back(path.filename().string());
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+TEST_F(FileInventoryTest, BuildsListingWithLanguages) {
+    FileInventory inventory(test_dir_);
+
+    EXPECT_EQ(inventory.file_count(), 4);
+    EXPECT_EQ(inventory.directory_count(), 4);
+    EXPECT_TRUE(inventory.contains_directory("src/detail/"));
+
+    auto impl = inventory.find("src/detail/impl.cpp");
+    ASSERT_TRUE(impl.has_value());
+    EXPECT_EQ(impl->language, Language::CPP);
+    EXPECT_EQ(impl->size, 11);
+    EXPECT_EQ(inventory.find("scripts/gen.py")->language, Language::PYTHON);
+    EXPECT_FALSE(inventory.find("missing.cpp").has_value());
+}
+
+TEST_F(FileInventoryTest, QueriesSubtreesWithGlobs) {
+    FileInventory inventory(test_dir_);
+    GlobSet cpp({"*.cpp", "*.hpp"});
+
+    EXPECT_EQ(names(inventory.query("", true, cpp)),
+              (std::vector<std::string>{"a.hpp", "impl.cpp", "main.cpp"}));
+    EXPECT_EQ(names(inventory.query("", false, cpp)),
+              (std::vector<std::string>{"main.cpp"}));
+    EXPECT_EQ(names(inventory.query("src/", true, cpp)),
+              (std::vector<std::string>{"a.hpp", "impl.cpp"}));
+
+    // Path patterns are relative to the queried directory
+    GlobSet path_glob({"detail/*.cpp"});
+    EXPECT_EQ(names(inventory.query("src/", true, path_glob)),
+              (std::vector<std::string>{"impl.cpp"}));
+}
+
+TEST_F(FileInventoryTest, UnchangedTreeIsNotRelisted) {
+    age_directories();
+    FileInventory inventory(test_dir_);
+
+    auto stats = inventory.refresh();
+    EXPECT_EQ(stats.directories_checked, 4);
+    EXPECT_EQ(stats.directories_relisted, 0);
+    EXPECT_FALSE(stats.rebuilt);
+}
+
+TEST_F(FileInventoryTest, RefreshTracksAddedAndRemovedEntries) {
+    age_directories();
+    FileInventory inventory(test_dir_);
+    auto id_before = inventory.find("main.cpp")->id;
+
+    create_file(test_dir_ / "src" / "b.cpp", "class B {};");
+    fs::create_directories(test_dir_ / "src" / "fresh" / "deeper");
+    create_file(test_dir_ / "src" / "fresh" / "deeper" / "c.cpp", "");
+    fs::remove_all(test_dir_ / "scripts");
+
+    auto stats = inventory.refresh();
+    EXPECT_EQ(stats.files_added, 2);
+    EXPECT_EQ(stats.files_removed, 1);
+    EXPECT_FALSE(stats.rebuilt);
+
+    EXPECT_TRUE(inventory.find("src/b.cpp").has_value());
+    EXPECT_TRUE(inventory.find("src/fresh/deeper/c.cpp").has_value());
+    EXPECT_FALSE(inventory.find("scripts/gen.py").has_value());
+    EXPECT_FALSE(inventory.contains_directory("scripts/"));
+    EXPECT_EQ(inventory.find("main.cpp")->id, id_before);
+}
+
+TEST_F(FileInventoryTest, IgnoreFileChangeRebuilds) {
+    FileInventory inventory(test_dir_);
+    ASSERT_TRUE(inventory.find("src/detail/impl.cpp").has_value());
+
+    create_file(test_dir_ / ".gitignore", "detail/\n");
+    auto stats = inventory.refresh();
+
+    EXPECT_TRUE(stats.rebuilt);
+    EXPECT_FALSE(inventory.find("src/detail/impl.cpp").has_value());
+    EXPECT_FALSE(inventory.contains_directory("src/detail/"));
+    EXPECT_TRUE(inventory.find("src/a.hpp").has_value());
+}
+
+TEST_F(FileInventoryTest, NotifyChangedRestatsInPlaceEdits) {
+    age_directories();
+    FileInventory inventory(test_dir_);
+
+    // Editing a file in place leaves the directory mtime untouched
+    create_file(test_dir_ / "src" / "a.hpp", "class A { int x; };");
+    inventory.refresh();
+    EXPECT_EQ(inventory.find("src/a.hpp")->size, 11);
+
+    inventory.notify_changed(test_dir_ / "src" / "a.hpp");
+    auto stats = inventory.refresh();
+    EXPECT_GE(stats.directories_relisted, 1);
+    EXPECT_EQ(inventory.find("src/a.hpp")->size, 19);
+}
+
+TEST_F(FileInventoryTest, WatchedRefreshOnlyRelistsNotifiedDirectories) {
+    age_directories();
+    FileInventory inventory(test_dir_);
+    inventory.refresh();
+
+    create_file(test_dir_ / "src" / "new.cpp", "");
+
+    // Without a notification the watched refresh does not look at the disk
+    auto quiet = inventory.refresh(false);
+    EXPECT_EQ(quiet.directories_checked, 0);
+    EXPECT_FALSE(inventory.find("src/new.cpp").has_value());
+
+    inventory.notify_changed(test_dir_ / "src" / "new.cpp");
+    auto stats = inventory.refresh(false);
+    EXPECT_EQ(stats.files_added, 1);
+    EXPECT_TRUE(inventory.find("src/new.cpp").has_value());
+
+    // Lost notifications force a full check
+    create_file(test_dir_ / "scripts" / "other.py", "");
+    inventory.invalidate_all();
+    inventory.refresh(false);
+    EXPECT_TRUE(inventory.find("scripts/other.py").has_value());
+}
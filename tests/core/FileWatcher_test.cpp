@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "core/FileWatcher.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+
+class FileWatcherTest : public ::testing::Test {
+protected:
+    fs::path test_dir_;
+    std::mutex mutex_;
+    std::vector<ChangeBatch> batches_;
+
+    void SetUp() override {
+        test_dir_ = fs::canonical(fs::temp_directory_path()) / "file_watcher_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_ / "src");
+        fs::create_directories(test_dir_ / "build" / "obj");
+        create_file(test_dir_ / "src" / "a.cpp", "class A {};");
+    }
+
+    void TearDown() override {
+        fs::remove_all(test_dir_);
+    }
+
+    void create_file(const fs::path& path, const std::string& content) {
+        std::ofstream file(path);
+        file << content;
+    }
+
+    std::unique_ptr<FileWatcher> make_watcher(std::chrono::milliseconds debounce) {
+        auto watcher = std::make_unique<FileWatcher>(test_dir_, debounce);
+        watcher->add_listener([this](const ChangeBatch& batch) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batches_.push_back(batch);
+        });
+        watcher->start();
+        return watcher;
+    }
+
+    bool was_reported(const fs::path& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& batch : batches_) {
+            if (std::find(batch.paths.begin(), batch.paths.end(), path) != batch.paths.end()) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+TEST_F(FileWatcherTest, WatchesTreeExceptExcludedDirectories) {
+    auto watcher = make_watcher(std::chrono::milliseconds(50));
+
+    EXPECT_TRUE(watcher->healthy());
+    EXPECT_TRUE(watcher->is_watching(test_dir_));
+    EXPECT_TRUE(watcher->is_watching(test_dir_ / "src"));
+    EXPECT_FALSE(watcher->is_watching(test_dir_ / "build"));
+    EXPECT_EQ(watcher->watch_count(), 2);
+
+    watcher->stop();
+    EXPECT_FALSE(watcher->healthy());
+}
+
+TEST_F(FileWatcherTest, SyncDeliversCoalescedChanges) {
+    // Long debounce: only sync() can deliver within the test
+    auto watcher = make_watcher(std::chrono::seconds(60));
+
+    for (int i = 0; i < 5; i++) {
+        create_file(test_dir_ / "src" / "a.cpp", "class A { int x" + std::to_string(i) + "; };");
+    }
+    create_file(test_dir_ / "b.cpp", "");
+    watcher->sync();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT_EQ(batches_.size(), 1);
+    EXPECT_FALSE(batches_[0].overflow);
+    EXPECT_EQ(batches_[0].paths,
+              (std::vector<fs::path>{test_dir_ / "b.cpp", test_dir_ / "src" / "a.cpp"}));
+    EXPECT_EQ(watcher->generation(), 1);
+}
+
+TEST_F(FileWatcherTest, NewDirectoriesAreWatched) {
+    auto watcher = make_watcher(std::chrono::seconds(60));
+
+    fs::create_directories(test_dir_ / "src" / "fresh");
+    watcher->sync();
+    EXPECT_TRUE(watcher->is_watching(test_dir_ / "src" / "fresh"));
+
+    create_file(test_dir_ / "src" / "fresh" / "c.cpp", "");
+    watcher->sync();
+    EXPECT_TRUE(was_reported(test_dir_ / "src" / "fresh" / "c.cpp"));
+
+    fs::remove_all(test_dir_ / "src" / "fresh");
+    watcher->sync();
+    EXPECT_TRUE(was_reported(test_dir_ / "src" / "fresh"));
+    EXPECT_FALSE(watcher->is_watching(test_dir_ / "src" / "fresh"));
+}
+
+TEST_F(FileWatcherTest, BackgroundThreadFlushesAfterDebounce) {
+    auto watcher = make_watcher(std::chrono::milliseconds(20));
+
+    create_file(test_dir_ / "src" / "a.cpp", "class A { int y; };");
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (watcher->generation() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(was_reported(test_dir_ / "src" / "a.cpp"));
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "core/GitIndex.hpp"
+#include "core/PathResolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+
+class GitIndexTest : public ::testing::Test {
+protected:
+    fs::path test_dir_;
+
+    void SetUp() override {
+        if (std::system("git --version > /dev/null 2>&1") != 0) {
+            GTEST_SKIP() << "git is not available";
+        }
+
+        test_dir_ = fs::canonical(fs::temp_directory_path()) / "git_index_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_ / "src" / "detail");
+        fs::create_directories(test_dir_ / "third_party");
+
+        create_file(test_dir_ / "main.cpp", "int main() {}\n");
+        create_file(test_dir_ / "src" / "a.hpp", "class A {};\n");
+        create_file(test_dir_ / "src" / "detail" / "impl.cpp", "void f() {}\n");
+        create_file(test_dir_ / "third_party" / "lib.cpp", "void g() {}\n");
+        create_file(test_dir_ / "notes.txt", "tracked\n");
+
+        // Keep file mtimes clearly older than the index so entries are not racy
+        auto past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+        for (const auto& entry : fs::recursive_directory_iterator(test_dir_)) {
+            if (entry.is_regular_file()) {
+                fs::last_write_time(entry.path(), past);
+            }
+        }
+
+        git("init -q");
+        git("add .");
+        create_file(test_dir_ / "untracked.cpp", "class U {};\n");
+    }
+
+    void TearDown() override {
+        PathResolver::set_git_index_enabled(false);
+        if (!test_dir_.empty()) {
+            fs::remove_all(test_dir_);
+        }
+    }
+
+    void git(const std::string& args) {
+        std::string command = "git -C '" + test_dir_.string() + "' " + args + " > /dev/null 2>&1";
+        ASSERT_EQ(std::system(command.c_str()), 0) << command;
+    }
+
+    void create_file(const fs::path& path, const std::string& content) {
+        std::ofstream file(path);
+        file << content;
+    }
+
+    static std::vector<std::string> names(const std::vector<fs::path>& paths) {
+        std::vector<std::string> result;
+        for (const auto& path : paths) {
+            result.push_back(path.filename().string());
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+TEST_F(GitIndexTest, ListsTrackedFiles) {
+    GitIndex index(test_dir_);
+    GlobSet cpp({"*.cpp", "*.hpp"});
+
+    EXPECT_EQ(index.size(), 5);
+    EXPECT_EQ(names(index.query("", true, cpp)),
+              (std::vector<std::string>{"a.hpp", "impl.cpp", "main.cpp"}));
+    EXPECT_EQ(names(index.query("", false, cpp)),
+              (std::vector<std::string>{"main.cpp"}));
+    EXPECT_EQ(names(index.query("src/", true, cpp)),
+              (std::vector<std::string>{"a.hpp", "impl.cpp"}));
+
+    // Excluded directories are skipped below the queried directory only
+    EXPECT_EQ(names(index.query("third_party/", true, cpp)),
+              (std::vector<std::string>{"lib.cpp"}));
+
+    auto results = index.query("src/", true, cpp);
+    ASSERT_FALSE(results.empty());
+    EXPECT_EQ(results.front(), test_dir_ / "src" / "a.hpp");
+}
+
+TEST_F(GitIndexTest, ReadsIndexVersion4) {
+    git("update-index --index-version 4");
+    GitIndex index(test_dir_);
+
+    EXPECT_EQ(index.version(), 4);
+    EXPECT_NE(index.find("src/detail/impl.cpp"), nullptr);
+    EXPECT_EQ(names(index.query("src/", true, GlobSet({"*.cpp"}))),
+              (std::vector<std::string>{"impl.cpp"}));
+}
+
+TEST_F(GitIndexTest, BlobIdOnlyForUnchangedFiles) {
+    GitIndex index(test_dir_);
+    WalkEntry stat;
+
+    ASSERT_TRUE(DirectoryWalker::stat_path(test_dir_ / "src" / "a.hpp", stat));
+    auto id = index.blob_id_if_unchanged("src/a.hpp", stat);
+    ASSERT_TRUE(id.has_value());
+    EXPECT_EQ(*id, ContentHash::git_blob_id("class A {};\n"));
+
+    create_file(test_dir_ / "src" / "a.hpp", "class A { int x; };\n");
+    ASSERT_TRUE(DirectoryWalker::stat_path(test_dir_ / "src" / "a.hpp", stat));
+    EXPECT_FALSE(index.blob_id_if_unchanged("src/a.hpp", stat).has_value());
+
+    ASSERT_TRUE(DirectoryWalker::stat_path(test_dir_ / "untracked.cpp", stat));
+    EXPECT_FALSE(index.blob_id_if_unchanged("untracked.cpp", stat).has_value());
+}
+
+TEST_F(GitIndexTest, DetectsRewrittenIndex) {
+    GitIndex index(test_dir_);
+    EXPECT_TRUE(index.is_current());
+
+    git("add untracked.cpp");
+    EXPECT_FALSE(index.is_current());
+    EXPECT_EQ(GitIndex(test_dir_).size(), 6);
+}
+
+TEST_F(GitIndexTest, PathResolverListsFromIndex) {
+    PathResolver::set_git_index_enabled(true);
+
+    auto results = PathResolver::resolve_paths({(test_dir_ / "src").string()}, true);
+    EXPECT_EQ(names(results), (std::vector<std::string>{"a.hpp", "impl.cpp"}));
+
+    // Untracked files are not listed; the index is reloaded after git add
+    results = PathResolver::resolve_paths({test_dir_.string()}, false);
+    EXPECT_EQ(names(results), (std::vector<std::string>{"main.cpp"}));
+    git("add untracked.cpp");
+    results = PathResolver::resolve_paths({test_dir_.string()}, false);
+    EXPECT_EQ(names(results), (std::vector<std::string>{"main.cpp", "untracked.cpp"}));
+
+    EXPECT_TRUE(PathResolver::indexed_blob_id(test_dir_ / "main.cpp").has_value());
+    EXPECT_FALSE(PathResolver::indexed_blob_id(test_dir_ / "missing.cpp").has_value());
+}
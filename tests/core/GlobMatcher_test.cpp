@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "core/GlobMatcher.hpp"
+
+using namespace ts_mcp;
+
+TEST(GlobPatternTest, WildcardsDoNotCrossSlash) {
+    GlobPattern star("test_*.hpp");
+    EXPECT_TRUE(star.matches("test_.hpp"));
+    EXPECT_TRUE(star.matches("test_parser.hpp"));
+    EXPECT_FALSE(star.matches("test_parser.cpp"));
+    EXPECT_FALSE(star.matches("test_a/b.hpp"));
+
+    GlobPattern any("a?c.h");
+    EXPECT_TRUE(any.matches("abc.h"));
+    EXPECT_FALSE(any.matches("ac.h"));
+    EXPECT_FALSE(any.matches("a/c.h"));
+}
+
+TEST(GlobPatternTest, CharacterClassesAndEscapes) {
+    GlobPattern range("file[0-9].[ch]");
+    EXPECT_TRUE(range.matches("file3.c"));
+    EXPECT_TRUE(range.matches("file9.h"));
+    EXPECT_FALSE(range.matches("filex.c"));
+    EXPECT_FALSE(range.matches("file3.cpp"));
+
+    GlobPattern negated("[!_]*.cpp");
+    EXPECT_TRUE(negated.matches("main.cpp"));
+    EXPECT_FALSE(negated.matches("_internal.cpp"));
+
+    GlobPattern escaped("a\\*b");
+    EXPECT_TRUE(escaped.matches("a*b"));
+    EXPECT_FALSE(escaped.matches("axb"));
+
+    GlobPattern unterminated("[abc");
+    EXPECT_TRUE(unterminated.matches("[abc"));
+}
+
+TEST(GlobPatternTest, GlobstarMatchesZeroOrMoreDirectories) {
+    GlobPattern pattern(std::string("src/**") + "/*.cpp");
+    EXPECT_TRUE(pattern.matches("src/a.cpp"));
+    EXPECT_TRUE(pattern.matches("src/x/y/a.cpp"));
+    EXPECT_FALSE(pattern.matches("lib/a.cpp"));
+    EXPECT_FALSE(pattern.matches("src/a.hpp"));
+
+    GlobPattern trailing("gen/**");
+    EXPECT_TRUE(trailing.matches("gen/a"));
+    EXPECT_TRUE(trailing.matches("gen/a/b.cpp"));
+    EXPECT_FALSE(trailing.matches("other/gen/a"));
+}
+
+TEST(GlobPatternTest, GlobstarSlashNeedsWholeDirectories) {
+    GlobPattern leading("**/a.cpp");
+    EXPECT_TRUE(leading.matches("a.cpp"));
+    EXPECT_TRUE(leading.matches("x/a.cpp"));
+    EXPECT_FALSE(leading.matches("xa.cpp"));
+
+    GlobPattern inner("src/**/a.cpp");
+    EXPECT_TRUE(inner.matches("src/x/a.cpp"));
+    EXPECT_FALSE(inner.matches("src/xa.cpp"));
+
+    GlobPattern between("a/**/b");
+    EXPECT_TRUE(between.matches("a/b"));
+    EXPECT_TRUE(between.matches("a/x/y/b"));
+    EXPECT_FALSE(between.matches("a/xb"));
+
+    GlobPattern both("**/gen/**");
+    EXPECT_TRUE(both.matches("src/gen/a"));
+    EXPECT_FALSE(both.matches("xgen/a"));
+}
+
+TEST(GlobPatternTest, PrefixPruning) {
+    GlobPattern pattern("src/gen/*.cpp");
+    EXPECT_TRUE(pattern.may_match_prefix("src/"));
+    EXPECT_TRUE(pattern.may_match_prefix("src/gen/"));
+    EXPECT_FALSE(pattern.may_match_prefix("docs/"));
+    EXPECT_FALSE(pattern.may_match_prefix("src/gen/deep/"));
+
+    GlobPattern deep(std::string("src/**") + "/*.h");
+    EXPECT_TRUE(deep.may_match_prefix("src/a/b/c/"));
+    EXPECT_FALSE(deep.may_match_prefix("test/"));
+}
+
+TEST(GlobPatternTest, LongPatternsUseFallbackMatcher) {
+    std::string long_name(80, 'x');
+    GlobPattern pattern(long_name + "*.cpp");
+    EXPECT_TRUE(pattern.matches(long_name + ".cpp"));
+    EXPECT_TRUE(pattern.matches(long_name + "_more.cpp"));
+    EXPECT_FALSE(pattern.matches(long_name + ".hpp"));
+    EXPECT_TRUE(pattern.may_match_prefix("anything/"));  // Never prunes
+}
+
+TEST(GlobSetTest, ClassifiesPatternsByShape) {
+    GlobSet globs({"*.cpp", "*.hpp", "CMakeLists.txt", "test_*.h", "*.tar.gz", "src/gen/*.inc"});
+
+    EXPECT_EQ(globs.size(), 6);
+    EXPECT_TRUE(globs.matches("a/b/main.cpp", "main.cpp"));
+    EXPECT_TRUE(globs.matches("CMakeLists.txt", "CMakeLists.txt"));
+    EXPECT_TRUE(globs.matches("x/test_util.h", "test_util.h"));
+    EXPECT_TRUE(globs.matches("dist/pkg.tar.gz", "pkg.tar.gz"));
+    EXPECT_TRUE(globs.matches("src/gen/tables.inc", "tables.inc"));
+    EXPECT_FALSE(globs.matches("lib/tables.inc", "tables.inc"));
+    EXPECT_FALSE(globs.matches("util.h", "util.h"));
+    EXPECT_FALSE(globs.matches("Makefile", "Makefile"));
+}
+
+TEST(GlobSetTest, MayMatchUnderOnlyPrunesForPathPatterns) {
+    GlobSet names({"*.cpp"});
+    EXPECT_TRUE(names.may_match_under("anything/"));
+
+    GlobSet paths({"src/*.cpp", "include/**"});
+    EXPECT_TRUE(paths.may_match_under("src/"));
+    EXPECT_TRUE(paths.may_match_under("include/a/b/"));
+    EXPECT_FALSE(paths.may_match_under("tests/"));
+    EXPECT_FALSE(paths.may_match_under("src/detail/"));
+
+    GlobSet none;
+    EXPECT_TRUE(none.empty());
+    EXPECT_FALSE(none.matches("a.cpp", "a.cpp"));
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "core/IgnoreRules.hpp"
+
+using namespace ts_mcp;
+
+TEST(IgnoreRulesTest, BasenamePatternsMatchAtAnyDepth) {
+    IgnoreRules rules("*.o\nnode_modules/\n# comment\n\ngenerated.cpp\n", "", nullptr);
+
+    EXPECT_EQ(rules.rule_count(), 3);
+    EXPECT_TRUE(rules.is_ignored("a.o", false));
+    EXPECT_TRUE(rules.is_ignored("src/lib/a.o", false));
+    EXPECT_TRUE(rules.is_ignored("web/node_modules", true));
+    EXPECT_FALSE(rules.is_ignored("web/node_modules", false));  // Directory-only rule
+    EXPECT_TRUE(rules.is_ignored("src/generated.cpp", false));
+    EXPECT_FALSE(rules.is_ignored("src/main.cpp", false));
+}
+
+TEST(IgnoreRulesTest, AnchoredPatternsAreRelativeToBase) {
+    IgnoreRules rules("/out\ndocs/*.md\n", "sub/", nullptr);
+
+    EXPECT_TRUE(rules.is_ignored("sub/out", true));
+    EXPECT_FALSE(rules.is_ignored("sub/deeper/out", true));
+    EXPECT_TRUE(rules.is_ignored("sub/docs/a.md", false));
+    EXPECT_FALSE(rules.is_ignored("sub/docs/x/a.md", false));
+    EXPECT_FALSE(rules.is_ignored("other/docs/a.md", false));
+}
+
+TEST(IgnoreRulesTest, GlobstarAndCharacterClasses) {
+    IgnoreRules rules("**/gen/**\nlog[0-9].txt\n", "", nullptr);
+
+    EXPECT_TRUE(rules.is_ignored("gen/a.cpp", false));
+    EXPECT_TRUE(rules.is_ignored("x/y/gen/z/a.cpp", false));
+    EXPECT_TRUE(rules.is_ignored("log7.txt", false));
+    EXPECT_FALSE(rules.is_ignored("logx.txt", false));
+    EXPECT_FALSE(rules.is_ignored("src/xgen/a.cpp", false));
+
+    IgnoreRules directories("**/gen/\n", "", nullptr);
+    EXPECT_TRUE(directories.is_ignored("src/gen", true));
+    EXPECT_FALSE(directories.is_ignored("src/xgen", true));
+}
+
+TEST(IgnoreRulesTest, LastMatchWinsAndChildOverridesParent) {
+    auto parent = std::make_shared<IgnoreRules>("*.cpp\n!keep.cpp\n", "", nullptr);
+    IgnoreRules child("keep.cpp\n!drop_me_not.cpp\n", "lib/", parent);
+
+    EXPECT_TRUE(parent->is_ignored("a.cpp", false));
+    EXPECT_FALSE(parent->is_ignored("keep.cpp", false));
+    EXPECT_TRUE(child.is_ignored("lib/keep.cpp", false));
+    EXPECT_FALSE(child.is_ignored("lib/drop_me_not.cpp", false));
+    EXPECT_TRUE(child.is_ignored("lib/other.cpp", false));
+}
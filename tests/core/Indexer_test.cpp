@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "core/Indexer.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+
+class IndexerTest : public ::testing::Test {
+protected:
+    fs::path test_dir_;
+    std::vector<fs::path> files_;
+
+    void SetUp() override {
+        test_dir_ = fs::temp_directory_path() / "indexer_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_ / "src");
+        for (int i = 0; i < 8; ++i) {
+            auto file = test_dir_ / "src" / ("f" + std::to_string(i) + ".cpp");
+            std::ofstream(file) << "#include <vector>\nclass C" << i << " {};\nvoid g" << i << "() {}\n";
+            files_.push_back(file);
+        }
+    }
+
+    void TearDown() override {
+        fs::remove_all(test_dir_);
+    }
+};
+
+TEST_F(IndexerTest, ServerAnalyzerReusesIndexedFacts) {
+    auto cache = std::make_shared<FactCache>(test_dir_ / "index");
+    Indexer indexer(cache, 4);
+    auto stats = indexer.run(files_);
+
+    EXPECT_EQ(stats.files, files_.size());
+    EXPECT_EQ(stats.failed, 0u);
+    EXPECT_EQ(stats.computed, files_.size() * 4);
+    EXPECT_EQ(cache->stats().entries, files_.size() * 4);
+
+    ASTAnalyzer analyzer;
+    analyzer.set_fact_cache(std::make_shared<FactCache>(test_dir_ / "index"));
+    auto classes = analyzer.find_classes(files_[3]);
+    ASSERT_EQ(classes["classes"].size(), 1u);
+    EXPECT_EQ(analyzer.find_includes(files_[5])["includes"].size(), 1u);
+    EXPECT_EQ(analyzer.cache_size(), 0u) << "Indexed files should not be parsed";
+}
+
+TEST_F(IndexerTest, RerunOnlyComputesChangedFiles) {
+    auto cache = std::make_shared<FactCache>(test_dir_ / "index");
+    Indexer(cache, 2).run(files_);
+
+    std::ofstream(files_[0]) << "class Changed {};\n";
+    auto stats = Indexer(cache, 2).run(files_);
+
+    EXPECT_EQ(stats.computed, 4u);
+    EXPECT_EQ(stats.reused, (files_.size() - 1) * 4);
+}
+
+TEST_F(IndexerTest, ExtraStepsRunForEveryFile) {
+    auto cache = std::make_shared<FactCache>(test_dir_ / "index");
+    Indexer indexer(cache, 3);
+    std::atomic<size_t> calls{0};
+    indexer.add_step([&calls](const std::shared_ptr<ASTAnalyzer>& analyzer, const fs::path& file) {
+        analyzer->cached_facts(file, "test/lines", [] { return json{{"lines", 3}}; });
+        calls++;
+    });
+
+    auto stats = indexer.run(files_);
+    EXPECT_EQ(calls.load(), files_.size());
+    EXPECT_EQ(cache->stats().entries, files_.size() * 5);
+    EXPECT_EQ(stats.failed, 0u);
+}
@@ -0,0 +1,80 @@
+#include "core/Logging.hpp"
+#include <gtest/gtest.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <thread>
+
+using namespace ts_mcp;
+
+class LoggingTest : public ::testing::Test {
+protected:
+    std::ostringstream output;
+    std::shared_ptr<spdlog::logger> previous_;
+
+    void SetUp() override {
+        previous_ = spdlog::default_logger();
+        auto logger = std::make_shared<spdlog::logger>(
+            "logging_test", std::make_shared<spdlog::sinks::ostream_sink_mt>(output));
+        logger->set_pattern("%l %v");
+        spdlog::set_default_logger(logger);
+        WarningSummary::set_interval(std::chrono::milliseconds(1000));
+    }
+
+    void TearDown() override {
+        spdlog::set_default_logger(previous_);
+    }
+
+    std::vector<std::string> lines() const {
+        std::vector<std::string> result;
+        std::istringstream in(output.str());
+        for (std::string line; std::getline(in, line);) {
+            result.push_back(line);
+        }
+        return result;
+    }
+};
+
+TEST_F(LoggingTest, SummaryLogsEachMessageOnceWithItsCount) {
+    {
+        WarningSummary summary("find_references");
+        for (int i = 0; i < 50; ++i) {
+            WarningSummary::note("Parse completed with syntax errors");
+        }
+        WarningSummary::note("Other warning");
+        EXPECT_EQ(summary.count("Parse completed with syntax errors"), 50u);
+        EXPECT_TRUE(output.str().empty()) << "Nothing is logged before the summary ends";
+    }
+
+    std::vector<std::string> expected = {
+        "warning find_references: Parse completed with syntax errors (50 times)",
+        "warning find_references: Other warning"
+    };
+    EXPECT_EQ(lines(), expected);
+}
+
+TEST_F(LoggingTest, SummariesAreThreadLocal) {
+    WarningSummary summary("request");
+    std::thread([] {
+        WarningSummary::note("Noted on another thread");
+    }).join();
+    EXPECT_EQ(summary.count("Noted on another thread"), 0u);
+    EXPECT_EQ(lines(), std::vector<std::string>{"warning Noted on another thread"});
+}
+
+TEST_F(LoggingTest, WithoutSummaryMessagesAreRateLimited) {
+    WarningSummary::set_interval(std::chrono::milliseconds(100));
+    for (int i = 0; i < 20; ++i) {
+        WarningSummary::note("Rate limited warning");
+    }
+    EXPECT_EQ(lines().size(), 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    WarningSummary::note("Rate limited warning");
+
+    std::vector<std::string> expected = {
+        "warning Rate limited warning",
+        "warning Rate limited warning (19 more suppressed)"
+    };
+    EXPECT_EQ(lines(), expected);
+}
@@ -0,0 +1,111 @@
+#include "core/ASTAnalyzer.hpp"
+#include "core/MemoryAccounting.hpp"
+#include "core/TreeSitterParser.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <optional>
+
+using namespace ts_mcp;
+
+namespace {
+
+/**
+ * @brief Installs the tracking allocator before the first test creates a parser
+ */
+class TrackingEnvironment : public ::testing::Environment {
+public:
+    void SetUp() override { TreeSitterMemory::install(); }
+};
+
+const auto* tracking_environment = ::testing::AddGlobalTestEnvironment(new TrackingEnvironment);
+
+const char* SOURCE = R"(
+class Shape {
+public:
+    virtual ~Shape() = default;
+    virtual double area() const = 0;
+};
+
+class Square : public Shape {
+public:
+    explicit Square(double side) : side_(side) {}
+    double area() const override { return side_ * side_; }
+private:
+    double side_;
+};
+)";
+
+} // namespace
+
+TEST(MemoryAccountingTest, ParseIsChargedToTheActiveAccount) {
+    ASSERT_TRUE(TreeSitterMemory::installed());
+    TreeSitterParser parser(Language::CPP);
+    parser.parse_string("int warm_up;");  // Parser buffers are not part of a tree
+
+    MemoryAccount account;
+    std::unique_ptr<Tree> tree;
+    {
+        MemoryAccount::Scope scope(account);
+        tree = parser.parse_string(SOURCE);
+    }
+    ASSERT_NE(tree, nullptr);
+    EXPECT_GT(account.bytes(), 0);
+    EXPECT_GE(TreeSitterMemory::stats().bytes, account.bytes());
+
+    // Allocations outside the scope are not charged
+    int64_t charged = account.bytes();
+    auto other = parser.parse_string(SOURCE);
+    EXPECT_EQ(account.bytes(), charged);
+
+    // The parser may keep a few recycled nodes charged to the account
+    tree.reset();
+    EXPECT_LT(account.bytes(), charged / 2);
+}
+
+TEST(MemoryAccountingTest, AllocationsOutliveTheirAccountHandle) {
+    TreeSitterParser parser(Language::CPP);
+    auto before = TreeSitterMemory::stats();
+
+    std::unique_ptr<Tree> tree;
+    {
+        std::optional<MemoryAccount> account(std::in_place);
+        MemoryAccount::Scope scope(*account);
+        tree = parser.parse_string(SOURCE);
+        account.reset();
+    }
+    ASSERT_NE(tree, nullptr);
+    EXPECT_FALSE(tree->has_error());
+
+    auto during = TreeSitterMemory::stats();
+    EXPECT_GT(during.bytes, before.bytes);
+    EXPECT_GE(during.peak_bytes, during.bytes);
+
+    tree.reset();
+    EXPECT_LT(TreeSitterMemory::stats().bytes, during.bytes);
+}
+
+TEST(MemoryAccountingTest, AnalyzerReportsPerFileUsage) {
+    ASTAnalyzer analyzer;
+    std::filesystem::path fixture_path = "../fixtures/simple_class.cpp";
+    ASSERT_TRUE(std::filesystem::exists(fixture_path));
+
+    analyzer.find_classes(fixture_path);
+    json usage = analyzer.memory_usage(5);
+
+    EXPECT_EQ(usage["documents"], 1);
+    EXPECT_GT(usage["source_bytes"].get<int64_t>(), 0);
+    EXPECT_GT(usage["tree_bytes"].get<int64_t>(), 0);
+    ASSERT_EQ(usage["top_files"].size(), 1u);
+    EXPECT_EQ(usage["top_files"][0]["tree_bytes"], usage["tree_bytes"]);
+
+    analyzer.clear_cache();
+    usage = analyzer.memory_usage(5);
+    EXPECT_EQ(usage["documents"], 0);
+    EXPECT_EQ(usage["tree_bytes"], 0);
+}
+
+TEST(MemoryAccountingTest, HeapBytesIgnoresInlineStrings) {
+    EXPECT_EQ(heap_bytes(std::string("short")), 0u);
+    std::string long_string(1000, 'x');
+    EXPECT_GT(heap_bytes(long_string), long_string.size());
+}
@@ -0,0 +1,160 @@
+#include "core/Metrics.hpp"
+#include "core/MetricsExporter.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+
+TEST(MetricsTest, CounterSumsAcrossThreads) {
+    auto counter = Metrics::counter("test_metrics_threads_total", "test");
+    uint64_t before = counter.value();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([counter] {
+            for (int i = 0; i < 1000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Shards of finished threads still count
+    EXPECT_EQ(counter.value() - before, 4000u);
+}
+
+TEST(MetricsTest, SameNameAndLabelsIsSameMetric) {
+    auto a = Metrics::counter("test_metrics_dedupe_total", "test", {{"tool", "x"}});
+    auto b = Metrics::counter("test_metrics_dedupe_total", "test", {{"tool", "x"}});
+    auto other = Metrics::counter("test_metrics_dedupe_total", "test", {{"tool", "y"}});
+
+    uint64_t before = b.value();
+    a.add(5);
+    EXPECT_EQ(b.value() - before, 5u);
+    EXPECT_EQ(other.value(), 0u);
+
+    EXPECT_THROW(Metrics::gauge("test_metrics_dedupe_total", "test", {{"tool", "x"}}),
+                 std::invalid_argument);
+}
+
+TEST(MetricsTest, HistogramBucketsAreLogLinear) {
+    EXPECT_EQ(Histogram::bucket_index(0), 0u);
+    EXPECT_EQ(Histogram::bucket_index(7), 7u);
+
+    // Every value lies below its bucket's upper bound and at or above the previous one
+    for (uint64_t v : {8ull, 9ull, 15ull, 16ull, 1000ull, 123456789ull, (1ull << 40) + 12345}) {
+        size_t index = Histogram::bucket_index(v);
+        EXPECT_LT(v, Histogram::bucket_upper_bound(index)) << v;
+        ASSERT_GT(index, 0u);
+        EXPECT_GE(v, Histogram::bucket_upper_bound(index - 1)) << v;
+
+        // Relative bucket width is at most 1/8
+        uint64_t width = Histogram::bucket_upper_bound(index) - Histogram::bucket_upper_bound(index - 1);
+        EXPECT_LE(width * 8, Histogram::bucket_upper_bound(index - 1)) << v;
+    }
+
+    EXPECT_EQ(Histogram::bucket_index(~0ull), Histogram::BUCKETS - 1);
+}
+
+TEST(MetricsTest, HistogramPercentiles) {
+    auto histogram = Metrics::histogram("test_metrics_latency_seconds", "test");
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v * 1000);  // 1us .. 1ms
+    }
+
+    auto snap = histogram.snapshot();
+    EXPECT_EQ(snap.count, 1000u);
+    EXPECT_EQ(snap.max, 1000000u);
+    EXPECT_EQ(snap.sum, 500500000u);
+
+    auto p50 = snap.percentile(0.5);
+    EXPECT_GE(p50, 500000u);
+    EXPECT_LE(p50, 500000u * 9 / 8);
+    EXPECT_EQ(snap.percentile(1.0), 1000000u);
+}
+
+TEST(MetricsTest, PrometheusFormat) {
+    auto counter = Metrics::counter("test_metrics_prom_total", "Help text", {{"tool", "a\"b"}});
+    counter.add(3);
+    auto histogram = Metrics::histogram("test_metrics_prom_seconds", "Latency");
+    histogram.record(2'000'000);  // 2ms
+
+    std::string text = Metrics::to_prometheus();
+    EXPECT_NE(text.find("# TYPE test_metrics_prom_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("test_metrics_prom_total{tool=\"a\\\"b\"} "), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_metrics_prom_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("test_metrics_prom_seconds_bucket{le=\"+Inf\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_metrics_prom_seconds_bucket{le=\"0.001048576\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("test_metrics_prom_seconds_bucket{le=\"0.002097152\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_metrics_prom_seconds_count 1\n"), std::string::npos);
+
+    auto json_stats = Metrics::to_json();
+    bool found = false;
+    for (const auto& metric : json_stats["metrics"]) {
+        if (metric["name"] == "test_metrics_prom_seconds") {
+            found = true;
+            EXPECT_EQ(metric["type"], "histogram");
+            EXPECT_EQ(metric["count"], 1);
+            EXPECT_NEAR(metric["max_ms"].get<double>(), 2.0, 1e-9);
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+#ifdef __linux__
+
+TEST(MetricsExporterTest, WritesFileAndServesSocket) {
+    fs::path dir = fs::temp_directory_path() / ("metrics_test_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    fs::path file = dir / "metrics.prom";
+    fs::path socket_path = dir / "metrics.sock";
+
+    Metrics::counter("test_metrics_export_total", "test").add();
+
+    {
+        MetricsExporter exporter(file, socket_path, std::chrono::milliseconds(50));
+        exporter.start();
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        ASSERT_GE(fd, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+        ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+        std::string received;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+            received.append(buffer, static_cast<size_t>(n));
+        }
+        ::close(fd);
+        EXPECT_NE(received.find("test_metrics_export_total 1"), std::string::npos);
+
+        exporter.stop();
+    }
+
+    std::ifstream in(file);
+    std::stringstream content;
+    content << in.rdbuf();
+    EXPECT_NE(content.str().find("test_metrics_export_total 1"), std::string::npos);
+    EXPECT_FALSE(fs::exists(socket_path));
+
+    fs::remove_all(dir);
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "core/ParseGuard.hpp"
+#include "core/LexicalScanner.hpp"
+#include "core/TreeSitterParser.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace ts_mcp;
+
+namespace {
+
+/**
+ * @brief Restores the default limits when a test ends
+ */
+class ParseGuardTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        ParseGuard::set_limits(ParseLimits{});
+    }
+};
+
+} // namespace
+
+TEST_F(ParseGuardTest, RefusesOversizedSources) {
+    ParseLimits limits;
+    limits.max_file_bytes = 100;
+    ParseGuard::set_limits(limits);
+
+    EXPECT_EQ(ParseGuard::check(std::string(100, 'x')), DegradeReason::NONE);
+    EXPECT_EQ(ParseGuard::check(std::string(101, 'x')), DegradeReason::TOO_LARGE);
+    EXPECT_EQ(ParseGuard::to_string(DegradeReason::TOO_LARGE), "too_large");
+}
+
+TEST_F(ParseGuardTest, GeneratedAndMinifiedOnlyAboveTheirLimit) {
+    std::string generated = "// Code generated by protoc. DO NOT EDIT.\n";
+    std::string minified(4000, 'a');
+    std::string handwritten;
+    while (handwritten.size() < 4000) {
+        handwritten += "int value = compute(1, 2);\n";
+    }
+    while (generated.size() < 4000) {
+        generated += "int x;\n";
+    }
+
+    EXPECT_TRUE(ParseGuard::looks_generated(generated));
+    EXPECT_FALSE(ParseGuard::looks_generated(handwritten));
+    EXPECT_TRUE(ParseGuard::looks_minified(minified));
+    EXPECT_FALSE(ParseGuard::looks_minified(handwritten));
+
+    EXPECT_EQ(ParseGuard::check(generated), DegradeReason::NONE) << "Small generated files are parsed";
+
+    ParseLimits limits;
+    limits.max_generated_bytes = 1000;
+    ParseGuard::set_limits(limits);
+    EXPECT_EQ(ParseGuard::check(generated), DegradeReason::GENERATED);
+    EXPECT_EQ(ParseGuard::check(minified), DegradeReason::MINIFIED);
+    EXPECT_EQ(ParseGuard::check(handwritten), DegradeReason::NONE);
+}
+
+TEST_F(ParseGuardTest, ParserReportsWhyItRefused) {
+    ParseLimits limits;
+    limits.max_file_bytes = 16;
+    ParseGuard::set_limits(limits);
+
+    TreeSitterParser parser(Language::CPP);
+    EXPECT_FALSE(parser.parse_string("int a; int b; int c;"));
+    EXPECT_EQ(parser.last_degraded(), DegradeReason::TOO_LARGE);
+
+    EXPECT_TRUE(parser.parse_string("int a;"));
+    EXPECT_EQ(parser.last_degraded(), DegradeReason::NONE);
+}
+
+TEST(LexicalScannerTest, LineMetrics) {
+    auto metrics = LexicalScanner::line_metrics("// c\n\nint x;\n  // d\n", Language::CPP);
+    EXPECT_EQ(metrics.lines, 4u);
+    EXPECT_EQ(metrics.blank_lines, 1u);
+    EXPECT_EQ(metrics.comment_lines, 2u);
+    EXPECT_EQ(metrics.longest_line, 6u);
+
+    EXPECT_EQ(LexicalScanner::line_metrics("", Language::CPP).lines, 0u);
+    EXPECT_EQ(LexicalScanner::line_metrics("# c\nx = 1", Language::PYTHON).comment_lines, 1u);
+}
+
+TEST(LexicalScannerTest, CppIncludes) {
+    auto includes = LexicalScanner::includes(
+        "#include <vector>\n"
+        "  #  include \"a/b.hpp\" // comment\n"
+        "#define include_guard\n"
+        "#include MACRO_HEADER\n"
+        "#includefoo <x>\n",
+        Language::CPP);
+
+    ASSERT_EQ(includes.size(), 2u);
+    EXPECT_EQ(includes[0].path, "vector");
+    EXPECT_TRUE(includes[0].is_system);
+    EXPECT_EQ(includes[0].line, 0);
+    EXPECT_EQ(includes[1].path, "a/b.hpp");
+    EXPECT_FALSE(includes[1].is_system);
+    EXPECT_EQ(includes[1].line, 1);
+    EXPECT_EQ(includes[1].column, 2);
+    EXPECT_EQ(includes[1].kind, "include");
+}
+
+TEST(LexicalScannerTest, PythonImports) {
+    auto imports = LexicalScanner::includes(
+        "import os.path\n"
+        "from . import sibling\n"
+        "from typing import List\n"
+        "important = 1\n",
+        Language::PYTHON);
+
+    ASSERT_EQ(imports.size(), 3u);
+    EXPECT_EQ(imports[0].kind, "import");
+    EXPECT_EQ(imports[0].path, "os.path");
+    EXPECT_EQ(imports[1].kind, "import_from");
+    EXPECT_EQ(imports[1].path, ".");
+    EXPECT_EQ(imports[2].path, "typing");
+    EXPECT_EQ(imports[2].line, 2);
+}
+
+TEST(LexicalScannerTest, FindWordMatchesWholeIdentifiers) {
+    auto matches = LexicalScanner::find_word("foo(); foobar();\n  x = foo_ + foo;\n", "foo");
+    ASSERT_EQ(matches.size(), 2u);
+    EXPECT_EQ(matches[0].line, 0);
+    EXPECT_EQ(matches[0].column, 0);
+    EXPECT_EQ(matches[1].line, 1);
+    EXPECT_EQ(matches[1].column, 13);
+    EXPECT_EQ(matches[1].context, "x = foo_ + foo;");
+
+    EXPECT_EQ(LexicalScanner::find_word("a a a a", "a", 3).size(), 3u);
+    EXPECT_TRUE(LexicalScanner::find_word("abc", "").empty());
+}
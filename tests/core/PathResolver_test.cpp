@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "core/PathResolver.hpp"
 #include <filesystem>
+#include <algorithm>
 #include <fstream>
+#include <thread>
 
 using namespace ts_mcp;
 namespace fs = std::filesystem;
@@ -124,6 +126,64 @@ TEST_F(PathResolverTest, FilePatternFilter) {
     }
 }
 
+TEST_F(PathResolverTest, PathPatternFilter) {
+    // Patterns with '/' match the path relative to the scanned directory
+    auto results = PathResolver::resolve_paths(
+        {test_dir_.string()},
+        true,
+        {"subdir/deep/*.cxx", "file?.h", "nested[0-9].cc"}
+    );
+
+    // file3.h, nested2.cc, deep_file.cxx
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0].filename(), "file3.h");
+}
+
+TEST_F(PathResolverTest, SeesChangesBetweenCalls) {
+    auto first = PathResolver::resolve_paths({test_dir_.string()}, true, {"*.cpp"});
+    ASSERT_EQ(first.size(), 2);
+
+    create_file(test_dir_ / "subdir" / "deep" / "added.cpp", "class G {};");
+    fs::remove(test_dir_ / "file1.cpp");
+
+    // Subdirectory queries are answered by the same inventory
+    auto sub = PathResolver::resolve_paths({(test_dir_ / "subdir").string()}, true, {"*.cpp"});
+    ASSERT_EQ(sub.size(), 2);
+    EXPECT_EQ(sub[0].filename(), "added.cpp");
+    EXPECT_EQ(sub[1].filename(), "nested1.cpp");
+
+    auto all = PathResolver::resolve_paths({test_dir_.string()}, true, {"*.cpp"});
+    EXPECT_EQ(all.size(), 2);
+}
+
+TEST_F(PathResolverTest, ConcurrentFirstListingsShareOneInventory) {
+    // Outside test_dir_: earlier tests' inventory of it would answer
+    auto root = fs::temp_directory_path() / "path_resolver_race_test";
+    fs::remove_all(root);
+    for (int i = 0; i < 50; ++i) {
+        fs::create_directories(root / std::to_string(i));
+        create_file(root / std::to_string(i) / "a.cpp", "");
+    }
+
+    std::vector<std::vector<fs::path>> results(8);
+    std::vector<std::thread> threads;
+    for (auto& result : results) {
+        threads.emplace_back([&] { result = PathResolver::resolve_paths({root.string()}, true, {"*.cpp"}); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& result : results) {
+        EXPECT_EQ(result.size(), 50u);
+    }
+    auto inventories = PathResolver::inventories();
+    EXPECT_EQ(std::count_if(inventories.begin(), inventories.end(),
+                            [&](const auto& inventory) { return inventory->root() == fs::canonical(root); }),
+              1);
+    fs::remove_all(root);
+}
+
 TEST_F(PathResolverTest, NonexistentPath) {
     auto fake_path = test_dir_ / "nonexistent.cpp";
     auto results = PathResolver::resolve_paths({fake_path.string()});
@@ -140,3 +200,56 @@ TEST_F(PathResolverTest, EmptyResult) {
 
     EXPECT_EQ(results.size(), 0);
 }
+
+TEST_F(PathResolverTest, SkipsExcludedDirectories) {
+    for (const char* name : {".git", "build", "node_modules", "third_party", "_deps"}) {
+        fs::create_directories(test_dir_ / name / "inner");
+        create_file(test_dir_ / name / "inner" / "skipped.cpp", "class X {};");
+    }
+
+    auto results = PathResolver::resolve_paths({test_dir_.string()}, true);
+
+    // Same 6 files as RecursiveDirectory, nothing from excluded trees
+    ASSERT_EQ(results.size(), 6);
+    for (const auto& path : results) {
+        EXPECT_NE(path.filename(), "skipped.cpp");
+    }
+}
+
+TEST_F(PathResolverTest, ExplicitExcludedRootIsScanned) {
+    auto build_dir = test_dir_ / "build";
+    fs::create_directories(build_dir);
+    create_file(build_dir / "generated.cpp", "class G {};");
+
+    auto results = PathResolver::resolve_paths({build_dir.string()}, true);
+
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].filename(), "generated.cpp");
+}
+
+TEST_F(PathResolverTest, HonorsGitignore) {
+    create_file(test_dir_ / ".gitignore", "file2.hpp\ndeep/\n*.cc\n");
+
+    auto results = PathResolver::resolve_paths({test_dir_.string()}, true);
+
+    // file1.cpp, file3.h, nested1.cpp remain
+    ASSERT_EQ(results.size(), 3);
+    for (const auto& path : results) {
+        EXPECT_NE(path.filename(), "file2.hpp");
+        EXPECT_NE(path.filename(), "nested2.cc");
+        EXPECT_NE(path.filename(), "deep_file.cxx");
+    }
+}
+
+TEST_F(PathResolverTest, NestedIgnoreFileOverridesParent) {
+    // Ancestor ignore files are only consulted inside a repository
+    fs::create_directories(test_dir_ / ".git");
+    create_file(test_dir_ / ".gitignore", "*.cc\n");
+    create_file(test_dir_ / "subdir" / ".ignore", "!nested2.cc\nnested1.cpp\n");
+
+    auto results = PathResolver::resolve_paths({(test_dir_ / "subdir").string()}, false);
+
+    // Parent rule is re-included by the child .ignore; nested1.cpp is ignored
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].filename(), "nested2.cc");
+}
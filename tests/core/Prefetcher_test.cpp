@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "core/Prefetcher.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <optional>
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+
+class PrefetcherTest : public ::testing::Test {
+protected:
+    fs::path test_dir_;
+    std::shared_ptr<ASTAnalyzer> analyzer_ = std::make_shared<ASTAnalyzer>();
+    Prefetcher::Budget budget_;
+
+    void SetUp() override {
+        test_dir_ = fs::temp_directory_path() / "prefetcher_test";
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_ / "src" / "util");
+        test_dir_ = fs::canonical(test_dir_);
+        budget_.cpu_percent = 100;
+        budget_.resume_delay = std::chrono::milliseconds(0);
+
+        write("src/widget.cpp",
+              "#include \"widget.hpp\"\n#include \"util/strings.hpp\"\n#include <vector>\n"
+              "void run(Gadget& gadget) {}\n");
+        write("src/widget.hpp", "#pragma once\nclass Widget {};\n");
+        write("src/util/strings.hpp", "#pragma once\nvoid trim();\n");
+        write("src/util/Gadget.hpp", "#pragma once\nclass Gadget {};\n");
+        write("src/unrelated.hpp", "class Unrelated {};\n");
+    }
+
+    void TearDown() override {
+        fs::remove_all(test_dir_);
+    }
+
+    void write(const std::string& name, const std::string& content) {
+        std::ofstream(test_dir_ / name) << content;
+    }
+};
+
+TEST_F(PrefetcherTest, NeighborsArePairIncludesAndTypeSites) {
+    Prefetcher prefetcher(analyzer_, budget_);
+    auto neighbors = prefetcher.neighbors(test_dir_ / "src" / "widget.cpp");
+
+    std::vector<fs::path> expected = {
+        test_dir_ / "src" / "widget.hpp",          // Same stem, and included
+        test_dir_ / "src" / "util" / "strings.hpp",  // Resolved include
+        test_dir_ / "src" / "util" / "Gadget.hpp"    // Header named after a used type
+    };
+    EXPECT_EQ(neighbors, expected);
+}
+
+TEST_F(PrefetcherTest, PythonImportsResolveFromThePackage) {
+    fs::create_directories(test_dir_ / "pkg");
+    write("pkg/__init__.py", "");
+    write("pkg/models.py", "class User:\n    pass\n");
+    write("pkg/util.py", "def helper():\n    pass\n");
+    write("pkg/app.py", "from .models import User\nimport pkg.util\nimport os\n");
+
+    Prefetcher prefetcher(analyzer_, budget_);
+    auto neighbors = prefetcher.neighbors(test_dir_ / "pkg" / "app.py");
+
+    std::vector<fs::path> expected = {test_dir_ / "pkg" / "models.py", test_dir_ / "pkg" / "util.py"};
+    EXPECT_EQ(neighbors, expected);
+}
+
+TEST_F(PrefetcherTest, RequestDoneParsesTheNeighborhood) {
+    Prefetcher prefetcher(analyzer_, budget_);
+    prefetcher.start();
+    prefetcher.request_done({test_dir_ / "src" / "widget.cpp"});
+    ASSERT_TRUE(prefetcher.wait_idle(std::chrono::seconds(10)));
+
+    EXPECT_TRUE(analyzer_->has_tree(test_dir_ / "src" / "widget.hpp"));
+    EXPECT_TRUE(analyzer_->has_tree(test_dir_ / "src" / "util" / "Gadget.hpp"));
+    EXPECT_FALSE(analyzer_->has_tree(test_dir_ / "src" / "unrelated.hpp"));
+}
+
+TEST_F(PrefetcherTest, NothingIsPrefetchedBeyondTheMemoryBudget) {
+    budget_.max_tree_bytes = 1;
+    Prefetcher prefetcher(analyzer_, budget_);
+    prefetcher.start();
+    prefetcher.request_done({test_dir_ / "src" / "widget.cpp"});
+    ASSERT_TRUE(prefetcher.wait_idle(std::chrono::seconds(10)));
+
+    EXPECT_FALSE(analyzer_->has_tree(test_dir_ / "src" / "widget.hpp"));
+    EXPECT_FALSE(analyzer_->has_tree(test_dir_ / "src" / "util" / "Gadget.hpp"));
+}
+
+TEST_F(PrefetcherTest, RequestsPausePrefetching) {
+    Prefetcher prefetcher(analyzer_, budget_);
+    prefetcher.start();
+    {
+        Prefetcher::Yield request(&prefetcher);
+        prefetcher.request_done({test_dir_ / "src" / "widget.cpp"});
+        EXPECT_FALSE(prefetcher.wait_idle(std::chrono::milliseconds(200)));
+        EXPECT_FALSE(analyzer_->has_tree(test_dir_ / "src" / "widget.hpp"));
+    }
+    ASSERT_TRUE(prefetcher.wait_idle(std::chrono::seconds(10)));
+    EXPECT_TRUE(analyzer_->has_tree(test_dir_ / "src" / "widget.hpp"));
+}
+
+TEST_F(PrefetcherTest, RequestsSkipTheRestOfAFileInProgress) {
+    Prefetcher prefetcher(analyzer_, budget_);
+    std::optional<Prefetcher::Yield> request;
+    std::mutex mutex;
+    fs::path interrupted;
+    std::vector<fs::path> completed;
+    prefetcher.add_step([&](const std::shared_ptr<ASTAnalyzer>&, const fs::path& file) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (interrupted.empty()) {
+            interrupted = file;
+            request.emplace(&prefetcher);  // A request arrives during the first file
+        }
+    });
+    prefetcher.add_step([&](const std::shared_ptr<ASTAnalyzer>&, const fs::path& file) {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.push_back(file);
+    });
+    prefetcher.start();
+    prefetcher.request_done({test_dir_ / "src" / "widget.cpp"});
+
+    EXPECT_FALSE(prefetcher.wait_idle(std::chrono::milliseconds(200)));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_TRUE(completed.empty());
+        ASSERT_FALSE(interrupted.empty());
+        EXPECT_TRUE(analyzer_->has_tree(interrupted)) << "The parsed tree is kept";
+        request.reset();
+    }
+    ASSERT_TRUE(prefetcher.wait_idle(std::chrono::seconds(10)));
+    EXPECT_FALSE(completed.empty());
+    EXPECT_EQ(std::count(completed.begin(), completed.end(), interrupted), 0);
+}
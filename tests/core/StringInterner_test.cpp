@@ -0,0 +1,96 @@
+#include "core/StringInterner.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ts_mcp;
+
+TEST(StringInternerTest, EqualTextHasEqualIds) {
+    StringId a = StringId::of("src/core/ASTAnalyzer.cpp");
+    StringId b = StringInterner::intern(std::string("src/core/") + "ASTAnalyzer.cpp");
+    StringId c = StringId::of("src/core/ASTAnalyzer.hpp");
+
+    EXPECT_EQ(a, b);
+    EXPECT_FALSE(a == c);
+    EXPECT_EQ(a.view(), "src/core/ASTAnalyzer.cpp");
+    EXPECT_EQ(c.str(), "src/core/ASTAnalyzer.hpp");
+}
+
+TEST(StringInternerTest, EmptyStringIsTheDefaultId) {
+    EXPECT_EQ(StringId::of(""), StringId{});
+    EXPECT_TRUE(StringId{}.empty());
+    EXPECT_EQ(StringId{}.view(), "");
+    EXPECT_FALSE(StringId::of("x").empty());
+}
+
+TEST(StringInternerTest, FindDoesNotIntern) {
+    size_t before = StringInterner::stats().strings;
+    EXPECT_FALSE(StringInterner::find("never_interned_name_7f3a").has_value());
+    EXPECT_EQ(StringInterner::stats().strings, before);
+
+    StringId id = StringId::of("interned_name_7f3a");
+    ASSERT_TRUE(StringInterner::find("interned_name_7f3a").has_value());
+    EXPECT_EQ(*StringInterner::find("interned_name_7f3a"), id);
+}
+
+TEST(StringInternerTest, LargeStringsKeepTheirText) {
+    std::string large(100 * 1024, 'q');
+    large.back() = 'z';
+    StringId id = StringId::of(large);
+    StringId small = StringId::of("after_large");
+
+    EXPECT_EQ(id.view(), large);
+    EXPECT_EQ(small.view(), "after_large");
+    EXPECT_EQ(StringId::of(large), id);
+}
+
+TEST(StringInternerTest, ManyStringsAcrossTableSegments) {
+    std::vector<StringId> ids;
+    for (int i = 0; i < 5000; i++) {
+        ids.push_back(StringId::of("symbol_" + std::to_string(i)));
+    }
+    for (int i = 0; i < 5000; i++) {
+        ASSERT_EQ(ids[i].view(), "symbol_" + std::to_string(i));
+    }
+    EXPECT_GE(StringInterner::stats().strings, 5000u);
+    EXPECT_GT(StringInterner::stats().bytes, 0u);
+}
+
+TEST(StringInternerTest, ConcurrentInterningAgrees) {
+    constexpr int THREADS = 4;
+    constexpr int STRINGS = 2000;
+    std::vector<std::vector<StringId>> results(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < STRINGS; i++) {
+                StringId id = StringId::of("concurrent_" + std::to_string(i));
+                if (id.view() != "concurrent_" + std::to_string(i)) {
+                    return;
+                }
+                results[t].push_back(id);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 1; t < THREADS; t++) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+    EXPECT_EQ(results[0].size(), static_cast<size_t>(STRINGS));
+}
+
+TEST(StringInternerTest, LessOrdersByText) {
+    // Interned in reverse, so id order differs from text order
+    std::vector<StringId> ids = {StringId::of("zeta_order"), StringId::of("mid_order"),
+                                 StringId::of("alpha_order")};
+    std::sort(ids.begin(), ids.end(), StringIdLess{});
+
+    EXPECT_EQ(ids[0].view(), "alpha_order");
+    EXPECT_EQ(ids[1].view(), "mid_order");
+    EXPECT_EQ(ids[2].view(), "zeta_order");
+}
@@ -0,0 +1,116 @@
+#include "core/Trace.hpp"
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace ts_mcp;
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        file = fs::temp_directory_path() / ("trace_test_" + std::to_string(::getpid()) + ".json");
+    }
+
+    void TearDown() override {
+        Tracer::stop();
+        fs::remove(file);
+    }
+
+    json read_trace() const {
+        std::ifstream in(file);
+        return json::parse(in);
+    }
+
+    static std::vector<json> spans(const json& trace, const std::string& name) {
+        std::vector<json> result;
+        for (const auto& event : trace["traceEvents"]) {
+            if (event["ph"] == "X" && event["name"] == name) {
+                result.push_back(event);
+            }
+        }
+        return result;
+    }
+
+    fs::path file;
+};
+
+TEST_F(TraceTest, DisabledRecordsNothing) {
+    {
+        TraceSpan span("before_start");
+    }
+    Tracer::start(file);
+    ASSERT_TRUE(Tracer::stop());
+
+    auto trace = read_trace();
+    EXPECT_TRUE(spans(trace, "before_start").empty());
+}
+
+TEST_F(TraceTest, NestedSpansWithDetail) {
+    Tracer::start(file);
+    {
+        TraceSpan outer("outer", "a.cpp");
+        {
+            TraceSpan inner("inner");
+            inner.set_detail("3 files");
+        }
+    }
+    ASSERT_TRUE(Tracer::stop());
+
+    auto trace = read_trace();
+    auto outer = spans(trace, "outer");
+    auto inner = spans(trace, "inner");
+    ASSERT_EQ(outer.size(), 1u);
+    ASSERT_EQ(inner.size(), 1u);
+
+    EXPECT_EQ(outer[0]["args"]["detail"], "a.cpp");
+    EXPECT_EQ(inner[0]["args"]["detail"], "3 files");
+    EXPECT_EQ(outer[0]["tid"], inner[0]["tid"]);
+
+    // Inner lies within outer
+    double outer_start = outer[0]["ts"], outer_end = outer_start + outer[0]["dur"].get<double>();
+    double inner_start = inner[0]["ts"], inner_end = inner_start + inner[0]["dur"].get<double>();
+    EXPECT_LE(outer_start, inner_start);
+    EXPECT_GE(outer_end + 0.001, inner_end);
+}
+
+TEST_F(TraceTest, ThreadsGetSeparateBuffers) {
+    Tracer::start(file);
+    {
+        TraceSpan span("main_thread");
+    }
+    std::thread([] { TraceSpan span("worker_thread"); }).join();
+    ASSERT_TRUE(Tracer::stop());
+
+    auto trace = read_trace();
+    auto main_spans = spans(trace, "main_thread");
+    auto worker_spans = spans(trace, "worker_thread");
+    ASSERT_EQ(main_spans.size(), 1u);
+    ASSERT_EQ(worker_spans.size(), 1u);
+    EXPECT_NE(main_spans[0]["tid"], worker_spans[0]["tid"]);
+}
+
+TEST_F(TraceTest, RingBufferKeepsNewestEvents) {
+    // Run on a fresh thread so the buffer is sized by this start()
+    Tracer::start(file, 4);
+    std::thread([] {
+        for (int i = 0; i < 10; ++i) {
+            TraceSpan span("ring", std::to_string(i));
+        }
+    }).join();
+    ASSERT_TRUE(Tracer::stop());
+
+    auto trace = read_trace();
+    auto ring = spans(trace, "ring");
+    ASSERT_EQ(ring.size(), 4u);
+    EXPECT_EQ(ring.front()["args"]["detail"], "6");
+    EXPECT_EQ(ring.back()["args"]["detail"], "9");
+    EXPECT_EQ(trace["otherData"]["dropped_events"], 6);
+}
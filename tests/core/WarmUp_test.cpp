@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "core/WarmUp.hpp"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+
+class WarmUpTest : public ::testing::Test {
+protected:
+    fs::path test_dir_;
+    std::shared_ptr<ASTAnalyzer> analyzer_ = std::make_shared<ASTAnalyzer>();
+    WarmUp::Options options_;
+
+    void SetUp() override {
+        test_dir_ = fs::temp_directory_path() / "warm_up_test" /
+                    ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        fs::remove_all(test_dir_);
+        fs::create_directories(test_dir_ / "old");
+        fs::create_directories(test_dir_ / "new");
+        options_.resume_delay = std::chrono::milliseconds(0);
+    }
+
+    void TearDown() override {
+        fs::remove_all(test_dir_.parent_path());
+    }
+
+    fs::path write(const std::string& name, int age_minutes) {
+        auto file = test_dir_ / name;
+        std::ofstream(file) << "class " << file.stem().string() << " {};\nvoid f() {}\n";
+        fs::last_write_time(file, fs::file_time_type::clock::now() - std::chrono::minutes(age_minutes));
+        return file;
+    }
+};
+
+TEST_F(WarmUpTest, WarmsFactsOfEveryFile) {
+    for (int i = 0; i < 6; ++i) {
+        write("new/w" + std::to_string(i) + ".cpp", i);
+    }
+    options_.threads = 2;
+    WarmUp warm_up(analyzer_, {test_dir_}, options_);
+    warm_up.start();
+    ASSERT_TRUE(warm_up.wait(std::chrono::seconds(10)));
+
+    json status = warm_up.status();
+    EXPECT_EQ(status["state"], "done");
+    EXPECT_EQ(status["files_total"], 6);
+    EXPECT_EQ(status["files_done"], 6);
+    EXPECT_EQ(status["files_failed"], 0);
+    EXPECT_EQ(analyzer_->fact_record_count(), 6u);
+    EXPECT_EQ(analyzer_->cache_size(), 0u) << "Warm-up should keep facts, not trees";
+}
+
+TEST_F(WarmUpTest, KeepsTreesThatRequestsUse) {
+    auto loaded = write("new/loaded.cpp", 1);
+    auto used = write("new/used.cpp", 2);
+    write("new/other.cpp", 3);
+    ASSERT_TRUE(analyzer_->snapshot(loaded));
+
+    WarmUp warm_up(analyzer_, {test_dir_}, options_);
+    warm_up.add_step([&](const std::shared_ptr<ASTAnalyzer>& analyzer, const fs::path& file) {
+        if (file == used) {
+            // A request uses the tree while the warm-up holds it
+            std::thread([&] { EXPECT_TRUE(analyzer->snapshot(file)); }).join();
+        }
+    });
+    warm_up.start();
+    ASSERT_TRUE(warm_up.wait(std::chrono::seconds(10)));
+
+    EXPECT_TRUE(analyzer_->has_tree(loaded));
+    EXPECT_TRUE(analyzer_->has_tree(used));
+    EXPECT_EQ(analyzer_->cache_size(), 2u);
+}
+
+TEST_F(WarmUpTest, RecentAndTouchedFilesFirst) {
+    write("old/a.cpp", 300);
+    write("old/b.cpp", 200);
+    write("new/c.cpp", 30);
+    write("new/d.cpp", 10);
+    write("touched.cpp", 500);
+
+    std::mutex mutex;
+    std::vector<std::string> order;
+    WarmUp warm_up(analyzer_, {test_dir_}, options_);
+    warm_up.add_step([&](const std::shared_ptr<ASTAnalyzer>&, const fs::path& file) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(file.filename().string());
+    });
+
+    warm_up.touch(test_dir_ / "old" / "b.cpp");
+    warm_up.start();
+    ASSERT_TRUE(warm_up.wait(std::chrono::seconds(10)));
+
+    // The touched file's directory by recency, then the rest by recency
+    std::vector<std::string> expected = {"b.cpp", "a.cpp", "d.cpp", "c.cpp", "touched.cpp"};
+    EXPECT_EQ(order, expected);
+}
+
+TEST_F(WarmUpTest, RequestsPauseWarmUp) {
+    for (int i = 0; i < 3; ++i) {
+        write("new/p" + std::to_string(i) + ".cpp", i);
+    }
+    WarmUp warm_up(analyzer_, {test_dir_}, options_);
+    {
+        WarmUp::Yield request(&warm_up);
+        warm_up.start();
+        EXPECT_FALSE(warm_up.wait(std::chrono::milliseconds(200)));
+        json status = warm_up.status();
+        EXPECT_EQ(status["files_done"], 0);
+        EXPECT_TRUE(status["paused"].get<bool>());
+    }
+    ASSERT_TRUE(warm_up.wait(std::chrono::seconds(10)));
+    EXPECT_EQ(warm_up.status()["files_done"], 3);
+}
+
+TEST_F(WarmUpTest, StopsWhenFactMemoryIsFull) {
+    for (int i = 0; i < 8; ++i) {
+        write("new/m" + std::to_string(i) + ".cpp", i);
+    }
+    CacheLimits limits;
+    limits.max_fact_bytes = 1;
+    analyzer_->set_cache_limits(limits);
+
+    WarmUp warm_up(analyzer_, {test_dir_}, options_);
+    warm_up.start();
+    ASSERT_TRUE(warm_up.wait(std::chrono::seconds(10)));
+
+    json status = warm_up.status();
+    EXPECT_EQ(status["state"], "fact_memory_full");
+    EXPECT_EQ(status["files_done"], 1);
+}
+
+TEST_F(WarmUpTest, StopBeforeDoneLeavesTheRest) {
+    for (int i = 0; i < 4; ++i) {
+        write("new/s" + std::to_string(i) + ".cpp", i);
+    }
+    WarmUp warm_up(analyzer_, {test_dir_}, options_);
+    {
+        WarmUp::Yield request(&warm_up);
+        warm_up.start();
+        warm_up.stop();
+    }
+    EXPECT_TRUE(warm_up.wait(std::chrono::seconds(1)));
+    EXPECT_EQ(warm_up.status()["state"], "stopped");
+    EXPECT_EQ(warm_up.status()["files_done"], 0);
+}
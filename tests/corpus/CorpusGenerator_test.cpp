@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "corpus/CorpusGenerator.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace ts_mcp;
+namespace fs = std::filesystem;
+
+class CorpusGeneratorTest : public ::testing::Test {
+protected:
+    fs::path test_dir_;
+
+    void SetUp() override {
+        test_dir_ = fs::temp_directory_path() / "corpus_generator_test";
+        fs::remove_all(test_dir_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(test_dir_);
+    }
+
+    static std::string read_file(const fs::path& path) {
+        std::ifstream file(path);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+};
+
+TEST_F(CorpusGeneratorTest, SameSeedSameOutput) {
+    CorpusConfig config;
+    config.file_count = 40;
+    config.mega_files = 1;
+    config.mega_file_classes = 20;
+
+    CorpusGenerator a(config);
+    CorpusGenerator b(config);
+    for (size_t i = 0; i < config.file_count; ++i) {
+        EXPECT_EQ(a.relative_path(i), b.relative_path(i));
+        EXPECT_EQ(a.file_content(i), b.file_content(i));
+    }
+    EXPECT_EQ(a.mega_file_content(0), b.mega_file_content(0));
+
+    config.seed = 2;
+    CorpusGenerator c(config);
+    bool differs = false;
+    for (size_t i = 0; i < config.file_count && !differs; ++i) {
+        differs = a.file_content(i) != c.file_content(i);
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST_F(CorpusGeneratorTest, WritesRequestedShape) {
+    CorpusConfig config;
+    config.file_count = 200;
+    config.files_per_directory = 20;
+    config.python_ratio = 0.25;
+    config.cycle_ratio = 0.5;
+    config.hierarchy_depth = 3;
+    config.inheritance_ratio = 1.0;
+    config.mega_files = 2;
+    config.mega_file_classes = 30;
+
+    CorpusGenerator generator(config);
+    auto stats = generator.generate(test_dir_);
+
+    EXPECT_EQ(stats.files, 202);
+    EXPECT_EQ(stats.cpp_files + stats.python_files, 202);
+    EXPECT_GT(stats.python_files, 0);
+    EXPECT_GT(stats.include_edges, 0);
+    EXPECT_GT(stats.include_cycles, 0);
+    EXPECT_EQ(stats.max_hierarchy_depth, 3);
+    EXPECT_GE(stats.directories, 10);
+
+    size_t on_disk = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(test_dir_)) {
+        on_disk += entry.is_regular_file() ? 1 : 0;
+    }
+    EXPECT_EQ(on_disk, stats.files);
+
+    EXPECT_EQ(read_file(test_dir_ / generator.relative_path(7)), generator.file_content(7));
+    EXPECT_TRUE(fs::exists(test_dir_ / "mega" / "mega1.cpp"));
+}
+
+TEST_F(CorpusGeneratorTest, FilesReferenceEachOther) {
+    CorpusConfig config;
+    config.file_count = 60;
+    config.python_ratio = 0.5;
+    config.cross_file_call_ratio = 1.0;
+
+    CorpusGenerator generator(config);
+    bool cpp_include = false;
+    bool python_import = false;
+    for (size_t i = 1; i < config.file_count; ++i) {
+        auto content = generator.file_content(i);
+        if (generator.relative_path(i).ends_with(".py")) {
+            python_import |= content.find("import d0.") != std::string::npos;
+            EXPECT_NE(content.find("class C" + std::to_string(i) + "_0"), std::string::npos);
+        } else {
+            cpp_include |= content.find("#include \"d0/") != std::string::npos;
+            EXPECT_NE(content.find("namespace corpus"), std::string::npos);
+        }
+    }
+    EXPECT_TRUE(cpp_include);
+    EXPECT_TRUE(python_import);
+}
+
+TEST_F(CorpusGeneratorTest, RejectsInvalidConfig) {
+    CorpusConfig config;
+    config.python_ratio = 1.5;
+    EXPECT_THROW(CorpusGenerator{config}, std::invalid_argument);
+
+    config.python_ratio = 0.0;
+    config.files_per_directory = 0;
+    EXPECT_THROW(CorpusGenerator{config}, std::invalid_argument);
+}
@@ -1,6 +1,9 @@
 #include "mcp/MCPServer.hpp"
 #include "MockTransport.hpp"
+#include "core/Trace.hpp"
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 #include <thread>
 
 using namespace ts_mcp;
@@ -185,3 +188,129 @@ TEST_F(MCPServerTest, MultipleRequests) {
     }
     EXPECT_EQ(response_count, 3);
 }
+
+TEST_F(MCPServerTest, ToolCallsRecordMetrics) {
+    ToolInfo info{"metrics_tool", "Fails on request", {{"type", "object"}}};
+    server->register_tool(info, [](const json& args) -> json {
+        if (args.value("fail", false)) {
+            return {{"error", "requested failure"}};
+        }
+        return {{"ok", true}};
+    });
+
+    MetricLabels labels = {{"tool", "metrics_tool"}};
+    auto calls = Metrics::counter("ts_mcp_tool_calls_total", "Tool calls", labels);
+    auto errors = Metrics::counter("ts_mcp_tool_errors_total", "Tool calls that failed", labels);
+    auto latency = Metrics::histogram("ts_mcp_tool_latency_seconds", "Tool execution time", labels);
+    uint64_t calls_before = calls.value();
+    uint64_t errors_before = errors.value();
+    uint64_t latency_before = latency.snapshot().count;
+
+    for (bool fail : {false, true, false}) {
+        mock_transport_raw->push_request({
+            {"jsonrpc", "2.0"},
+            {"id", 1},
+            {"method", "tools/call"},
+            {"params", {{"name", "metrics_tool"}, {"arguments", {{"fail", fail}}}}}
+        });
+    }
+    mock_transport_raw->push_request(json());  // Empty message to signal EOF
+
+    server->run();
+
+    EXPECT_EQ(calls.value() - calls_before, 3u);
+    EXPECT_EQ(errors.value() - errors_before, 1u);
+    EXPECT_EQ(latency.snapshot().count - latency_before, 3u);
+    EXPECT_EQ(Metrics::gauge("ts_mcp_requests_active", "Requests being handled").value(), 0);
+}
+
+TEST_F(MCPServerTest, SlowToolCallsAreLogged) {
+    auto log_path = std::filesystem::temp_directory_path() / "mcp_server_test_slow.jsonl";
+    std::filesystem::remove(log_path);
+    server->set_slow_request_log(std::make_unique<SlowRequestLog>(log_path, std::chrono::milliseconds(20)));
+
+    ToolInfo info{"sleepy_tool", "Sleeps on request", {{"type", "object"}}};
+    server->register_tool(info, [](const json& args) -> json {
+        TraceSpan span("sleep");
+        std::this_thread::sleep_for(std::chrono::milliseconds(args.value("sleep_ms", 0)));
+        RequestProfile::add_resolved_files(3);
+        RequestProfile::add_parse();
+        return {{"slept", args.value("sleep_ms", 0)}};
+    });
+
+    for (int sleep_ms : {0, 40}) {
+        mock_transport_raw->push_request({
+            {"jsonrpc", "2.0"},
+            {"id", sleep_ms},
+            {"method", "tools/call"},
+            {"params", {{"name", "sleepy_tool"}, {"arguments", {{"sleep_ms", sleep_ms}}}}}
+        });
+    }
+    mock_transport_raw->push_request(json());  // Empty message to signal EOF
+
+    server->run();
+
+    std::ifstream in(log_path);
+    std::vector<json> entries;
+    for (std::string line; std::getline(in, line);) {
+        entries.push_back(json::parse(line));
+    }
+    std::filesystem::remove(log_path);
+
+    // Only the slow call is logged
+    ASSERT_EQ(entries.size(), 1u);
+    const auto& entry = entries[0];
+    EXPECT_EQ(entry["tool"], "sleepy_tool");
+    EXPECT_EQ(entry["arguments"]["sleep_ms"], 40);
+    EXPECT_GE(entry["duration_ms"].get<double>(), 40.0);
+    EXPECT_EQ(entry["resolved_files"], 3);
+    EXPECT_EQ(entry["parses"], 1);
+    EXPECT_EQ(entry["failed"], false);
+    EXPECT_GT(entry["result_bytes"].get<size_t>(), 0u);
+    EXPECT_TRUE(entry.contains("timestamp"));
+
+    ASSERT_TRUE(entry["phases"].contains("tool"));
+    ASSERT_TRUE(entry["phases"].contains("sleep"));
+    EXPECT_TRUE(entry["phases"].contains("serialize_result"));
+    EXPECT_EQ(entry["phases"]["sleep"]["count"], 1);
+    EXPECT_GE(entry["phases"]["sleep"]["total_ms"].get<double>(), 40.0);
+}
+
+TEST_F(MCPServerTest, WarmUpStartsOnClientRoots) {
+    auto root = std::filesystem::temp_directory_path() / "mcp_warm_up_roots";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "src");
+    std::ofstream(root / "src" / "a.cpp") << "class A {};\n";
+    std::ofstream(root / "src" / "b.cpp") << "class B {};\n";
+
+    auto warm_up = std::make_shared<WarmUp>(std::make_shared<ASTAnalyzer>(),
+                                            std::vector<std::filesystem::path>{root / "unused"});
+    server->set_warm_up(warm_up);
+
+    mock_transport_raw->push_request({
+        {"jsonrpc", "2.0"},
+        {"id", 1},
+        {"method", "initialize"},
+        {"params", {{"capabilities", {{"roots", json::object()}}}}}
+    });
+    mock_transport_raw->push_request({{"jsonrpc", "2.0"}, {"method", "notifications/initialized"}});
+    mock_transport_raw->push_request({
+        {"jsonrpc", "2.0"},
+        {"id", "ts_mcp/roots"},
+        {"result", {{"roots", json::array({{{"uri", "file://" + root.string()}, {"name", "repo"}}})}}}
+    });
+    mock_transport_raw->push_request(json());  // Empty message to signal EOF
+
+    server->run();
+
+    EXPECT_EQ(mock_transport_raw->pop_response()["id"], 1);
+    json roots_request = mock_transport_raw->pop_response();
+    EXPECT_EQ(roots_request["method"], "roots/list");
+    EXPECT_FALSE(mock_transport_raw->has_responses()) << "The roots response must not be answered";
+
+    ASSERT_TRUE(warm_up->wait(std::chrono::seconds(10)));
+    json status = warm_up->status();
+    EXPECT_EQ(status["roots"][0], root.string());
+    EXPECT_EQ(status["files_done"], 2);
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,190 @@
+#include "mcp/MCPServer.hpp"
+#include "mcp/ProcessTransport.hpp"
+#include "mcp/RecordingTransport.hpp"
+#include "mcp/SessionReplayer.hpp"
+#include "MockTransport.hpp"
+#include <gtest/gtest.h>
+#include <deque>
+#include <filesystem>
+#include <functional>
+
+using namespace ts_mcp;
+using json = nlohmann::json;
+
+namespace {
+
+/**
+ * @brief Server stand-in that answers each request through a callback
+ */
+class ScriptedServer : public ITransport {
+public:
+    explicit ScriptedServer(std::function<json(const json&)> answer) : answer_(std::move(answer)) {}
+
+    json read_message() override {
+        if (pending_.empty()) {
+            return json();
+        }
+        json message = pending_.front();
+        pending_.pop_front();
+        return message;
+    }
+
+    void write_message(const json& message) override {
+        received.push_back(message);
+        if (message.contains("id")) {
+            pending_.push_back(answer_(message));
+        }
+    }
+
+    bool is_open() const override { return true; }
+
+    std::vector<json> received;
+
+private:
+    std::function<json(const json&)> answer_;
+    std::deque<json> pending_;
+};
+
+json tool_call(int id, const std::string& name) {
+    return {
+        {"jsonrpc", "2.0"},
+        {"id", id},
+        {"method", "tools/call"},
+        {"params", {{"name", name}, {"arguments", json::object()}}}
+    };
+}
+
+json text_result(const json& request, const json& payload) {
+    return {
+        {"jsonrpc", "2.0"},
+        {"id", request["id"]},
+        {"result", {{"content", json::array({{{"type", "text"}, {"text", payload.dump(2)}}})}}}
+    };
+}
+
+class ReplayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        capture_ = std::filesystem::temp_directory_path() /
+                   ("ts_mcp_replay_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                    "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".jsonl");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(capture_);
+    }
+
+    /**
+     * @brief Record a session of two echo tool calls and a notification
+     */
+    void record_session() {
+        auto* mock = new MockTransport();
+        auto recording = std::make_unique<RecordingTransport>(std::unique_ptr<ITransport>(mock), capture_);
+        MCPServer server(std::move(recording));
+        server.register_tool({"echo", "Echo", {{"type", "object"}}}, [](const json& args) -> json {
+            return {{"count", 3}, {"args", args}};
+        });
+
+        mock->push_request({{"jsonrpc", "2.0"}, {"method", "notifications/initialized"}});
+        mock->push_request(tool_call(1, "echo"));
+        mock->push_request(tool_call(2, "echo"));
+        mock->push_request(json());
+        server.run();
+    }
+
+    std::filesystem::path capture_;
+};
+
+} // namespace
+
+TEST_F(ReplayTest, RecordingCapturesBothDirections) {
+    record_session();
+
+    auto capture = SessionReplayer::load(capture_);
+    ASSERT_EQ(capture.size(), 5u);  // 3 incoming, 2 responses
+
+    size_t incoming = 0;
+    double last_t = 0;
+    for (const auto& message : capture) {
+        incoming += message.incoming ? 1 : 0;
+        EXPECT_GE(message.t_ms, last_t);
+        last_t = message.t_ms;
+    }
+    EXPECT_EQ(incoming, 3u);
+    EXPECT_TRUE(capture[0].incoming);
+    EXPECT_EQ(capture[0].message["method"], "notifications/initialized");
+    EXPECT_FALSE(capture[2].incoming);
+    EXPECT_EQ(capture[2].message["id"], 1);
+}
+
+TEST_F(ReplayTest, IdenticalResponsesHaveNoMismatches) {
+    record_session();
+
+    // Same payload, different text formatting: normalization hides the difference
+    ScriptedServer server([](const json& request) {
+        return text_result(request, {{"count", 3}, {"args", json::object()}});
+    });
+
+    SessionReplayer replayer(SessionReplayer::load(capture_));
+    ReplayOptions options;
+    options.max_speed = true;
+    auto report = replayer.run(server, options);
+
+    EXPECT_EQ(server.received.size(), 3u);
+    EXPECT_EQ(report.messages_sent, 3u);
+    EXPECT_EQ(report.requests, 2u);
+    EXPECT_EQ(report.responses, 2u);
+    EXPECT_EQ(report.compared, 2u);
+    EXPECT_EQ(report.mismatches, 0u);
+    EXPECT_EQ(report.latencies_ms.size(), 2u);
+
+    json summary = report.to_json();
+    EXPECT_TRUE(summary["latency_ms"].contains("p99"));
+    EXPECT_GE(summary["throughput_rps"].get<double>(), 0.0);
+}
+
+TEST_F(ReplayTest, ChangedResponsesAreDiffed) {
+    record_session();
+
+    ScriptedServer server([](const json& request) {
+        int count = request["id"] == 2 ? 4 : 3;
+        return text_result(request, {{"count", count}, {"args", json::object()}});
+    });
+
+    SessionReplayer replayer(SessionReplayer::load(capture_));
+    ReplayOptions options;
+    options.max_speed = true;
+    auto report = replayer.run(server, options);
+
+    EXPECT_EQ(report.mismatches, 1u);
+    ASSERT_EQ(report.diffs.size(), 1u);
+    EXPECT_EQ(report.diffs[0]["id"], 2);
+    EXPECT_EQ(report.diffs[0]["tool"], "echo");
+    EXPECT_EQ(report.diffs[0]["patch"][0]["path"], "/result/content/0/text/count");
+}
+
+TEST_F(ReplayTest, MissingResponsesStopTheReplay) {
+    record_session();
+
+    auto capture = SessionReplayer::load(capture_);
+    MockTransport closed;  // Accepts messages, never answers
+    SessionReplayer replayer(capture);
+    ReplayOptions options;
+    options.max_speed = true;
+    auto report = replayer.run(closed, options);
+
+    EXPECT_EQ(report.requests, 1u);
+    EXPECT_EQ(report.responses, 0u);
+    EXPECT_EQ(report.missing_responses, 1u);
+}
+
+TEST(ProcessTransportTest, ExchangesLinesWithChildProcess) {
+    ProcessTransport transport({"cat"});
+    json message = {{"jsonrpc", "2.0"}, {"id", 7}, {"method", "ping"}};
+
+    transport.write_message(message);
+    EXPECT_EQ(transport.read_message(), message);
+
+    EXPECT_EQ(transport.close(), 0);
+    EXPECT_FALSE(transport.is_open());
+}
@@ -0,0 +1,109 @@
+#include "mcp/ShardPool.hpp"
+#include "core/ASTAnalyzer.hpp"
+#include "core/PathResolver.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+using namespace ts_mcp;
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief A worker stand-in answering every shard_facts call with one fact about its shard
+ */
+std::vector<std::string> fake_worker() {
+    return {"sh", "-c",
+            "while read -r line; do "
+            "id=$(echo \"$line\" | sed 's/.*\"id\":\\([0-9]*\\).*/\\1/'); "
+            "shard=$(echo \"$line\" | sed 's/.*\"shard\":\\([0-9]*\\).*/\\1/'); "
+            "printf '{\"jsonrpc\":\"2.0\",\"id\":%s,\"result\":{\"content\":[{\"type\":\"text\",\"text\":"
+            "\"{\\\\\"facts\\\\\":[{\\\\\"file\\\\\":\\\\\"/shard/%s.cpp\\\\\",\\\\\"kind\\\\\":\\\\\"k\\\\\","
+            "\\\\\"facts\\\\\":%s}]}\"}]}}\\n' \"$id\" \"$shard\" \"$shard\"; "
+            "done"};
+}
+
+} // namespace
+
+TEST(ShardPoolTest, GathersFactsFromAllWorkers) {
+    ShardPool pool(fake_worker(), 3);
+    auto context = pool.coordinator_context();
+    pool.gather("find_references", {{"symbol", "x"}}, context);
+
+    EXPECT_TRUE(context.failed_shards().empty());
+    EXPECT_EQ(context.fact_count(), 3u);
+    for (int shard = 0; shard < 3; ++shard) {
+        const json* facts = context.lookup("/shard/" + std::to_string(shard) + ".cpp", "k");
+        ASSERT_NE(facts, nullptr);
+        EXPECT_EQ(*facts, shard);
+    }
+
+    // Workers keep serving later calls
+    auto again = pool.coordinator_context();
+    pool.gather("find_references", {{"symbol", "y"}}, again);
+    EXPECT_EQ(again.fact_count(), 3u);
+}
+
+TEST(ShardPoolTest, DeadWorkersFailTheirShards) {
+    ShardPool pool({"sh", "-c", "exit 3"}, 2);
+    auto context = pool.coordinator_context();
+    pool.gather("find_classes", json::object(), context);
+
+    EXPECT_EQ(context.failed_shards().size(), 2u);
+    EXPECT_EQ(context.fact_count(), 0u);
+
+    // A file of a failed shard is reported, not silently recomputed
+    EXPECT_THROW(context.lookup("/any/file.cpp", "k"), std::runtime_error);
+}
+
+TEST(ShardPoolTest, WorkerFactsRebuildTheUnshardedResult) {
+    auto dir = fs::temp_directory_path() / "shard_pool_test";
+    fs::remove_all(dir);
+    for (int d = 0; d < 6; ++d) {
+        fs::create_directories(dir / ("d" + std::to_string(d)));
+        for (int f = 0; f <= d; ++f) {
+            std::ofstream(dir / ("d" + std::to_string(d)) / ("f" + std::to_string(f) + ".cpp")) << "int x;\n";
+        }
+    }
+
+    // A repo-wide tool: per-file facts through the analyzer, then a merge
+    auto analyzer = std::make_shared<ASTAnalyzer>();
+    std::atomic<int> computed{0};
+    ToolHandler count_files = [&](const json& args) -> json {
+        auto files = PathResolver::resolve_paths({args["filepath"].get<std::string>()});
+        int total = 0;
+        for (const auto& file : files) {
+            total += analyzer->cached_facts(file, "one", [&] {
+                computed++;
+                return json(1);
+            }, false).get<int>();
+        }
+        return {{"total", total}, {"success", true}};
+    };
+    json args = {{"filepath", dir.string()}};
+    int expected = count_files(args)["total"].get<int>();
+    EXPECT_EQ(expected, 21);
+
+    auto worker = ShardPool::worker_handler({{"count_files", count_files}});
+    auto coordinator = ShardContext::coordinator(3);
+    computed = 0;
+    for (uint32_t shard = 0; shard < 3; ++shard) {
+        json reply = worker({{"tool", "count_files"}, {"arguments", args}, {"shard", shard}, {"shards", 3}});
+        coordinator.add_facts(reply["facts"]);
+    }
+    EXPECT_EQ(computed.load(), expected) << "Each file is computed by exactly one worker";
+    EXPECT_EQ(coordinator.fact_count(), static_cast<size_t>(expected));
+
+    computed = 0;
+    {
+        ShardContext::Scope scope(&coordinator);
+        EXPECT_EQ(count_files(args)["total"].get<int>(), expected);
+    }
+    EXPECT_EQ(computed.load(), 0) << "The coordinator only merges";
+
+    ASSERT_EQ(worker({{"tool", "parse_file"}, {"arguments", args}, {"shard", 0}, {"shards", 3}}).count("error"), 1u);
+    fs::remove_all(dir);
+}
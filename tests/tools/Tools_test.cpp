@@ -5,8 +5,11 @@
 #include "tools/ExtractInterfaceTool.hpp"
 #include "tools/FindReferencesTool.hpp"
 #include "tools/GetFileSummaryTool.hpp"
+#include "tools/ServerStatsTool.hpp"
+#include "tools/MemoryStatsTool.hpp"
 #include <gtest/gtest.h>
 #include <filesystem>
+#include <fstream>
 
 using namespace ts_mcp;
 using json = nlohmann::json;
@@ -319,6 +322,77 @@ TEST_F(ToolsTest, ExecuteQueryTool_DirectoryRecursive) {
     EXPECT_GT(result["total_files"].get<int>(), 0);
 }
 
+TEST_F(ToolsTest, ExecuteQueryTool_AggregateCounts) {
+    fs::path dir = fs::temp_directory_path() / "execute_query_aggregate";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "a");
+    fs::create_directories(dir / "b");
+    dir = fs::canonical(dir);
+    std::ofstream(dir / "a" / "x.cpp") << "void g() {}\nvoid f() { new int; new int; g(); }\n";
+    std::ofstream(dir / "b" / "y.cpp") << "void h() { g(); g(); f(); }\n";
+
+    ExecuteQueryTool tool(analyzer);
+    json args = {
+        {"filepath", dir.string()},
+        {"query", "(call_expression function: (identifier) @callee) (new_expression) @new"},
+        {"aggregate", "count"}
+    };
+    json result = tool.execute(args);
+    ASSERT_FALSE(result.contains("error")) << result.dump();
+    EXPECT_EQ(result["total_files"], 2);
+    EXPECT_EQ(result["total_captures"], 6);
+    EXPECT_EQ(result["groups"], json::parse(R"([{"key":"callee","count":4},{"key":"new","count":2}])"));
+    EXPECT_FALSE(result.contains("results")) << "Aggregates carry no matches";
+
+    args["aggregate"] = "text";
+    args["capture"] = "callee";
+    args["top_k"] = 1;
+    result = tool.execute(args);
+    EXPECT_EQ(result["total_captures"], 4);
+    EXPECT_EQ(result["distinct"], 2);
+    EXPECT_EQ(result["truncated"], true);
+    EXPECT_EQ(result["groups"], json::parse(R"([{"key":"g","count":3}])"));
+
+    args["aggregate"] = "directory";
+    args["capture"] = "@new";
+    result = tool.execute(args);
+    ASSERT_EQ(result["groups"].size(), 1u);
+    EXPECT_EQ(result["groups"][0]["key"], (dir / "a").string());
+    EXPECT_EQ(result["groups"][0]["count"], 2);
+
+    args["aggregate"] = "file";
+    args["capture"] = "callee";
+    args["top_k"] = 0;
+    result = tool.execute(args);
+    json expected = {
+        {{"key", (dir / "b" / "y.cpp").string()}, {"count", 3}},
+        {{"key", (dir / "a" / "x.cpp").string()}, {"count", 1}}
+    };
+    EXPECT_EQ(result["groups"], expected);
+
+    fs::remove_all(dir);
+}
+
+TEST_F(ToolsTest, ExecuteQueryTool_AggregateInvalidArguments) {
+    ExecuteQueryTool tool(analyzer);
+    json args = {
+        {"filepath", (fixtures_dir / "simple_class.cpp").string()},
+        {"query", "(class_specifier name: (type_identifier) @name)"},
+        {"aggregate", "sum"}
+    };
+    EXPECT_TRUE(tool.execute(args).contains("error"));
+
+    args["aggregate"] = "text";
+    args["top_k"] = -1;
+    EXPECT_TRUE(tool.execute(args).contains("error"));
+
+    args.erase("top_k");
+    args["capture"] = "missing";
+    json result = tool.execute(args);
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"], "Query has no capture named @missing");
+}
+
 // ExtractInterfaceTool Tests
 
 TEST_F(ToolsTest, ExtractInterfaceTool_CppBasic) {
@@ -915,3 +989,61 @@ TEST_F(ToolsTest, GetFileSummaryTool_ToolInfo) {
     EXPECT_TRUE(info.input_schema["properties"].contains("include_comments"));
     EXPECT_TRUE(info.input_schema["properties"].contains("include_docstrings"));
 }
+
+TEST_F(ToolsTest, ServerStatsTool_ReportsCacheMetrics) {
+    ParseFileTool parse_tool(analyzer);
+    ServerStatsTool stats_tool(analyzer);
+
+    json before = stats_tool.execute(json::object());
+    ASSERT_TRUE(before.contains("metrics"));
+
+    auto counter_value = [](const json& stats, const std::string& name) -> uint64_t {
+        for (const auto& metric : stats["metrics"]) {
+            if (metric["name"] == name) {
+                return metric["value"].get<uint64_t>();
+            }
+        }
+        return 0;
+    };
+
+    std::string filepath = (fixtures_dir / "simple_class.cpp").string();
+    parse_tool.execute({{"filepath", filepath}});
+    parse_tool.execute({{"filepath", filepath}});
+
+    json after = stats_tool.execute(json::object());
+    EXPECT_EQ(counter_value(after, "ts_mcp_cache_misses_total") -
+              counter_value(before, "ts_mcp_cache_misses_total"), 1u);
+    EXPECT_GE(counter_value(after, "ts_mcp_cache_hits_total") -
+              counter_value(before, "ts_mcp_cache_hits_total"), 1u);
+    EXPECT_GT(counter_value(after, "ts_mcp_bytes_parsed_total"),
+              counter_value(before, "ts_mcp_bytes_parsed_total"));
+    EXPECT_EQ(after["cache_entries"], 1);
+
+    json prometheus = stats_tool.execute({{"format", "prometheus"}});
+    ASSERT_TRUE(prometheus.contains("text"));
+    EXPECT_NE(prometheus["text"].get<std::string>().find("# TYPE ts_mcp_cache_hits_total counter"),
+              std::string::npos);
+
+    json invalid = stats_tool.execute({{"format", "xml"}});
+    EXPECT_TRUE(invalid.contains("error"));
+}
+
+TEST_F(ToolsTest, MemoryStatsTool_ListsHeaviestFiles) {
+    ParseFileTool parse_tool(analyzer);
+    MemoryStatsTool memory_tool(analyzer);
+
+    parse_tool.execute({{"filepath", (fixtures_dir / "simple_class.cpp").string()}});
+    parse_tool.execute({{"filepath", (fixtures_dir / "template_class.cpp").string()}});
+
+    json result = memory_tool.execute({{"top", 1}});
+    ASSERT_FALSE(result.contains("error")) << result.dump();
+    EXPECT_EQ(result["parse_cache"]["documents"], 2);
+    EXPECT_GT(result["parse_cache"]["source_bytes"].get<int64_t>(), 0);
+    ASSERT_EQ(result["parse_cache"]["top_files"].size(), 1u);
+    EXPECT_TRUE(result["tree_sitter"].contains("tracking"));
+    EXPECT_TRUE(result["indexes"]["file_inventories"].is_array());
+    EXPECT_GE(result["total_bytes"].get<int64_t>(), result["parse_cache"]["source_bytes"].get<int64_t>());
+
+    json invalid = memory_tool.execute({{"top", -1}});
+    EXPECT_TRUE(invalid.contains("error"));
+}